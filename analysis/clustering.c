@@ -1,10 +1,12 @@
 #include "clustering.h"
 #include "../core/math/fixed_point.h"
 #include <string.h>
+#include <stdlib.h>
 
 #define TAG "CLUSTERING"
 
 // Static state for streaming clustering
+static DataPoint_t streaming_points[CLUSTERING_STREAM_CAPACITY];
 static Dataset_t streaming_dataset;
 static KMeansResult_t streaming_result;
 static bool streaming_active = false;
@@ -13,7 +15,7 @@ static bool streaming_active = false;
 FuriStatus clustering_engine_init(void) {
     FURI_LOG_I(TAG, "Initializing clustering engine");
     
-    memset(&streaming_dataset, 0, sizeof(streaming_dataset));
+    clustering_dataset_init(&streaming_dataset, streaming_points, CLUSTERING_STREAM_CAPACITY);
     memset(&streaming_result, 0, sizeof(streaming_result));
     streaming_active = false;
     
@@ -24,107 +26,477 @@ void clustering_engine_deinit(void) {
     streaming_active = false;
 }
 
-// K-means clustering main function
-KMeansResult_t clustering_kmeans(const Dataset_t* data, uint8_t k) {
-    KMeansResult_t result;
-    memset(&result, 0, sizeof(result));
+// ============================================================================
+// K-MEANS HELPERS
+// Distances are compared squared in raw Q15.16 units (64-bit, no square
+// root); a root is only taken where the Hamerly bounds need true distances.
+// ============================================================================
+
+// Analysis-thread scratch: the Hamerly bounds and the hierarchical distance
+// matrix are never live at the same time
+static union {
+    struct {
+        uint32_t upper[KMEANS_BOUNDS_CAPACITY];     // >= distance to own centroid
+        uint32_t lower[KMEANS_BOUNDS_CAPACITY];     // <= distance to any other centroid
+    } bounds;
+    uint16_t distances[HIERARCHICAL_MATRIX_SIZE];   // Packed upper triangle
+} clustering_scratch;
+
+static uint32_t kmeans_rng_state = KMEANS_SEED;
+
+// Squared per-axis delta. Deltas saturate at INT32_MAX so each square stays
+// below 2^62 and the sum of both axes fits in 64 bits for any fixed_t input.
+static inline uint64_t kmeans_axis_sq(fixed_t a, fixed_t b) {
+    int64_t d = (int64_t)a - b;
+    uint64_t mag = (d < 0) ? (uint64_t)-d : (uint64_t)d;
+    if(mag > INT32_MAX) mag = INT32_MAX;
+    return mag * mag;
+}
+
+static inline uint64_t kmeans_dist_sq(fixed_t ax, fixed_t ay, fixed_t bx, fixed_t by) {
+    return kmeans_axis_sq(ax, bx) + kmeans_axis_sq(ay, by);
+}
+
+static inline uint64_t kmeans_point_dist_sq(const DataPoint_t* p, const Centroid_t* c) {
+    return kmeans_dist_sq(p->x, p->y, c->x, c->y);
+}
+
+// Integer square root (floor)
+static uint32_t kmeans_isqrt(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = 1ULL << 62;
+    
+    while(bit > x) bit >>= 2;
+    while(bit) {
+        if(x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    
+    return (root > UINT32_MAX) ? UINT32_MAX : (uint32_t)root;
+}
+
+// Squared raw distance to Q15.16 (saturating)
+static inline fixed_t kmeans_sq_to_fixed(uint64_t sq) {
+    sq >>= FIXED_FRACTIONAL_BITS;
+    return (sq > FIXED_MAX) ? FIXED_MAX : (fixed_t)sq;
+}
+
+// xorshift32 - deterministic so repeated runs on the same data agree
+static inline uint32_t kmeans_rand(void) {
+    uint32_t x = kmeans_rng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    kmeans_rng_state = x;
+    return x;
+}
+
+// Nearest and second-nearest centroid (squared distances)
+static uint8_t kmeans_nearest(KMeansResult_t* result, const DataPoint_t* point,
+                              uint64_t* best_sq, uint64_t* second_sq) {
+    uint64_t best = UINT64_MAX, second = UINT64_MAX;
+    uint8_t best_cluster = 0;
+    
+    for(uint8_t j = 0; j < result->k; j++) {
+        uint64_t sq = kmeans_point_dist_sq(point, &result->centroids[j]);
+        if(sq < best) {
+            second = best;
+            best = sq;
+            best_cluster = j;
+        } else if(sq < second) {
+            second = sq;
+        }
+    }
+    result->distance_evals += result->k;
+    
+    *best_sq = best;
+    if(second_sq) *second_sq = second;
+    return best_cluster;
+}
+
+// Move centroids to the mean of their points; returns Manhattan movement
+static fixed_t kmeans_move_centroids(KMeansResult_t* result, const Dataset_t* data) {
+    int64_t sum_x[KMEANS_MAX_K] = {0};
+    int64_t sum_y[KMEANS_MAX_K] = {0};
+    uint16_t counts[KMEANS_MAX_K] = {0};
     
+    for(uint16_t i = 0; i < data->count; i++) {
+        uint8_t cluster = data->points[i].cluster_id;
+        if(cluster >= result->k) continue;
+        sum_x[cluster] += data->points[i].x;
+        sum_y[cluster] += data->points[i].y;
+        counts[cluster]++;
+    }
+    
+    fixed_t movement = 0;
+    for(uint8_t i = 0; i < result->k; i++) {
+        // If no points in cluster, leave centroid unchanged
+        if(counts[i] == 0) continue;
+        
+        fixed_t x = (fixed_t)(sum_x[i] / counts[i]);
+        fixed_t y = (fixed_t)(sum_y[i] / counts[i]);
+        movement += fixed_abs(x - result->centroids[i].x) + fixed_abs(y - result->centroids[i].y);
+        result->centroids[i].x = x;
+        result->centroids[i].y = y;
+    }
+    
+    return movement;
+}
+
+// Converged if movement is less than 0.5% of typical scale
+static inline bool kmeans_settled(fixed_t movement) {
+    return movement < KMEANS_MOVE_THRESHOLD;
+}
+
+// Point counts and inertia for the current assignment
+static void kmeans_finalize(KMeansResult_t* result, const Dataset_t* data) {
+    uint64_t inertia[KMEANS_MAX_K] = {0};
+    
+    for(uint8_t i = 0; i < result->k; i++) {
+        result->centroids[i].point_count = 0;
+    }
+    
+    for(uint16_t i = 0; i < data->count; i++) {
+        uint8_t cluster = data->points[i].cluster_id;
+        if(cluster >= result->k) continue;
+        inertia[cluster] += kmeans_point_dist_sq(&data->points[i], &result->centroids[cluster]);
+        result->centroids[cluster].point_count++;
+    }
+    result->distance_evals += data->count;
+    
+    uint64_t total = 0;
+    for(uint8_t i = 0; i < result->k; i++) {
+        result->centroids[i].inertia = kmeans_sq_to_fixed(inertia[i]);
+        total += inertia[i];
+    }
+    result->total_inertia = kmeans_sq_to_fixed(total);
+}
+
+// Plain Lloyd iterations (datasets larger than the bound arrays)
+static void kmeans_lloyd(KMeansResult_t* result, const Dataset_t* data) {
+    for(uint8_t iter = 0; iter < KMEANS_MAX_ITERATIONS; iter++) {
+        bool changed = clustering_kmeans_assign_points(result, data);
+        fixed_t movement = kmeans_move_centroids(result, data);
+        
+        result->iterations = iter + 1;
+        
+        if((iter > 0 && !changed) || kmeans_settled(movement)) {
+            result->converged = true;
+            break;
+        }
+    }
+}
+
+// Hamerly's accelerated Lloyd: one upper and one lower bound per point let most
+// points skip the distance scan once centroids start to settle
+static void kmeans_hamerly(KMeansResult_t* result, const Dataset_t* data) {
+    uint8_t k = result->k;
+    DataPoint_t* points = data->points;
+    uint32_t* upper = clustering_scratch.bounds.upper;
+    uint32_t* lower = clustering_scratch.bounds.lower;
+    
+    // Initial assignment with exact bounds
+    for(uint16_t i = 0; i < data->count; i++) {
+        uint64_t best_sq, second_sq;
+        points[i].cluster_id = kmeans_nearest(result, &points[i], &best_sq, &second_sq);
+        upper[i] = kmeans_isqrt(best_sq) + 1;
+        lower[i] = kmeans_isqrt(second_sq);
+    }
+    
+    for(uint8_t iter = 0; iter < KMEANS_MAX_ITERATIONS; iter++) {
+        Centroid_t prev[KMEANS_MAX_K];
+        memcpy(prev, result->centroids, sizeof(Centroid_t) * k);
+        
+        fixed_t movement = kmeans_move_centroids(result, data);
+        result->iterations = iter + 1;
+        
+        if(kmeans_settled(movement)) {
+            result->converged = true;
+            break;
+        }
+        
+        // Per-centroid drift, plus the two largest for the lower bounds
+        uint32_t drift[KMEANS_MAX_K];
+        uint32_t drift_max = 0, drift_second = 0;
+        uint8_t drift_max_idx = 0;
+        for(uint8_t j = 0; j < k; j++) {
+            drift[j] = kmeans_isqrt(kmeans_dist_sq(prev[j].x, prev[j].y,
+                                                   result->centroids[j].x,
+                                                   result->centroids[j].y)) + 1;
+            if(drift[j] > drift_max) {
+                drift_second = drift_max;
+                drift_max = drift[j];
+                drift_max_idx = j;
+            } else if(drift[j] > drift_second) {
+                drift_second = drift[j];
+            }
+        }
+        
+        // Half the distance from each centroid to its nearest neighbour
+        uint32_t half_gap[KMEANS_MAX_K];
+        for(uint8_t j = 0; j < k; j++) {
+            uint64_t nearest_sq = UINT64_MAX;
+            for(uint8_t m = 0; m < k; m++) {
+                if(m == j) continue;
+                uint64_t sq = kmeans_dist_sq(result->centroids[j].x, result->centroids[j].y,
+                                             result->centroids[m].x, result->centroids[m].y);
+                if(sq < nearest_sq) nearest_sq = sq;
+            }
+            half_gap[j] = kmeans_isqrt(nearest_sq) / 2;
+        }
+        result->distance_evals += k * (k - 1);
+        
+        bool changed = false;
+        for(uint16_t i = 0; i < data->count; i++) {
+            uint8_t own = points[i].cluster_id;
+            uint32_t lower_drift = (own == drift_max_idx) ? drift_second : drift_max;
+            
+            upper[i] = (upper[i] > UINT32_MAX - drift[own]) ?
+                              UINT32_MAX : upper[i] + drift[own];
+            lower[i] = (lower[i] > lower_drift) ?
+                              lower[i] - lower_drift : 0;
+            
+            uint32_t bound = (half_gap[own] > lower[i]) ? half_gap[own] : lower[i];
+            if(upper[i] <= bound) continue;
+            
+            // Tighten the upper bound before paying for a full scan
+            upper[i] = kmeans_isqrt(
+                kmeans_point_dist_sq(&points[i], &result->centroids[own])) + 1;
+            result->distance_evals++;
+            if(upper[i] <= bound) continue;
+            
+            uint64_t best_sq, second_sq;
+            uint8_t best = kmeans_nearest(result, &points[i], &best_sq, &second_sq);
+            if(best != own) {
+                points[i].cluster_id = best;
+                changed = true;
+            }
+            upper[i] = kmeans_isqrt(best_sq) + 1;
+            lower[i] = kmeans_isqrt(second_sq);
+        }
+        
+        if(!changed) {
+            result->converged = true;
+            break;
+        }
+    }
+}
+
+// Simplified silhouette from centroid distances - O(n*k) instead of O(n^2)
+static fixed_t kmeans_centroid_silhouette(const Dataset_t* data, const KMeansResult_t* clusters) {
+    int64_t total_score = 0;
+    
+    for(uint16_t i = 0; i < data->count; i++) {
+        uint8_t own = data->points[i].cluster_id;
+        uint64_t a_sq = kmeans_point_dist_sq(&data->points[i], &clusters->centroids[own]);
+        uint64_t b_sq = UINT64_MAX;
+        
+        for(uint8_t c = 0; c < clusters->k; c++) {
+            if(c == own) continue;
+            uint64_t sq = kmeans_point_dist_sq(&data->points[i], &clusters->centroids[c]);
+            if(sq < b_sq) b_sq = sq;
+        }
+        
+        uint32_t a = kmeans_isqrt(a_sq);
+        uint32_t b = kmeans_isqrt(b_sq);
+        uint32_t max_ab = (a > b) ? a : b;
+        if(max_ab > 0) {
+            total_score += (((int64_t)b - a) << FIXED_FRACTIONAL_BITS) / max_ab;
+        }
+    }
+    
+    return (fixed_t)(total_score / data->count);
+}
+
+// Cluster quality: exact silhouette for small sets, centroid-based otherwise
+static fixed_t kmeans_quality(const Dataset_t* data, const KMeansResult_t* clusters) {
+    if(clusters->k < 2 || data->count < 2) return 0;
+    if(data->count <= KMEANS_SILHOUETTE_EXACT_MAX) {
+        return clustering_silhouette_score(data, clusters);
+    }
+    return kmeans_centroid_silhouette(data, clusters);
+}
+
+// Clamp requested k to the engine limit and the dataset size
+static uint8_t kmeans_clamp_k(const Dataset_t* data, uint8_t k) {
     if(k == 0 || k > KMEANS_MAX_K) {
         k = 3;  // Default to 3 clusters
     }
     if(k > data->count) {
         k = data->count;  // Can't have more clusters than points
     }
+    return k;
+}
+
+// ============================================================================
+// K-MEANS CLUSTERING
+// ============================================================================
+
+// K-means clustering main function
+KMeansResult_t clustering_kmeans(const Dataset_t* data, uint8_t k) {
+    if(data->count > KMEANS_BOUNDS_CAPACITY) {
+        return clustering_kmeans_minibatch(data, k, KMEANS_MINIBATCH_SIZE,
+                                           KMEANS_MINIBATCH_ITERATIONS);
+    }
     
-    result.k = k;
+    KMeansResult_t result;
+    memset(&result, 0, sizeof(result));
+    result.k = kmeans_clamp_k(data, k);
+    if(result.k == 0) return result;
     
-    // Initialize centroids randomly (using first k points)
-    for(uint8_t i = 0; i < k; i++) {
-        result.centroids[i].x = data->points[i].x;
-        result.centroids[i].y = data->points[i].y;
-        result.centroids[i].point_count = 0;
-        result.centroids[i].inertia = 0;
-    }
+    clustering_kmeans_seed(&result, data);
     
     // Run iterative optimization
     clustering_kmeans_iterative(&result, data);
     
-    // Calculate silhouette score
-    result.silhouette_score = clustering_silhouette_score(data, &result);
+    result.silhouette_score = kmeans_quality(data, &result);
     
     return result;
 }
 
-// Iterative K-means optimization
-void clustering_kmeans_iterative(KMeansResult_t* result, const Dataset_t* data) {
-    KMeansResult_t prev_result;
+// k-means++ seeding: each new centroid is drawn with probability proportional
+// to its squared distance from the nearest centroid chosen so far
+void clustering_kmeans_seed(KMeansResult_t* result, const Dataset_t* data) {
+    if(result->k == 0 || data->count == 0) return;
     
-    for(uint8_t iter = 0; iter < KMEANS_MAX_ITERATIONS; iter++) {
-        memcpy(&prev_result, result, sizeof(KMeansResult_t));
+    kmeans_rng_state = KMEANS_SEED ^ data->count;
+    if(kmeans_rng_state == 0) kmeans_rng_state = KMEANS_SEED;
+    
+    const DataPoint_t* first = &data->points[kmeans_rand() % data->count];
+    for(uint8_t c = 0; c < result->k; c++) {
+        result->centroids[c].x = first->x;
+        result->centroids[c].y = first->y;
+        result->centroids[c].point_count = 0;
+        result->centroids[c].inertia = 0;
+    }
+    
+    for(uint8_t c = 1; c < result->k; c++) {
+        // Weights use Q15.16 squared units so the 64-bit total cannot overflow
+        uint64_t total = 0;
+        for(uint16_t i = 0; i < data->count; i++) {
+            uint64_t best = UINT64_MAX;
+            for(uint8_t j = 0; j < c; j++) {
+                uint64_t sq = kmeans_point_dist_sq(&data->points[i], &result->centroids[j]);
+                if(sq < best) best = sq;
+            }
+            total += best >> FIXED_FRACTIONAL_BITS;
+        }
+        result->distance_evals += (uint32_t)data->count * c;
         
-        // Assign points to nearest centroids
-        clustering_kmeans_assign_points(result, data);
+        // Every point coincides with a centroid: keep the duplicates
+        if(total == 0) break;
         
-        // Update centroids
-        clustering_kmeans_update_centroids(result, data);
+        uint64_t target = (((uint64_t)kmeans_rand() << 32) | kmeans_rand()) % total;
+        uint16_t pick = data->count - 1;
+        for(uint16_t i = 0; i < data->count; i++) {
+            uint64_t best = UINT64_MAX;
+            for(uint8_t j = 0; j < c; j++) {
+                uint64_t sq = kmeans_point_dist_sq(&data->points[i], &result->centroids[j]);
+                if(sq < best) best = sq;
+            }
+            uint64_t weight = best >> FIXED_FRACTIONAL_BITS;
+            if(target < weight) {
+                pick = i;
+                break;
+            }
+            target -= weight;
+        }
+        result->distance_evals += (uint32_t)(pick + 1) * c;
         
-        result->iterations = iter + 1;
+        result->centroids[c].x = data->points[pick].x;
+        result->centroids[c].y = data->points[pick].y;
+    }
+}
+
+// Iterative K-means optimization from seeded centroids
+void clustering_kmeans_iterative(KMeansResult_t* result, const Dataset_t* data) {
+    result->converged = false;
+    if(result->k == 0 || data->count == 0) return;
+    
+    if(data->count <= KMEANS_BOUNDS_CAPACITY) {
+        kmeans_hamerly(result, data);
+    } else {
+        kmeans_lloyd(result, data);
+    }
+    
+    kmeans_finalize(result, data);
+}
+
+// Mini-batch K-means: centroids follow random samples with a per-centroid
+// learning rate of 1/count, then one full pass assigns every point
+KMeansResult_t clustering_kmeans_minibatch(const Dataset_t* data, uint8_t k,
+                                           uint16_t batch_size, uint8_t iterations) {
+    KMeansResult_t result;
+    memset(&result, 0, sizeof(result));
+    result.k = kmeans_clamp_k(data, k);
+    if(result.k == 0 || batch_size == 0) return result;
+    
+    clustering_kmeans_seed(&result, data);
+    
+    uint32_t seen[KMEANS_MAX_K] = {0};
+    for(uint8_t iter = 0; iter < iterations; iter++) {
+        fixed_t movement = 0;
         
-        // Check convergence
-        if(clustering_kmeans_check_convergence(&prev_result, result)) {
-            result->converged = true;
+        for(uint16_t b = 0; b < batch_size; b++) {
+            const DataPoint_t* point = &data->points[kmeans_rand() % data->count];
+            uint64_t best_sq;
+            uint8_t c = kmeans_nearest(&result, point, &best_sq, NULL);
+            
+            seen[c]++;
+            fixed_t dx = (fixed_t)(((int64_t)point->x - result.centroids[c].x) / (int64_t)seen[c]);
+            fixed_t dy = (fixed_t)(((int64_t)point->y - result.centroids[c].y) / (int64_t)seen[c]);
+            result.centroids[c].x += dx;
+            result.centroids[c].y += dy;
+            movement += fixed_abs(dx) + fixed_abs(dy);
+        }
+        
+        result.iterations = iter + 1;
+        
+        // Movement is summed over the batch, so compare the per-sample mean
+        if(iter > 0 && kmeans_settled(movement / batch_size)) {
+            result.converged = true;
             break;
         }
     }
     
-    // Calculate total inertia
-    result->total_inertia = 0;
-    for(uint8_t i = 0; i < result->k; i++) {
-        result->total_inertia += result->centroids[i].inertia;
-    }
+    clustering_kmeans_assign_points(&result, data);
+    kmeans_finalize(&result, data);
+    result.silhouette_score = kmeans_quality(data, &result);
+    
+    return result;
 }
 
-// Assign points to nearest centroids
+// Assign points to nearest centroids (squared distances, no square root)
 bool clustering_kmeans_assign_points(KMeansResult_t* result, const Dataset_t* data) {
     bool changed = false;
+    uint64_t inertia[KMEANS_MAX_K] = {0};
     
     // Reset point counts
     for(uint8_t i = 0; i < result->k; i++) {
         result->centroids[i].point_count = 0;
-        result->centroids[i].inertia = 0;
     }
     
-    // Assign each point to nearest centroid
     for(uint16_t i = 0; i < data->count; i++) {
-        fixed_t min_distance = FIXED_MAX;
-        uint8_t best_cluster = 0;
-        
-        for(uint8_t j = 0; j < result->k; j++) {
-            DataPoint_t centroid_point;
-            centroid_point.x = result->centroids[j].x;
-            centroid_point.y = result->centroids[j].y;
-            
-            fixed_t dist = clustering_distance_euclidean(&data->points[i], &centroid_point);
-            
-            if(dist < min_distance) {
-                min_distance = dist;
-                best_cluster = j;
-            }
-        }
+        uint64_t best_sq;
+        uint8_t best_cluster = kmeans_nearest(result, &data->points[i], &best_sq, NULL);
         
         if(data->points[i].cluster_id != best_cluster) {
             changed = true;
         }
         
-        // Temporarily store assignment
-        // (Note: we're modifying a const pointer here, which is bad practice
-        // but necessary for this implementation. In production, use non-const.)
-        ((Dataset_t*)data)->points[i].cluster_id = best_cluster;
+        // Dataset views share their points buffer; assignments are written in place
+        data->points[i].cluster_id = best_cluster;
         result->centroids[best_cluster].point_count++;
-        
-        // Accumulate squared distance for inertia
-        fixed_t sq_dist = fixed_mul(min_distance, min_distance);
-        result->centroids[best_cluster].inertia += sq_dist;
+        inertia[best_cluster] += best_sq;
+    }
+    
+    for(uint8_t i = 0; i < result->k; i++) {
+        result->centroids[i].inertia = kmeans_sq_to_fixed(inertia[i]);
     }
     
     return changed;
@@ -132,26 +504,7 @@ bool clustering_kmeans_assign_points(KMeansResult_t* result, const Dataset_t* da
 
 // Update centroid positions
 void clustering_kmeans_update_centroids(KMeansResult_t* result, const Dataset_t* data) {
-    // Accumulate coordinates for each cluster
-    fixed_t sum_x[KMEANS_MAX_K] = {0};
-    fixed_t sum_y[KMEANS_MAX_K] = {0};
-    uint16_t counts[KMEANS_MAX_K] = {0};
-    
-    for(uint16_t i = 0; i < data->count; i++) {
-        uint8_t cluster = data->points[i].cluster_id;
-        sum_x[cluster] += data->points[i].x;
-        sum_y[cluster] += data->points[i].y;
-        counts[cluster]++;
-    }
-    
-    // Calculate new centroids
-    for(uint8_t i = 0; i < result->k; i++) {
-        if(counts[i] > 0) {
-            result->centroids[i].x = sum_x[i] / counts[i];
-            result->centroids[i].y = sum_y[i] / counts[i];
-        }
-        // If no points in cluster, leave centroid unchanged
-    }
+    kmeans_move_centroids(result, data);
 }
 
 // Check for convergence
@@ -167,11 +520,7 @@ bool clustering_kmeans_check_convergence(const KMeansResult_t* prev,
         total_movement += fixed_abs(dx) + fixed_abs(dy);
     }
     
-    // Converged if movement is less than threshold
-    // Threshold is 0.5% of typical scale (represented in fixed-point)
-    fixed_t threshold = FIXED_ONE / 200;  // 0.5%
-    
-    return (total_movement < threshold);
+    return kmeans_settled(total_movement);
 }
 
 // Calculate Euclidean distance between two points
@@ -278,24 +627,40 @@ void clustering_extract_features(const Frame_t* frame, DataPoint_t* features,
     }
 }
 
-// Extract features from pulse sequence
-void clustering_extract_pulse_features(const Pulse_t* pulses, uint16_t pulse_count,
-                                        DataPoint_t* features, uint16_t* count) {
+// Extract features from pulse sequence (widths read in place from the pulse store)
+void clustering_extract_pulse_features(const SessionPulseView_t* pulses,
+                                        DataPoint_t* features, uint16_t max_features,
+                                        uint16_t* count) {
     *count = 0;
     
-    if(pulse_count < 2) return;
+    if(pulses->count < 2) return;
     
     // Create features from consecutive pulse pairs
-    for(uint16_t i = 0; i < pulse_count - 1 && *count < MAX_PULSE_COUNT; i += 2) {
+    for(uint16_t i = 0; i < pulses->count - 1 && *count < max_features; i += 2) {
         // Feature 1: Mark width
-        features[*count].x = INT_TO_FIXED(pulses[i].width_us);
+        features[*count].x = INT_TO_FIXED(session_pulse_width(pulses, i));
         // Feature 2: Space width
-        features[*count].y = INT_TO_FIXED(pulses[i + 1].width_us);
+        features[*count].y = INT_TO_FIXED(session_pulse_width(pulses, i + 1));
         features[*count].cluster_id = 0;
+        features[*count].frame_id = 0;
         (*count)++;
     }
 }
 
+// Bind dataset to storage
+void clustering_dataset_init(Dataset_t* data, DataPoint_t* storage, uint16_t capacity) {
+    data->points = storage;
+    data->count = 0;
+    data->capacity = capacity;
+    data->num_features = 2;
+}
+
+// Fill dataset with mark/space features from a session pulse window
+uint16_t clustering_dataset_from_pulses(Dataset_t* data, const SessionPulseView_t* pulses) {
+    clustering_extract_pulse_features(pulses, data->points, data->capacity, &data->count);
+    return data->count;
+}
+
 // Find optimal k using silhouette score
 uint8_t clustering_find_optimal_k(const Dataset_t* data, uint8_t k_min, uint8_t k_max) {
     fixed_t best_score = FIXED_MIN;
@@ -316,7 +681,7 @@ uint8_t clustering_find_optimal_k(const Dataset_t* data, uint8_t k_min, uint8_t
 
 // Initialize streaming clustering
 void clustering_init_streaming(uint8_t k) {
-    memset(&streaming_dataset, 0, sizeof(streaming_dataset));
+    clustering_dataset_init(&streaming_dataset, streaming_points, CLUSTERING_STREAM_CAPACITY);
     memset(&streaming_result, 0, sizeof(streaming_result));
     streaming_result.k = k;
     streaming_active = true;
@@ -325,7 +690,7 @@ void clustering_init_streaming(uint8_t k) {
 // Add point to streaming clustering
 void clustering_add_point_streaming(const DataPoint_t* point) {
     if(!streaming_active) return;
-    if(streaming_dataset.count >= MAX_PULSE_COUNT) return;
+    if(streaming_dataset.count >= streaming_dataset.capacity) return;
     
     memcpy(&streaming_dataset.points[streaming_dataset.count], point, sizeof(DataPoint_t));
     streaming_dataset.count++;
@@ -343,7 +708,6 @@ KMeansResult_t clustering_get_streaming_result(void) {
 
 // Reset streaming clustering
 void clustering_reset_streaming(void) {
-    memset(&streaming_dataset, 0, sizeof(streaming_dataset));
     streaming_dataset.count = 0;
 }
 
@@ -391,23 +755,369 @@ void clustering_normalize_for_display(const Dataset_t* data,
     }
 }
 
-// Hierarchical clustering (simplified)
-Dendrogram_t clustering_hierarchical(const Dataset_t* data, DistanceMetric_t metric) {
-    Dendrogram_t dendrogram;
-    memset(&dendrogram, 0, sizeof(dendrogram));
+// ============================================================================
+// HIERARCHICAL CLUSTERING
+// Nearest-neighbor chain over a packed upper-triangular distance matrix,
+// O(n^2) time. Distances are quantised to 16 bits against the largest
+// pairwise distance; single/complete/average linkage only ever produce values
+// inside that range, so the scale holds for every merge.
+// ============================================================================
+
+#define HIER_Q_MAX      0xFFFEU     // Largest quantised distance
+#define HIER_NONE       0xFFFF
+
+// Per-point working state (the matrix lives in clustering_scratch)
+static uint16_t hier_size[HIERARCHICAL_MAX_POINTS];
+static uint16_t hier_chain[HIERARCHICAL_MAX_POINTS];
+static bool hier_active[HIERARCHICAL_MAX_POINTS];
+
+// Packed index of the pair (i, j), i != j
+static inline uint32_t hier_index(uint16_t n, uint16_t i, uint16_t j) {
+    if(i > j) {
+        uint16_t t = i;
+        i = j;
+        j = t;
+    }
+    return (uint32_t)i * n - ((uint32_t)i * (i + 1)) / 2 + (j - i - 1);
+}
+
+// Point distance in raw Q15.16 units (DTW has no meaning for single points
+// and falls back to Euclidean)
+static uint32_t hier_point_distance(const DataPoint_t* a, const DataPoint_t* b,
+                                    DistanceMetric_t metric) {
+    switch(metric) {
+        case DISTANCE_MANHATTAN: {
+            uint64_t d = (uint64_t)llabs((int64_t)a->x - b->x) +
+                         (uint64_t)llabs((int64_t)a->y - b->y);
+            return (d > UINT32_MAX) ? UINT32_MAX : (uint32_t)d;
+        }
+        case DISTANCE_COSINE: {
+            fixed_t d = clustering_distance_cosine(a, b);
+            return (d < 0) ? 0 : (uint32_t)d;
+        }
+        case DISTANCE_EUCLIDEAN:
+        case DISTANCE_DTW:
+        default:
+            return kmeans_isqrt(kmeans_dist_sq(a->x, a->y, b->x, b->y));
+    }
+}
+
+// Lance-Williams update for the merged cluster (a absorbs b) against c
+static inline uint16_t hier_linkage(HierarchicalLinkage_t linkage, uint16_t d_ac, uint16_t d_bc,
+                                    uint16_t size_a, uint16_t size_b) {
+    switch(linkage) {
+        case LINKAGE_SINGLE:
+            return (d_ac < d_bc) ? d_ac : d_bc;
+        case LINKAGE_COMPLETE:
+            return (d_ac > d_bc) ? d_ac : d_bc;
+        case LINKAGE_AVERAGE:
+        default:
+            return (uint16_t)(((uint32_t)d_ac * size_a + (uint32_t)d_bc * size_b) /
+                              (size_a + size_b));
+    }
+}
+
+// Leaf i of an n-leaf pass, spread evenly over the whole dataset
+static inline const DataPoint_t* hier_point(const Dataset_t* data, uint16_t n, uint16_t i) {
+    return &data->points[(uint32_t)i * data->count / n];
+}
+
+// Union-find root with path halving
+static uint16_t hier_find(uint16_t* parent, uint16_t i) {
+    while(parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+// Agglomerative clustering. Larger datasets are subsampled with an even
+// stride to HIERARCHICAL_MAX_POINTS leaves; source_points records the
+// original size (see clustering_hierarchical_leaf_point).
+bool clustering_hierarchical(const Dataset_t* data, DistanceMetric_t metric,
+                             HierarchicalLinkage_t linkage, Dendrogram_t* dendrogram) {
+    memset(dendrogram, 0, sizeof(Dendrogram_t));
+    
+    uint16_t n = data->count;
+    if(n < 2) return false;
+    if(n > HIERARCHICAL_MAX_POINTS) {
+        FURI_LOG_D(TAG, "Hierarchical: sampling %d of %d points", HIERARCHICAL_MAX_POINTS, n);
+        n = HIERARCHICAL_MAX_POINTS;
+    }
+    
+    uint16_t* dist = clustering_scratch.distances;
+    
+    // Scale: largest pairwise distance maps to HIER_Q_MAX
+    uint32_t max_dist = 0;
+    for(uint16_t i = 0; i < n; i++) {
+        for(uint16_t j = i + 1; j < n; j++) {
+            uint32_t d = hier_point_distance(hier_point(data, n, i), hier_point(data, n, j), metric);
+            if(d > max_dist) max_dist = d;
+        }
+    }
+    for(uint16_t i = 0; i < n; i++) {
+        for(uint16_t j = i + 1; j < n; j++) {
+            uint32_t d = hier_point_distance(hier_point(data, n, i), hier_point(data, n, j), metric);
+            dist[hier_index(n, i, j)] = max_dist ?
+                (uint16_t)(((uint64_t)d * HIER_Q_MAX) / max_dist) : 0;
+        }
+        hier_size[i] = 1;
+        hier_active[i] = true;
+    }
+    
+    // Nearest-neighbor chain: follow nearest neighbours until two clusters are
+    // mutual nearest neighbours, merge them, and resume from the chain's tail
+    uint16_t chain_len = 0;
+    uint16_t merges = 0;
+    while(merges < n - 1) {
+        if(chain_len == 0) {
+            for(uint16_t i = 0; i < n; i++) {
+                if(hier_active[i]) {
+                    hier_chain[chain_len++] = i;
+                    break;
+                }
+            }
+        }
+        
+        uint16_t a, b;
+        uint16_t d_ab;
+        while(1) {
+            a = hier_chain[chain_len - 1];
+            
+            // Prefer the previous chain element on ties so the chain cannot cycle
+            b = HIER_NONE;
+            d_ab = 0xFFFF;
+            if(chain_len >= 2) {
+                b = hier_chain[chain_len - 2];
+                d_ab = dist[hier_index(n, a, b)];
+            }
+            for(uint16_t c = 0; c < n; c++) {
+                if(!hier_active[c] || c == a) continue;
+                uint16_t d = dist[hier_index(n, a, c)];
+                if(d < d_ab || b == HIER_NONE) {
+                    d_ab = d;
+                    b = c;
+                }
+            }
+            
+            if(chain_len >= 2 && b == hier_chain[chain_len - 2]) break;
+            hier_chain[chain_len++] = b;
+        }
+        chain_len -= 2;
+        
+        // Merge b into a; node children are fixed up after sorting
+        DendrogramNode_t* node = &dendrogram->nodes[merges++];
+        node->left = a;
+        node->right = b;
+        node->distance = (fixed_t)(((uint64_t)d_ab * max_dist) / HIER_Q_MAX);
+        if(node->distance < 0) node->distance = FIXED_MAX;
+        
+        for(uint16_t c = 0; c < n; c++) {
+            if(!hier_active[c] || c == a || c == b) continue;
+            uint32_t ac = hier_index(n, a, c);
+            dist[ac] = hier_linkage(linkage, dist[ac], dist[hier_index(n, b, c)],
+                                    hier_size[a], hier_size[b]);
+        }
+        hier_size[a] += hier_size[b];
+        hier_active[b] = false;
+    }
+    
+    // Chain order is not distance order: stable-sort merges by distance
+    for(uint16_t i = 1; i < merges; i++) {
+        DendrogramNode_t key = dendrogram->nodes[i];
+        uint16_t j = i;
+        while(j > 0 && dendrogram->nodes[j - 1].distance > key.distance) {
+            dendrogram->nodes[j] = dendrogram->nodes[j - 1];
+            j--;
+        }
+        dendrogram->nodes[j] = key;
+    }
+    
+    // Relabel: leaves are 0..n-1, merge i becomes node n + i
+    uint16_t* parent = hier_chain;      // Chain is empty now, reuse it
+    uint16_t* node_of = hier_size;
+    for(uint16_t i = 0; i < n; i++) {
+        parent[i] = i;
+        node_of[i] = i;
+    }
+    for(uint16_t m = 0; m < merges; m++) {
+        DendrogramNode_t* node = &dendrogram->nodes[m];
+        uint16_t ra = hier_find(parent, node->left);
+        uint16_t rb = hier_find(parent, node->right);
+        uint16_t left = node_of[ra];
+        uint16_t right = node_of[rb];
+        
+        node->left = left;
+        node->right = right;
+        node->num_points = ((left < n) ? 1 : dendrogram->nodes[left - n].num_points) +
+                           ((right < n) ? 1 : dendrogram->nodes[right - n].num_points);
+        
+        parent[rb] = ra;
+        node_of[ra] = n + m;
+    }
+    
+    dendrogram->num_points = n;
+    dendrogram->source_points = data->count;
+    dendrogram->num_nodes = merges;
+    dendrogram->root_index = n + merges - 1;
+    
+    return true;
+}
+
+// Flat clustering: undo the last k-1 merges and label the k subtrees
+void clustering_hierarchical_cut(const Dendrogram_t* dendrogram, uint8_t k,
+                                  uint8_t* assignments) {
+    uint16_t n = dendrogram->num_points;
+    if(n == 0) return;
+    if(k == 0) k = 1;
+    if(k > n) k = n;
+    
+    // Representative leaf of every node, then union the kept merges
+    uint16_t* parent = hier_chain;
+    uint16_t* rep = hier_size;
+    for(uint16_t i = 0; i < n; i++) {
+        parent[i] = i;
+    }
+    
+    uint16_t keep = n - k;
+    for(uint16_t m = 0; m < keep && m < dendrogram->num_nodes; m++) {
+        const DendrogramNode_t* node = &dendrogram->nodes[m];
+        uint16_t left = (node->left < n) ? node->left : rep[node->left - n];
+        uint16_t right = (node->right < n) ? node->right : rep[node->right - n];
+        rep[m] = left;
+        parent[hier_find(parent, right)] = hier_find(parent, left);
+    }
+    
+    // Label roots in order of first appearance
+    uint8_t next_label = 0;
+    for(uint16_t i = 0; i < n; i++) {
+        uint16_t root = hier_find(parent, i);
+        if(root == i) assignments[i] = next_label++;
+    }
+    for(uint16_t i = 0; i < n; i++) {
+        assignments[i] = assignments[hier_find(parent, i)];
+    }
+}
+
+// Natural cluster count: the widest jump between successive merge distances
+uint8_t clustering_hierarchical_suggest_k(const Dendrogram_t* dendrogram, uint8_t k_max) {
+    uint16_t merges = dendrogram->num_nodes;
+    if(merges < 2) return 1;
+    if(k_max > merges) k_max = merges;
     
-    // This is a placeholder for full hierarchical clustering
-    // Full implementation would require O(n^2) distance matrix and
-    // iterative merging of closest clusters
+    // Cutting below merge m leaves (merges - m + 1) clusters
+    uint8_t best_k = 1;
+    fixed_t best_gap = 0;
+    for(uint8_t k = 2; k <= k_max; k++) {
+        uint16_t m = merges - k + 1;
+        fixed_t gap = dendrogram->nodes[m].distance - dendrogram->nodes[m - 1].distance;
+        if(gap > best_gap) {
+            best_gap = gap;
+            best_k = k;
+        }
+    }
     
-    FURI_LOG_I(TAG, "Hierarchical clustering not fully implemented");
-    UNUSED(data);
-    UNUSED(metric);
+    return best_k;
+}
+
+// ============================================================================
+// DYNAMIC TIME WARPING
+// L1 cost, Sakoe-Chiba band |i - j| <= band. Two rolling rows of 2*band+1
+// cells replace the full cost matrix, and rows are abandoned as soon as
+// every cell exceeds the caller's best-so-far.
+// ============================================================================
+
+#define DTW_ROW_CELLS   (2 * DTW_MAX_BAND + 1)
+#define DTW_INF_COST    INT64_MAX
+
+// Clamp an accumulated cost into fixed_t
+static inline fixed_t dtw_cost_to_fixed(int64_t cost) {
+    return (cost >= FIXED_MAX) ? DTW_INFINITY : (fixed_t)cost;
+}
+
+// Banded DTW core; path_length receives the steps of the optimal path
+static fixed_t dtw_banded(const fixed_t* seq1, uint16_t len1,
+                          const fixed_t* seq2, uint16_t len2,
+                          uint16_t band, fixed_t best_so_far, uint16_t* path_length) {
+    if(len1 == 0 || len2 == 0) return DTW_INFINITY;
+    if(band > DTW_MAX_BAND) band = DTW_MAX_BAND;
+    
+    uint16_t length_diff = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if(length_diff > band) return DTW_INFINITY;   // No path fits in the band
+    
+    // Cell k of row i holds column j = i - band + k
+    int64_t rows[2][DTW_ROW_CELLS];
+    uint16_t steps[2][DTW_ROW_CELLS];
+    int64_t* prev = rows[0];
+    int64_t* curr = rows[1];
+    uint16_t* prev_steps = steps[0];
+    uint16_t* curr_steps = steps[1];
+    
+    for(uint16_t k = 0; k < DTW_ROW_CELLS; k++) {
+        prev[k] = DTW_INF_COST;
+        prev_steps[k] = 0;
+    }
+    
+    for(uint16_t i = 0; i < len1; i++) {
+        int32_t j_lo = (int32_t)i - band;
+        int32_t j_hi = (int32_t)i + band;
+        int64_t row_min = DTW_INF_COST;
+        
+        for(uint16_t k = 0; k < DTW_ROW_CELLS; k++) {
+            int32_t j = j_lo + k;
+            curr[k] = DTW_INF_COST;
+            curr_steps[k] = 0;
+            if(j < 0 || j >= len2 || j > j_hi) continue;
+            
+            int64_t cost = fixed_abs(seq1[i] - seq2[j]);
+            int64_t best = DTW_INF_COST;
+            uint16_t best_steps = 0;
+            
+            if(i == 0 && j == 0) {
+                best = 0;
+            } else {
+                // (i-1, j) sits one cell right in the previous row
+                if(k + 1 < DTW_ROW_CELLS && prev[k + 1] < best) {
+                    best = prev[k + 1];
+                    best_steps = prev_steps[k + 1];
+                }
+                // (i-1, j-1) is the same cell index
+                if(prev[k] < best) {
+                    best = prev[k];
+                    best_steps = prev_steps[k];
+                }
+                // (i, j-1)
+                if(k > 0 && curr[k - 1] < best) {
+                    best = curr[k - 1];
+                    best_steps = curr_steps[k - 1];
+                }
+            }
+            if(best == DTW_INF_COST) continue;
+            
+            curr[k] = best + cost;
+            curr_steps[k] = best_steps + 1;
+            if(curr[k] < row_min) row_min = curr[k];
+        }
+        
+        // Early abandon: the cost along any path only grows
+        if(row_min >= best_so_far) return DTW_INFINITY;
+        
+        int64_t* swap = prev;
+        prev = curr;
+        curr = swap;
+        uint16_t* swap_steps = prev_steps;
+        prev_steps = curr_steps;
+        curr_steps = swap_steps;
+    }
     
-    return dendrogram;
+    // Final cell (len1-1, len2-1)
+    uint16_t k_end = (uint16_t)((int32_t)(len2 - 1) - ((int32_t)(len1 - 1) - band));
+    if(prev[k_end] >= best_so_far) return DTW_INFINITY;   // No better than the caller's best
+    if(path_length) *path_length = prev_steps[k_end];
+    return dtw_cost_to_fixed(prev[k_end]);
 }
 
-// Dynamic Time Warping (simplified)
+// Dynamic Time Warping between two sequences
 DTWResult_t clustering_dtw(const fixed_t* seq1, uint16_t len1,
                           const fixed_t* seq2, uint16_t len2) {
     DTWResult_t result;
@@ -416,22 +1126,25 @@ DTWResult_t clustering_dtw(const fixed_t* seq1, uint16_t len1,
     if(len1 > DTW_MAX_LENGTH) len1 = DTW_MAX_LENGTH;
     if(len2 > DTW_MAX_LENGTH) len2 = DTW_MAX_LENGTH;
     
-    // DTW distance matrix (would use dynamic programming)
-    // This is a simplified placeholder
-    fixed_t total_dist = 0;
-    uint16_t min_len = (len1 < len2) ? len1 : len2;
-    
-    for(uint16_t i = 0; i < min_len; i++) {
-        fixed_t diff = seq1[i] - seq2[i];
-        total_dist += fixed_abs(diff);
-    }
-    
-    result.total_distance = total_dist / min_len;
-    result.path_length = min_len;
+    // Widen the band so sequences of different length still align
+    uint16_t band = (len1 > len2) ? len1 - len2 : len2 - len1;
+    if(band < DTW_DEFAULT_BAND) band = DTW_DEFAULT_BAND;
     
+    result.total_distance = dtw_banded(seq1, len1, seq2, len2, band, DTW_INFINITY,
+                                       &result.path_length);
     return result;
 }
 
+// Banded DTW distance, DTW_INFINITY once it exceeds best_so_far
+fixed_t clustering_dtw_banded(const fixed_t* seq1, uint16_t len1,
+                              const fixed_t* seq2, uint16_t len2,
+                              uint16_t band, fixed_t best_so_far) {
+    if(len1 > DTW_MAX_LENGTH) len1 = DTW_MAX_LENGTH;
+    if(len2 > DTW_MAX_LENGTH) len2 = DTW_MAX_LENGTH;
+    
+    return dtw_banded(seq1, len1, seq2, len2, band, best_so_far, NULL);
+}
+
 // DTW distance for pulse sequences
 fixed_t clustering_dtw_distance(const Pulse_t* pulses1, uint16_t count1,
                                  const Pulse_t* pulses2, uint16_t count2) {
@@ -454,6 +1167,99 @@ fixed_t clustering_dtw_distance(const Pulse_t* pulses1, uint16_t count1,
     return result.total_distance;
 }
 
+// Prepare a template: copy the sequence and build its LB_Keogh envelope
+void clustering_dtw_template_init(DTWTemplate_t* tmpl, const fixed_t* seq,
+                                  uint16_t length, uint16_t band) {
+    if(length > DTW_MAX_LENGTH) length = DTW_MAX_LENGTH;
+    if(band > DTW_MAX_BAND) band = DTW_MAX_BAND;
+    
+    memcpy(tmpl->seq, seq, length * sizeof(fixed_t));
+    tmpl->length = length;
+    tmpl->band = band;
+    
+    // Envelope at query index i covers template columns [i - band, i + band]
+    for(uint16_t i = 0; i < DTW_MAX_LENGTH; i++) {
+        int32_t lo = (int32_t)i - band;
+        int32_t hi = (int32_t)i + band;
+        if(lo < 0) lo = 0;
+        if(hi >= length) hi = length - 1;
+        
+        fixed_t upper = FIXED_MIN;
+        fixed_t lower = FIXED_MAX;
+        for(int32_t j = lo; j <= hi; j++) {
+            if(seq[j] > upper) upper = seq[j];
+            if(seq[j] < lower) lower = seq[j];
+        }
+        
+        // Query indices no path can reach: an empty envelope never prunes
+        if(lo > hi) {
+            upper = FIXED_MAX;
+            lower = FIXED_MIN;
+        }
+        tmpl->upper[i] = upper;
+        tmpl->lower[i] = lower;
+    }
+}
+
+// LB_Keogh: L1 distance from the query to the template envelope. Every cell on
+// a warping path is at least this far, so the bound never exceeds the DTW cost.
+fixed_t clustering_dtw_lb_keogh(const DTWTemplate_t* tmpl, const fixed_t* query,
+                                uint16_t length, fixed_t best_so_far) {
+    if(length > DTW_MAX_LENGTH) length = DTW_MAX_LENGTH;
+    
+    int64_t bound = 0;
+    for(uint16_t i = 0; i < length; i++) {
+        if(query[i] > tmpl->upper[i]) {
+            bound += (int64_t)query[i] - tmpl->upper[i];
+        } else if(query[i] < tmpl->lower[i]) {
+            bound += (int64_t)tmpl->lower[i] - query[i];
+        }
+        if(bound >= best_so_far) return DTW_INFINITY;
+    }
+    
+    return dtw_cost_to_fixed(bound);
+}
+
+// Closest template to the query: LB_Keogh first, banded DTW only for survivors
+uint16_t clustering_dtw_match(const DTWTemplate_t* templates, uint16_t count,
+                              const fixed_t* query, uint16_t length,
+                              fixed_t* best_distance, DTWMatchStats_t* stats) {
+    uint16_t best_index = DTW_NO_MATCH;
+    fixed_t best = DTW_INFINITY;
+    
+    if(length > DTW_MAX_LENGTH) length = DTW_MAX_LENGTH;
+    
+    for(uint16_t t = 0; t < count; t++) {
+        const DTWTemplate_t* tmpl = &templates[t];
+        if(stats) stats->candidates++;
+        
+        uint16_t length_diff = (length > tmpl->length) ? length - tmpl->length
+                                                       : tmpl->length - length;
+        if(length_diff > tmpl->band) {
+            if(stats) stats->length_rejected++;
+            continue;
+        }
+        
+        if(clustering_dtw_lb_keogh(tmpl, query, length, best) == DTW_INFINITY) {
+            if(stats) stats->lb_pruned++;
+            continue;
+        }
+        
+        fixed_t dist = dtw_banded(query, length, tmpl->seq, tmpl->length, tmpl->band, best, NULL);
+        if(dist == DTW_INFINITY) {
+            if(stats) stats->abandoned++;
+            continue;
+        }
+        
+        if(stats) stats->full_evaluations++;
+        best = dist;
+        best_index = t;
+    }
+    
+    if(best_distance) *best_distance = best;
+    return best_index;
+}
+
 // Save clusters to file
 bool clustering_save_clusters(const KMeansResult_t* clusters, const char* filename) {
     // Would implement file serialization
@@ -2,6 +2,8 @@
 #define CLUSTERING_H
 
 #include "../core/flipper_rf_lab.h"
+#include "../core/session_store.h"
+#include "../core/math/fixed_point.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -15,7 +17,20 @@ extern "C" {
 #define KMEANS_MAX_K            5       // Maximum clusters
 #define KMEANS_MAX_ITERATIONS   100     // Max iterations before forced convergence
 #define KMEANS_CONVERGENCE      5       // Stop when movement < 0.5% (in fixed-point)
+#define KMEANS_MOVE_THRESHOLD   (FIXED_ONE / 200)   // Total centroid movement for convergence
+#define KMEANS_SEED             0x9E3779B9U         // k-means++ sampling seed (deterministic)
+#define KMEANS_BOUNDS_CAPACITY  CLUSTERING_STREAM_CAPACITY  // Points with Hamerly bounds
+#define KMEANS_MINIBATCH_SIZE   128     // Samples per mini-batch step
+#define KMEANS_MINIBATCH_ITERATIONS 50  // Mini-batch steps for datasets above the bound capacity
+#define KMEANS_SILHOUETTE_EXACT_MAX 256 // Larger sets score with the centroid silhouette
 #define DTW_MAX_LENGTH          128     // Max sequence length for DTW
+#define DTW_MAX_BAND            32      // Widest Sakoe-Chiba band (row buffers are 2*band+1)
+#define DTW_DEFAULT_BAND        8       // Band used by clustering_dtw for equal-length input
+#define DTW_INFINITY            FIXED_MAX   // Abandoned or unreachable alignment
+#define DTW_NO_MATCH            0xFFFF
+#define CLUSTERING_STREAM_CAPACITY  (MAX_PULSE_COUNT / 2)   // One point per mark/space pair
+#define HIERARCHICAL_MAX_POINTS 128     // Packed 16-bit matrix shares K-means scratch RAM
+#define HIERARCHICAL_MATRIX_SIZE    (HIERARCHICAL_MAX_POINTS * (HIERARCHICAL_MAX_POINTS - 1) / 2)
 
 // Distance metric types
 typedef enum {
@@ -25,6 +40,13 @@ typedef enum {
     DISTANCE_DTW
 } DistanceMetric_t;
 
+// Linkage criteria (all reducible, as the nearest-neighbor chain requires)
+typedef enum {
+    LINKAGE_SINGLE = 0,
+    LINKAGE_COMPLETE,
+    LINKAGE_AVERAGE
+} HierarchicalLinkage_t;
+
 // Cluster quality metrics
 typedef enum {
     QUALITY_SILHOUETTE = 0,
@@ -43,9 +65,11 @@ typedef struct {
     uint8_t frame_id;       // Source frame reference
 } DataPoint_t;
 
+// Feature points over caller-provided storage (see clustering_dataset_init)
 typedef struct {
-    DataPoint_t points[MAX_PULSE_COUNT];
+    DataPoint_t* points;
     uint16_t count;
+    uint16_t capacity;
     uint8_t num_features;
 } Dataset_t;
 
@@ -63,6 +87,7 @@ typedef struct {
     bool converged;         // Convergence flag
     fixed_t total_inertia;  // Total within-cluster sum of squares
     fixed_t silhouette_score; // Cluster quality score
+    uint32_t distance_evals;  // Point-centroid distances computed
 } KMeansResult_t;
 
 // ============================================================================
@@ -76,22 +101,51 @@ typedef struct {
     uint16_t num_points;    // Points in this cluster
 } DendrogramNode_t;
 
+// Merges in increasing distance order. Child ids below num_points are
+// leaves; id num_points + i refers to nodes[i]. When the dataset had more
+// than HIERARCHICAL_MAX_POINTS points the leaves are an even sample of it
+// (source_points > num_points).
 typedef struct {
-    DendrogramNode_t nodes[MAX_PULSE_COUNT * 2];
+    DendrogramNode_t nodes[HIERARCHICAL_MAX_POINTS - 1];
     uint16_t num_nodes;
     uint16_t root_index;
+    uint16_t num_points;    // Leaves
+    uint16_t source_points; // Dataset points the leaves were taken from
 } Dendrogram_t;
 
+// Dataset index of a leaf (identity unless the dataset was subsampled)
+static inline uint16_t clustering_hierarchical_leaf_point(const Dendrogram_t* dendrogram,
+                                                          uint16_t leaf) {
+    if(dendrogram->num_points == 0) return leaf;
+    return (uint16_t)((uint32_t)leaf * dendrogram->source_points / dendrogram->num_points);
+}
+
 // ============================================================================
 // DYNAMIC TIME WARPING
 // ============================================================================
 
 typedef struct {
-    uint16_t path[DTW_MAX_LENGTH][2];   // Warping path coordinates
-    uint16_t path_length;
-    fixed_t total_distance;
+    uint16_t path_length;       // Steps on the optimal warping path
+    fixed_t total_distance;     // Accumulated L1 cost (DTW_INFINITY if no path)
 } DTWResult_t;
 
+// Stored sequence with its precomputed LB_Keogh envelope
+typedef struct {
+    fixed_t seq[DTW_MAX_LENGTH];
+    fixed_t upper[DTW_MAX_LENGTH];  // Max of seq over [i - band, i + band]
+    fixed_t lower[DTW_MAX_LENGTH];  // Min of seq over [i - band, i + band]
+    uint16_t length;
+    uint16_t band;
+} DTWTemplate_t;
+
+typedef struct {
+    uint32_t candidates;
+    uint32_t length_rejected;       // Length difference wider than the band
+    uint32_t lb_pruned;             // Rejected by LB_Keogh
+    uint32_t abandoned;             // DTW stopped early against best-so-far
+    uint32_t full_evaluations;      // DTW ran to completion (new best)
+} DTWMatchStats_t;
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -102,6 +156,9 @@ void clustering_engine_deinit(void);
 
 // K-means clustering
 KMeansResult_t clustering_kmeans(const Dataset_t* data, uint8_t k);
+void clustering_kmeans_seed(KMeansResult_t* result, const Dataset_t* data);
+KMeansResult_t clustering_kmeans_minibatch(const Dataset_t* data, uint8_t k,
+                                           uint16_t batch_size, uint8_t iterations);
 void clustering_kmeans_iterative(KMeansResult_t* result, const Dataset_t* data);
 bool clustering_kmeans_assign_points(KMeansResult_t* result, const Dataset_t* data);
 void clustering_kmeans_update_centroids(KMeansResult_t* result, const Dataset_t* data);
@@ -109,16 +166,30 @@ bool clustering_kmeans_check_convergence(const KMeansResult_t* prev,
                                           const KMeansResult_t* current);
 
 // Hierarchical clustering
-Dendrogram_t clustering_hierarchical(const Dataset_t* data, DistanceMetric_t metric);
+bool clustering_hierarchical(const Dataset_t* data, DistanceMetric_t metric,
+                             HierarchicalLinkage_t linkage, Dendrogram_t* dendrogram);
 void clustering_hierarchical_cut(const Dendrogram_t* dendrogram, uint8_t k, 
                                   uint8_t* assignments);
+uint8_t clustering_hierarchical_suggest_k(const Dendrogram_t* dendrogram, uint8_t k_max);
 
 // Dynamic Time Warping
 DTWResult_t clustering_dtw(const fixed_t* seq1, uint16_t len1,
                           const fixed_t* seq2, uint16_t len2);
+fixed_t clustering_dtw_banded(const fixed_t* seq1, uint16_t len1,
+                              const fixed_t* seq2, uint16_t len2,
+                              uint16_t band, fixed_t best_so_far);
 fixed_t clustering_dtw_distance(const Pulse_t* pulses1, uint16_t count1,
                                  const Pulse_t* pulses2, uint16_t count2);
 
+// DTW template matching
+void clustering_dtw_template_init(DTWTemplate_t* tmpl, const fixed_t* seq,
+                                  uint16_t length, uint16_t band);
+fixed_t clustering_dtw_lb_keogh(const DTWTemplate_t* tmpl, const fixed_t* query,
+                                uint16_t length, fixed_t best_so_far);
+uint16_t clustering_dtw_match(const DTWTemplate_t* templates, uint16_t count,
+                              const fixed_t* query, uint16_t length,
+                              fixed_t* best_distance, DTWMatchStats_t* stats);
+
 // Cluster quality assessment
 fixed_t clustering_silhouette_score(const Dataset_t* data, 
                                      const KMeansResult_t* clusters);
@@ -138,8 +209,13 @@ fixed_t clustering_distance_cosine(const DataPoint_t* a, const DataPoint_t* b);
 // Feature extraction for clustering
 void clustering_extract_features(const Frame_t* frame, DataPoint_t* features, 
                                   uint16_t* count);
-void clustering_extract_pulse_features(const Pulse_t* pulses, uint16_t pulse_count,
-                                        DataPoint_t* features, uint16_t* count);
+void clustering_extract_pulse_features(const SessionPulseView_t* pulses,
+                                        DataPoint_t* features, uint16_t max_features,
+                                        uint16_t* count);
+
+// Dataset construction
+void clustering_dataset_init(Dataset_t* data, DataPoint_t* storage, uint16_t capacity);
+uint16_t clustering_dataset_from_pulses(Dataset_t* data, const SessionPulseView_t* pulses);
 
 // Visualization support (for 128x64 display)
 void clustering_get_bounds(const Dataset_t* data, fixed_t* min_x, fixed_t* max_x,
@@ -2,6 +2,7 @@
 #include "../core/math/fixed_point.h"
 #include "../core/math/statistics.h"
 #include "../storage/sd_manager.h"
+#include "../storage/fingerprint_db.h"
 #include <string.h>
 
 #define TAG "FINGERPRINT"
@@ -9,9 +10,20 @@
 // Static state
 static FingerprintCaptureState_t capture_state;
 static DeviceDatabase_t device_database;
+static FingerprintIndex_t fingerprint_index;
+static FingerprintMatchStats_t match_stats;
 static TemporalDeviceRecord_t temporal_records[MAX_DEVICE_DB_ENTRIES];
 static uint8_t num_temporal_records = 0;
+static uint32_t dirty_devices[(MAX_DEVICE_DB_ENTRIES + 31) / 32];   // match_count/last_seen not journaled yet
 static bool fingerprinting_initialized = false;
+static uint32_t stats_scratch[FINGERPRINT_STATS_SCRATCH];          // Selection buffer for exact quantiles
+
+// Sample accessor for statistics over derived (non-materialized) series
+typedef uint32_t (*FingerprintSampleFn)(const void* ctx, uint16_t i);
+static void calc_statistics_sampled(FingerprintSampleFn sample, const void* ctx,
+                                    uint16_t count, StatisticalSummary_t* result);
+static void temporal_load(const FingerprintDbTemporal_t* record, void* ctx);
+static uint32_t robust_std_dev(const StatisticalSummary_t* stats);
 
 // Weighting factors for fingerprint comparison
 static const uint8_t drift_weight = 30;      // 30% timing drift
@@ -29,13 +41,21 @@ FuriStatus fingerprinting_engine_init(void) {
     
     memset(&capture_state, 0, sizeof(capture_state));
     memset(&device_database, 0, sizeof(device_database));
+    memset(&fingerprint_index, 0, sizeof(fingerprint_index));
+    memset(&match_stats, 0, sizeof(match_stats));
     memset(temporal_records, 0, sizeof(temporal_records));
     num_temporal_records = 0;
+    memset(dirty_devices, 0, sizeof(dirty_devices));
     
     // Load device database from SD card
-    // (Would implement in full version)
-    
+    fingerprint_db_open(&device_database, temporal_load, NULL);
+    fingerprinting_rebuild_index();
     fingerprinting_initialized = true;
+    
+    if(fingerprint_db_needs_compaction()) {
+        fingerprinting_save_database();
+    }
+    
     FURI_LOG_I(TAG, "Fingerprinting engine initialized");
     
     return FuriStatusOk;
@@ -46,6 +66,7 @@ void fingerprinting_engine_deinit(void) {
     
     // Save device database
     fingerprinting_save_database();
+    fingerprint_db_close();
     
     fingerprinting_initialized = false;
 }
@@ -68,32 +89,44 @@ bool fingerprinting_is_capturing(void) {
     return (capture_state.state == FINGERPRINT_STATE_SAMPLING);
 }
 
-// Process captured frame
-void fingerprinting_process_frame(const Frame_t* frame) {
+// Interval between the i-th frame and the next one
+static uint32_t frame_interval_sample(const void* ctx, uint16_t i) {
+    const SessionFrameView_t* frames = ctx;
+    return session_frame_meta(frames, i + 1)->timestamp_us -
+           session_frame_meta(frames, i)->timestamp_us;
+}
+
+// Per-byte symbol timing of the i-th frame
+static uint32_t frame_symbol_sample(const void* ctx, uint16_t i) {
+    const SessionFrameMeta_t* meta = session_frame_meta(ctx, i);
+    return (meta->length > 0) ? meta->duration_us / meta->length : 0;
+}
+
+// Array element sampler for fingerprinting_calc_statistics
+static uint32_t array_sample(const void* ctx, uint16_t i) {
+    return ((const uint32_t*)ctx)[i];
+}
+
+// Process frames captured since the last call. The view is referenced, not
+// copied, and must start at the first frame of this capture.
+void fingerprinting_process_frames(const SessionFrameView_t* frames) {
     if(capture_state.state != FINGERPRINT_STATE_SAMPLING) return;
     
-    uint32_t now = frame->timestamp_us;
+    SessionFrameView_t view = session_frame_view_slice(frames, 0, FINGERPRINT_SAMPLE_COUNT);
     
-    // Calculate inter-frame interval
-    if(capture_state.last_frame_timestamp > 0) {
-        uint32_t interval = now - capture_state.last_frame_timestamp;
-        
-        if(capture_state.interval_count < FINGERPRINT_SAMPLE_COUNT) {
-            capture_state.inter_frame_intervals[capture_state.interval_count++] = interval;
-        }
+    // Samples taken from a closed session no longer match the arena slots
+    if(view.generation != capture_state.frames.generation) {
+        capture_state.frames_captured = 0;
+        memset(capture_state.rssi_envelope, 0, sizeof(capture_state.rssi_envelope));
     }
-    capture_state.last_frame_timestamp = now;
+    capture_state.frames = view;
     
-    // Store symbol timing (simplified - would analyze actual symbol edges)
-    if(capture_state.symbol_count < FINGERPRINT_SAMPLE_COUNT) {
-        capture_state.symbol_timings[capture_state.symbol_count++] = frame->duration_us / frame->length;
+    // Update RSSI envelope with the new frames
+    for(uint16_t i = capture_state.frames_captured; i < capture_state.frames.count; i++) {
+        const SessionFrameMeta_t* meta = session_frame_meta(&capture_state.frames, i);
+        capture_state.rssi_envelope[i % 16] = (uint8_t)(meta->rssi_dbm + 128);  // Offset to positive
     }
-    
-    // Update RSSI envelope
-    uint8_t rssi_idx = capture_state.frames_captured % 16;
-    capture_state.rssi_envelope[rssi_idx] = (uint8_t)(frame->rssi_dbm + 128);  // Offset to positive
-    
-    capture_state.frames_captured++;
+    capture_state.frames_captured = capture_state.frames.count;
     
     // Check if we have enough samples
     if(capture_state.frames_captured >= FINGERPRINT_SAMPLE_COUNT) {
@@ -102,6 +135,12 @@ void fingerprinting_process_frame(const Frame_t* frame) {
         
         FURI_LOG_I(TAG, "Fingerprint capture complete, %lu frames", capture_state.frames_captured);
     }
+    
+    // Rolled over while the slots were read: resample from the new session
+    if(session_frame_view_stale(&capture_state.frames)) {
+        capture_state.state = FINGERPRINT_STATE_SAMPLING;
+        capture_state.frames_captured = 0;
+    }
 }
 
 // Process RSSI sample for slope analysis
@@ -120,15 +159,18 @@ void fingerprinting_process_rssi_sample(uint8_t rssi, uint32_t timestamp_us) {
 
 // Analyze timing drift
 void fingerprinting_analyze_timing_drift(void) {
-    if(capture_state.interval_count < 10) return;
+    if(capture_state.frames.count < 11) return;
     
     StatisticalSummary_t stats;
-    fingerprinting_calc_statistics(capture_state.inter_frame_intervals,
-                                  capture_state.interval_count,
-                                  &stats);
+    calc_statistics_sampled(frame_interval_sample, &capture_state.frames,
+                            capture_state.frames.count - 1, &stats);
     
-    capture_state.current_fingerprint.drift_mean = stats.mean;
-    capture_state.current_fingerprint.drift_variance = stats.variance;
+    // A missed frame doubles one interval; the median and quartile spread
+    // ignore it where the mean and variance would not
+    uint64_t spread = robust_std_dev(&stats);
+    spread *= spread;
+    capture_state.current_fingerprint.drift_mean = stats.median;
+    capture_state.current_fingerprint.drift_variance = (spread > UINT32_MAX) ? UINT32_MAX : (uint32_t)spread;
 }
 
 // Analyze rise/fall slopes from RSSI samples
@@ -166,17 +208,16 @@ void fingerprinting_analyze_rise_fall_slopes(void) {
 
 // Analyze clock stability
 void fingerprinting_analyze_clock_stability(void) {
-    if(capture_state.symbol_count < 10) return;
+    if(capture_state.frames.count < 10) return;
     
     StatisticalSummary_t stats;
-    fingerprinting_calc_statistics(capture_state.symbol_timings,
-                                  capture_state.symbol_count,
-                                  &stats);
+    calc_statistics_sampled(frame_symbol_sample, &capture_state.frames,
+                            capture_state.frames.count, &stats);
     
     // Calculate PPM deviation
-    // ppm = (std_dev / mean) * 1,000,000
-    if(stats.mean > 0) {
-        uint32_t ppm = (stats.std_dev * 1000000) / stats.mean;
+    // ppm = (robust std_dev / median) * 1,000,000
+    if(stats.median > 0) {
+        uint64_t ppm = (uint64_t)robust_std_dev(&stats) * 1000000 / stats.median;
         if(ppm > 255) ppm = 255;  // Clamp to uint8_t
         capture_state.current_fingerprint.clock_stability_ppm = (uint8_t)ppm;
     }
@@ -227,52 +268,260 @@ uint16_t fingerprinting_calculate_hash(const RFFingerprint_t* fingerprint) {
     return crc;
 }
 
-// Match fingerprint against database
-uint8_t fingerprinting_match_device(const RFFingerprint_t* fingerprint,
-                                    uint16_t* matched_device_id,
-                                    RFFingerprint_t* matched_fingerprint) {
-    uint8_t best_confidence = 0;
-    uint16_t best_match = 0;
+// ============================================================================
+// MATCHING INDEX
+// Database features in struct-of-arrays form, kept sorted by drift_mean.
+// The drift term alone is a lower bound on the weighted distance, so a search
+// walks outward from the query's drift and stops once that bound reaches the
+// best distance found; candidates are further prefiltered on clock ppm and
+// every distance is abandoned as soon as its partial sum exceeds the best.
+// ============================================================================
+
+// Weighted distance at or above which similarity drops below FINGERPRINT_CONFIDENCE_LOW
+#define FINGERPRINT_MATCH_MAX_DISTANCE \
+    ((uint32_t)(100 - FINGERPRINT_CONFIDENCE_LOW + 1) * FINGERPRINT_MAX_DISTANCE / 100)
+
+// Convert a weighted distance to 0-100% similarity (inverse relationship)
+static inline uint8_t distance_to_confidence(uint32_t distance) {
+    if(distance >= FINGERPRINT_MAX_DISTANCE) return 0;
+    return (uint8_t)(100 - (distance * 100 / FINGERPRINT_MAX_DISTANCE));
+}
+
+static inline uint32_t abs_diff(uint32_t a, uint32_t b) {
+    return (a > b) ? a - b : b - a;
+}
+
+// First index position with drift_mean >= key
+static uint16_t index_lower_bound(uint32_t key) {
+    uint16_t lo = 0, hi = fingerprint_index.count;
+    while(lo < hi) {
+        uint16_t mid = (lo + hi) / 2;
+        if(fingerprint_index.drift_mean[mid] < key) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// Write fingerprint features to index position pos
+static void index_store(uint16_t pos, const RFFingerprint_t* fingerprint, uint16_t device_id) {
+    fingerprint_index.drift_mean[pos] = fingerprint->drift_mean;
+    fingerprint_index.drift_variance[pos] = fingerprint->drift_variance;
+    fingerprint_index.rise_time[pos] = fingerprint->rise_time_avg;
+    fingerprint_index.fall_time[pos] = fingerprint->fall_time_avg;
+    fingerprint_index.clock_ppm[pos] = fingerprint->clock_stability_ppm;
+    memcpy(fingerprint_index.rssi[pos], fingerprint->rssi_signature, 16);
+    fingerprint_index.device_id[pos] = device_id;
+}
+
+// Move index entries [from, count) by one slot (+1 opens a gap, -1 closes it)
+static void index_shift(uint16_t from, int8_t dir) {
+    uint16_t n = fingerprint_index.count - from;
+    uint16_t to = from + dir;
     
+    memmove(&fingerprint_index.drift_mean[to], &fingerprint_index.drift_mean[from], n * sizeof(uint32_t));
+    memmove(&fingerprint_index.drift_variance[to], &fingerprint_index.drift_variance[from], n * sizeof(uint32_t));
+    memmove(&fingerprint_index.rise_time[to], &fingerprint_index.rise_time[from], n * sizeof(uint16_t));
+    memmove(&fingerprint_index.fall_time[to], &fingerprint_index.fall_time[from], n * sizeof(uint16_t));
+    memmove(&fingerprint_index.clock_ppm[to], &fingerprint_index.clock_ppm[from], n);
+    memmove(fingerprint_index.rssi[to], fingerprint_index.rssi[from], n * 16);
+    memmove(&fingerprint_index.device_id[to], &fingerprint_index.device_id[from], n * sizeof(uint16_t));
+}
+
+// Add a database entry to the index
+static void index_insert(const RFFingerprint_t* fingerprint, uint16_t device_id) {
+    if(fingerprint_index.count >= MAX_DEVICE_DB_ENTRIES) return;
+    
+    uint16_t pos = index_lower_bound(fingerprint->drift_mean);
+    index_shift(pos, 1);
+    index_store(pos, fingerprint, device_id);
+    fingerprint_index.count++;
+}
+
+// Drop a database entry; later database slots shift down by one
+static void index_remove(uint16_t device_id) {
+    for(uint16_t i = 0; i < fingerprint_index.count; i++) {
+        if(fingerprint_index.device_id[i] == device_id) {
+            index_shift(i + 1, -1);
+            fingerprint_index.count--;
+            break;
+        }
+    }
+    
+    for(uint16_t i = 0; i < fingerprint_index.count; i++) {
+        if(fingerprint_index.device_id[i] > device_id) fingerprint_index.device_id[i]--;
+    }
+}
+
+// Rebuild the index from the database
+void fingerprinting_rebuild_index(void) {
+    fingerprint_index.count = 0;
     for(uint16_t i = 0; i < device_database.count; i++) {
-        uint8_t confidence = fingerprinting_calculate_similarity(
-            fingerprint, &device_database.fingerprints[i]);
+        index_insert(&device_database.fingerprints[i], i);
+    }
+}
+
+// Weighted distance to index entry pos, abandoned (returns limit) once the
+// partial sum reaches limit. Terms match fingerprinting_weighted_distance.
+static uint32_t index_distance(const RFFingerprint_t* q, uint16_t pos, uint32_t limit) {
+    uint32_t drift_dist = abs_diff(q->drift_mean, fingerprint_index.drift_mean[pos]);
+    drift_dist += abs_diff(q->drift_variance, fingerprint_index.drift_variance[pos]) / 10;
+    uint32_t distance = (drift_dist * drift_weight) / 100;
+    
+    uint32_t clock_dist = abs_diff(q->clock_stability_ppm, fingerprint_index.clock_ppm[pos]);
+    distance += (clock_dist * clock_weight) / 100;
+    if(distance >= limit) return limit;
+    
+    uint32_t slope_dist = abs_diff(q->rise_time_avg, fingerprint_index.rise_time[pos]);
+    slope_dist += abs_diff(q->fall_time_avg, fingerprint_index.fall_time[pos]);
+    distance += (slope_dist * slope_weight) / 100;
+    if(distance >= limit) return limit;
+    
+    const uint8_t* rssi = fingerprint_index.rssi[pos];
+    uint32_t rssi_dist = 0;
+    for(uint8_t i = 0; i < 16; i += 4) {
+        rssi_dist += abs_diff(q->rssi_signature[i], rssi[i]);
+        rssi_dist += abs_diff(q->rssi_signature[i + 1], rssi[i + 1]);
+        rssi_dist += abs_diff(q->rssi_signature[i + 2], rssi[i + 2]);
+        rssi_dist += abs_diff(q->rssi_signature[i + 3], rssi[i + 3]);
+        if(distance + (rssi_dist * rssi_weight) / 100 >= limit) return limit;
+    }
+    
+    return distance + (rssi_dist * rssi_weight) / 100;
+}
+
+// Nearest database entry to q, searching outward from index position start
+static void index_search(const RFFingerprint_t* q, uint16_t start, FingerprintMatch_t* match) {
+    uint32_t best = FINGERPRINT_MATCH_MAX_DISTANCE;
+    uint16_t best_pos = FINGERPRINT_NO_MATCH;
+    int32_t lo = (int32_t)start - 1;
+    uint16_t hi = start;
+    
+    match_stats.queries++;
+    
+    while(lo >= 0 || hi < fingerprint_index.count) {
+        // Visit the side whose drift is closer to the query
+        uint32_t lo_gap = (lo >= 0) ? q->drift_mean - fingerprint_index.drift_mean[lo] : UINT32_MAX;
+        uint32_t hi_gap = (hi < fingerprint_index.count) ?
+                          fingerprint_index.drift_mean[hi] - q->drift_mean : UINT32_MAX;
+        bool take_lo = lo_gap <= hi_gap;
+        uint16_t pos = take_lo ? (uint16_t)lo : hi;
+        uint32_t gap = take_lo ? lo_gap : hi_gap;
+        
+        // Drift bound is monotone along each side: nothing further can win
+        uint32_t bound = (gap * drift_weight) / 100;
+        if(bound >= best) break;
+        
+        if(take_lo) lo--;
+        else hi++;
+        match_stats.candidates++;
+        
+        bound += (abs_diff(q->clock_stability_ppm, fingerprint_index.clock_ppm[pos]) *
+                  clock_weight) / 100;
+        if(bound >= best) {
+            match_stats.prefiltered++;
+            continue;
+        }
+        
+        uint32_t distance = index_distance(q, pos, best);
+        if(distance >= best) {
+            match_stats.abandoned++;
+            continue;
+        }
+        
+        match_stats.full_distances++;
+        best = distance;
+        best_pos = pos;
+        if(distance == 0) break;    // Identical features (same unique_hash)
+    }
+    
+    if(best_pos == FINGERPRINT_NO_MATCH) {
+        match->device_id = FINGERPRINT_NO_MATCH;
+        match->distance = FINGERPRINT_MAX_DISTANCE;
+        match->confidence = 0;
+    } else {
+        match->device_id = fingerprint_index.device_id[best_pos];
+        match->distance = best;
+        match->confidence = distance_to_confidence(best);
+    }
+}
+
+// Count a match; the change is journaled on the next flush
+static void record_match(uint16_t device_id, const RFFingerprint_t* fingerprint) {
+    device_database.match_count[device_id]++;
+    device_database.last_seen[device_id] = furi_get_tick();
+    dirty_devices[device_id / 32] |= 1UL << (device_id % 32);
+    
+    fingerprinting_update_temporal_record(device_id, fingerprint);
+}
+
+// Match several fingerprints in one sweep. Queries are visited in drift order so
+// each search starts from the previous position instead of a fresh binary search.
+uint16_t fingerprinting_match_batch(const RFFingerprint_t* fingerprints, uint16_t count,
+                                    FingerprintMatch_t* results) {
+    uint8_t order[FINGERPRINT_BATCH_MAX];
+    uint16_t matched = 0;
+    
+    if(count > FINGERPRINT_BATCH_MAX) count = FINGERPRINT_BATCH_MAX;
+    
+    for(uint8_t i = 0; i < count; i++) {
+        uint8_t j = i;
+        while(j > 0 && fingerprints[order[j - 1]].drift_mean > fingerprints[i].drift_mean) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+    
+    uint16_t cursor = 0;
+    for(uint8_t i = 0; i < count; i++) {
+        const RFFingerprint_t* q = &fingerprints[order[i]];
+        while(cursor < fingerprint_index.count && fingerprint_index.drift_mean[cursor] < q->drift_mean) {
+            cursor++;
+        }
         
-        if(confidence > best_confidence) {
-            best_confidence = confidence;
-            best_match = i;
+        FingerprintMatch_t* match = &results[order[i]];
+        index_search(q, cursor, match);
+        
+        if(match->device_id != FINGERPRINT_NO_MATCH) {
+            record_match(match->device_id, q);
+            matched++;
         }
     }
     
-    if(best_confidence >= FINGERPRINT_CONFIDENCE_LOW) {
-        *matched_device_id = best_match;
+    return matched;
+}
+
+// Index search counters
+FingerprintMatchStats_t fingerprinting_get_match_stats(void) {
+    return match_stats;
+}
+
+// Match fingerprint against database (indexed, see MATCHING INDEX)
+uint8_t fingerprinting_match_device(const RFFingerprint_t* fingerprint,
+                                    uint16_t* matched_device_id,
+                                    RFFingerprint_t* matched_fingerprint) {
+    FingerprintMatch_t match;
+    index_search(fingerprint, index_lower_bound(fingerprint->drift_mean), &match);
+    
+    if(match.device_id != FINGERPRINT_NO_MATCH) {
+        *matched_device_id = match.device_id;
         if(matched_fingerprint) {
             memcpy(matched_fingerprint, 
-                   &device_database.fingerprints[best_match],
+                   &device_database.fingerprints[match.device_id],
                    sizeof(RFFingerprint_t));
         }
         
-        // Update temporal record
-        fingerprinting_update_temporal_record(best_match, fingerprint);
+        // Update match counters and temporal record
+        record_match(match.device_id, fingerprint);
     }
     
-    return best_confidence;
+    return match.confidence;
 }
 
 // Calculate similarity between two fingerprints (0-100%)
 uint8_t fingerprinting_calculate_similarity(const RFFingerprint_t* a,
                                           const RFFingerprint_t* b) {
-    // Calculate weighted distance
-    uint32_t distance = fingerprinting_weighted_distance(a, b);
-    
-    // Convert distance to confidence (inverse relationship)
-    // Max expected distance is roughly 10000 for completely different devices
-    uint32_t max_distance = 10000;
-    
-    if(distance >= max_distance) return 0;
-    
-    uint8_t confidence = (uint8_t)(100 - (distance * 100 / max_distance));
-    return confidence;
+    return distance_to_confidence(fingerprinting_weighted_distance(a, b));
 }
 
 // Calculate Euclidean distance
@@ -379,11 +628,13 @@ bool fingerprinting_add_to_database(const RFFingerprint_t* fingerprint,
     device_database.match_count[idx] = 1;
     
     device_database.count++;
+    index_insert(fingerprint, idx);
     
     FURI_LOG_I(TAG, "Added device %d: %s", idx, device_name);
     
-    // Save to SD card
-    sd_manager_export_fingerprint(fingerprint, device_name);
+    // Persist: one journal entry instead of rewriting the database
+    fingerprint_db_journal(FP_JOURNAL_ADD, &device_database, idx);
+    fingerprint_db_sync();
     
     return true;
 }
@@ -392,16 +643,24 @@ bool fingerprinting_add_to_database(const RFFingerprint_t* fingerprint,
 bool fingerprinting_remove_from_database(uint16_t device_id) {
     if(device_id >= device_database.count) return false;
     
-    // Shift entries
+    // Shift entries; dirty bits are by slot and move with them, so counters
+    // not journaled yet stay attached to their device
     for(uint16_t i = device_id; i < device_database.count - 1; i++) {
         device_database.fingerprints[i] = device_database.fingerprints[i + 1];
         memcpy(device_database.device_names[i], 
                device_database.device_names[i + 1], 16);
         device_database.last_seen[i] = device_database.last_seen[i + 1];
         device_database.match_count[i] = device_database.match_count[i + 1];
+        
+        uint32_t next = (dirty_devices[(i + 1) / 32] >> ((i + 1) % 32)) & 1;
+        dirty_devices[i / 32] = (dirty_devices[i / 32] & ~(1UL << (i % 32))) | (next << (i % 32));
     }
     
     device_database.count--;
+    dirty_devices[device_database.count / 32] &= ~(1UL << (device_database.count % 32));
+    index_remove(device_id);
+    fingerprint_db_journal(FP_JOURNAL_REMOVE, &device_database, device_id);
+    fingerprint_db_sync();
     FURI_LOG_I(TAG, "Removed device %d from database", device_id);
     
     return true;
@@ -458,8 +717,8 @@ const char* fingerprinting_get_state_string(void) {
     }
 }
 
-// Calculate statistics
-void fingerprinting_calc_statistics(const uint32_t* data,
+// Calculate statistics over count samples produced by sample(ctx, i)
+static void calc_statistics_sampled(FingerprintSampleFn sample, const void* ctx,
                                     uint16_t count,
                                     StatisticalSummary_t* result) {
     if(count == 0) {
@@ -467,15 +726,31 @@ void fingerprinting_calc_statistics(const uint32_t* data,
         return;
     }
     
-    // Find min, max, and calculate sum
+    // Find min, max, and calculate sum. Quantiles are exact while the
+    // samples fit the selection buffer, P² estimates beyond that.
+    bool exact = (count <= FINGERPRINT_STATS_SCRATCH);
+    P2Quantile_t quartiles[3];
+    if(!exact) {
+        p2_quantile_init(&quartiles[0], 25);
+        p2_quantile_init(&quartiles[1], 50);
+        p2_quantile_init(&quartiles[2], 75);
+    }
+    
     uint64_t sum = 0;
-    result->min = data[0];
-    result->max = data[0];
+    result->min = sample(ctx, 0);
+    result->max = result->min;
     
     for(uint16_t i = 0; i < count; i++) {
-        sum += data[i];
-        if(data[i] < result->min) result->min = data[i];
-        if(data[i] > result->max) result->max = data[i];
+        uint32_t value = sample(ctx, i);
+        sum += value;
+        if(value < result->min) result->min = value;
+        if(value > result->max) result->max = value;
+        if(exact) {
+            stats_scratch[i] = value;
+        } else {
+            int32_t clamped = (value > INT32_MAX) ? INT32_MAX : (int32_t)value;
+            for(uint8_t q = 0; q < 3; q++) p2_quantile_add(&quartiles[q], clamped);
+        }
     }
     
     result->mean = (uint32_t)(sum / count);
@@ -483,7 +758,7 @@ void fingerprinting_calc_statistics(const uint32_t* data,
     // Calculate variance
     uint64_t variance_sum = 0;
     for(uint16_t i = 0; i < count; i++) {
-        int64_t diff = (int64_t)data[i] - (int64_t)result->mean;
+        int64_t diff = (int64_t)sample(ctx, i) - (int64_t)result->mean;
         variance_sum += diff * diff;
     }
     
@@ -502,8 +777,37 @@ void fingerprinting_calc_statistics(const uint32_t* data,
     }
     result->std_dev = std_dev;
     
-    // Calculate median (simplified - would use sorting in full version)
-    result->median = result->mean;
+    if(exact) {
+        // Median first; the quartiles then lie in the two partitions it leaves
+        result->median = stats_median_u32(stats_scratch, count);
+        uint16_t mid = count / 2;
+        uint16_t k25 = (count - 1) / 4;
+        uint16_t k75 = 3 * (count - 1) / 4;
+        result->p25 = stats_select_u32(stats_scratch, mid + 1, k25);
+        result->p75 = (k75 >= mid) ?
+            stats_select_u32(&stats_scratch[mid], count - mid, k75 - mid) :
+            stats_select_u32(stats_scratch, mid + 1, k75);
+    } else {
+        result->p25 = (uint32_t)p2_quantile_get(&quartiles[0]);
+        result->median = (uint32_t)p2_quantile_get(&quartiles[1]);
+        result->p75 = (uint32_t)p2_quantile_get(&quartiles[2]);
+    }
+}
+
+// Standard deviation estimated from the interquartile range (IQR / 1.349
+// for a normal distribution), insensitive to missed frames and bursts.
+// The three P² estimators run independently and can cross on short or
+// bursty streams, so a negative IQR counts as no spread.
+static uint32_t robust_std_dev(const StatisticalSummary_t* stats) {
+    uint32_t iqr = (stats->p75 > stats->p25) ? stats->p75 - stats->p25 : 0;
+    return (uint32_t)((uint64_t)iqr * 7413 / 10000);
+}
+
+// Calculate statistics
+void fingerprinting_calc_statistics(const uint32_t* data,
+                                    uint16_t count,
+                                    StatisticalSummary_t* result) {
+    calc_statistics_sampled(array_sample, data, count, result);
 }
 
 // Update temporal record
@@ -608,10 +912,69 @@ void fingerprinting_detect_counterfeit(const RFFingerprint_t* fingerprint,
     }
 }
 
-// Save database to SD
+// Snapshot transfer of temporal records (history is not persisted)
+static void temporal_load(const FingerprintDbTemporal_t* record, void* ctx) {
+    UNUSED(ctx);
+    
+    if(!record) {
+        memset(temporal_records, 0, sizeof(temporal_records));
+        num_temporal_records = 0;
+        return;
+    }
+    if(num_temporal_records >= MAX_DEVICE_DB_ENTRIES) return;
+    
+    TemporalDeviceRecord_t* out = &temporal_records[num_temporal_records++];
+    memset(out, 0, sizeof(TemporalDeviceRecord_t));
+    out->device_id = record->device_id;
+    out->baseline = record->baseline;
+    out->first_seen = record->first_seen;
+    out->last_seen = record->last_seen;
+    out->match_count = record->match_count;
+    out->drift_detected = record->drift_detected;
+    out->drift_magnitude = record->drift_magnitude;
+}
+
+static void temporal_save(uint16_t index, FingerprintDbTemporal_t* out, void* ctx) {
+    UNUSED(ctx);
+    
+    const TemporalDeviceRecord_t* record = &temporal_records[index];
+    out->device_id = record->device_id;
+    out->baseline = record->baseline;
+    out->first_seen = record->first_seen;
+    out->last_seen = record->last_seen;
+    out->match_count = record->match_count;
+    out->drift_detected = record->drift_detected;
+    out->drift_magnitude = record->drift_magnitude;
+}
+
+// Save database to SD (full snapshot, resets the journal)
 void fingerprinting_save_database(void) {
-    // Would implement full database serialization
+    if(!fingerprinting_initialized) return;
+    
     FURI_LOG_I(TAG, "Saving fingerprint database (%d devices)", device_database.count);
+    
+    if(fingerprint_db_compact(&device_database, num_temporal_records, temporal_save, NULL)) {
+        memset(dirty_devices, 0, sizeof(dirty_devices));
+    }
+}
+
+// Journal match counter changes since the last flush, compacting when the
+// journal has grown past its threshold
+void fingerprinting_flush_database(void) {
+    if(!fingerprinting_initialized) return;
+    
+    for(uint16_t i = 0; i < device_database.count; i++) {
+        uint32_t bit = 1UL << (i % 32);
+        if(!(dirty_devices[i / 32] & bit)) continue;
+        
+        if(!fingerprint_db_journal(FP_JOURNAL_UPDATE, &device_database, i)) break;
+        dirty_devices[i / 32] &= ~bit;
+    }
+    fingerprint_db_sync();
+    
+    if(fingerprint_db_needs_compaction()) {
+        fingerprinting_save_database();
+    }
 }
 
 // Track temporal drift
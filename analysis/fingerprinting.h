@@ -2,6 +2,7 @@
 #define FINGERPRINTING_H
 
 #include "../core/flipper_rf_lab.h"
+#include "../core/session_store.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,10 +13,11 @@ extern "C" {
 // Device-level identification via RF imperfections
 // ============================================================================
 
-#define FINGERPRINT_SAMPLE_COUNT    1000    // Frames for drift analysis
+#define FINGERPRINT_SAMPLE_COUNT    MAX_FRAME_COUNT // Frames for drift analysis (one session)
 #define RSSI_SAMPLE_RATE_HZ         100000  // 100kHz RSSI sampling
 #define SLOPE_WINDOW_US             10      // Window for rise/fall measurement
 #define MAX_SLOPE_SAMPLES           256     // Buffer for slope analysis
+#define FINGERPRINT_STATS_SCRATCH   FINGERPRINT_SAMPLE_COUNT // Exact quantiles up to this many samples
 
 // Fingerprint confidence thresholds
 #define FINGERPRINT_CONFIDENCE_HIGH     90  // 90%+ = high confidence match
@@ -23,6 +25,11 @@ extern "C" {
 #define FINGERPRINT_CONFIDENCE_LOW      50  // 50-69% = low confidence
 #define FINGERPRINT_CONFIDENCE_NONE     0   // <50% = no match
 
+// Matching index
+#define FINGERPRINT_MAX_DISTANCE    10000   // Weighted distance of completely different devices
+#define FINGERPRINT_BATCH_MAX       16      // Fingerprints per fingerprinting_match_batch call
+#define FINGERPRINT_NO_MATCH        0xFFFF
+
 // ============================================================================
 // FINGERPRINTING STATE
 // ============================================================================
@@ -36,20 +43,15 @@ typedef enum {
 } FingerprintState_t;
 
 typedef struct {
-    // Timing analysis
-    uint32_t inter_frame_intervals[FINGERPRINT_SAMPLE_COUNT];
-    uint16_t interval_count;
-    uint32_t last_frame_timestamp;
+    // Frame window in the shared session store (intervals and symbol
+    // timings are derived from frame metadata in place)
+    SessionFrameView_t frames;
     
     // RSSI slope analysis
     uint8_t rssi_samples[MAX_SLOPE_SAMPLES];
     uint16_t rssi_sample_count;
     uint32_t rssi_sample_start;
     
-    // Clock stability
-    uint32_t symbol_timings[FINGERPRINT_SAMPLE_COUNT];
-    uint16_t symbol_count;
-    
     // RSSI envelope
     uint8_t rssi_envelope[16];  // 16-point characteristic curve
     
@@ -63,6 +65,36 @@ typedef struct {
     
 } FingerprintCaptureState_t;
 
+// ============================================================================
+// MATCHING INDEX
+// ============================================================================
+
+// Database features as struct-of-arrays, sorted by drift_mean
+typedef struct {
+    uint32_t drift_mean[MAX_DEVICE_DB_ENTRIES];     // Sort key
+    uint32_t drift_variance[MAX_DEVICE_DB_ENTRIES];
+    uint16_t rise_time[MAX_DEVICE_DB_ENTRIES];
+    uint16_t fall_time[MAX_DEVICE_DB_ENTRIES];
+    uint8_t clock_ppm[MAX_DEVICE_DB_ENTRIES];
+    uint8_t rssi[MAX_DEVICE_DB_ENTRIES][16];
+    uint16_t device_id[MAX_DEVICE_DB_ENTRIES];      // Database slot
+    uint16_t count;
+} FingerprintIndex_t;
+
+typedef struct {
+    uint16_t device_id;             // FINGERPRINT_NO_MATCH below FINGERPRINT_CONFIDENCE_LOW
+    uint8_t confidence;
+    uint32_t distance;
+} FingerprintMatch_t;
+
+typedef struct {
+    uint32_t queries;
+    uint32_t candidates;            // Entries inside the drift bound
+    uint32_t prefiltered;           // Rejected on drift + clock ppm
+    uint32_t abandoned;             // Partial distance exceeded the best
+    uint32_t full_distances;        // Distance completed (new best)
+} FingerprintMatchStats_t;
+
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -77,7 +109,7 @@ void fingerprinting_stop_capture(void);
 bool fingerprinting_is_capturing(void);
 
 // Frame processing
-void fingerprinting_process_frame(const Frame_t* frame);
+void fingerprinting_process_frames(const SessionFrameView_t* frames);
 void fingerprinting_process_rssi_sample(uint8_t rssi, uint32_t timestamp_us);
 
 // Analysis functions
@@ -94,8 +126,12 @@ uint16_t fingerprinting_calculate_hash(const RFFingerprint_t* fingerprint);
 uint8_t fingerprinting_match_device(const RFFingerprint_t* fingerprint, 
                                     uint16_t* matched_device_id,
                                     RFFingerprint_t* matched_fingerprint);
+uint16_t fingerprinting_match_batch(const RFFingerprint_t* fingerprints, uint16_t count,
+                                    FingerprintMatch_t* results);
 uint8_t fingerprinting_calculate_similarity(const RFFingerprint_t* a, 
                                           const RFFingerprint_t* b);
+void fingerprinting_rebuild_index(void);
+FingerprintMatchStats_t fingerprinting_get_match_stats(void);
 
 // Database operations
 bool fingerprinting_add_to_database(const RFFingerprint_t* fingerprint, 
@@ -103,6 +139,8 @@ bool fingerprinting_add_to_database(const RFFingerprint_t* fingerprint,
 bool fingerprinting_remove_from_database(uint16_t device_id);
 const RFFingerprint_t* fingerprinting_get_database_entry(uint16_t device_id);
 uint16_t fingerprinting_get_database_count(void);
+void fingerprinting_save_database(void);
+void fingerprinting_flush_database(void);
 
 // Learning mode
 void fingerprinting_start_learning(const char* device_name);
@@ -142,6 +180,8 @@ typedef struct {
     uint32_t min;
     uint32_t max;
     uint32_t median;
+    uint32_t p25;                   // Quartiles: robust spread for drift and jitter
+    uint32_t p75;
 } StatisticalSummary_t;
 
 void fingerprinting_calc_statistics(const uint32_t* data, 
@@ -1,6 +1,8 @@
 #include "protocol_infer.h"
 #include "../core/math/statistics.h"
+#include "../core/math/dsp.h"
 #include <string.h>
+#include <math.h>
 
 #define TAG "PROTOCOL_INFER"
 
@@ -17,31 +19,30 @@ void protocol_infer_deinit(void) {
     memset(&infer_state, 0, sizeof(infer_state));
 }
 
-// Add pulse to analysis
-void protocol_infer_add_pulse(const Pulse_t* pulse) {
-    if(infer_state.pulse_count >= MAX_PULSE_COUNT) return;
-    
-    memcpy(&infer_state.pulses[infer_state.pulse_count], pulse, sizeof(Pulse_t));
-    infer_state.pulse_count++;
-    infer_state.samples_collected++;
+// Point analysis at a pulse window of the session store
+void protocol_infer_set_pulses(const SessionPulseView_t* pulses) {
+    infer_state.pulses = *pulses;
+    infer_state.pulse_count = pulses->count;
+    infer_state.samples_collected = pulses->count;
 }
 
-// Add frame to analysis
-void protocol_infer_add_frame(const Frame_t* frame) {
-    if(infer_state.frame_count >= MAX_FRAME_SAMPLES) return;
-    
-    memcpy(&infer_state.frames[infer_state.frame_count], frame, sizeof(Frame_t));
-    infer_state.frame_count++;
+// Point analysis at a frame window of the session store
+void protocol_infer_set_frames(const SessionFrameView_t* frames) {
+    infer_state.frames = session_frame_view_slice(frames, 0, MAX_FRAME_SAMPLES);
+    infer_state.frame_count = infer_state.frames.count;
 }
 
 // Reset analysis state
 void protocol_infer_reset(void) {
+    memset(&infer_state.pulses, 0, sizeof(infer_state.pulses));
+    memset(&infer_state.frames, 0, sizeof(infer_state.frames));
     infer_state.pulse_count = 0;
     infer_state.frame_count = 0;
     infer_state.cluster_count = 0;
     infer_state.samples_collected = 0;
-    memset(&infer_state.mark_histogram, 0, sizeof(TimingHistogram_t));
-    memset(&infer_state.space_histogram, 0, sizeof(TimingHistogram_t));
+    memset(&infer_state.mark_histogram, 0, sizeof(PulseTimingHistogram_t));
+    memset(&infer_state.space_histogram, 0, sizeof(PulseTimingHistogram_t));
+    memset(&infer_state.stream, 0, sizeof(ProtocolInferStream_t));
     memset(&infer_state.hypothesis, 0, sizeof(ProtocolHypothesis_t));
 }
 
@@ -90,17 +91,18 @@ void protocol_infer_build_histograms(void) {
     uint16_t min_mark = 0xFFFF, max_mark = 0;
     uint16_t min_space = 0xFFFF, max_space = 0;
     
+    const SessionPulseView_t* pulses = &infer_state.pulses;
+    
     for(uint16_t i = 0; i < infer_state.pulse_count; i++) {
-        if(infer_state.pulses[i].level == 1) {  // Mark
-            if(infer_state.pulses[i].width_us < min_mark) 
-                min_mark = infer_state.pulses[i].width_us;
-            if(infer_state.pulses[i].width_us > max_mark) 
-                max_mark = infer_state.pulses[i].width_us;
+        uint16_t word = session_pulse_word(pulses, i);
+        uint16_t width = pulse_unpack_width(word);
+        
+        if(pulse_unpack_level(word) == 1) {  // Mark
+            if(width < min_mark) min_mark = width;
+            if(width > max_mark) max_mark = width;
         } else {  // Space
-            if(infer_state.pulses[i].width_us < min_space) 
-                min_space = infer_state.pulses[i].width_us;
-            if(infer_state.pulses[i].width_us > max_space) 
-                max_space = infer_state.pulses[i].width_us;
+            if(width < min_space) min_space = width;
+            if(width > max_space) max_space = width;
         }
     }
     
@@ -124,9 +126,10 @@ void protocol_infer_build_histograms(void) {
     
     // Fill histograms
     for(uint16_t i = 0; i < infer_state.pulse_count; i++) {
-        uint16_t width = infer_state.pulses[i].width_us;
+        uint16_t word = session_pulse_word(pulses, i);
+        uint16_t width = pulse_unpack_width(word);
         
-        if(infer_state.pulses[i].level == 1) {  // Mark
+        if(pulse_unpack_level(word) == 1) {  // Mark
             uint16_t bin = (width - min_mark) / infer_state.mark_histogram.bin_width_us;
             if(bin >= infer_state.mark_histogram.num_bins) 
                 bin = infer_state.mark_histogram.num_bins - 1;
@@ -197,21 +200,21 @@ void protocol_infer_cluster_pulses(void) {
 // Detect modulation type
 void protocol_infer_detect_modulation(void) {
     infer_state.hypothesis.modulation = protocol_infer_detect_modulation_type(
-        infer_state.pulses, infer_state.pulse_count);
+        &infer_state.pulses);
     
     // Calculate confidence based on signal characteristics
     switch(infer_state.hypothesis.modulation) {
-        case MOD_OOK:
+        case INFER_MOD_OOK:
             infer_state.hypothesis.modulation_confidence = 
-                protocol_infer_check_ook(infer_state.pulses, infer_state.pulse_count) ? 90 : 50;
+                protocol_infer_check_ook(&infer_state.pulses) ? 90 : 50;
             break;
-        case MOD_FSK:
+        case INFER_MOD_FSK:
             infer_state.hypothesis.modulation_confidence = 
-                protocol_infer_check_fsk(infer_state.pulses, infer_state.pulse_count) ? 85 : 50;
+                protocol_infer_check_fsk(&infer_state.pulses) ? 85 : 50;
             break;
-        case MOD_ASK:
+        case INFER_MOD_ASK:
             infer_state.hypothesis.modulation_confidence = 
-                protocol_infer_check_ask(infer_state.pulses, infer_state.pulse_count) ? 80 : 50;
+                protocol_infer_check_ask(&infer_state.pulses) ? 80 : 50;
             break;
         default:
             infer_state.hypothesis.modulation_confidence = 30;
@@ -219,42 +222,44 @@ void protocol_infer_detect_modulation(void) {
 }
 
 // Detect modulation from pulses
-ModulationType_t protocol_infer_detect_modulation_type(const Pulse_t* pulses, 
-                                                        uint16_t count) {
-    if(count < 10) return MOD_UNKNOWN;
+InferredModulation_t protocol_infer_detect_modulation_type(const SessionPulseView_t* pulses) {
+    uint16_t count = pulses->count;
+    if(count < 10) return INFER_MOD_UNKNOWN;
     
     // Check for OOK (On-Off Keying) - presence/absence of carrier
     uint16_t zero_count = 0;
     for(uint16_t i = 0; i < count; i++) {
-        if(pulses[i].width_us > 1000) zero_count++;  // Long pulses suggest OOK
+        if(session_pulse_width(pulses, i) > 1000) zero_count++;  // Long pulses suggest OOK
     }
     
     if(zero_count > count / 3) {
-        return MOD_OOK;
+        return INFER_MOD_OOK;
     }
     
     // Check for FSK - frequency changes would be detected via RSSI or spectral analysis
     // Simplified: assume FSK if we see consistent timing patterns
     if(infer_state.cluster_count >= 2) {
-        return MOD_FSK;
+        return INFER_MOD_FSK;
     }
     
     // Default to ASK for amplitude variations
-    return MOD_ASK;
+    return INFER_MOD_ASK;
 }
 
 // Check OOK characteristics
-bool protocol_infer_check_ook(const Pulse_t* pulses, uint16_t count) {
+bool protocol_infer_check_ook(const SessionPulseView_t* pulses) {
     // OOK has long periods of no signal
     uint32_t total_space = 0, total_mark = 0;
     uint16_t space_count = 0, mark_count = 0;
+    uint16_t count = pulses->count;
     
     for(uint16_t i = 0; i < count; i++) {
-        if(pulses[i].level == 0) {
-            total_space += pulses[i].width_us;
+        uint16_t word = session_pulse_word(pulses, i);
+        if(pulse_unpack_level(word) == 0) {
+            total_space += pulse_unpack_duration(word);
             space_count++;
         } else {
-            total_mark += pulses[i].width_us;
+            total_mark += pulse_unpack_duration(word);
             mark_count++;
         }
     }
@@ -269,14 +274,16 @@ bool protocol_infer_check_ook(const Pulse_t* pulses, uint16_t count) {
 }
 
 // Check FSK characteristics
-bool protocol_infer_check_fsk(const Pulse_t* pulses, uint16_t count) {
+bool protocol_infer_check_fsk(const SessionPulseView_t* pulses) {
+    UNUSED(pulses);
     // FSK would show consistent timing with frequency changes
     // We detect this through multiple timing clusters
     return (infer_state.cluster_count >= 2);
 }
 
 // Check ASK characteristics
-bool protocol_infer_check_ask(const Pulse_t* pulses, uint16_t count) {
+bool protocol_infer_check_ask(const SessionPulseView_t* pulses) {
+    UNUSED(pulses);
     // ASK has amplitude variations but consistent timing
     // Simplified check
     return (infer_state.cluster_count == 1);
@@ -285,7 +292,7 @@ bool protocol_infer_check_ask(const Pulse_t* pulses, uint16_t count) {
 // Detect encoding type
 void protocol_infer_detect_encoding(void) {
     infer_state.hypothesis.encoding = protocol_infer_detect_encoding_type(
-        infer_state.frames, infer_state.frame_count);
+        &infer_state.frames);
     
     // Calculate confidence
     switch(infer_state.hypothesis.encoding) {
@@ -304,22 +311,21 @@ void protocol_infer_detect_encoding(void) {
 }
 
 // Detect encoding from frames
-EncodingType_t protocol_infer_detect_encoding_type(const Frame_t* frames, 
-                                                    uint16_t count) {
-    if(count < 2) return ENC_UNKNOWN;
+EncodingType_t protocol_infer_detect_encoding_type(const SessionFrameView_t* frames) {
+    if(frames->count < 2) return ENC_UNKNOWN;
     
     // Check for Manchester encoding (transition in every bit period)
-    if(protocol_infer_check_manchester(frames, count)) {
+    if(protocol_infer_check_manchester(frames)) {
         return ENC_MANCHESTER;
     }
     
     // Check for PWM (Pulse Width Modulation)
-    if(protocol_infer_check_pwm(frames, count)) {
+    if(protocol_infer_check_pwm(frames)) {
         return ENC_PWM;
     }
     
     // Check for Miller encoding
-    if(protocol_infer_check_miller(frames, count)) {
+    if(protocol_infer_check_miller(frames)) {
         return ENC_MILLER;
     }
     
@@ -328,17 +334,21 @@ EncodingType_t protocol_infer_detect_encoding_type(const Frame_t* frames,
 }
 
 // Check Manchester encoding
-bool protocol_infer_check_manchester(const Frame_t* frames, uint16_t count) {
+bool protocol_infer_check_manchester(const SessionFrameView_t* frames) {
     // Manchester has transitions in every bit cell
     // Check pulse patterns for consistent mid-bit transitions
+    UNUSED(frames);
     
     if(infer_state.pulse_count < 20) return false;
     
     uint16_t transition_count = 0;
+    uint8_t prev_level = session_pulse_level(&infer_state.pulses, 0);
     for(uint16_t i = 1; i < infer_state.pulse_count; i++) {
-        if(infer_state.pulses[i].level != infer_state.pulses[i-1].level) {
+        uint8_t level = session_pulse_level(&infer_state.pulses, i);
+        if(level != prev_level) {
             transition_count++;
         }
+        prev_level = level;
     }
     
     // Manchester should have ~50% transitions
@@ -347,18 +357,18 @@ bool protocol_infer_check_manchester(const Frame_t* frames, uint16_t count) {
 }
 
 // Check Miller encoding
-bool protocol_infer_check_miller(const Frame_t* frames, uint16_t count) {
+bool protocol_infer_check_miller(const SessionFrameView_t* frames) {
     // Miller has transitions at bit boundaries for 1s
     // Simplified check
     UNUSED(frames);
-    UNUSED(count);
     return false;  // Would need more sophisticated analysis
 }
 
 // Check PWM encoding
-bool protocol_infer_check_pwm(const Frame_t* frames, uint16_t count) {
+bool protocol_infer_check_pwm(const SessionFrameView_t* frames) {
     // PWM uses pulse width to encode data
     // Check for two distinct pulse widths
+    UNUSED(frames);
     
     if(infer_state.cluster_count < 2) return false;
     
@@ -370,6 +380,13 @@ bool protocol_infer_check_pwm(const Frame_t* frames, uint16_t count) {
     return (ratio > 1.8f && ratio < 2.2f) || (ratio > 0.45f && ratio < 0.55f);
 }
 
+// Confidence from timing consistency (low std_dev = consistent timing)
+static uint8_t timing_confidence(uint16_t mean, uint16_t std_dev) {
+    if(std_dev < mean / 10) return 90;
+    if(std_dev < mean / 5) return 70;
+    return 50;
+}
+
 // Analyze timing
 void protocol_infer_analyze_timing(void) {
     infer_state.hypothesis.baud_rate = protocol_infer_estimate_baud_rate();
@@ -379,14 +396,7 @@ void protocol_infer_analyze_timing(void) {
     uint16_t min, max, mean, std_dev;
     protocol_infer_calculate_timing_stats(&min, &max, &mean, &std_dev);
     
-    // Low std_dev indicates consistent timing
-    if(std_dev < mean / 10) {
-        infer_state.hypothesis.timing_confidence = 90;
-    } else if(std_dev < mean / 5) {
-        infer_state.hypothesis.timing_confidence = 70;
-    } else {
-        infer_state.hypothesis.timing_confidence = 50;
-    }
+    infer_state.hypothesis.timing_confidence = timing_confidence(mean, std_dev);
 }
 
 // Estimate baud rate
@@ -429,7 +439,7 @@ void protocol_infer_calculate_timing_stats(uint16_t* min, uint16_t* max,
     uint32_t sum = 0;
     
     for(uint16_t i = 0; i < infer_state.pulse_count; i++) {
-        uint16_t width = infer_state.pulses[i].width_us;
+        uint16_t width = session_pulse_width(&infer_state.pulses, i);
         if(width < *min) *min = width;
         if(width > *max) *max = width;
         sum += width;
@@ -440,7 +450,7 @@ void protocol_infer_calculate_timing_stats(uint16_t* min, uint16_t* max,
     // Calculate standard deviation
     uint32_t variance_sum = 0;
     for(uint16_t i = 0; i < infer_state.pulse_count; i++) {
-        int32_t diff = (int32_t)infer_state.pulses[i].width_us - *mean;
+        int32_t diff = (int32_t)session_pulse_width(&infer_state.pulses, i) - *mean;
         variance_sum += diff * diff;
     }
     
@@ -451,34 +461,33 @@ void protocol_infer_calculate_timing_stats(uint16_t* min, uint16_t* max,
 void protocol_infer_detect_preamble(void) {
     uint16_t preamble_len = 0;
     infer_state.hypothesis.preamble_pattern = 
-        protocol_infer_detect_preamble_pattern(infer_state.frames, 
-                                                infer_state.frame_count, 
-                                                &preamble_len);
+        protocol_infer_detect_preamble_pattern(&infer_state.frames, &preamble_len);
     infer_state.hypothesis.preamble_length_bits = preamble_len;
 }
 
 // Detect preamble from frames
-uint16_t protocol_infer_detect_preamble_pattern(const Frame_t* frames, 
+uint16_t protocol_infer_detect_preamble_pattern(const SessionFrameView_t* frames, 
                                                  uint16_t* length_bits) {
-    if(infer_state.frame_count < 2) {
+    if(frames->count < 2) {
         *length_bits = 0;
         return 0;
     }
     
     // Look for common prefix bits
-    uint8_t min_len = frames[0].length;
-    for(uint16_t i = 1; i < infer_state.frame_count; i++) {
-        if(frames[i].length < min_len) min_len = frames[i].length;
+    uint8_t min_len = session_frame_length(frames, 0);
+    for(uint16_t i = 1; i < frames->count; i++) {
+        if(session_frame_length(frames, i) < min_len) min_len = session_frame_length(frames, i);
     }
     
     // Check bits from start
+    const uint8_t* first = session_frame_payload(frames, 0);
     uint8_t preamble_bytes = 0;
     for(uint8_t byte = 0; byte < min_len; byte++) {
         bool all_same = true;
-        uint8_t first_val = frames[0].data[byte];
+        uint8_t first_val = first[byte];
         
-        for(uint16_t i = 1; i < infer_state.frame_count; i++) {
-            if(frames[i].data[byte] != first_val) {
+        for(uint16_t i = 1; i < frames->count; i++) {
+            if(session_frame_payload(frames, i)[byte] != first_val) {
                 all_same = false;
                 break;
             }
@@ -493,7 +502,7 @@ uint16_t protocol_infer_detect_preamble_pattern(const Frame_t* frames,
     
     *length_bits = preamble_bytes * 8;
     return (preamble_bytes > 0) ? 
-        ((frames[0].data[0] << 8) | (preamble_bytes > 1 ? frames[0].data[1] : 0)) : 0;
+        ((first[0] << 8) | (preamble_bytes > 1 ? first[1] : 0)) : 0;
 }
 
 // Estimate payload length
@@ -503,7 +512,7 @@ uint8_t protocol_infer_estimate_payload_length(void) {
     // Calculate average frame length minus preamble and checksum
     uint32_t total_len = 0;
     for(uint16_t i = 0; i < infer_state.frame_count; i++) {
-        total_len += infer_state.frames[i].length;
+        total_len += session_frame_length(&infer_state.frames, i);
     }
     
     uint8_t avg_len = total_len / infer_state.frame_count;
@@ -522,7 +531,7 @@ void protocol_infer_detect_checksum_type(void) {
     // Simplified: assume last 1-2 bytes are checksum
     if(infer_state.frame_count > 0) {
         infer_state.hypothesis.checksum_length_bits = 
-            (infer_state.frames[0].length > 4) ? 16 : 8;
+            (session_frame_length(&infer_state.frames, 0) > 4) ? 16 : 8;
     }
 }
 
@@ -582,8 +591,289 @@ void protocol_infer_generate_hypothesis(void) {
     }
 }
 
-// Get hypothesis
+// ============================================================================
+// STREAMING INFERENCE
+// Each pulse updates log-scaled histograms, running clusters and timing
+// moments in O(1); the hypothesis is rebuilt from those summaries on demand
+// without rescanning the pulse history.
+// ============================================================================
+
+// Log2 bin of a pulse width: exact below 16 us, then 16 sub-bins per octave
+uint16_t protocol_infer_log_bin(uint16_t width_us) {
+    if(width_us < (1U << STREAM_HIST_SUB_BITS)) return width_us;
+    
+    uint16_t exponent = 31 - __builtin_clz(width_us);
+    uint16_t mantissa = (width_us >> (exponent - STREAM_HIST_SUB_BITS)) &
+                        ((1U << STREAM_HIST_SUB_BITS) - 1);
+    return ((exponent - STREAM_HIST_SUB_BITS + 1) << STREAM_HIST_SUB_BITS) | mantissa;
+}
+
+// Representative width (bin midpoint) of a log2 bin
+uint16_t protocol_infer_log_bin_center(uint16_t bin) {
+    if(bin < (1U << STREAM_HIST_SUB_BITS)) return bin;
+    
+    uint16_t exponent = (bin >> STREAM_HIST_SUB_BITS) + STREAM_HIST_SUB_BITS - 1;
+    uint16_t mantissa = bin & ((1U << STREAM_HIST_SUB_BITS) - 1);
+    uint16_t shift = exponent - STREAM_HIST_SUB_BITS;
+    uint32_t low = ((uint32_t)((1U << STREAM_HIST_SUB_BITS) | mantissa)) << shift;
+    uint32_t center = low + ((1UL << shift) >> 1);
+    return (center > 0xFFFF) ? 0xFFFF : (uint16_t)center;
+}
+
+// Add one sample, tracking the peak; halves all bins when a bin saturates
+static void log_histogram_add(LogHistogram_t* hist, uint16_t width_us) {
+    uint16_t bin = protocol_infer_log_bin(width_us);
+    
+    if(hist->bins[bin] == 0xFFFF) {
+        hist->total = 0;
+        for(uint16_t i = 0; i < MAX_PULSE_BINS; i++) {
+            hist->bins[i] >>= 1;
+            hist->total += hist->bins[i];
+        }
+        hist->peak_count >>= 1;
+    }
+    
+    hist->bins[bin]++;
+    hist->total++;
+    
+    if(hist->bins[bin] > hist->peak_count) {
+        hist->peak_count = hist->bins[bin];
+        hist->peak_bin = bin;
+    }
+}
+
+// Leader clustering of mark widths with running-mean centers
+static void stream_cluster_add(ProtocolInferStream_t* stream, uint16_t width_us) {
+    uint32_t width_q8 = (uint32_t)width_us << 8;
+    uint8_t nearest = 0;
+    uint32_t nearest_dist = UINT32_MAX;
+    
+    for(uint8_t i = 0; i < stream->cluster_count; i++) {
+        uint32_t center = stream->center_q8[i];
+        uint32_t dist = (width_q8 > center) ? width_q8 - center : center - width_q8;
+        if(dist < nearest_dist) {
+            nearest_dist = dist;
+            nearest = i;
+        }
+    }
+    
+    bool joins = stream->cluster_count > 0 &&
+                 nearest_dist <= stream->center_q8[nearest] / STREAM_CLUSTER_TOL_DIV;
+    
+    if(!joins && stream->cluster_count < MAX_SYMBOL_TYPES) {
+        // Open a new cluster
+        uint8_t c = stream->cluster_count++;
+        stream->center_q8[c] = width_q8;
+        stream->spread_q8[c] = 0;
+        stream->clusters[c].center_us = width_us;
+        stream->clusters[c].spread_us = 0;
+        stream->clusters[c].count = 1;
+        stream->clusters[c].assigned_symbol = c;
+        return;
+    }
+    
+    // Join (or, with all slots taken, merge into) the nearest cluster
+    PulseCluster_t* cluster = &stream->clusters[nearest];
+    if(cluster->count < 0xFFFF) cluster->count++;
+    
+    uint32_t window = (cluster->count < STREAM_CLUSTER_WINDOW) ? cluster->count
+                                                                : STREAM_CLUSTER_WINDOW;
+    int32_t delta = (int32_t)(width_q8 - stream->center_q8[nearest]);
+    stream->center_q8[nearest] += delta / (int32_t)window;
+    
+    // Running mean absolute deviation as the cluster spread
+    int32_t spread_delta = (int32_t)nearest_dist - (int32_t)stream->spread_q8[nearest];
+    stream->spread_q8[nearest] += spread_delta / (int32_t)window;
+    
+    cluster->center_us = (uint16_t)(stream->center_q8[nearest] >> 8);
+    cluster->spread_us = (uint16_t)(stream->spread_q8[nearest] >> 8);
+}
+
+// Fold one pulse into the streaming summaries - O(1) except a rare rescale
+void protocol_infer_add_pulse(const Pulse_t* pulse) {
+    ProtocolInferStream_t* stream = &infer_state.stream;
+    uint16_t width = pulse->width_us;
+    
+    if(stream->pulse_count > 0 && pulse->level != stream->last_level) {
+        stream->transitions++;
+    }
+    stream->last_level = pulse->level;
+    
+    stream->pulse_count++;
+    stream->width_sum += width;
+    stream->width_sum_sq += (uint64_t)width * width;
+    if(stream->pulse_count == 1 || width < stream->min_width_us) stream->min_width_us = width;
+    if(width > stream->max_width_us) stream->max_width_us = width;
+    if(width > STREAM_OOK_LONG_US) stream->long_pulses++;
+    
+    if(pulse->level) {
+        log_histogram_add(&stream->mark, width);
+        stream->mark_total_us += width;
+        stream->mark_count++;
+        if(width >= MIN_PULSE_WIDTH_US) stream_cluster_add(stream, width);
+    } else {
+        log_histogram_add(&stream->space, width);
+        stream->space_total_us += width;
+        stream->space_count++;
+    }
+    
+    infer_state.samples_collected++;
+    stream->dirty = true;
+}
+
+// Feed the pulses of the view not yet consumed. Returns pulses added.
+uint16_t protocol_infer_stream_pulses(const SessionPulseView_t* pulses) {
+    ProtocolInferStream_t* stream = &infer_state.stream;
+    
+    protocol_infer_set_pulses(pulses);
+    infer_state.samples_collected = stream->pulse_count;
+    
+    uint16_t end = pulses->first + pulses->count;
+    uint16_t behind = end - stream->next_pulse;
+    if(!stream->started || behind > pulses->count) {
+        // First call, or the store overwrote pulses we never saw
+        stream->next_pulse = pulses->first;
+        stream->started = true;
+        behind = pulses->count;
+    }
+    
+    uint16_t offset = pulses->count - behind;
+    Pulse_t pulse = {0};
+    for(uint16_t i = offset; i < pulses->count; i++) {
+        pulse.width_us = session_pulse_width(pulses, i);
+        pulse.level = session_pulse_level(pulses, i);
+        protocol_infer_add_pulse(&pulse);
+    }
+    stream->next_pulse = end;
+    
+    return behind;
+}
+
+// Point frame-level analysis at new frames; structure is re-derived on refresh
+void protocol_infer_stream_frames(const SessionFrameView_t* frames) {
+    if(frames->count == infer_state.frame_count &&
+       frames->first == infer_state.frames.first &&
+       frames->generation == infer_state.frames.generation) {
+        return;
+    }
+    
+    protocol_infer_set_frames(frames);
+    infer_state.stream.frames_dirty = true;
+    infer_state.stream.dirty = true;
+}
+
+// Rebuild the hypothesis from the streaming summaries
+void protocol_infer_refresh_hypothesis(void) {
+    ProtocolInferStream_t* stream = &infer_state.stream;
+    ProtocolHypothesis_t* hyp = &infer_state.hypothesis;
+    
+    if(!stream->dirty) return;
+    stream->dirty = false;
+    
+    if(stream->pulse_count < 10 && infer_state.frame_count < 2) return;
+    
+    // Significant clusters (>= 5% of marks), shortest first
+    uint8_t count = 0;
+    for(uint8_t i = 0; i < stream->cluster_count; i++) {
+        if(stream->clusters[i].count * 20UL < stream->mark_count) continue;
+        
+        uint8_t pos = count++;
+        while(pos > 0 && infer_state.clusters[pos - 1].center_us > stream->clusters[i].center_us) {
+            infer_state.clusters[pos] = infer_state.clusters[pos - 1];
+            pos--;
+        }
+        infer_state.clusters[pos] = stream->clusters[i];
+    }
+    for(uint8_t i = 0; i < count; i++) {
+        infer_state.clusters[i].assigned_symbol = i;
+    }
+    infer_state.cluster_count = count;
+    
+    // Modulation: same rules as the batch checks, from running counters
+    if(stream->pulse_count >= 10) {
+        uint32_t mark_avg = stream->mark_count ? stream->mark_total_us / stream->mark_count : 0;
+        uint32_t space_avg = stream->space_count ? stream->space_total_us / stream->space_count : 0;
+        bool asymmetric = stream->mark_count && stream->space_count &&
+                          (mark_avg > space_avg * 2 || space_avg > mark_avg * 2);
+        
+        if(stream->long_pulses > stream->pulse_count / 3) {
+            hyp->modulation = INFER_MOD_OOK;
+            hyp->modulation_confidence = asymmetric ? 90 : 50;
+        } else if(count >= 2) {
+            hyp->modulation = INFER_MOD_FSK;
+            hyp->modulation_confidence = 85;
+        } else {
+            hyp->modulation = INFER_MOD_ASK;
+            hyp->modulation_confidence = (count == 1) ? 80 : 50;
+        }
+    } else {
+        hyp->modulation = INFER_MOD_UNKNOWN;
+        hyp->modulation_confidence = 30;
+    }
+    
+    // Encoding: Manchester toggles level about every other symbol
+    uint32_t toggle_pct = stream->pulse_count > 1 ?
+        stream->transitions * 100 / (stream->pulse_count - 1) : 0;
+    if(stream->pulse_count >= 20 && toggle_pct > 40 && toggle_pct < 60) {
+        hyp->encoding = ENC_MANCHESTER;
+        hyp->encoding_confidence = 85;
+    } else if(count >= 2 &&
+              infer_state.clusters[1].center_us * 10UL >= infer_state.clusters[0].center_us * 18UL &&
+              infer_state.clusters[1].center_us * 10UL <= infer_state.clusters[0].center_us * 22UL) {
+        hyp->encoding = ENC_PWM;
+        hyp->encoding_confidence = 80;
+    } else {
+        hyp->encoding = ENC_NRZ;
+        hyp->encoding_confidence = 70;
+    }
+    
+    // Timing from running moments
+    hyp->symbol_period_us = protocol_infer_estimate_symbol_period();
+    hyp->baud_rate = hyp->symbol_period_us ? 1000000 / hyp->symbol_period_us : 0;
+    if(stream->pulse_count > 0) {
+        uint64_t mean = stream->width_sum / stream->pulse_count;
+        uint64_t mean_sq = stream->width_sum_sq / stream->pulse_count;
+        uint64_t variance = (mean_sq > mean * mean) ? mean_sq - mean * mean : 0;
+        if(variance > UINT32_MAX) variance = UINT32_MAX;
+        hyp->timing_confidence = timing_confidence((uint16_t)mean, dsp_isqrt32((uint32_t)variance));
+    }
+    
+    // Frame structure only changes with new frames
+    if(stream->frames_dirty) {
+        stream->frames_dirty = false;
+        protocol_infer_detect_preamble();
+        protocol_infer_estimate_frame_structure();
+    }
+    
+    protocol_infer_generate_hypothesis();
+}
+
+// Streaming histogram (marks or spaces)
+const LogHistogram_t* protocol_infer_get_stream_histogram(bool marks) {
+    return marks ? &infer_state.stream.mark : &infer_state.stream.space;
+}
+
+// Mark cluster centers: streaming clusters if any, else the batch ones
+uint8_t protocol_infer_get_cluster_centers(uint16_t* centers, uint8_t max_centers) {
+    const PulseCluster_t* clusters = infer_state.stream.clusters;
+    uint8_t count = infer_state.stream.cluster_count;
+    if(count == 0) {
+        clusters = infer_state.clusters;
+        count = infer_state.cluster_count;
+    }
+
+    if(count > max_centers) count = max_centers;
+    for(uint8_t i = 0; i < count; i++) {
+        centers[i] = clusters[i].center_us;
+    }
+    return count;
+}
+
+// Get hypothesis, refreshing it from the streaming summaries if stale
 const ProtocolHypothesis_t* protocol_infer_get_hypothesis(void) {
+    if(infer_state.stream.dirty) {
+        protocol_infer_refresh_hypothesis();
+    }
     return &infer_state.hypothesis;
 }
 
@@ -602,14 +892,14 @@ void protocol_infer_print_hypothesis(const ProtocolHypothesis_t* hyp, char* buff
 }
 
 // Get modulation string
-const char* protocol_infer_modulation_string(ModulationType_t mod) {
+const char* protocol_infer_modulation_string(InferredModulation_t mod) {
     switch(mod) {
-        case MOD_OOK: return "OOK";
-        case MOD_ASK: return "ASK";
-        case MOD_FSK: return "FSK";
-        case MOD_GFSK: return "GFSK";
-        case MOD_MSK: return "MSK";
-        case MOD_PSK: return "PSK";
+        case INFER_MOD_OOK: return "OOK";
+        case INFER_MOD_ASK: return "ASK";
+        case INFER_MOD_FSK: return "FSK";
+        case INFER_MOD_GFSK: return "GFSK";
+        case INFER_MOD_MSK: return "MSK";
+        case INFER_MOD_PSK: return "PSK";
         default: return "Unknown";
     }
 }
@@ -635,10 +925,10 @@ void protocol_infer_quick_analyze(const Frame_t* frame,
     
     // Quick modulation guess based on frame characteristics
     if(frame->rssi_dbm < -80) {
-        quick_result->modulation = MOD_OOK;
+        quick_result->modulation = INFER_MOD_OOK;
         quick_result->modulation_confidence = 60;
     } else {
-        quick_result->modulation = MOD_ASK;
+        quick_result->modulation = INFER_MOD_ASK;
         quick_result->modulation_confidence = 50;
     }
     
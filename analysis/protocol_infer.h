@@ -2,6 +2,7 @@
 #define PROTOCOL_INFER_H
 
 #include "../core/flipper_rf_lab.h"
+#include "../core/session_store.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,16 +18,23 @@ extern "C" {
 #define MAX_FRAME_SAMPLES       100
 #define MAX_PREAMBLE_LEN        32
 
+// Streaming inference: log-scaled histograms, 16 sub-bins per octave
+// (~6% relative resolution), widths below 16 us binned exactly
+#define STREAM_HIST_SUB_BITS    4
+#define STREAM_CLUSTER_WINDOW   64      // Running-mean window for cluster centers
+#define STREAM_CLUSTER_TOL_DIV  4       // Pulse joins a cluster within center/4
+#define STREAM_OOK_LONG_US      1000    // Pulses longer than this suggest OOK gaps
+
 // Modulation types
 typedef enum {
-    MOD_UNKNOWN = 0,
-    MOD_OOK,
-    MOD_ASK,
-    MOD_FSK,
-    MOD_GFSK,
-    MOD_MSK,
-    MOD_PSK
-} ModulationType_t;
+    INFER_MOD_UNKNOWN = 0,
+    INFER_MOD_OOK,
+    INFER_MOD_ASK,
+    INFER_MOD_FSK,
+    INFER_MOD_GFSK,
+    INFER_MOD_MSK,
+    INFER_MOD_PSK
+} InferredModulation_t;
 
 // Encoding types
 typedef enum {
@@ -50,7 +58,7 @@ typedef struct {
 
 // Protocol hypothesis
 typedef struct {
-    ModulationType_t modulation;
+    InferredModulation_t modulation;
     EncodingType_t encoding;
     uint32_t baud_rate;
     uint32_t bit_rate;
@@ -96,7 +104,7 @@ typedef struct {
     uint16_t peak_bin;
     uint16_t peak_count;
     uint16_t total_samples;
-} TimingHistogram_t;
+} PulseTimingHistogram_t;
 
 // Pulse cluster
 typedef struct {
@@ -106,24 +114,68 @@ typedef struct {
     uint8_t assigned_symbol;
 } PulseCluster_t;
 
+// Fixed-resolution log2 histogram (bin layout independent of the data range)
+typedef struct {
+    uint16_t bins[MAX_PULSE_BINS];
+    uint16_t peak_bin;
+    uint16_t peak_count;
+    uint32_t total;
+} LogHistogram_t;
+
+// Running statistics updated in O(1) per pulse
+typedef struct {
+    LogHistogram_t mark;
+    LogHistogram_t space;
+    
+    // Mark clusters with running centers (Q8 fixed point)
+    PulseCluster_t clusters[MAX_SYMBOL_TYPES];
+    uint32_t center_q8[MAX_SYMBOL_TYPES];
+    uint32_t spread_q8[MAX_SYMBOL_TYPES];
+    uint8_t cluster_count;
+    
+    // Timing moments
+    uint32_t pulse_count;
+    uint64_t width_sum;
+    uint64_t width_sum_sq;
+    uint16_t min_width_us;
+    uint16_t max_width_us;
+    uint32_t mark_total_us;
+    uint32_t space_total_us;
+    uint32_t mark_count;
+    uint32_t space_count;
+    uint32_t long_pulses;
+    uint32_t transitions;
+    uint8_t last_level;
+    
+    // Position in the session pulse store
+    uint16_t next_pulse;
+    bool started;
+    
+    bool dirty;                     // Hypothesis needs refresh
+    bool frames_dirty;              // Frame structure needs refresh
+} ProtocolInferStream_t;
+
 // Analysis state
 typedef struct {
-    // Raw pulse data
-    Pulse_t pulses[MAX_PULSE_COUNT];
+    // Pulse window in the shared session store
+    SessionPulseView_t pulses;
     uint16_t pulse_count;
     
     // Timing analysis
-    TimingHistogram_t mark_histogram;
-    TimingHistogram_t space_histogram;
+    PulseTimingHistogram_t mark_histogram;
+    PulseTimingHistogram_t space_histogram;
     
     // Clustering
     PulseCluster_t clusters[MAX_SYMBOL_TYPES];
     uint8_t cluster_count;
     
-    // Frame samples
-    Frame_t frames[MAX_FRAME_SAMPLES];
+    // Frame window in the shared session store (at most MAX_FRAME_SAMPLES)
+    SessionFrameView_t frames;
     uint16_t frame_count;
     
+    // Streaming mode
+    ProtocolInferStream_t stream;
+    
     // Hypothesis
     ProtocolHypothesis_t hypothesis;
     
@@ -141,9 +193,9 @@ typedef struct {
 FuriStatus protocol_infer_init(void);
 void protocol_infer_deinit(void);
 
-// Data collection
-void protocol_infer_add_pulse(const Pulse_t* pulse);
-void protocol_infer_add_frame(const Frame_t* frame);
+// Data collection (views are referenced, not copied)
+void protocol_infer_set_pulses(const SessionPulseView_t* pulses);
+void protocol_infer_set_frames(const SessionFrameView_t* frames);
 void protocol_infer_reset(void);
 
 // Analysis pipeline
@@ -156,24 +208,32 @@ void protocol_infer_analyze_timing(void);
 void protocol_infer_detect_preamble(void);
 void protocol_infer_estimate_frame_structure(void);
 
+// Streaming mode - incremental updates, hypothesis refreshed lazily
+void protocol_infer_add_pulse(const Pulse_t* pulse);
+uint16_t protocol_infer_stream_pulses(const SessionPulseView_t* pulses);
+void protocol_infer_stream_frames(const SessionFrameView_t* frames);
+void protocol_infer_refresh_hypothesis(void);
+const LogHistogram_t* protocol_infer_get_stream_histogram(bool marks);
+uint8_t protocol_infer_get_cluster_centers(uint16_t* centers, uint8_t max_centers);
+uint16_t protocol_infer_log_bin(uint16_t width_us);
+uint16_t protocol_infer_log_bin_center(uint16_t bin);
+
 // Hypothesis generation
 void protocol_infer_generate_hypothesis(void);
 const ProtocolHypothesis_t* protocol_infer_get_hypothesis(void);
 uint8_t protocol_infer_get_confidence(void);
 
 // Modulation detection
-ModulationType_t protocol_infer_detect_modulation_type(const Pulse_t* pulses, 
-                                                        uint16_t count);
-bool protocol_infer_check_ook(const Pulse_t* pulses, uint16_t count);
-bool protocol_infer_check_fsk(const Pulse_t* pulses, uint16_t count);
-bool protocol_infer_check_ask(const Pulse_t* pulses, uint16_t count);
+InferredModulation_t protocol_infer_detect_modulation_type(const SessionPulseView_t* pulses);
+bool protocol_infer_check_ook(const SessionPulseView_t* pulses);
+bool protocol_infer_check_fsk(const SessionPulseView_t* pulses);
+bool protocol_infer_check_ask(const SessionPulseView_t* pulses);
 
 // Encoding detection
-EncodingType_t protocol_infer_detect_encoding_type(const Frame_t* frames, 
-                                                    uint16_t count);
-bool protocol_infer_check_manchester(const Frame_t* frames, uint16_t count);
-bool protocol_infer_check_miller(const Frame_t* frames, uint16_t count);
-bool protocol_infer_check_pwm(const Frame_t* frames, uint16_t count);
+EncodingType_t protocol_infer_detect_encoding_type(const SessionFrameView_t* frames);
+bool protocol_infer_check_manchester(const SessionFrameView_t* frames);
+bool protocol_infer_check_miller(const SessionFrameView_t* frames);
+bool protocol_infer_check_pwm(const SessionFrameView_t* frames);
 
 // Timing analysis
 uint32_t protocol_infer_estimate_baud_rate(void);
@@ -182,7 +242,7 @@ void protocol_infer_calculate_timing_stats(uint16_t* min, uint16_t* max,
                                             uint16_t* mean, uint16_t* std_dev);
 
 // Frame structure analysis
-uint16_t protocol_infer_detect_preamble_pattern(const Frame_t* frames, 
+uint16_t protocol_infer_detect_preamble_pattern(const SessionFrameView_t* frames, 
                                                  uint16_t* length_bits);
 uint8_t protocol_infer_estimate_payload_length(void);
 void protocol_infer_detect_checksum_type(void);
@@ -190,7 +250,7 @@ void protocol_infer_detect_checksum_type(void);
 // Utility functions
 void protocol_infer_print_hypothesis(const ProtocolHypothesis_t* hyp, char* buffer, 
                                       uint32_t max_len);
-const char* protocol_infer_modulation_string(ModulationType_t mod);
+const char* protocol_infer_modulation_string(InferredModulation_t mod);
 const char* protocol_infer_encoding_string(EncodingType_t enc);
 
 // Real-time analysis
@@ -1,5 +1,6 @@
 #include "threat_model.h"
 #include "../core/math/fixed_point.h"
+#include "../core/math/crc.h"
 #include "../storage/sd_manager.h"
 #include <string.h>
 #include <math.h>
@@ -54,33 +55,248 @@ bool threat_model_is_analyzing(void) {
     return (analysis_context.state != THREAT_STATE_IDLE);
 }
 
-// Add frame to analysis
-void threat_model_add_frame(const Frame_t* frame) {
-    if(analysis_context.frame_count >= MAX_FRAME_SAMPLES) return;
+// Payload of the i-th analyzed frame
+static inline const uint8_t* tm_payload(uint16_t i) {
+    return session_frame_payload(&analysis_context.frames, i);
+}
+
+// Payload length of the i-th analyzed frame
+static inline uint8_t tm_length(uint16_t i) {
+    uint8_t len = session_frame_length(&analysis_context.frames, i);
+    return (len < MAX_PAYLOAD_SIZE) ? len : MAX_PAYLOAD_SIZE;
+}
+
+// ============================================================================
+// PER-FRAME INCREMENTAL STATE
+// ============================================================================
+
+// 4 payload bytes as one word, byte b at bits 8 * (b % 4). Payload slots are
+// SESSION_PAYLOAD_STRIDE bytes, so whole-word reads stay inside the slot.
+static inline uint32_t tm_load_word(const uint8_t* p) {
+    uint32_t word;
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+// Bits differing over the common prefix, plus 8 per byte of length difference
+static uint16_t tm_frame_distance(const uint8_t* a, uint8_t len_a, const uint8_t* b, uint8_t len_b) {
+    uint8_t len = (len_a < len_b) ? len_a : len_b;
+    uint8_t extra = (len_a < len_b) ? len_b - len_a : len_a - len_b;
+    return threat_model_hamming_distance(a, b, len) + extra * 8;
+}
+
+// Slot holding an identical payload, or the empty slot where it belongs
+static uint16_t* tm_replay_probe(const uint8_t* data, uint8_t len) {
+    uint32_t hash = crc_compute(crc_get_engine(CRC_ENGINE_32_REF), 0xFFFFFFFF, 0xFFFFFFFF,
+                                data, len);
+    uint16_t slot = hash & (THREAT_REPLAY_SLOTS - 1);
+    
+    while(analysis_context.replay_slots[slot]) {
+        uint16_t f = analysis_context.replay_slots[slot] - 1;
+        if(tm_length(f) == len && memcmp(tm_payload(f), data, len) == 0) break;
+        slot = (slot + 1) & (THREAT_REPLAY_SLOTS - 1);
+    }
+    
+    return &analysis_context.replay_slots[slot];
+}
+
+// Big-endian field value
+static inline uint32_t tm_field_value(const uint8_t* data, uint8_t bytes) {
+    uint32_t value = 0;
+    for(uint8_t b = 0; b < bytes; b++) value = (value << 8) | data[b];
+    return value;
+}
+
+// Mean flip percentage if the field looks like a rolling code, else 0:
+// changes often, flips about half its bits per change, is not a counter
+// (small steps or one direction) and does not toggle between two values
+static uint8_t tm_rolling_score(const RollingFieldStats_t* f, uint8_t bits) {
+    uint16_t changes = f->changes;
+    if(changes < THREAT_ROLLING_MIN_CHANGES) return 0;
     
-    uint16_t idx = analysis_context.frame_count;
-    uint8_t len = (frame->length < MAX_PAYLOAD_SIZE) ? frame->length : MAX_PAYLOAD_SIZE;
+    uint8_t flip_pct = (uint32_t)f->bit_flips * 100 / (changes * bits);
+    if(flip_pct < THREAT_ROLLING_FLIP_PCT) return 0;
+    if(f->delta_hist[0] * 100 > changes * THREAT_ROLLING_STEP_PCT) return 0;
+    if(f->recurrences * 100 > changes * THREAT_ROLLING_RECUR_PCT) return 0;
     
-    memcpy(analysis_context.payloads[idx], frame->data, len);
-    analysis_context.payload_lengths[idx] = len;
-    analysis_context.frame_count++;
+    uint16_t dominant = (f->increments * 2 > changes) ? f->increments : changes - f->increments;
+    if(dominant * 100 > changes * THREAT_ROLLING_MONO_PCT) return 0;
     
-    // Update byte frequencies
-    threat_model_update_byte_frequencies(frame->data, len);
+    return flip_pct;
 }
 
-// Add raw payload
-void threat_model_add_payload(const uint8_t* data, uint8_t len) {
-    if(analysis_context.frame_count >= MAX_FRAME_SAMPLES) return;
+// Update every candidate field with one frame, O(1) per field, and keep the
+// best rolling-code field (widest, then highest flip rate) current
+static void tm_update_rolling_fields(const uint8_t* data, uint8_t len) {
+    for(uint8_t w = 0; w < THREAT_ROLLING_WIDTHS; w++) {
+        uint8_t bytes = 2 << w;
+        uint8_t bits = bytes * 8;
+        
+        for(uint8_t pos = 0; pos + bytes <= len; pos++) {
+            RollingFieldStats_t* f = &analysis_context.rolling_fields[w][pos];
+            uint32_t value = tm_field_value(&data[pos], bytes);
+            
+            if(f->samples == 0) {
+                f->last = value;
+                f->previous = value;
+            } else if(value != f->last && f->changes < UINT8_MAX) {
+                uint32_t magnitude = (value > f->last) ? value - f->last : f->last - value;
+                if(value > f->last) f->increments++;
+                
+                if(magnitude <= THREAT_ROLLING_STEP_MAX) {
+                    f->delta_hist[0]++;
+                } else if(magnitude < (1UL << (bits / 2))) {
+                    f->delta_hist[1]++;
+                } else {
+                    f->delta_hist[2]++;
+                }
+                
+                f->bit_flips += __builtin_popcount(value ^ f->last);
+                if(f->changes > 0 && value == f->previous) f->recurrences++;
+                f->changes++;
+                f->previous = f->last;
+                f->last = value;
+            } else if(value != f->last) {
+                f->previous = f->last;
+                f->last = value;
+            }
+            if(f->samples < UINT8_MAX) f->samples++;
+        }
+    }
     
-    uint16_t idx = analysis_context.frame_count;
-    uint8_t copy_len = (len < MAX_PAYLOAD_SIZE) ? len : MAX_PAYLOAD_SIZE;
+    // Fields this frame is too short for keep their evidence
+    bool found = false;
+    uint8_t best_pos = 0;
+    uint8_t best_len = 0;
+    uint8_t best_score = 0;
     
-    memcpy(analysis_context.payloads[idx], data, copy_len);
-    analysis_context.payload_lengths[idx] = copy_len;
-    analysis_context.frame_count++;
+    for(uint8_t w = 0; w < THREAT_ROLLING_WIDTHS; w++) {
+        uint8_t bytes = 2 << w;
+        for(uint8_t pos = 0; pos + bytes <= MAX_PAYLOAD_SIZE; pos++) {
+            uint8_t score = tm_rolling_score(&analysis_context.rolling_fields[w][pos], bytes * 8);
+            if(score && (bytes > best_len || score > best_score)) {
+                found = true;
+                best_pos = pos;
+                best_len = bytes;
+                best_score = score;
+            }
+        }
+    }
+    
+    if(found && !analysis_context.rolling_code_detected) {
+        FURI_LOG_I(TAG, "Rolling code detected at byte %d (%d bytes)", best_pos, best_len);
+    }
+    
+    analysis_context.rolling_code_detected = found;
+    analysis_context.rolling_code_field_position = best_pos;
+    analysis_context.rolling_code_field_length = best_len;
+    analysis_context.rolling_code_flip_pct = best_score;
+}
+
+static void tm_reset_incremental(void) {
+    memset(analysis_context.byte_frequencies, 0, sizeof(analysis_context.byte_frequencies));
+    analysis_context.total_bytes = 0;
+    
+    memset(analysis_context.static_bit_mask, 0xFF, sizeof(analysis_context.static_bit_mask));
+    analysis_context.static_min_length = 0;
+    analysis_context.static_ratio = 0;
+    
+    analysis_context.min_hamming_distance = 0xFFFF;
+    analysis_context.adjacent_hamming_sum = 0;
+    
+    memset(analysis_context.replay_slots, 0, sizeof(analysis_context.replay_slots));
+    analysis_context.exact_replay_detected = false;
+    analysis_context.replay_count = 0;
+    
+    memset(analysis_context.rolling_fields, 0, sizeof(analysis_context.rolling_fields));
+    analysis_context.rolling_code_detected = false;
+    analysis_context.rolling_code_field_position = 0;
+    analysis_context.rolling_code_field_length = 0;
+    analysis_context.rolling_code_flip_pct = 0;
+    analysis_context.rolling_code_sequence_length = 0;
+}
+
+// Fold frame i into the static mask, Hamming matrix and replay table:
+// O(payload words) per frame, O(window * words) for the matrix row,
+// rolling-code fields and replay table
+static void tm_ingest_frame(uint16_t i) {
+    const uint8_t* data = tm_payload(i);
+    uint8_t len = tm_length(i);
     
     threat_model_update_byte_frequencies(data, len);
+    
+    // Static bits: AND out every bit that differs from frame 0. Bytes past the
+    // shortest frame are never counted, min_length only shrinks.
+    if(i == 0) {
+        analysis_context.static_min_length = len;
+    } else {
+        if(len < analysis_context.static_min_length) analysis_context.static_min_length = len;
+        
+        const uint8_t* ref = tm_payload(0);
+        uint8_t words = (analysis_context.static_min_length + 3) / 4;
+        for(uint8_t w = 0; w < words; w++) {
+            analysis_context.static_bit_mask[w] &= ~(tm_load_word(&ref[w * 4]) ^
+                                                     tm_load_word(&data[w * 4]));
+        }
+    }
+    
+    // Hamming row against the frames still in the window
+    uint8_t row = i % THREAT_HAMMING_WINDOW;
+    uint16_t first = (i >= THREAT_HAMMING_WINDOW) ? i - (THREAT_HAMMING_WINDOW - 1) : 0;
+    analysis_context.hamming_matrix[row][row] = 0;
+    for(uint16_t j = first; j < i; j++) {
+        uint8_t col = j % THREAT_HAMMING_WINDOW;
+        uint16_t d = tm_frame_distance(tm_payload(j), tm_length(j), data, len);
+        analysis_context.hamming_matrix[row][col] = d;
+        analysis_context.hamming_matrix[col][row] = d;
+        if(d < analysis_context.min_hamming_distance) analysis_context.min_hamming_distance = d;
+    }
+    if(i > 0) {
+        analysis_context.adjacent_hamming_sum +=
+            analysis_context.hamming_matrix[row][(i - 1) % THREAT_HAMMING_WINDOW];
+    }
+    
+    tm_update_rolling_fields(data, len);
+    
+    // Exact replay: payload already in the hash table
+    uint16_t* slot = tm_replay_probe(data, len);
+    if(*slot) {
+        analysis_context.exact_replay_detected = true;
+        if(analysis_context.replay_count < 10) {
+            analysis_context.replay_frame_indices[analysis_context.replay_count++] = *slot - 1;
+        }
+    } else {
+        *slot = i + 1;
+    }
+}
+
+// Point analysis at a frame window of the session store. A view that extends
+// the previous one only feeds the new frames into the incremental state.
+void threat_model_set_frames(const SessionFrameView_t* frames) {
+    SessionFrameView_t view = session_frame_view_slice(frames, 0, MAX_FRAME_SAMPLES);
+    uint16_t start = analysis_context.frame_count;
+    
+    if(view.store != analysis_context.frames.store ||
+       view.generation != analysis_context.frames.generation ||
+       view.first != analysis_context.frames.first ||
+       view.count < start) {
+        tm_reset_incremental();
+        start = 0;
+    }
+    
+    analysis_context.frames = view;
+    analysis_context.frame_count = view.count;
+    
+    for(uint16_t i = start; i < view.count; i++) {
+        tm_ingest_frame(i);
+    }
+    
+    // A rollover during ingest may have refilled slots being read; score
+    // nothing and rebuild from the new session on the next call
+    if(session_frame_view_stale(&view)) {
+        tm_reset_incremental();
+        analysis_context.frame_count = 0;
+    }
 }
 
 // Update byte frequency counts
@@ -128,48 +344,28 @@ float threat_model_calculate_byte_entropy(const uint8_t* data, uint8_t len) {
     return entropy;
 }
 
-// Detect static (unchanging) patterns
+// Detect static (unchanging) patterns: the mask is kept current per frame,
+// only the ratio is derived here
 void threat_model_detect_static_patterns(void) {
     if(analysis_context.frame_count < 2) return;
     
-    uint8_t min_len = analysis_context.payload_lengths[0];
-    for(uint16_t i = 1; i < analysis_context.frame_count; i++) {
-        if(analysis_context.payload_lengths[i] < min_len) {
-            min_len = analysis_context.payload_lengths[i];
-        }
-    }
-    
-    // For each bit position, check if it's constant across all frames
-    memset(analysis_context.static_bit_mask, 0xFF, sizeof(analysis_context.static_bit_mask));
-    
-    for(uint16_t frame = 1; frame < analysis_context.frame_count; frame++) {
-        for(uint8_t byte = 0; byte < min_len; byte++) {
-            uint8_t diff = analysis_context.payloads[0][byte] ^ 
-                          analysis_context.payloads[frame][byte];
-            
-            // Clear bits that differ
-            uint32_t word_idx = byte / 4;
-            uint8_t bit_offset = (byte % 4) * 8;
-            analysis_context.static_bit_mask[word_idx] &= ~(diff << bit_offset);
-        }
+    uint8_t min_len = analysis_context.static_min_length;
+    if(min_len == 0) {
+        analysis_context.static_ratio = 0;
+        return;
     }
     
-    // Calculate static ratio
     uint16_t static_bits = 0;
-    uint16_t total_bits = min_len * 8;
-    
-    for(uint8_t i = 0; i < min_len; i++) {
-        uint32_t word_idx = i / 4;
-        uint8_t bit_offset = (i % 4) * 8;
-        uint8_t static_byte = (analysis_context.static_bit_mask[word_idx] >> bit_offset) & 0xFF;
-        
-        // Count bits set in static_byte
-        for(uint8_t b = 0; b < 8; b++) {
-            if(static_byte & (1 << b)) static_bits++;
-        }
+    uint8_t full_words = min_len / 4;
+    for(uint8_t w = 0; w < full_words; w++) {
+        static_bits += __builtin_popcount(analysis_context.static_bit_mask[w]);
+    }
+    if(min_len % 4) {
+        uint32_t partial = (1UL << ((min_len % 4) * 8)) - 1;
+        static_bits += __builtin_popcount(analysis_context.static_bit_mask[full_words] & partial);
     }
     
-    analysis_context.static_ratio = (static_bits * 100) / total_bits;
+    analysis_context.static_ratio = (static_bits * 100) / (min_len * 8);
 }
 
 // Calculate static ratio percentage
@@ -187,8 +383,8 @@ void threat_model_detect_preamble(void) {
     for(uint8_t len = 1; len <= max_preamble_len; len++) {
         bool match = true;
         for(uint16_t i = 1; i < analysis_context.frame_count; i++) {
-            if(memcmp(analysis_context.payloads[0], 
-                     analysis_context.payloads[i], len) != 0) {
+            if(memcmp(tm_payload(0), 
+                     tm_payload(i), len) != 0) {
                 match = false;
                 break;
             }
@@ -199,7 +395,7 @@ void threat_model_detect_preamble(void) {
             analysis_context.fixed_preamble = 0;
             for(uint8_t i = 0; i < len; i++) {
                 analysis_context.fixed_preamble = (analysis_context.fixed_preamble << 8) | 
-                                                analysis_context.payloads[0][i];
+                                                tm_payload(0)[i];
             }
         } else {
             break;
@@ -207,167 +403,389 @@ void threat_model_detect_preamble(void) {
     }
 }
 
-// Analyze CRC
-void threat_model_analyze_crc(void) {
-    analysis_context.state = THREAT_STATE_ANALYZING_CRC;
-    
-    if(analysis_context.frame_count < 5) return;
+// ============================================================================
+// CRC IDENTIFICATION
+// ============================================================================
+
+// A CRC hypothesis for the database search: entry, field placement and order
+typedef struct {
+    uint8_t entry;
+    uint8_t tail;                   // Bytes after the CRC field
+    bool little_endian;
+    bool alive;
+    uint16_t matches;
+    uint16_t misses;
+} CRCCandidate_t;
+
+#define CRC_MAX_CANDIDATES  (CRC_POLYNOMIALS_COUNT * (CRC_MAX_TAIL + 1) * 2)
+#define CRC_POLY_WORDS      ((MAX_PAYLOAD_SIZE * 8 + 32) / 32 + 1)
+
+// GF(2) polynomial, bit i = coefficient of x^i
+typedef struct {
+    uint32_t w[CRC_POLY_WORDS];
+} GF2Poly_t;
+
+static CrcEngine_t crc_entry_engines[CRC_POLYNOMIALS_COUNT];
+static CRCCandidate_t crc_candidates[CRC_MAX_CANDIDATES];
+static GF2Poly_t crc_gcd_a, crc_gcd_b;
+
+// CRC field value stored in bytes at data
+static uint32_t crc_read_field(const uint8_t* data, uint8_t bytes, bool little_endian) {
+    uint32_t value = 0;
+    for(uint8_t i = 0; i < bytes; i++) {
+        uint8_t b = little_endian ? data[bytes - 1 - i] : data[i];
+        value = (value << 8) | b;
+    }
+    return value;
+}
+
+// Record a detected CRC in the analysis context
+static void crc_set_result(uint8_t type, uint32_t polynomial, uint8_t width, bool reflected,
+                           bool little_endian, uint8_t tail, uint32_t xor_constant) {
+    analysis_context.suspected_crc_type = type;
+    analysis_context.suspected_polynomial = polynomial;
+    analysis_context.crc_width = width;
+    analysis_context.crc_reflected = reflected;
+    analysis_context.crc_little_endian = little_endian;
+    analysis_context.crc_position = width / 8 + tail;
+    analysis_context.crc_xor_constant = xor_constant;
+    analysis_context.crc_validated = true;
+}
+
+// Single pass over the frames evaluating every database entry, tail and byte
+// order together. Registers are shared between entries with the same engine
+// and init, and each tail only extends the shorter prefix by one byte.
+static bool crc_search_database(void) {
+    uint16_t frame_count = analysis_context.frame_count;
+    uint16_t required = frame_count * 8 / 10 + 1;          // > 80% of frames
+    uint16_t allowed_misses = frame_count - required;
+    uint16_t num_candidates = 0;
     
-    // Try each CRC polynomial
     for(uint8_t p = 0; p < NUM_CRC_POLYNOMIALS; p++) {
         const CRCPolynomial_t* poly = &crc_database[p];
-        uint8_t match_count = 0;
+        crc_engine_make(&crc_entry_engines[p], poly->polynomial, poly->width, poly->reflect_in);
         
-        for(uint16_t i = 0; i < analysis_context.frame_count; i++) {
-            uint8_t len = analysis_context.payload_lengths[i];
-            if(len < 3) continue;  // Need at least data + CRC
-            
-            // Try different CRC positions
-            for(uint8_t crc_pos = len - 2; crc_pos >= len - 4 && crc_pos > 0; crc_pos--) {
-                if(threat_model_test_crc(analysis_context.payloads[i], crc_pos, poly)) {
-                    match_count++;
-                    break;
-                }
+        for(uint8_t tail = 0; tail <= CRC_MAX_TAIL; tail++) {
+            for(uint8_t order = 0; order < (poly->width > 8 ? 2 : 1); order++) {
+                CRCCandidate_t* c = &crc_candidates[num_candidates++];
+                c->entry = p;
+                c->tail = tail;
+                c->little_endian = order;
+                c->alive = true;
+                c->matches = 0;
+                c->misses = 0;
             }
         }
+    }
+    
+    uint16_t alive = num_candidates;
+    uint32_t regs[CRC_POLYNOMIALS_COUNT][CRC_MAX_TAIL + 1];
+    int8_t max_tail[CRC_POLYNOMIALS_COUNT];
+    
+    for(uint16_t i = 0; i < frame_count && alive > 0; i++) {
+        const uint8_t* data = tm_payload(i);
+        uint8_t len = tm_length(i);
+        
+        for(uint8_t p = 0; p < NUM_CRC_POLYNOMIALS; p++) max_tail[p] = -2;  // Not computed
         
-        // If >80% of frames match, we found the CRC
-        if(match_count > (analysis_context.frame_count * 8 / 10)) {
-            analysis_context.suspected_crc_type = p;
-            analysis_context.suspected_polynomial = poly->polynomial;
-            analysis_context.crc_validated = true;
+        for(uint16_t k = 0; k < num_candidates; k++) {
+            CRCCandidate_t* c = &crc_candidates[k];
+            if(!c->alive) continue;
             
-            FURI_LOG_I(TAG, "Detected CRC: %s", poly->name);
-            break;
+            uint8_t p = c->entry;
+            const CRCPolynomial_t* poly = &crc_database[p];
+            const CrcEngine_t* engine = &crc_entry_engines[p];
+            uint8_t bytes = poly->width / 8;
+            
+            if(max_tail[p] == -2) {
+                // Reuse an entry with identical register evolution
+                uint8_t q;
+                for(q = 0; q < p; q++) {
+                    if(max_tail[q] != -2 && crc_database[q].initial == poly->initial &&
+                       crc_entry_engines[q].polynomial == engine->polynomial &&
+                       crc_entry_engines[q].width == engine->width &&
+                       crc_entry_engines[q].reflected == engine->reflected) break;
+                }
+                
+                if(q < p) {
+                    memcpy(regs[p], regs[q], sizeof(regs[p]));
+                    max_tail[p] = max_tail[q];
+                } else if(len <= bytes) {
+                    max_tail[p] = -1;
+                } else {
+                    int8_t t = (len - bytes - 1 < CRC_MAX_TAIL) ? len - bytes - 1 : CRC_MAX_TAIL;
+                    uint8_t start = len - bytes - t;
+                    uint32_t reg = crc_update(engine, crc_init_register(engine, poly->initial),
+                                              data, start);
+                    max_tail[p] = t;
+                    regs[p][t] = reg;
+                    while(--t >= 0) {
+                        reg = crc_update(engine, reg, &data[start++], 1);
+                        regs[p][t] = reg;
+                    }
+                }
+            }
+            
+            bool match = false;
+            if((int8_t)c->tail <= max_tail[p]) {
+                uint32_t crc = (regs[p][c->tail] ^ poly->xor_out) & crc_width_mask(poly->width);
+                match = (crc == crc_read_field(&data[len - bytes - c->tail], bytes,
+                                               c->little_endian));
+            }
+            
+            if(match) {
+                c->matches++;
+            } else if(++c->misses > allowed_misses ||
+                      (c->matches == 0 && c->misses >= CRC_PROBE_FRAMES)) {
+                c->alive = false;
+                alive--;
+            }
         }
     }
+    
+    // Best surviving candidate; ties keep database order
+    CRCCandidate_t* best = NULL;
+    for(uint16_t k = 0; k < num_candidates; k++) {
+        CRCCandidate_t* c = &crc_candidates[k];
+        if(!c->alive || c->matches < required) continue;
+        if(!best || c->matches > best->matches) best = c;
+    }
+    
+    if(!best) return false;
+    
+    const CRCPolynomial_t* poly = &crc_database[best->entry];
+    crc_set_result(best->entry, poly->polynomial, poly->width, poly->reflect_in,
+                   best->little_endian, best->tail, poly->xor_out);
+    FURI_LOG_I(TAG, "Detected CRC: %s (%d/%d frames)", poly->name, best->matches, frame_count);
+    
+    return true;
 }
 
-// Test if CRC matches
-bool threat_model_test_crc(const uint8_t* data, uint8_t len, 
-                           const CRCPolynomial_t* poly) {
-    if(poly->width == 8) {
-        uint8_t crc = threat_model_calculate_crc8(data, len, 
-                                                    poly->polynomial & 0xFF, 
-                                                    poly->initial);
-        return (crc == data[len]);
-    } else if(poly->width == 16) {
-        uint16_t crc = threat_model_calculate_crc16(data, len, 
-                                                     poly->polynomial, 
-                                                     poly->initial);
-        return ((crc >> 8) == data[len] && (crc & 0xFF) == data[len + 1]);
+// Highest set coefficient, -1 for the zero polynomial
+static int16_t gf2_degree(const GF2Poly_t* p) {
+    for(int16_t i = CRC_POLY_WORDS - 1; i >= 0; i--) {
+        if(p->w[i]) return i * 32 + 31 - __builtin_clz(p->w[i]);
     }
-    return false;
+    return -1;
 }
 
-// Calculate CRC-16
-uint16_t threat_model_calculate_crc16(const uint8_t* data, uint8_t len,
-                                       uint16_t polynomial, uint16_t init) {
-    uint16_t crc = init;
+// a ^= b * x^shift
+static void gf2_xor_shifted(GF2Poly_t* a, const GF2Poly_t* b, uint16_t shift) {
+    uint16_t words = shift / 32;
+    uint8_t bits = shift % 32;
     
-    for(uint8_t i = 0; i < len; i++) {
-        crc ^= (data[i] << 8);
-        for(uint8_t j = 0; j < 8; j++) {
-            if(crc & 0x8000) {
-                crc = (crc << 1) ^ polynomial;
-            } else {
-                crc <<= 1;
-            }
+    for(int16_t i = CRC_POLY_WORDS - 1; i >= (int16_t)words; i--) {
+        uint32_t v = b->w[i - words] << bits;
+        if(bits && i - words > 0) v |= b->w[i - words - 1] >> (32 - bits);
+        a->w[i] ^= v;
+    }
+}
+
+// gcd(a, b), result left in a (b is clobbered)
+static void gf2_gcd(GF2Poly_t* a, GF2Poly_t* b) {
+    GF2Poly_t* x = a;
+    GF2Poly_t* y = b;
+    int16_t dy;
+    
+    while((dy = gf2_degree(y)) >= 0) {
+        int16_t dx;
+        while((dx = gf2_degree(x)) >= dy) {
+            gf2_xor_shifted(x, y, dx - dy);
         }
+        GF2Poly_t* t = x;
+        x = y;
+        y = t;
     }
     
-    return crc;
+    if(x != a) memcpy(a, x, sizeof(GF2Poly_t));
 }
 
-// Calculate CRC-8
-uint8_t threat_model_calculate_crc8(const uint8_t* data, uint8_t len,
-                                     uint8_t polynomial, uint8_t init) {
-    uint8_t crc = init;
+// D(x) * x^width + F(x) for the difference of two frames: data bytes [0, pos)
+// and CRC field at pos. Any CRC of this layout divides it whatever its init
+// and final XOR, and constant prefix bytes (sync words) drop out.
+static void gf2_frame_difference(GF2Poly_t* out, const uint8_t* a, const uint8_t* b, uint8_t pos,
+                                 uint8_t width, bool reflected, bool little_endian) {
+    memset(out, 0, sizeof(GF2Poly_t));
+    uint16_t top = width + pos * 8 - 1;                     // Degree of the first data bit
     
-    for(uint8_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for(uint8_t j = 0; j < 8; j++) {
-            if(crc & 0x80) {
-                crc = (crc << 1) ^ polynomial;
-            } else {
-                crc <<= 1;
+    for(uint8_t i = 0; i < pos; i++) {
+        uint8_t d = a[i] ^ b[i];
+        for(uint8_t t = 0; d && t < 8; t++) {
+            uint8_t bit = reflected ? (d >> t) & 1 : (d >> (7 - t)) & 1;
+            if(bit) {
+                uint16_t degree = top - (i * 8 + t);
+                out->w[degree / 32] |= 1UL << (degree % 32);
             }
         }
     }
     
-    return crc;
+    uint32_t f = crc_read_field(&a[pos], width / 8, little_endian) ^
+                 crc_read_field(&b[pos], width / 8, little_endian);
+    out->w[0] ^= reflected ? crc_reflect(f, width) : f;
 }
 
-// Detect rolling code
-void threat_model_detect_rolling_code(void) {
-    if(analysis_context.frame_count < ENTROPY_HISTORY_SIZE) return;
+// Recover an unlisted linear CRC from XOR differences of equal-length frames:
+// the generator is the GCD of the difference polynomials, so no polynomial
+// has to be guessed. Init and final XOR fold into one constant per length.
+static bool crc_identify_linear(void) {
+    static const uint8_t widths[] = {8, 16, 32};
+    uint16_t frame_count = analysis_context.frame_count;
     
-    // Look for fields that change in every frame but aren't random
-    // This is a simplified check - full implementation would be more sophisticated
+    // Most common frame length
+    uint16_t length_counts[MAX_PAYLOAD_SIZE + 1];
+    memset(length_counts, 0, sizeof(length_counts));
+    for(uint16_t i = 0; i < frame_count; i++) length_counts[tm_length(i)]++;
     
-    uint8_t min_len = analysis_context.payload_lengths[0];
+    uint8_t len = 0;
+    for(uint8_t l = 1; l <= MAX_PAYLOAD_SIZE; l++) {
+        if(length_counts[l] > length_counts[len]) len = l;
+    }
+    if(length_counts[len] < 4) return false;    // Need two differences plus a check frame
     
-    for(uint8_t byte_pos = 0; byte_pos < min_len; byte_pos++) {
-        uint32_t values[ENTROPY_HISTORY_SIZE];
-        uint8_t value_count = 0;
-        
-        for(uint16_t i = 0; i < analysis_context.frame_count && i < ENTROPY_HISTORY_SIZE; i++) {
-            // Extract 4-byte value at this position
-            if(byte_pos + 4 <= analysis_context.payload_lengths[i]) {
-                uint32_t val = 0;
-                for(uint8_t b = 0; b < 4; b++) {
-                    val = (val << 8) | analysis_context.payloads[i][byte_pos + b];
-                }
-                values[value_count++] = val;
-            }
-        }
+    uint16_t ref;
+    for(ref = 0; tm_length(ref) != len; ref++) {}
+    const uint8_t* r = tm_payload(ref);
+    uint16_t required = length_counts[len] * 8 / 10 + 1;
+    
+    for(uint8_t wi = 0; wi < sizeof(widths); wi++) {
+        uint8_t width = widths[wi];
+        uint8_t bytes = width / 8;
         
-        // Check if values are sequential or have pattern
-        if(value_count >= 10) {
-            bool sequential = true;
-            for(uint8_t i = 1; i < value_count; i++) {
-                if(values[i] != values[i-1] + 1 && 
-                   values[i] != values[i-1] - 1 &&
-                   values[i] != values[i-1]) {
-                    sequential = false;
-                    break;
-                }
-            }
+        for(uint8_t hyp = 0; hyp < 4; hyp++) {
+            bool reflected = hyp & 1;
+            bool little_endian = hyp & 2;
+            if(bytes == 1 && little_endian) continue;
             
-            if(!sequential && threat_model_analyze_sequence_randomness(values, value_count)) {
-                analysis_context.rolling_code_detected = true;
-                analysis_context.rolling_code_field_position = byte_pos;
-                analysis_context.rolling_code_field_length = 4;
+            for(uint8_t tail = 0; tail <= CRC_MAX_TAIL; tail++) {
+                if(len <= bytes + tail) continue;
+                uint8_t pos = len - bytes - tail;
                 
-                // Store sequence for analysis
-                memcpy(analysis_context.rolling_code_sequence, values, 
-                       value_count * sizeof(uint32_t));
+                // GCD of the differences against the reference frame
+                uint8_t pairs = 0;
+                for(uint16_t i = ref + 1; i < frame_count && pairs < CRC_XOR_MAX_PAIRS; i++) {
+                    if(tm_length(i) != len) continue;
+                    
+                    GF2Poly_t* term = pairs ? &crc_gcd_b : &crc_gcd_a;
+                    gf2_frame_difference(term, r, tm_payload(i), pos, width, reflected,
+                                         little_endian);
+                    if(gf2_degree(term) < 0) continue;  // Identical frames
+                    
+                    if(pairs++) gf2_gcd(&crc_gcd_a, &crc_gcd_b);
+                    if(pairs >= 2 && gf2_degree(&crc_gcd_a) <= width) break;
+                }
                 
-                FURI_LOG_I(TAG, "Rolling code detected at byte %d", byte_pos);
-                break;
+                if(pairs < 2 || gf2_degree(&crc_gcd_a) != width || !(crc_gcd_a.w[0] & 1)) continue;
+                
+                // Confirm on every frame of this length
+                CrcEngine_t engine;
+                uint32_t polynomial = crc_gcd_a.w[0] & crc_width_mask(width);
+                crc_engine_make(&engine, polynomial, width, reflected);
+                
+                uint32_t constant = crc_read_field(&r[pos], bytes, little_endian) ^
+                                    crc_update(&engine, 0, r, pos);
+                uint16_t matches = 0;
+                for(uint16_t i = ref; i < frame_count; i++) {
+                    if(tm_length(i) != len) continue;
+                    const uint8_t* data = tm_payload(i);
+                    uint32_t k = crc_read_field(&data[pos], bytes, little_endian) ^
+                                 crc_update(&engine, 0, data, pos);
+                    if(k == constant) matches++;
+                }
+                if(matches < required) continue;
+                
+                crc_set_result(CRC_TYPE_CUSTOM, polynomial, width, reflected, little_endian,
+                               tail, constant);
+                FURI_LOG_I(TAG, "Recovered CRC-%d poly 0x%lX%s, xor 0x%lX (%d/%d frames)",
+                           width, polynomial, reflected ? " reflected" : "", constant, matches,
+                           length_counts[len]);
+                return true;
             }
         }
     }
+    
+    return false;
 }
 
-// Analyze sequence randomness
-bool threat_model_analyze_sequence_randomness(const uint32_t* sequence, uint8_t len) {
-    // Simple randomness test: check for patterns
-    // Full implementation would use more sophisticated tests
-    
-    // Check for repeating patterns
-    for(uint8_t period = 1; period <= len / 2; period++) {
-        bool repeating = true;
-        for(uint8_t i = period; i < len; i++) {
-            if(sequence[i] != sequence[i % period]) {
-                repeating = false;
-                break;
-            }
+// Analyze CRC: database polynomials first, then recovery of unlisted ones
+void threat_model_analyze_crc(void) {
+    analysis_context.state = THREAT_STATE_ANALYZING_CRC;
+    
+    if(analysis_context.frame_count < 5) return;
+    
+    if(!crc_search_database()) {
+        crc_identify_linear();
+    }
+}
+
+// Test if CRC matches (field at data[len], either byte order)
+bool threat_model_test_crc(const uint8_t* data, uint8_t len, 
+                           const CRCPolynomial_t* poly) {
+    CrcEngine_t engine;
+    crc_engine_make(&engine, poly->polynomial, poly->width, poly->reflect_in);
+    
+    uint8_t bytes = poly->width / 8;
+    uint32_t crc = crc_compute(&engine, poly->initial, poly->xor_out, data, len);
+    
+    return crc == crc_read_field(&data[len], bytes, false) ||
+           crc == crc_read_field(&data[len], bytes, true);
+}
+
+// Calculate CRC-16 (MSB-first, no final XOR)
+uint16_t threat_model_calculate_crc16(const uint8_t* data, uint8_t len,
+                                       uint16_t polynomial, uint16_t init) {
+    CrcEngine_t engine;
+    crc_engine_make(&engine, polynomial, 16, false);
+    return crc_update(&engine, init, data, len);
+}
+
+// Calculate CRC-8 (MSB-first, no final XOR)
+uint8_t threat_model_calculate_crc8(const uint8_t* data, uint8_t len,
+                                     uint8_t polynomial, uint8_t init) {
+    CrcEngine_t engine;
+    crc_engine_make(&engine, polynomial, 8, false);
+    return crc_update(&engine, init, data, len);
+}
+
+// Detect rolling code. Fields are classified as frames arrive
+// (tm_update_rolling_fields); this only snapshots the latest values of the
+// detected field.
+void threat_model_detect_rolling_code(void) {
+    analysis_context.rolling_code_sequence_length = 0;
+    if(!analysis_context.rolling_code_detected) return;
+    
+    uint8_t pos = analysis_context.rolling_code_field_position;
+    uint8_t bytes = analysis_context.rolling_code_field_length;
+    uint16_t count = 0;
+    
+    for(uint16_t i = analysis_context.frame_count; i-- > 0 && count < ENTROPY_HISTORY_SIZE;) {
+        if(pos + bytes <= tm_length(i)) count++;
+    }
+    
+    analysis_context.rolling_code_sequence_length = count;
+    for(uint16_t i = analysis_context.frame_count; i-- > 0 && count > 0;) {
+        if(pos + bytes <= tm_length(i)) {
+            analysis_context.rolling_code_sequence[--count] = tm_field_value(&tm_payload(i)[pos], bytes);
         }
-        if(repeating) return false;  // Not random if repeating
     }
+}
+
+// Analyze sequence randomness: not random if it repeats with a period of at
+// most len / 2. The smallest period is len - border (KMP failure function),
+// so one O(len) pass replaces testing every period.
+bool threat_model_analyze_sequence_randomness(const uint32_t* sequence, uint8_t len) {
+    if(len < 2) return true;
     
-    return true;
+    uint8_t border[UINT8_MAX];
+    border[0] = 0;
+    for(uint8_t i = 1; i < len; i++) {
+        uint8_t k = border[i - 1];
+        while(k > 0 && sequence[i] != sequence[k]) k = border[k - 1];
+        if(sequence[i] == sequence[k]) k++;
+        border[i] = k;
+    }
+    
+    uint8_t period = len - border[len - 1];
+    return period > len / 2;
 }
 
 // Estimate entropy bits in data
@@ -376,38 +794,19 @@ uint8_t threat_model_estimate_entropy_bits(const uint8_t* data, uint8_t len) {
     return (uint8_t)(entropy * len);  // Total entropy in bits
 }
 
-// Detect replay vulnerability
+// Detect replay vulnerability. Exact duplicates are caught as frames arrive
+// (tm_ingest_frame), so there is nothing left to scan here.
 void threat_model_detect_replay_vulnerability(void) {
-    analysis_context.exact_replay_detected = false;
-    analysis_context.replay_count = 0;
-    
-    // Check for identical frames
-    for(uint16_t i = 0; i < analysis_context.frame_count; i++) {
-        for(uint16_t j = i + 1; j < analysis_context.frame_count; j++) {
-            if(analysis_context.payload_lengths[i] == analysis_context.payload_lengths[j]) {
-                if(memcmp(analysis_context.payloads[i], 
-                         analysis_context.payloads[j],
-                         analysis_context.payload_lengths[i]) == 0) {
-                    analysis_context.exact_replay_detected = true;
-                    if(analysis_context.replay_count < 10) {
-                        analysis_context.replay_frame_indices[analysis_context.replay_count++] = i;
-                    }
-                }
-            }
-        }
+    if(analysis_context.exact_replay_detected) {
+        FURI_LOG_D(TAG, "%d replayed frames, closest pair %d bits",
+                   analysis_context.replay_count, analysis_context.min_hamming_distance);
     }
 }
 
 // Check frame uniqueness
 bool threat_model_check_frame_uniqueness(const uint8_t* data, uint8_t len) {
-    for(uint16_t i = 0; i < analysis_context.frame_count; i++) {
-        if(analysis_context.payload_lengths[i] == len) {
-            if(memcmp(analysis_context.payloads[i], data, len) == 0) {
-                return false;  // Not unique
-            }
-        }
-    }
-    return true;
+    if(len > MAX_PAYLOAD_SIZE) len = MAX_PAYLOAD_SIZE;
+    return *tm_replay_probe(data, len) == 0;
 }
 
 // Assess vulnerabilities
@@ -529,6 +928,12 @@ const char* threat_model_get_report(void) {
     return analysis_context.detailed_report;
 }
 
+// Result of the last completed assessment, NULL while none is available
+const ThreatAssessment_t* threat_model_get_assessment(void) {
+    if(analysis_context.state != THREAT_STATE_COMPLETE) return NULL;
+    return &analysis_context.assessment;
+}
+
 // Get risk level string
 const char* threat_model_get_risk_string(RiskLevel_t risk) {
     switch(risk) {
@@ -540,19 +945,34 @@ const char* threat_model_get_risk_string(RiskLevel_t risk) {
     }
 }
 
-// Calculate Hamming distance
-uint8_t threat_model_hamming_distance(const uint8_t* a, const uint8_t* b, uint8_t len) {
-    uint8_t distance = 0;
-    for(uint8_t i = 0; i < len; i++) {
-        uint8_t diff = a[i] ^ b[i];
-        // Count bits
-        for(uint8_t j = 0; j < 8; j++) {
-            if(diff & (1 << j)) distance++;
-        }
+// Calculate Hamming distance (word at a time)
+uint16_t threat_model_hamming_distance(const uint8_t* a, const uint8_t* b, uint8_t len) {
+    uint16_t distance = 0;
+    uint8_t i = 0;
+    
+    for(; i + 4 <= len; i += 4) {
+        distance += __builtin_popcount(tm_load_word(&a[i]) ^ tm_load_word(&b[i]));
+    }
+    for(; i < len; i++) {
+        distance += __builtin_popcount(a[i] ^ b[i]);
     }
+    
     return distance;
 }
 
+// Hamming distance between two analyzed frames, from the matrix when both
+// are still in the window
+uint16_t threat_model_get_frame_hamming(uint16_t i, uint16_t j) {
+    uint16_t count = analysis_context.frame_count;
+    if(i >= count || j >= count) return 0xFFFF;
+    
+    if(count - i <= THREAT_HAMMING_WINDOW && count - j <= THREAT_HAMMING_WINDOW) {
+        return analysis_context.hamming_matrix[i % THREAT_HAMMING_WINDOW][j % THREAT_HAMMING_WINDOW];
+    }
+    
+    return tm_frame_distance(tm_payload(i), tm_length(i), tm_payload(j), tm_length(j));
+}
+
 // Bitwise XOR
 void threat_model_bitwise_xor(const uint8_t* a, const uint8_t* b,
                                uint8_t* result, uint8_t len) {
@@ -632,7 +1052,7 @@ bool threat_model_find_fixed_fields(uint8_t* field_positions, uint8_t* field_len
     if(analysis_context.frame_count < 2) return false;
     
     *num_fields = 0;
-    uint8_t min_len = analysis_context.payload_lengths[0];
+    uint8_t min_len = analysis_context.static_min_length;
     
     // Find runs of static bits
     bool in_field = false;
@@ -2,6 +2,7 @@
 #define THREAT_MODEL_H
 
 #include "../core/flipper_rf_lab.h"
+#include "../core/session_store.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -16,6 +17,22 @@ extern "C" {
 #define MAX_FRAME_SAMPLES       256
 #define ENTROPY_HISTORY_SIZE    100
 #define CRC_POLYNOMIALS_COUNT   10
+#define CRC_MAX_TAIL            2       // Trailing bytes allowed after the CRC field
+#define CRC_PROBE_FRAMES        8       // Candidates matching none of these are dropped
+#define CRC_XOR_MAX_PAIRS       6       // Frame differences fed to the polynomial GCD
+#define CRC_TYPE_CUSTOM         0xFF    // suspected_crc_type for a recovered polynomial
+#define THREAT_PAYLOAD_WORDS    (MAX_PAYLOAD_SIZE / 4)
+#define THREAT_HAMMING_WINDOW   32      // Recent frames in the pairwise Hamming matrix
+#define THREAT_REPLAY_SLOTS     512     // Payload hash table, power of two > MAX_FRAME_SAMPLES
+
+// Rolling code classification (per candidate field, see RollingFieldStats_t)
+#define THREAT_ROLLING_WIDTHS       2       // Candidate field widths: 2 and 4 bytes
+#define THREAT_ROLLING_MIN_CHANGES  16      // Value changes before a field is classified
+#define THREAT_ROLLING_FLIP_PCT     40      // Min mean bits flipped per change (% of width)
+#define THREAT_ROLLING_STEP_MAX     16      // |delta| counted as a counter step
+#define THREAT_ROLLING_STEP_PCT     10      // Max counter-like changes (%)
+#define THREAT_ROLLING_RECUR_PCT    10      // Max changes back to the previous value (%)
+#define THREAT_ROLLING_MONO_PCT     80      // Max changes in one direction (%)
 
 // Vulnerability scoring thresholds
 #define VULN_SCORE_CRITICAL     900     // 90.0+
@@ -38,10 +55,23 @@ typedef enum {
     THREAT_STATE_COMPLETE
 } ThreatAnalysisState_t;
 
+// Running statistics of one candidate rolling-code field (big-endian value
+// at a fixed offset). Repeats of the same value are ignored, since remotes
+// send each code several times per press. Counters stop at 255 changes.
 typedef struct {
-    // Frame collection
-    uint8_t payloads[MAX_FRAME_SAMPLES][MAX_PAYLOAD_SIZE];
-    uint8_t payload_lengths[MAX_FRAME_SAMPLES];
+    uint32_t last;                  // Current value
+    uint32_t previous;              // Value before the last change
+    uint16_t bit_flips;             // Sum of popcount(value ^ last) over changes
+    uint8_t samples;                // Frames carrying the field (saturating)
+    uint8_t changes;
+    uint8_t recurrences;            // Changed back to the previous value
+    uint8_t increments;             // Changes to a larger value
+    uint8_t delta_hist[3];          // |delta| <= STEP_MAX, < 2^(bits / 2), larger
+} RollingFieldStats_t;
+
+typedef struct {
+    // Frame window in the shared session store (payloads read in place)
+    SessionFrameView_t frames;
     uint16_t frame_count;
     
     // Entropy analysis
@@ -50,28 +80,43 @@ typedef struct {
     float entropy_per_byte;
     uint8_t entropy_histogram[ENTROPY_HISTORY_SIZE];
     
-    // Pattern detection
-    uint32_t static_bit_mask[MAX_PAYLOAD_SIZE / 32 + 1];
+    // Pattern detection (mask maintained per frame, byte b at word b / 4)
+    uint32_t static_bit_mask[THREAT_PAYLOAD_WORDS];
+    uint8_t static_min_length;
     uint8_t static_ratio;
     uint16_t fixed_preamble;
     uint8_t preamble_length;
     
     // CRC analysis
-    uint8_t suspected_crc_type;
-    uint16_t suspected_polynomial;
-    uint8_t crc_position;
+    uint8_t suspected_crc_type;     // crc_database index or CRC_TYPE_CUSTOM
+    uint32_t suspected_polynomial;
+    uint8_t crc_position;           // CRC field start, in bytes from the frame end
+    uint8_t crc_width;
+    bool crc_reflected;
+    bool crc_little_endian;         // Field byte order
+    uint32_t crc_xor_constant;      // CRC_TYPE_CUSTOM: output XOR with init 0 (one frame length)
     bool crc_validated;
     
-    // Rolling code detection
+    // Rolling code detection, widths 2 << index at every start offset
+    RollingFieldStats_t rolling_fields[THREAT_ROLLING_WIDTHS][MAX_PAYLOAD_SIZE - 1];
     bool rolling_code_detected;
     uint8_t rolling_code_field_position;
     uint8_t rolling_code_field_length;
-    uint32_t rolling_code_sequence[ENTROPY_HISTORY_SIZE];
+    uint8_t rolling_code_flip_pct;  // Mean bits flipped per change (% of width)
+    uint32_t rolling_code_sequence[ENTROPY_HISTORY_SIZE];  // Latest values of the field
+    uint8_t rolling_code_sequence_length;
+    
+    // Pairwise Hamming distances (bits) of the last THREAT_HAMMING_WINDOW
+    // frames, indexed by frame % THREAT_HAMMING_WINDOW
+    uint16_t hamming_matrix[THREAT_HAMMING_WINDOW][THREAT_HAMMING_WINDOW];
+    uint16_t min_hamming_distance;  // Closest pair within the window
+    uint32_t adjacent_hamming_sum;  // Over consecutive frames
     
-    // Replay detection
+    // Replay detection (payload hash table, frame index + 1, 0 = empty)
     bool exact_replay_detected;
     uint16_t replay_frame_indices[10];
     uint8_t replay_count;
+    uint16_t replay_slots[THREAT_REPLAY_SLOTS];
     
     // Assessment
     ThreatAssessment_t assessment;
@@ -89,12 +134,12 @@ typedef struct {
 
 typedef struct {
     const char* name;
-    uint16_t polynomial;
+    uint32_t polynomial;
     uint8_t width;        // 8, 16, or 32
-    uint8_t initial;
+    uint32_t initial;
     bool reflect_in;
     bool reflect_out;
-    uint16_t xor_out;
+    uint32_t xor_out;
 } CRCPolynomial_t;
 
 // ============================================================================
@@ -111,8 +156,7 @@ void threat_model_stop_analysis(void);
 bool threat_model_is_analyzing(void);
 
 // Frame collection
-void threat_model_add_frame(const Frame_t* frame);
-void threat_model_add_payload(const uint8_t* data, uint8_t len);
+void threat_model_set_frames(const SessionFrameView_t* frames);
 
 // Entropy analysis
 float threat_model_calculate_entropy(void);
@@ -150,6 +194,7 @@ uint16_t threat_model_calculate_vulnerability_score(void);
 // Report generation
 void threat_model_generate_report(void);
 const char* threat_model_get_report(void);
+const ThreatAssessment_t* threat_model_get_assessment(void);
 const char* threat_model_get_risk_string(RiskLevel_t risk);
 
 // Utility functions
@@ -161,7 +206,8 @@ bool threat_model_verify_checksum(const uint8_t* data, uint8_t len,
                                    uint8_t checksum_pos);
 
 // Bit-level analysis
-uint8_t threat_model_hamming_distance(const uint8_t* a, const uint8_t* b, uint8_t len);
+uint16_t threat_model_hamming_distance(const uint8_t* a, const uint8_t* b, uint8_t len);
+uint16_t threat_model_get_frame_hamming(uint16_t i, uint16_t j);
 void threat_model_bitwise_xor(const uint8_t* a, const uint8_t* b, 
                                uint8_t* result, uint8_t len);
 
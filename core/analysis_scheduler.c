@@ -0,0 +1,202 @@
+#include "analysis_scheduler.h"
+#include "hal/timer_precision.h"
+
+#define TAG "SCHEDULER"
+
+// Per-type defaults: capture-derived work that the UI shows first gets the
+// tightest deadline, SD traffic the loosest. UI snapshots are submitted after
+// the work they show and are due within one display frame.
+typedef struct {
+    const char* name;
+    uint8_t priority;
+    uint32_t deadline_ms;
+} AnalysisTaskClass_t;
+
+static const AnalysisTaskClass_t task_classes[ANALYSIS_TASK_TYPE_COUNT] = {
+    [ANALYSIS_TASK_FINGERPRINT_UPDATE] = {"fingerprint", 0, 50},
+    [ANALYSIS_TASK_PROTOCOL_INFER]     = {"infer",       1, 200},
+    [ANALYSIS_TASK_THREAT_SCORE]       = {"threat",      2, 500},
+    [ANALYSIS_TASK_SD_FLUSH]           = {"sd_flush",    3, 2000},
+    [ANALYSIS_TASK_UI_SNAPSHOT]        = {"ui_snapshot", 4, UI_FRAME_INTERVAL_MS},
+};
+
+// Static state - binary min-heap ordered by (deadline, priority)
+static AnalysisTask_t task_heap[ANALYSIS_QUEUE_DEPTH];
+static uint16_t task_count = 0;
+static AnalysisSchedulerStats_t scheduler_stats;
+static volatile FuriThreadId consumer_thread = NULL;
+
+// ============================================================================
+// HEAP HELPERS (caller holds the critical section)
+// ============================================================================
+
+// True when task a should run before task b
+static inline bool task_before(const AnalysisTask_t* a, const AnalysisTask_t* b) {
+    int32_t slack = (int32_t)(a->deadline_tick - b->deadline_tick);  // Wrap-safe tick compare
+    if(slack != 0) return slack < 0;
+    return a->priority < b->priority;
+}
+
+static inline void task_swap(uint16_t i, uint16_t j) {
+    AnalysisTask_t tmp = task_heap[i];
+    task_heap[i] = task_heap[j];
+    task_heap[j] = tmp;
+}
+
+static void heap_sift_up(uint16_t i) {
+    while(i > 0) {
+        uint16_t parent = (i - 1) / 2;
+        if(!task_before(&task_heap[i], &task_heap[parent])) break;
+        task_swap(i, parent);
+        i = parent;
+    }
+}
+
+static void heap_sift_down(uint16_t i) {
+    while(1) {
+        uint16_t left = 2 * i + 1;
+        uint16_t right = left + 1;
+        uint16_t best = i;
+
+        if(left < task_count && task_before(&task_heap[left], &task_heap[best])) best = left;
+        if(right < task_count && task_before(&task_heap[right], &task_heap[best])) best = right;
+        if(best == i) break;
+
+        task_swap(i, best);
+        i = best;
+    }
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Initialize scheduler
+void analysis_scheduler_init(void) {
+    uint32_t primask = critical_section_enter();
+    task_count = 0;
+    memset(&scheduler_stats, 0, sizeof(scheduler_stats));
+    critical_section_exit(primask);
+
+    consumer_thread = NULL;
+}
+
+// Register the thread woken by submissions (NULL to detach)
+void analysis_scheduler_attach_consumer(FuriThreadId thread) {
+    consumer_thread = thread;
+    if(thread && task_count > 0) {
+        furi_thread_flags_set(thread, ANALYSIS_FLAG_TASK);
+    }
+}
+
+// Queue a task, coalescing with a queued task of the same type
+bool analysis_scheduler_submit(AnalysisTaskType_t type, uint32_t deadline_ms, uint32_t arg) {
+    if(type >= ANALYSIS_TASK_TYPE_COUNT) return false;
+
+    uint32_t now = furi_get_tick();
+    uint32_t deadline = now + (deadline_ms ? deadline_ms : task_classes[type].deadline_ms);
+    bool queued = true;
+
+    uint32_t primask = critical_section_enter();
+    scheduler_stats.submitted++;
+
+    uint16_t i;
+    for(i = 0; i < task_count; i++) {
+        if(task_heap[i].type == type) break;
+    }
+
+    if(i < task_count) {
+        // Batch: one pass covers every coalesced submission
+        AnalysisTask_t* task = &task_heap[i];
+        task->batch_count++;
+        task->arg = arg;
+        if((int32_t)(deadline - task->deadline_tick) < 0) {
+            task->deadline_tick = deadline;
+            heap_sift_up(i);
+        }
+        scheduler_stats.coalesced++;
+    } else if(task_count < ANALYSIS_QUEUE_DEPTH) {
+        AnalysisTask_t* task = &task_heap[task_count];
+        task->type = type;
+        task->priority = task_classes[type].priority;
+        task->batch_count = 1;
+        task->submit_tick = now;
+        task->deadline_tick = deadline;
+        task->arg = arg;
+        heap_sift_up(task_count++);
+        if(task_count > scheduler_stats.max_depth) scheduler_stats.max_depth = task_count;
+    } else {
+        scheduler_stats.dropped++;
+        queued = false;
+    }
+    critical_section_exit(primask);
+
+    FuriThreadId thread = consumer_thread;
+    if(queued && thread) {
+        furi_thread_flags_set(thread, ANALYSIS_FLAG_TASK);
+    }
+
+    return queued;
+}
+
+// Consumer: block until a task is queued, one of extra_flags is raised or the
+// timeout expires. Returns the raised flags (0 on timeout).
+uint32_t analysis_scheduler_wait(uint32_t extra_flags, uint32_t timeout_ms) {
+    // Tasks already queued: only pick up pending flags, don't sleep
+    if(analysis_scheduler_pending() > 0) timeout_ms = 0;
+
+    uint32_t flags = furi_thread_flags_wait(ANALYSIS_FLAG_TASK | extra_flags, FuriFlagWaitAny,
+                                            timeout_ms);
+    if(flags & FuriFlagError) flags = 0;
+
+    return flags;
+}
+
+// Consumer: remove the most urgent task
+bool analysis_scheduler_pop(AnalysisTask_t* task) {
+    bool found = false;
+
+    uint32_t primask = critical_section_enter();
+    if(task_count > 0) {
+        *task = task_heap[0];
+        task_heap[0] = task_heap[--task_count];
+        heap_sift_down(0);
+        scheduler_stats.executed++;
+        found = true;
+    }
+    critical_section_exit(primask);
+
+    if(found && (int32_t)(furi_get_tick() - task->deadline_tick) > 0) {
+        scheduler_stats.deadline_misses++;
+        FURI_LOG_D(TAG, "%s ran %ld ms late", task_classes[task->type].name,
+                   (int32_t)(furi_get_tick() - task->deadline_tick));
+    }
+
+    return found;
+}
+
+// Tasks currently queued
+uint16_t analysis_scheduler_pending(void) {
+    return __atomic_load_n(&task_count, __ATOMIC_ACQUIRE);
+}
+
+// Drop all queued tasks
+void analysis_scheduler_clear(void) {
+    uint32_t primask = critical_section_enter();
+    task_count = 0;
+    critical_section_exit(primask);
+}
+
+AnalysisSchedulerStats_t analysis_scheduler_get_stats(void) {
+    AnalysisSchedulerStats_t stats;
+
+    uint32_t primask = critical_section_enter();
+    stats = scheduler_stats;
+    critical_section_exit(primask);
+
+    return stats;
+}
+
+const char* analysis_scheduler_task_name(AnalysisTaskType_t type) {
+    return (type < ANALYSIS_TASK_TYPE_COUNT) ? task_classes[type].name : "unknown";
+}
@@ -0,0 +1,76 @@
+#ifndef ANALYSIS_SCHEDULER_H
+#define ANALYSIS_SCHEDULER_H
+
+#include <furi.h>
+#include "flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// ANALYSIS TASK SCHEDULER
+// Bounded earliest-deadline-first queue feeding the analysis thread.
+// Producers (capture thread, UI, ISRs) submit tasks and raise a thread flag;
+// the analysis thread sleeps on that flag instead of polling. A submission of
+// a type that is already queued is coalesced into the queued task, so bursts
+// of frames cost one analysis pass.
+// ============================================================================
+
+#define ANALYSIS_QUEUE_DEPTH        16              // Bounded task heap
+#define ANALYSIS_BATCH_MAX          8               // Tasks run per wake before re-checking flags
+#define ANALYSIS_FLAG_TASK          (1UL << 0)      // Raised on every submit
+
+typedef enum {
+    ANALYSIS_TASK_FINGERPRINT_UPDATE = 0,   // Feed new frames to fingerprinting
+    ANALYSIS_TASK_PROTOCOL_INFER,           // Re-run protocol inference
+    ANALYSIS_TASK_THREAT_SCORE,             // Re-score threat assessment
+    ANALYSIS_TASK_SD_FLUSH,                 // Flush buffered log data to SD
+    ANALYSIS_TASK_UI_SNAPSHOT,              // Publish a display snapshot
+    ANALYSIS_TASK_TYPE_COUNT
+} AnalysisTaskType_t;
+
+typedef struct {
+    AnalysisTaskType_t type;
+    uint8_t priority;               // Tie-break when deadlines match (0 = most urgent)
+    uint16_t batch_count;           // Submissions coalesced into this task
+    uint32_t submit_tick;           // First submission
+    uint32_t deadline_tick;         // Earliest deadline of the coalesced submissions
+    uint32_t arg;                   // Type-specific, latest submission wins
+} AnalysisTask_t;
+
+typedef struct {
+    uint32_t submitted;
+    uint32_t coalesced;             // Submissions merged into a queued task
+    uint32_t dropped;               // Rejected because the queue was full
+    uint32_t executed;
+    uint32_t deadline_misses;       // Tasks popped after their deadline
+    uint16_t max_depth;
+} AnalysisSchedulerStats_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Initialization
+void analysis_scheduler_init(void);
+void analysis_scheduler_attach_consumer(FuriThreadId thread);
+
+// Producers (thread or ISR context). deadline_ms = 0 uses the type default.
+bool analysis_scheduler_submit(AnalysisTaskType_t type, uint32_t deadline_ms, uint32_t arg);
+
+// Consumer
+uint32_t analysis_scheduler_wait(uint32_t extra_flags, uint32_t timeout_ms);
+bool analysis_scheduler_pop(AnalysisTask_t* task);
+uint16_t analysis_scheduler_pending(void);
+void analysis_scheduler_clear(void);
+
+// Diagnostics
+AnalysisSchedulerStats_t analysis_scheduler_get_stats(void);
+const char* analysis_scheduler_task_name(AnalysisTaskType_t type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ANALYSIS_SCHEDULER_H
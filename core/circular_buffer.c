@@ -0,0 +1,142 @@
+#include "flipper_rf_lab.h"
+
+// ============================================================================
+// LOCK-FREE SPSC RING BUFFER
+// One producer (typically an ISR) and one consumer thread. head and tail are
+// free-running 32-bit counters; occupancy is (head - tail), which stays
+// correct across wrap-around because the size is a power of two.
+// ============================================================================
+
+// Acquire/release accessors - single-word loads/stores are atomic on Cortex-M4,
+// the barriers keep payload accesses ordered against the index publish.
+#define RING_LOAD_ACQUIRE(p)        __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define RING_STORE_RELEASE(p, v)    __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define RING_LOAD_RELAXED(p)        __atomic_load_n((p), __ATOMIC_RELAXED)
+
+// Initialize ring over caller-provided static storage
+void circular_buffer_init(CircularBuffer_t* cb, uint8_t* buffer, uint32_t size) {
+    if(!cb || !buffer || size == 0) return;
+
+    // Round down to a power of two so masking replaces modulo
+    while(size & (size - 1)) {
+        size &= size - 1;
+    }
+
+    cb->buffer = buffer;
+    cb->size = size;
+    cb->mask = size - 1;
+    cb->head = 0;
+    cb->tail = 0;
+    cb->dropped = 0;
+}
+
+// Producer: push single byte
+bool circular_buffer_write(CircularBuffer_t* cb, uint8_t data) {
+    uint32_t head = RING_LOAD_RELAXED(&cb->head);
+    uint32_t tail = RING_LOAD_ACQUIRE(&cb->tail);
+
+    if(head - tail >= cb->size) {
+        cb->dropped++;
+        return false;
+    }
+
+    cb->buffer[head & cb->mask] = data;
+    RING_STORE_RELEASE(&cb->head, head + 1);
+    return true;
+}
+
+// Consumer: pop single byte
+bool circular_buffer_read(CircularBuffer_t* cb, uint8_t* data) {
+    uint32_t tail = RING_LOAD_RELAXED(&cb->tail);
+    uint32_t head = RING_LOAD_ACQUIRE(&cb->head);
+
+    if(head == tail) return false;
+
+    *data = cb->buffer[tail & cb->mask];
+    RING_STORE_RELEASE(&cb->tail, tail + 1);
+    return true;
+}
+
+// Producer: push up to len bytes, returns bytes accepted (at most two memcpys)
+uint32_t circular_buffer_push_n(CircularBuffer_t* cb, const uint8_t* data, uint32_t len) {
+    uint32_t head = RING_LOAD_RELAXED(&cb->head);
+    uint32_t tail = RING_LOAD_ACQUIRE(&cb->tail);
+    uint32_t space = cb->size - (head - tail);
+
+    if(len > space) {
+        cb->dropped += len - space;
+        len = space;
+    }
+    if(len == 0) return 0;
+
+    uint32_t offset = head & cb->mask;
+    uint32_t first = cb->size - offset;
+    if(first > len) first = len;
+
+    memcpy(&cb->buffer[offset], data, first);
+    if(len > first) {
+        memcpy(cb->buffer, data + first, len - first);
+    }
+
+    RING_STORE_RELEASE(&cb->head, head + len);
+    return len;
+}
+
+// Consumer: pop up to len bytes, returns bytes copied
+uint32_t circular_buffer_pop_n(CircularBuffer_t* cb, uint8_t* data, uint32_t len) {
+    uint32_t tail = RING_LOAD_RELAXED(&cb->tail);
+    uint32_t head = RING_LOAD_ACQUIRE(&cb->head);
+    uint32_t available = head - tail;
+
+    if(len > available) len = available;
+    if(len == 0) return 0;
+
+    uint32_t offset = tail & cb->mask;
+    uint32_t first = cb->size - offset;
+    if(first > len) first = len;
+
+    memcpy(data, &cb->buffer[offset], first);
+    if(len > first) {
+        memcpy(data + first, cb->buffer, len - first);
+    }
+
+    RING_STORE_RELEASE(&cb->tail, tail + len);
+    return len;
+}
+
+// Consumer: expose the contiguous readable span without copying.
+// Call circular_buffer_consume() once the span has been processed.
+uint32_t circular_buffer_peek_span(CircularBuffer_t* cb, const uint8_t** span) {
+    uint32_t tail = RING_LOAD_RELAXED(&cb->tail);
+    uint32_t head = RING_LOAD_ACQUIRE(&cb->head);
+    uint32_t available = head - tail;
+    uint32_t offset = tail & cb->mask;
+    uint32_t contiguous = cb->size - offset;
+
+    *span = &cb->buffer[offset];
+    return (available < contiguous) ? available : contiguous;
+}
+
+// Consumer: release bytes previously obtained through peek_span
+void circular_buffer_consume(CircularBuffer_t* cb, uint32_t len) {
+    uint32_t tail = RING_LOAD_RELAXED(&cb->tail);
+    uint32_t head = RING_LOAD_ACQUIRE(&cb->head);
+
+    if(len > head - tail) len = head - tail;
+    RING_STORE_RELEASE(&cb->tail, tail + len);
+}
+
+// Bytes currently queued (safe from either side)
+uint32_t circular_buffer_count(CircularBuffer_t* cb) {
+    return RING_LOAD_ACQUIRE(&cb->head) - RING_LOAD_ACQUIRE(&cb->tail);
+}
+
+// Bytes that can still be pushed
+uint32_t circular_buffer_free(CircularBuffer_t* cb) {
+    return cb->size - circular_buffer_count(cb);
+}
+
+// Consumer: discard everything queued
+void circular_buffer_clear(CircularBuffer_t* cb) {
+    RING_STORE_RELEASE(&cb->tail, RING_LOAD_ACQUIRE(&cb->head));
+}
@@ -26,8 +26,8 @@ extern "C" {
 // BUFFER SIZES - STATIC ALLOCATION ONLY
 // ============================================================================
 
-#define PULSE_BUFFER_SIZE       8192            // 8KB for pulse timing data
 #define FRAME_BUFFER_SIZE       16384           // 16KB for frame storage
+#define RX_RING_BUFFER_SIZE     2048            // Packet records from DMA drain (power of 2)
 #define MAX_PULSE_COUNT         4096            // Maximum pulses per capture
 #define MAX_FRAME_COUNT         256             // Maximum frames in session
 #define MAX_CLUSTERS            5               // K-means clustering limit
@@ -44,9 +44,24 @@ extern "C" {
 #define MAX_PULSE_WIDTH_US      65535           // 16-bit pulse width limit
 #define MIN_PULSE_WIDTH_US      10              // Minimum detectable pulse
 #define FRAME_TIMEOUT_US        10000           // 10ms inter-frame gap
-#define SPECTRUM_DWELL_MS       10              // 10ms per frequency step
+#define SPECTRUM_DWELL_MS       10              // Dwell on channels above the noise floor
 #define SPECTRUM_RANGE_MHZ      628             // 300-928 MHz range
 
+// ============================================================================
+// WORKER THREAD EVENTS
+// Workers sleep on thread flags; these bounds only cap how long they sleep
+// ============================================================================
+
+#define WORKER_FLAG_STOP        (1UL << 15)     // Shut down the worker
+#define RF_FLAG_RX              (1UL << 1)      // GDO0 FIFO threshold / end of packet
+#define RF_FLAG_EDGES           (1UL << 2)      // Edge-capture DMA half/full transfer
+#define RF_IDLE_TIMEOUT_MS      20              // Safety drain if a GDO0 edge is missed
+#define RF_SWEEP_STEP_MS        1               // Yield between sweep slices
+#define RF_PASSIVE_CYCLE_MS     100             // Passive monitor duty cycle
+#define UI_FRAME_INTERVAL_MS    33              // Redraw cap, ~30 fps
+#define MAIN_TICK_MS            100             // System checks on the dispatcher tick
+#define TELEMETRY_INTERVAL_MS   1000
+
 // ============================================================================
 // SYSTEM STATES
 // ============================================================================
@@ -107,11 +122,26 @@ typedef struct {
     uint32_t timestamp_us;          // Absolute timestamp (1us resolution)
 } Pulse_t;
 
+// Packed pulse storage (2 bytes per pulse instead of 8):
+//   bit 15    level
+//   bit 14    coarse flag - width counted in 16 us units (long gaps)
+//   bits 0-13 width
+// Timestamps are not stored per pulse; they are running sums of widths,
+// re-anchored with an absolute timestamp every PULSE_ANCHOR_INTERVAL pulses.
+// Use the pulse_store_* accessors (core/pulse_store.h) to read it.
+#define PULSE_STORE_CAPACITY    8192            // Packed pulses per capture (power of 2)
+#define PULSE_ANCHOR_INTERVAL   64              // Pulses per absolute timestamp anchor
+#define PULSE_LEVEL_BIT         0x8000
+#define PULSE_COARSE_BIT        0x4000
+#define PULSE_WIDTH_MASK        0x3FFF
+#define PULSE_COARSE_SHIFT      4
+
 typedef struct {
-    Pulse_t pulses[MAX_PULSE_COUNT];
-    uint16_t count;
-    uint16_t head;
-    uint16_t tail;
+    uint16_t packed[PULSE_STORE_CAPACITY];                              // Level | scale | width
+    uint32_t anchors[PULSE_STORE_CAPACITY / PULSE_ANCHOR_INTERVAL];     // Absolute timestamps (us)
+    uint16_t count;                 // Occupancy snapshot (head - tail)
+    uint16_t head;                  // Producer index (free-running)
+    uint16_t tail;                  // Consumer index (free-running)
     bool overflow;
 } PulseBuffer_t;
 
@@ -132,8 +162,8 @@ typedef struct {
     bool crc_valid;                 // CRC validation result
 } Frame_t;
 
+// Frame payloads and metadata live in the shared session store (session_store.h)
 typedef struct {
-    Frame_t frames[MAX_FRAME_COUNT];
     uint16_t count;
     uint16_t current_idx;
     uint32_t session_start_us;
@@ -157,7 +187,7 @@ typedef struct {
 
 typedef struct {
     RFFingerprint_t fingerprints[MAX_DEVICE_DB_ENTRIES];
-    uint8_t count;
+    uint16_t count;
     char device_names[MAX_DEVICE_DB_ENTRIES][16];
     uint32_t last_seen[MAX_DEVICE_DB_ENTRIES];
     uint16_t match_count[MAX_DEVICE_DB_ENTRIES];
@@ -238,13 +268,16 @@ typedef struct {
 // CIRCULAR BUFFER
 // ============================================================================
 
+// Single-producer/single-consumer lock-free ring. Size must be a power of two;
+// head is only written by the producer (ISR), tail only by the consumer thread.
+// Indices run free and are masked on access, so full/empty need no extra flag.
 typedef struct {
     uint8_t* buffer;
     uint32_t size;
-    volatile uint32_t head;
-    volatile uint32_t tail;
-    volatile uint32_t count;
-    FuriMutex* mutex;
+    uint32_t mask;
+    volatile uint32_t head;           // Producer write index
+    volatile uint32_t tail;           // Consumer read index
+    volatile uint32_t dropped;        // Bytes rejected because the ring was full
 } CircularBuffer_t;
 
 // ============================================================================
@@ -262,7 +295,6 @@ typedef struct {
     
     // Circular buffers
     CircularBuffer_t rx_buffer;
-    CircularBuffer_t pulse_circ_buffer;
     
     // Current session
     Session_t current_session;
@@ -297,11 +329,16 @@ bool memory_pools_init(void);
 void* memory_pool_alloc(uint32_t size);
 void memory_pool_free(void* ptr);
 
-// Circular buffer operations
+// Circular buffer operations (SPSC, ISR-safe, no locks)
 void circular_buffer_init(CircularBuffer_t* cb, uint8_t* buffer, uint32_t size);
 bool circular_buffer_write(CircularBuffer_t* cb, uint8_t data);
 bool circular_buffer_read(CircularBuffer_t* cb, uint8_t* data);
+uint32_t circular_buffer_push_n(CircularBuffer_t* cb, const uint8_t* data, uint32_t len);
+uint32_t circular_buffer_pop_n(CircularBuffer_t* cb, uint8_t* data, uint32_t len);
+uint32_t circular_buffer_peek_span(CircularBuffer_t* cb, const uint8_t** span);
+void circular_buffer_consume(CircularBuffer_t* cb, uint32_t len);
 uint32_t circular_buffer_count(CircularBuffer_t* cb);
+uint32_t circular_buffer_free(CircularBuffer_t* cb);
 void circular_buffer_clear(CircularBuffer_t* cb);
 
 // Worker threads
@@ -322,9 +359,6 @@ void passive_monitor_cycle(void);
 bool has_pending_analysis(void);
 void process_next_analysis_task(void);
 
-// Display functions
-void update_display(void);
-
 // ============================================================================
 // EXTERN DECLARATIONS
 // ============================================================================
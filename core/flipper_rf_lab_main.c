@@ -2,15 +2,23 @@
 #include "hal/cc1101_driver.h"
 #include "hal/gpio_manager.h"
 #include "hal/timer_precision.h"
+#include "hal/edge_capture.h"
+#include "session_store.h"
+#include "analysis_scheduler.h"
+#include "spectrum_sweep.h"
+#include "ui_snapshot.h"
+#include "profiler.h"
 #include "math/fixed_point.h"
 #include "math/statistics.h"
 #include "storage/sd_manager.h"
+#include "storage/sd_writer.h"
 #include "storage/compression.h"
 #include "analysis/fingerprinting.h"
 #include "analysis/clustering.h"
 #include "analysis/threat_model.h"
 #include "analysis/protocol_infer.h"
 #include "ui/main_menu.h"
+#include "ui/live_view.h"
 #include "research/telemetry.h"
 
 #include <gui/gui.h>
@@ -22,8 +30,9 @@
 
 // Statically allocated buffers - NO dynamic allocation after init
 static uint8_t dma_buffer[SPI_DMA_BUFFER_SIZE] __attribute__((aligned(4)));
-static uint8_t pulse_buffer[PULSE_BUFFER_SIZE] __attribute__((aligned(4)));
+static PulseBuffer_t pulse_buffer __attribute__((aligned(4)));
 static uint8_t frame_buffer[FRAME_BUFFER_SIZE] __attribute__((aligned(4)));
+static uint8_t rx_ring_storage[RX_RING_BUFFER_SIZE] __attribute__((aligned(4)));
 
 // Platform context - single global instance
 static FlipperRFLabContext platform_context = {0};
@@ -32,17 +41,24 @@ static FlipperRFLabContext platform_context = {0};
 static FuriThread* rf_capture_thread = NULL;
 static FuriThread* ui_update_thread = NULL;
 static FuriThread* analysis_thread = NULL;
+static FuriThread* storage_thread = NULL;
 
 // GUI handles
 static Gui* gui = NULL;
 static ViewDispatcher* view_dispatcher = NULL;
 static NotificationApp* notifications = NULL;
 
+// Profiler zone per analysis task type
+static ProfilerZoneId_t analysis_zones[ANALYSIS_TASK_TYPE_COUNT];
+
 // Function prototypes
 static int32_t rf_capture_worker(void* context);
 static int32_t ui_update_worker(void* context);
 static int32_t analysis_worker(void* context);
+static int32_t storage_worker(void* context);
 static void update_system_telemetry(void);
+static void stop_worker(FuriThread* thread);
+static void main_tick_callback(void* context);
 
 // ============================================================================
 // INITIALIZATION
@@ -54,20 +70,23 @@ static bool flipper_rf_lab_init(void) {
     // Initialize memory pools (static allocation only)
     platform_context.dma_buffer = dma_buffer;
     platform_context.dma_buffer_size = SPI_DMA_BUFFER_SIZE;
-    platform_context.pulse_buffer = pulse_buffer;
-    platform_context.pulse_buffer_size = PULSE_BUFFER_SIZE;
+    platform_context.pulse_buffer = (uint8_t*)&pulse_buffer;
+    platform_context.pulse_buffer_size = sizeof(pulse_buffer);
     platform_context.frame_buffer = frame_buffer;
     platform_context.frame_buffer_size = FRAME_BUFFER_SIZE;
     
     // Initialize circular buffers
-    circular_buffer_init(&platform_context.rx_buffer, dma_buffer, SPI_DMA_BUFFER_SIZE);
-    circular_buffer_init(&platform_context.pulse_circ_buffer, pulse_buffer, PULSE_BUFFER_SIZE);
+    circular_buffer_init(&platform_context.rx_buffer, rx_ring_storage, RX_RING_BUFFER_SIZE);
     
     // Initialize hardware abstraction layer
     if(cc1101_driver_init() != FuriStatusOk) {
         FURI_LOG_E(TAG, "CC1101 driver initialization failed");
         return false;
     }
+    cc1101_attach_rx_ring(&platform_context.rx_buffer);
+    
+    // DMA FIFO drain into the RX ring
+    cc1101_dma_init(dma_buffer, SPI_DMA_BUFFER_SIZE);
     
     if(gpio_manager_init() != FuriStatusOk) {
         FURI_LOG_E(TAG, "GPIO manager initialization failed");
@@ -77,6 +96,28 @@ static bool flipper_rf_lab_init(void) {
     // Initialize precision timing (DWT cycle counter)
     timer_precision_init();
     
+    // Cycle profiler; the one-shot trace covers the first zones of the run
+    profiler_init();
+    for(uint8_t type = 0; type < ANALYSIS_TASK_TYPE_COUNT; type++) {
+        analysis_zones[type] = profiler_zone_register(analysis_scheduler_task_name(type));
+    }
+    profiler_trace_arm();
+    
+    // Binary event log (timestamps from the DWT counter)
+    telemetry_init();
+    
+    // Hardware input-capture pulse timestamping on GDO2
+    if(edge_capture_init(&pulse_buffer) != FuriStatusOk) {
+        FURI_LOG_E(TAG, "Edge capture initialization failed");
+        return false;
+    }
+    
+    // Shared session store - one copy of frames and pulses for all engines
+    if(session_store_init(frame_buffer, FRAME_BUFFER_SIZE, &pulse_buffer) != FuriStatusOk) {
+        FURI_LOG_E(TAG, "Session store initialization failed");
+        return false;
+    }
+    
     // Initialize fixed-point math library
     fixed_point_init();
     
@@ -84,6 +125,8 @@ static bool flipper_rf_lab_init(void) {
     if(sd_manager_init() != FuriStatusOk) {
         FURI_LOG_E(TAG, "SD manager initialization failed");
         // Non-fatal - can still operate without SD
+    } else if(sd_writer_init() != FuriStatusOk) {
+        FURI_LOG_E(TAG, "SD writer initialization failed");
     }
     
     // Initialize analysis engines
@@ -107,12 +150,23 @@ static bool flipper_rf_lab_init(void) {
     view_dispatcher = view_dispatcher_alloc();
     view_dispatcher_attach_to_gui(view_dispatcher, gui, ViewDispatcherTypeFullscreen);
     
-    // Initialize main menu
+    // Initialize main menu and the live analysis view
     main_menu_init(view_dispatcher);
+    live_view_init(view_dispatcher);
+    
+    // System checks run on the dispatcher's tick, on the main thread
+    view_dispatcher_set_event_callback_context(view_dispatcher, &platform_context);
+    view_dispatcher_set_tick_event_callback(view_dispatcher, main_tick_callback, MAIN_TICK_MS);
     
     // Get notification service
     notifications = furi_record_open(RECORD_NOTIFICATION);
     
+    // Event-driven analysis queue (consumer attaches when the thread starts)
+    analysis_scheduler_init();
+    
+    // Display snapshots published by analysis (reader attaches when the UI thread starts)
+    ui_snapshot_init();
+    
     // Create worker threads
     rf_capture_thread = furi_thread_alloc();
     furi_thread_set_name(rf_capture_thread, "RF_Capture");
@@ -132,6 +186,12 @@ static bool flipper_rf_lab_init(void) {
     furi_thread_set_callback(analysis_thread, analysis_worker);
     furi_thread_set_context(analysis_thread, &platform_context);
     
+    storage_thread = furi_thread_alloc();
+    furi_thread_set_name(storage_thread, "SD_Writer");
+    furi_thread_set_stack_size(storage_thread, MAX_STACK_DEPTH);
+    furi_thread_set_callback(storage_thread, storage_worker);
+    furi_thread_set_context(storage_thread, &platform_context);
+    
     FURI_LOG_I(TAG, "Flipper RF Lab initialized successfully");
     return true;
 }
@@ -140,58 +200,155 @@ static bool flipper_rf_lab_init(void) {
 // WORKER THREADS
 // ============================================================================
 
+// Longest the capture thread may sleep before its periodic duties are due
+static uint32_t rf_capture_timeout_ms(const FlipperRFLabContext* ctx) {
+    if(ctx->rf_config.band == BAND_CUSTOM) return RF_SWEEP_STEP_MS;
+    if(ctx->low_power_mode) return RF_PASSIVE_CYCLE_MS;
+    return RF_IDLE_TIMEOUT_MS;
+}
+
+// Raw OOK/ASK reception timestamps GDO2 edges instead of reading packets.
+// Async serial mode has no FIFO and GDO2 can carry only one signal, so
+// packet DMA is released first and resumed once edge capture stops (the
+// deinit/init pairs keep each side's IOCFG2 save and restore consistent).
+static bool rf_capture_wants_edges(const FlipperRFLabContext* ctx) {
+    if(ctx->rf_config.band == BAND_CUSTOM) return false;
+    return ctx->rf_config.modulation == MOD_OOK || ctx->rf_config.modulation == MOD_ASK;
+}
+
+static void rf_capture_update_mode(const FlipperRFLabContext* ctx) {
+    bool want_edges = rf_capture_wants_edges(ctx);
+    if(want_edges == edge_capture_is_running()) return;
+    
+    if(want_edges) {
+        cc1101_dma_deinit();
+        if(!edge_capture_start()) {
+            FURI_LOG_W(TAG, "Edge capture unavailable, staying in packet mode");
+            cc1101_dma_init(dma_buffer, SPI_DMA_BUFFER_SIZE);
+        }
+    } else {
+        // Stopping flushes the pending edges, so infer on them once more
+        edge_capture_stop();
+        analysis_scheduler_submit(ANALYSIS_TASK_PROTOCOL_INFER, 0, 0);
+        cc1101_dma_init(dma_buffer, SPI_DMA_BUFFER_SIZE);
+    }
+}
+
+// Close the full session and continue in the same store. Frames were already
+// streamed to the capture file; the engines see the new generation.
+static void capture_session_rollover(FlipperRFLabContext* ctx) {
+    FURI_LOG_I(TAG, "Session full at %u frames, rolling over", session_store_frame_count());
+    session_store_reset();
+    ctx->current_session.count = 0;
+}
+
 static int32_t rf_capture_worker(void* context) {
     FlipperRFLabContext* ctx = (FlipperRFLabContext*)context;
-    UNUSED(ctx);
+    FuriThreadId self = furi_thread_get_current_id();
     
     FURI_LOG_I(TAG, "RF capture worker started");
     
+    // GDO0 and edge-capture DMA interrupts wake this thread
+    cc1101_set_rx_notify(self, RF_FLAG_RX);
+    edge_capture_set_notify(self, RF_FLAG_EDGES);
+    profiler_thread_register("RF_Capture");
+    
+    uint32_t shown_sweeps = 0;
+    
     while(1) {
-        // Check for RF activity
+        profiler_thread_idle();
+        uint32_t flags = furi_thread_flags_wait(RF_FLAG_RX | RF_FLAG_EDGES | WORKER_FLAG_STOP,
+                                                FuriFlagWaitAny, rf_capture_timeout_ms(ctx));
+        profiler_thread_active();
+        if(flags & FuriFlagError) flags = 0;  // Timeout
+        if(flags & WORKER_FLAG_STOP) break;
+        
+        rf_capture_update_mode(ctx);
+        
+        // Drain RX FIFO if GDO0 signalled threshold / end of packet
+        cc1101_dma_service();
+        
+        // Move completed packets into the session and queue their analysis
         if(cc1101_has_data()) {
             capture_frame_burst();
         }
         
+        // Fold pending captures into the pulse store and queue inference on new pulses.
+        // The previous batch was already queued, so a full store rolls first.
+        if(edge_capture_is_running()) {
+            if(session_store_is_full()) capture_session_rollover(ctx);
+            if(edge_capture_poll() > 0) {
+                analysis_scheduler_submit(ANALYSIS_TASK_PROTOCOL_INFER, 0, 0);
+            }
+        }
+        
         // Spectrum sweep mode
         if(ctx->rf_config.band == BAND_CUSTOM) {
             spectrum_sweep_step();
+            
+            // Publish the spectrum once per completed sweep
+            uint32_t sweeps = spectrum_sweep_view().sweeps;
+            if(sweeps != shown_sweeps) {
+                analysis_scheduler_submit(ANALYSIS_TASK_UI_SNAPSHOT, 0, sweeps);
+                shown_sweeps = sweeps;
+            }
+        } else if(spectrum_sweep_is_running()) {
+            spectrum_sweep_stop();
         }
         
         // Passive monitoring mode
         if(ctx->low_power_mode) {
             passive_monitor_cycle();
         }
-        
-        // Yield to other tasks
-        furi_delay_us(100);
     }
     
+    if(edge_capture_is_running()) edge_capture_stop();
+    cc1101_set_rx_notify(NULL, 0);
+    edge_capture_set_notify(NULL, 0);
     return 0;
 }
 
+// Redraws only when analysis has published a newer snapshot, at most once
+// per UI_FRAME_INTERVAL_MS. Input is handled by the view on the GUI thread.
 static int32_t ui_update_worker(void* context) {
     FlipperRFLabContext* ctx = (FlipperRFLabContext*)context;
     UNUSED(ctx);
     
     FURI_LOG_I(TAG, "UI update worker started");
+    ui_snapshot_set_reader(furi_thread_get_current_id());
+    profiler_thread_register("UI_Update");
     
-    uint32_t last_update = furi_get_tick();
+    uint32_t shown_version = 0;
     
     while(1) {
-        uint32_t now = furi_get_tick();
-        
-        // Update display at 30fps (33ms interval)
-        if(now - last_update >= 33) {
-            update_display();
-            last_update = now;
+        // Sleep until the next publish
+        if(ui_snapshot_version() == shown_version) {
+            profiler_thread_idle();
+            uint32_t flags = furi_thread_flags_wait(UI_SNAPSHOT_FLAG | WORKER_FLAG_STOP,
+                                                    FuriFlagWaitAny, FuriWaitForever);
+            profiler_thread_active();
+            if(!(flags & FuriFlagError) && (flags & WORKER_FLAG_STOP)) break;
+            continue;
         }
         
-        // Process user input
-        view_dispatcher_run(view_dispatcher);
+        uint32_t frame_start = furi_get_tick();
+        {
+            PROFILE_SCOPE("ui_frame");
+            shown_version = live_view_update(shown_version);
+        }
         
-        furi_delay_us(1000);
+        // Publishes during the rest of the frame interval are drawn together
+        uint32_t elapsed = furi_get_tick() - frame_start;
+        if(elapsed < UI_FRAME_INTERVAL_MS) {
+            profiler_thread_idle();
+            uint32_t flags = furi_thread_flags_wait(WORKER_FLAG_STOP, FuriFlagWaitAny,
+                                                    UI_FRAME_INTERVAL_MS - elapsed);
+            profiler_thread_active();
+            if(!(flags & FuriFlagError) && (flags & WORKER_FLAG_STOP)) break;
+        }
     }
     
+    ui_snapshot_set_reader(NULL);
     return 0;
 }
 
@@ -201,25 +358,183 @@ static int32_t analysis_worker(void* context) {
     
     FURI_LOG_I(TAG, "Analysis worker started");
     
+    analysis_scheduler_attach_consumer(furi_thread_get_current_id());
+    profiler_thread_register("Analysis");
+    uint32_t last_telemetry = furi_get_tick();
+    
     while(1) {
-        if(has_pending_analysis()) {
+        // Sleep until a task is queued or telemetry is due
+        uint32_t elapsed = furi_get_tick() - last_telemetry;
+        uint32_t timeout = (elapsed < TELEMETRY_INTERVAL_MS) ? TELEMETRY_INTERVAL_MS - elapsed : 0;
+        profiler_thread_idle();
+        uint32_t flags = analysis_scheduler_wait(WORKER_FLAG_STOP, timeout);
+        profiler_thread_active();
+        if(flags & WORKER_FLAG_STOP) break;
+        
+        // Run a bounded batch, most urgent deadline first
+        for(uint8_t i = 0; i < ANALYSIS_BATCH_MAX && has_pending_analysis(); i++) {
             process_next_analysis_task();
         }
         
         // Update telemetry periodically
-        static uint32_t last_telemetry = 0;
         uint32_t now = furi_get_tick();
-        if(now - last_telemetry >= 1000) {  // Every second
+        if(now - last_telemetry >= TELEMETRY_INTERVAL_MS) {
             update_system_telemetry();
             last_telemetry = now;
         }
+    }
+    
+    analysis_scheduler_attach_consumer(NULL);
+    return 0;
+}
+
+// The only thread that writes streamed data to the card
+static int32_t storage_worker(void* context) {
+    UNUSED(context);
+    
+    FURI_LOG_I(TAG, "Storage worker started");
+    
+    sd_writer_attach_consumer(furi_thread_get_current_id());
+    profiler_thread_register("SD_Writer");
+    
+    while(1) {
+        profiler_thread_idle();
+        uint32_t flags = sd_writer_wait(WORKER_FLAG_STOP);
+        profiler_thread_active();
+        if(flags & WORKER_FLAG_STOP) break;
         
-        furi_delay_us(100);
+        PROFILE_SCOPE("sd_service");
+        sd_writer_service();
     }
     
+    // Producers are stopped first, so this writes everything they queued
+    sd_writer_flush();
+    sd_writer_attach_consumer(NULL);
     return 0;
 }
 
+// ============================================================================
+// CAPTURE FUNCTIONS
+// ============================================================================
+
+// Queue a frame record (metadata + payload) to the session capture file. The
+// writer refuses it rather than blocking when the card falls behind.
+static void record_frame(const SessionFrameMeta_t* meta, const uint8_t* payload) {
+    uint8_t record[sizeof(SessionFrameMeta_t) + SESSION_PAYLOAD_STRIDE];
+    
+    memcpy(record, meta, sizeof(SessionFrameMeta_t));
+    memcpy(record + sizeof(SessionFrameMeta_t), payload, meta->length);
+    sd_writer_append(SD_WRITER_STREAM_CAPTURE, record, sizeof(SessionFrameMeta_t) + meta->length);
+}
+
+// Move completed packet records from the RX ring straight into session store slots
+void capture_frame_burst(void) {
+    FlipperRFLabContext* ctx = &platform_context;
+    Session_t* session = &ctx->current_session;
+    CC1101RxRecord_t record;
+    SessionFrameMeta_t* meta;
+    uint8_t* payload;
+    PROFILE_SCOPE("rx_burst");
+    
+    // Roll only with a record waiting, so the last frames of a full session
+    // are still queued for analysis before the store is reused
+    while(cc1101_has_data()) {
+        if(session_store_is_full()) capture_session_rollover(ctx);
+        
+        payload = session_store_reserve_frame(&meta);
+        if(!payload || !cc1101_pop_rx_record(&record, payload, SESSION_PAYLOAD_STRIDE)) {
+            break;
+        }
+        
+        meta->length = (record.length > SESSION_PAYLOAD_STRIDE) ? SESSION_PAYLOAD_STRIDE : record.length;
+        meta->timestamp_us = record.timestamp_cycles / DWT_CYCCNT_US;
+        meta->rssi_dbm = (uint16_t)cc1101_rssi_to_dbm(record.rssi);
+        meta->frequency_hz = ctx->rf_config.frequency_hz;
+        meta->crc_valid = (record.lqi & 0x80) != 0;
+        session_store_commit_frame();
+        
+        // GDO0 interrupt to frame in the session store
+        PROFILE_RECORD("rx_latency", DWT_CYCCNT - record.timestamp_cycles);
+        
+        if(sd_writer_stream_is_open(SD_WRITER_STREAM_CAPTURE) && !sd_writer_congested()) {
+            record_frame(meta, payload);
+        }
+        
+        ctx->total_captures++;
+    }
+    
+    uint16_t frame_count = session_store_frame_count();
+    if(frame_count == session->count) return;
+    TELEMETRY_LOG(TELEM_EVENT_FRAME_DETECTED, "RX_BURST", frame_count - session->count, frame_count);
+    session->count = frame_count;
+    
+    // New frames: queue the engines that consume them (coalesced per burst)
+    analysis_scheduler_submit(ANALYSIS_TASK_FINGERPRINT_UPDATE, 0, frame_count);
+    analysis_scheduler_submit(ANALYSIS_TASK_PROTOCOL_INFER, 0, frame_count);
+    analysis_scheduler_submit(ANALYSIS_TASK_THREAT_SCORE, 0, frame_count);
+    analysis_scheduler_submit(ANALYSIS_TASK_SD_FLUSH, 0, frame_count);
+}
+
+// ============================================================================
+// ANALYSIS FUNCTIONS
+// ============================================================================
+
+bool has_pending_analysis(void) {
+    return analysis_scheduler_pending() > 0;
+}
+
+// Run the most urgent queued task against the current session views
+void process_next_analysis_task(void) {
+    AnalysisTask_t task;
+    if(!analysis_scheduler_pop(&task)) return;
+    
+    ProfilerZoneId_t zone = (task.type < ANALYSIS_TASK_TYPE_COUNT) ?
+        analysis_zones[task.type] : PROFILER_ZONE_NONE;
+    profiler_zone_enter(zone);
+    
+    switch(task.type) {
+        case ANALYSIS_TASK_FINGERPRINT_UPDATE:
+            if(fingerprinting_is_capturing()) {
+                SessionFrameView_t frames = session_store_frames();
+                fingerprinting_process_frames(&frames);
+            }
+            break;
+        
+        case ANALYSIS_TASK_PROTOCOL_INFER: {
+            SessionPulseView_t pulses = session_store_pulses();
+            SessionFrameView_t frames = session_store_frames();
+            protocol_infer_stream_pulses(&pulses);
+            protocol_infer_stream_frames(&frames);
+            protocol_infer_refresh_hypothesis();
+            analysis_scheduler_submit(ANALYSIS_TASK_UI_SNAPSHOT, 0, frames.count);
+            break;
+        }
+        
+        case ANALYSIS_TASK_THREAT_SCORE:
+            if(threat_model_is_analyzing()) {
+                SessionFrameView_t frames = session_store_frames();
+                threat_model_set_frames(&frames);
+                threat_model_assess_vulnerabilities();
+                analysis_scheduler_submit(ANALYSIS_TASK_UI_SNAPSHOT, 0, frames.count);
+            }
+            break;
+        
+        case ANALYSIS_TASK_SD_FLUSH:
+            sd_manager_flush_rolling_log();
+            fingerprinting_flush_database();
+            break;
+        
+        case ANALYSIS_TASK_UI_SNAPSHOT:
+            ui_snapshot_refresh();
+            break;
+        
+        default:
+            break;
+    }
+    
+    profiler_zone_exit(zone);
+}
+
 // ============================================================================
 // SYSTEM FUNCTIONS
 // ============================================================================
@@ -227,24 +542,29 @@ static int32_t analysis_worker(void* context) {
 static void update_system_telemetry(void) {
     FlipperRFLabContext* ctx = &platform_context;
     
-    // Calculate CPU load using DWT cycle counter
-    uint32_t active_cycles = dwt_get_active_cycles();
-    uint32_t total_cycles = SYSTEM_CORE_CLOCK / 100;  // 10ms worth of cycles
+    // Busy time of the worker threads and hooked ISRs since the last call
+    ctx->telemetry.cpu_load_percent = profiler_cpu_sample();
+    telemetry_update_cpu_load(ctx->telemetry.cpu_load_percent);
     
-    ctx->telemetry.cpu_load_percent = (active_cycles * 100) / total_cycles;
-    if(ctx->telemetry.cpu_load_percent > 100) {
-        ctx->telemetry.cpu_load_percent = 100;
+    // GDO0 entry latency from the previous probe, then take a new sample
+    ProfilerIsrStats_t gdo0;
+    if(profiler_get_isr_stats(PROFILER_ISR_GDO0, &gdo0) && gdo0.probes > 0) {
+        ctx->telemetry.isr_latency_max_us = gdo0.latency_max_cycles / DWT_CYCCNT_US;
+        telemetry_update_isr_latency(gdo0.latency_last_cycles / DWT_CYCCNT_US);
     }
-    
-    // Reset cycle counter for next measurement
-    dwt_reset_cycle_counter();
+    cc1101_probe_isr_latency();
     
     // Update buffer utilization
     ctx->telemetry.buffer_utilization = 
-        (circular_buffer_count(&ctx->rx_buffer) * 100) / SPI_DMA_BUFFER_SIZE;
+        (circular_buffer_count(&ctx->rx_buffer) * 100) / ctx->rx_buffer.size;
+    
+    // Update radio counters
+    CC1101DmaStats_t dma_stats = cc1101_dma_get_stats();
+    ctx->telemetry.dma_transfer_count = dma_stats.dma_transfers;
     
     // Update uptime
     ctx->telemetry.uptime_seconds = furi_get_tick() / 1000;
+    telemetry_update_system_metrics();
     
     // Log telemetry if in debug mode
     FURI_LOG_D(TAG, "CPU: %lu%%, Buffer: %lu%%, Uptime: %lu s",
@@ -253,6 +573,28 @@ static void update_system_telemetry(void) {
                ctx->telemetry.uptime_seconds);
 }
 
+// Wake a worker with the stop flag and wait for it to exit
+static void stop_worker(FuriThread* thread) {
+    furi_thread_flags_set(furi_thread_get_id(thread), WORKER_FLAG_STOP);
+    furi_thread_join(thread);
+}
+
+// Dispatcher tick (main thread): system state checks
+static void main_tick_callback(void* context) {
+    FlipperRFLabContext* ctx = (FlipperRFLabContext*)context;
+    
+    // Special case: custom band = shutdown request
+    if(ctx->current_session.config.band == BAND_CUSTOM) {
+        view_dispatcher_stop(view_dispatcher);
+        return;
+    }
+    
+    // Enter low power if battery critical
+    if(ctx->telemetry.battery_voltage < 3.3f) {
+        enter_low_power_mode();
+    }
+}
+
 static void enter_low_power_mode(void) {
     FURI_LOG_I(TAG, "Entering low power mode");
     
@@ -283,37 +625,43 @@ int32_t flipper_rf_lab_main(void* p) {
     furi_thread_start(rf_capture_thread);
     furi_thread_start(ui_update_thread);
     furi_thread_start(analysis_thread);
+    furi_thread_start(storage_thread);
     
     FURI_LOG_I(TAG, "All workers started, entering main loop");
     
-    // Main loop - handle system state changes
-    while(1) {
-        // Check for shutdown signal
-        if(platform_context.current_session.config.band == BAND_CUSTOM) {
-            // Special case: custom band = shutdown request
-            break;
-        }
-        
-        // Enter low power if battery critical
-        if(platform_context.telemetry.battery_voltage < 3.3f) {
-            enter_low_power_mode();
-        }
-        
-        furi_delay_ms(100);
-    }
+    // Input, drawing and the system tick run here until Back on the main
+    // menu or a shutdown request stops the dispatcher
+    view_dispatcher_run(view_dispatcher);
     
     // Cleanup
     FURI_LOG_I(TAG, "Shutting down...");
     
+    stop_worker(rf_capture_thread);
+    stop_worker(ui_update_thread);
+    stop_worker(analysis_thread);
+    stop_worker(storage_thread);
+    
     furi_thread_free(rf_capture_thread);
     furi_thread_free(ui_update_thread);
     furi_thread_free(analysis_thread);
+    furi_thread_free(storage_thread);
     
+    live_view_deinit();
+    main_menu_deinit();
     view_dispatcher_free(view_dispatcher);
     furi_record_close(RECORD_GUI);
     furi_record_close(RECORD_NOTIFICATION);
     
+    fingerprinting_engine_deinit();
+    profiler_print_to_console();
+    profiler_trace_dump("profile_trace.bin");
+    telemetry_deinit();
+    sd_writer_deinit();
     sd_manager_deinit();
+    session_store_deinit();
+    edge_capture_deinit();
+    spectrum_sweep_stop();
+    cc1101_attach_rx_ring(NULL);
     cc1101_driver_deinit();
     
     FURI_LOG_I(TAG, "Shutdown complete");
@@ -1,7 +1,10 @@
 #include "cc1101_driver.h"
+#include "timer_precision.h"
+#include "../profiler.h"
 #include <furi_hal_spi.h>
 #include <furi_hal_gpio.h>
 #include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_exti.h>
 
 #define TAG "CC1101"
 
@@ -15,6 +18,8 @@
 #define CC1101_SPI_TIMEOUT  1000    // 1ms SPI timeout
 #define CC1101_RESET_DELAY_US 100   // Reset delay
 #define CC1101_CALIBRATE_TIME_US 750 // Calibration time
+#define CC1101_STATE_POLL_LIMIT 100 // MARCSTATE polls while the SPI lock is held
+#define CC1101_RSSI_OFFSET_DB 74    // RSSI offset, datasheet table 31 (433 MHz)
 
 // Static state
 static volatile bool cc1101_initialized = false;
@@ -23,6 +28,43 @@ static CC1101Config_t current_config;
 static FuriMutex* spi_mutex = NULL;
 static volatile uint32_t isr_count = 0;
 static volatile uint8_t last_rssi = 0;
+static CircularBuffer_t* rx_ring = NULL;
+static volatile FuriThreadId rx_notify_thread = NULL;
+static uint32_t rx_notify_flags = 0;
+
+// DMA receive state
+static uint8_t* dma_rx_buffer = NULL;
+static uint16_t dma_rx_size = 0;
+static volatile bool dma_rx_enabled = false;
+static volatile bool dma_in_flight = false;
+static volatile bool fifo_irq_pending = false;
+static volatile uint32_t fifo_irq_timestamp = 0;
+static volatile bool latency_probe_pending = false;   // Next GDO0 entry may be a software probe
+static CC1101DmaStats_t dma_stats;
+static uint8_t saved_iocfg0 = 0;
+static uint8_t saved_iocfg2 = 0;
+static uint8_t saved_fifothr = 0;
+
+// Packet reassembly across FIFO-threshold chunks:
+// [record header][length byte][payload][rssi][lqi]
+static uint8_t rx_assembly[sizeof(CC1101RxRecord_t) + 1 + 255 + 2];
+static uint16_t rx_assembly_count = 0;
+static uint16_t rx_assembly_expected = 0;
+
+// Shadow of the configuration registers as committed to the chip. Reads of
+// non-volatile registers are served from here, so read-modify-write costs no
+// SPI read.
+static uint8_t reg_shadow[CC1101_CONFIG_REG_COUNT];
+static bool shadow_valid = false;
+
+// Open register transaction (recursive mutex held by the owner). Queued
+// values stay in txn_pending until commit; only the owner sees them.
+static FuriMutex* txn_mutex = NULL;
+static volatile FuriThreadId txn_owner = NULL;
+static uint8_t txn_depth = 0;
+static uint64_t txn_dirty = 0;      // Bit n set = register n queued
+static uint8_t txn_pending[CC1101_CONFIG_REG_COUNT];
+static CC1101TxnStats_t txn_stats;
 
 // Preset configurations (register values for common settings)
 // 433.92 MHz, 2.4 kbps, OOK
@@ -57,11 +99,130 @@ const uint8_t CC1101_CONFIG_315_ASK[] = {
     0x16, 0x17, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
-// ISR handler for GDO0 (packet detection)
+// ISR handler for GDO0 (FIFO threshold / end of packet)
+// Only latches a timestamp and a drain request; all SPI traffic happens in the
+// capture thread so the ISR never contends for the bus or a mutex.
 static void cc1101_gdo0_isr(void* context) {
     UNUSED(context);
+    uint32_t enter_cycles = profiler_isr_enter(PROFILER_ISR_GDO0);
+    
+    // A probe on an idle line only measures entry; it must not wake a drain
+    // or lend its timestamp to the next packet
+    if(__atomic_exchange_n(&latency_probe_pending, false, __ATOMIC_ACQ_REL) &&
+       !furi_hal_gpio_read(CC1101_GDO0_PIN)) {
+        profiler_isr_exit(PROFILER_ISR_GDO0, enter_cycles);
+        return;
+    }
     isr_count++;
-    last_rssi = cc1101_read_rssi_live();
+
+    if(!fifo_irq_pending) {
+        fifo_irq_timestamp = DWT_CYCCNT;
+    }
+    fifo_irq_pending = true;
+
+    // Wake the capture thread instead of letting it poll
+    FuriThreadId thread = rx_notify_thread;
+    if(thread) {
+        furi_thread_flags_set(thread, rx_notify_flags);
+    }
+    
+    profiler_isr_exit(PROFILER_ISR_GDO0, enter_cycles);
+}
+
+// Pend the GDO0 EXTI line in software to sample interrupt entry latency. The
+// ISR returns straight after its entry hook unless GDO0 is really asserted.
+void cc1101_probe_isr_latency(void) {
+    if(!cc1101_initialized) return;
+    
+    __atomic_store_n(&latency_probe_pending, true, __ATOMIC_RELEASE);
+    profiler_isr_arm_probe(PROFILER_ISR_GDO0);
+    LL_EXTI_GenerateSWI_0_31((CC1101_GDO0_PIN)->pin);
+}
+
+// Attach the ring that receives completed packet records (NULL to detach)
+void cc1101_attach_rx_ring(CircularBuffer_t* ring) {
+    rx_ring = ring;
+}
+
+// Thread flags raised from the GDO0 ISR when the FIFO needs draining (NULL to stop)
+void cc1101_set_rx_notify(FuriThreadId thread, uint32_t flags) {
+    rx_notify_flags = flags;
+    rx_notify_thread = thread;
+}
+
+// Check whether at least one packet record is queued
+bool cc1101_has_data(void) {
+    CircularBuffer_t* ring = rx_ring;
+    return ring && circular_buffer_count(ring) >= sizeof(CC1101RxRecord_t);
+}
+
+// Pop the next packet record; payload beyond max_len is discarded
+bool cc1101_pop_rx_record(CC1101RxRecord_t* record, uint8_t* payload, uint8_t max_len) {
+    CircularBuffer_t* ring = rx_ring;
+    if(!ring || circular_buffer_count(ring) < sizeof(CC1101RxRecord_t)) return false;
+
+    circular_buffer_pop_n(ring, (uint8_t*)record, sizeof(CC1101RxRecord_t));
+
+    uint8_t copy = (record->length < max_len) ? record->length : max_len;
+    circular_buffer_pop_n(ring, payload, copy);
+    circular_buffer_consume(ring, record->length - copy);
+
+    return true;
+}
+
+// ============================================================================
+// SPI FRAMES AND SHADOW REGISTERS
+// ============================================================================
+
+// Unlocked frame helpers (caller holds spi_mutex and the SPI bus)
+static void cc1101_frame_tx(uint8_t header, const uint8_t* data, uint8_t len) {
+    furi_hal_gpio_write(CC1101_CS_PIN, false);
+    furi_delay_us(1);
+    furi_hal_spi_bus_tx(CC1101_SPI_HANDLE, &header, 1, CC1101_SPI_TIMEOUT);
+    if(len > 0) furi_hal_spi_bus_tx(CC1101_SPI_HANDLE, data, len, CC1101_SPI_TIMEOUT);
+    furi_hal_gpio_write(CC1101_CS_PIN, true);
+}
+
+static uint8_t cc1101_frame_read_status(uint8_t reg) {
+    uint8_t addr = (reg & 0x3F) | CC1101_READ_BURST;
+    uint8_t value = 0;
+    
+    furi_hal_gpio_write(CC1101_CS_PIN, false);
+    furi_delay_us(1);
+    furi_hal_spi_bus_tx(CC1101_SPI_HANDLE, &addr, 1, CC1101_SPI_TIMEOUT);
+    furi_hal_spi_bus_rx(CC1101_SPI_HANDLE, &value, 1, CC1101_SPI_TIMEOUT);
+    furi_hal_gpio_write(CC1101_CS_PIN, true);
+    
+    return value;
+}
+
+// FSCAL3..FSCAL0 are rewritten by every calibration
+static inline bool cc1101_shadow_volatile(uint8_t reg) {
+    return reg >= CC1101_FSCAL3 && reg <= CC1101_FSCAL0;
+}
+
+// Copy bytes that went to / came from the chip into the shadow
+static void cc1101_shadow_store(uint8_t reg, const uint8_t* data, uint8_t len) {
+    if(reg >= CC1101_CONFIG_REG_COUNT) return;
+    if(len > CC1101_CONFIG_REG_COUNT - reg) len = CC1101_CONFIG_REG_COUNT - reg;
+    memcpy(&reg_shadow[reg], data, len);
+}
+
+// True when the calling thread has a transaction open
+static inline bool cc1101_txn_owned(void) {
+    return txn_depth > 0 && txn_owner == furi_thread_get_current_id();
+}
+
+// Queue configuration registers reg..reg+len-1 in the open transaction.
+// False if the range leaves the shadowed block (written immediately instead).
+static bool cc1101_txn_queue(uint8_t reg, const uint8_t* data, uint8_t len) {
+    if(reg >= CC1101_CONFIG_REG_COUNT || len > CC1101_CONFIG_REG_COUNT - reg) return false;
+    
+    for(uint8_t i = 0; i < len; i++) {
+        txn_pending[reg + i] = data[i];
+        txn_dirty |= 1ULL << (reg + i);
+    }
+    return true;
 }
 
 // Initialize CC1101 driver
@@ -80,6 +241,13 @@ FuriStatus cc1101_driver_init(void) {
         return FuriStatusError;
     }
     
+    txn_mutex = furi_mutex_alloc(FuriMutexTypeRecursive);
+    if(!txn_mutex) {
+        FURI_LOG_E(TAG, "Failed to allocate transaction mutex");
+        furi_mutex_free(spi_mutex);
+        return FuriStatusError;
+    }
+    
     // Configure GPIO pins
     furi_hal_gpio_init(CC1101_CS_PIN, GpioModeOutputPushPull, GpioPullNo, GpioSpeedVeryHigh);
     furi_hal_gpio_write(CC1101_CS_PIN, true);  // CS high (inactive)
@@ -102,12 +270,14 @@ FuriStatus cc1101_driver_init(void) {
     if(partnum != 0x00) {
         FURI_LOG_E(TAG, "CC1101 not detected (wrong part number)");
         furi_hal_spi_release(CC1101_SPI_HANDLE);
+        furi_mutex_free(txn_mutex);
         furi_mutex_free(spi_mutex);
         return FuriStatusError;
     }
     
     // Load default configuration (433 MHz OOK)
     cc1101_load_preset_config(CC1101_CONFIG_433_OOK);
+    cc1101_shadow_sync();
     
     // Calibrate frequency synthesizer
     cc1101_calibrate();
@@ -128,13 +298,15 @@ void cc1101_driver_deinit(void) {
     
     FURI_LOG_I(TAG, "Deinitializing CC1101 driver");
     
-    // Disable interrupt
+    // Stop DMA receive and disable interrupt
+    cc1101_dma_deinit();
     furi_hal_gpio_remove_int_callback(CC1101_GDO0_PIN);
     
     // Enter idle state
     cc1101_enter_idle();
     
     // Release resources
+    furi_mutex_free(txn_mutex);
     furi_mutex_free(spi_mutex);
     
     cc1101_initialized = false;
@@ -151,10 +323,15 @@ void cc1101_reset(void) {
     // Send reset command
     cc1101_send_command(CC1101_SRES);
     furi_delay_us(CC1101_RESET_DELAY_US);
+    
+    // Registers are back at their reset values until the next sync
+    shadow_valid = false;
 }
 
-// Write single register
+// Write single register (queued while this thread has a transaction open)
 void cc1101_write_register(uint8_t reg, uint8_t value) {
+    if(cc1101_txn_owned() && cc1101_txn_queue(reg, &value, 1)) return;
+    
     furi_mutex_acquire(spi_mutex, FuriWaitForever);
     furi_hal_spi_acquire(CC1101_SPI_HANDLE);
     
@@ -169,12 +346,22 @@ void cc1101_write_register(uint8_t reg, uint8_t value) {
     furi_hal_gpio_write(CC1101_CS_PIN, true);
     furi_delay_us(1);
     
+    cc1101_shadow_store(reg, &value, 1);
+    
     furi_hal_spi_release(CC1101_SPI_HANDLE);
     furi_mutex_release(spi_mutex);
 }
 
-// Read single register
+// Read single register (configuration registers come from the shadow; a
+// transaction owner also sees its own queued values)
 uint8_t cc1101_read_register(uint8_t reg) {
+    if(reg < CC1101_CONFIG_REG_COUNT && cc1101_txn_owned() && (txn_dirty & (1ULL << reg))) {
+        return txn_pending[reg];
+    }
+    if(reg < CC1101_CONFIG_REG_COUNT && shadow_valid && !cc1101_shadow_volatile(reg)) {
+        return reg_shadow[reg];
+    }
+    
     uint8_t value = 0;
     
     furi_mutex_acquire(spi_mutex, FuriWaitForever);
@@ -183,23 +370,27 @@ uint8_t cc1101_read_register(uint8_t reg) {
     furi_hal_gpio_write(CC1101_CS_PIN, false);
     furi_delay_us(1);
     
-    // Send address with read bit
-    uint8_t addr = (reg & 0x3F) | CC1101_READ_SINGLE;
+    // Send address with read bit (status registers 0x30-0x3D need the burst
+    // bit, otherwise the address is decoded as a command strobe)
+    uint8_t addr = (reg & 0x3F) | ((reg >= CC1101_PARTNUM) ? CC1101_READ_BURST : CC1101_READ_SINGLE);
     furi_hal_spi_bus_tx(CC1101_SPI_HANDLE, &addr, 1, CC1101_SPI_TIMEOUT);
     furi_hal_spi_bus_rx(CC1101_SPI_HANDLE, &value, 1, CC1101_SPI_TIMEOUT);
     
     furi_hal_gpio_write(CC1101_CS_PIN, true);
     furi_delay_us(1);
     
+    cc1101_shadow_store(reg, &value, 1);
+    
     furi_hal_spi_release(CC1101_SPI_HANDLE);
     furi_mutex_release(spi_mutex);
     
     return value;
 }
 
-// Burst write
+// Burst write (queued while this thread has a transaction open)
 void cc1101_write_burst(uint8_t reg, const uint8_t* data, uint8_t len) {
     if(len == 0) return;
+    if(cc1101_txn_owned() && cc1101_txn_queue(reg & 0x3F, data, len)) return;
     
     furi_mutex_acquire(spi_mutex, FuriWaitForever);
     furi_hal_spi_acquire(CC1101_SPI_HANDLE);
@@ -215,6 +406,8 @@ void cc1101_write_burst(uint8_t reg, const uint8_t* data, uint8_t len) {
     furi_hal_gpio_write(CC1101_CS_PIN, true);
     furi_delay_us(1);
     
+    cc1101_shadow_store(reg & 0x3F, data, len);
+    
     furi_hal_spi_release(CC1101_SPI_HANDLE);
     furi_mutex_release(spi_mutex);
 }
@@ -237,6 +430,8 @@ void cc1101_read_burst(uint8_t reg, uint8_t* data, uint8_t len) {
     furi_hal_gpio_write(CC1101_CS_PIN, true);
     furi_delay_us(1);
     
+    cc1101_shadow_store(reg & 0x3F, data, len);
+    
     furi_hal_spi_release(CC1101_SPI_HANDLE);
     furi_mutex_release(spi_mutex);
 }
@@ -258,6 +453,100 @@ void cc1101_send_command(uint8_t cmd) {
     furi_mutex_release(spi_mutex);
 }
 
+// ============================================================================
+// REGISTER TRANSACTIONS
+// ============================================================================
+
+// Reload the shadow from the chip (after reset / preset load)
+void cc1101_shadow_sync(void) {
+    uint8_t regs[CC1101_CONFIG_REG_COUNT];
+    cc1101_read_burst(0x00, regs, CC1101_CONFIG_REG_COUNT);
+    shadow_valid = true;
+}
+
+// Open (or nest) a transaction for the calling thread
+void cc1101_txn_begin(void) {
+    furi_mutex_acquire(txn_mutex, FuriWaitForever);
+    txn_owner = furi_thread_get_current_id();
+    txn_depth++;
+}
+
+// Queue reg = (reg & ~mask) | (bits & mask) against the shadow
+void cc1101_txn_modify(uint8_t reg, uint8_t mask, uint8_t bits) {
+    uint8_t value = cc1101_read_register(reg);
+    cc1101_write_register(reg, (value & ~mask) | (bits & mask));
+}
+
+// Send the queued registers: one burst per dirty run, runs separated by at
+// most CC1101_TXN_GAP_MAX clean registers merged (the gap is rewritten with
+// its shadow value, never across a volatile FSCAL register)
+static uint8_t cc1101_txn_flush(void) {
+    uint64_t dirty = txn_dirty;
+    txn_dirty = 0;
+    if(dirty == 0) return 0;
+    
+    uint8_t bursts = 0;
+    
+    furi_mutex_acquire(spi_mutex, FuriWaitForever);
+    furi_hal_spi_acquire(CC1101_SPI_HANDLE);
+    
+    uint8_t run[CC1101_CONFIG_REG_COUNT];
+    uint8_t reg = 0;
+    while(reg < CC1101_CONFIG_REG_COUNT) {
+        if(!(dirty & (1ULL << reg))) {
+            reg++;
+            continue;
+        }
+        
+        uint8_t last = reg;
+        for(uint8_t next = reg + 1;
+            next < CC1101_CONFIG_REG_COUNT && next <= last + CC1101_TXN_GAP_MAX + 1; next++) {
+            if(dirty & (1ULL << next)) {
+                last = next;
+            } else if(!shadow_valid || cc1101_shadow_volatile(next)) {
+                break;
+            }
+        }
+        
+        // Queued values, gap registers rewritten with their committed value
+        uint8_t len = last - reg + 1;
+        for(uint8_t i = 0; i < len; i++) {
+            run[i] = (dirty & (1ULL << (reg + i))) ? txn_pending[reg + i] : reg_shadow[reg + i];
+        }
+        cc1101_frame_tx(reg | CC1101_WRITE_BURST, run, len);
+        cc1101_shadow_store(reg, run, len);
+        txn_stats.registers_written += len;
+        bursts++;
+        reg = last + 1;
+    }
+    furi_delay_us(1);
+    
+    furi_hal_spi_release(CC1101_SPI_HANDLE);
+    furi_mutex_release(spi_mutex);
+    
+    txn_stats.commits++;
+    txn_stats.bursts += bursts;
+    return bursts;
+}
+
+// Close a transaction; the outermost commit writes
+uint8_t cc1101_txn_commit(void) {
+    if(!cc1101_txn_owned()) return 0;
+    
+    uint8_t bursts = 0;
+    if(--txn_depth == 0) {
+        bursts = cc1101_txn_flush();
+        txn_owner = NULL;
+    }
+    furi_mutex_release(txn_mutex);
+    
+    return bursts;
+}
+
+CC1101TxnStats_t cc1101_txn_get_stats(void) {
+    return txn_stats;
+}
+
 // Get status
 CC1101Status_t cc1101_get_status(void) {
     CC1101Status_t status;
@@ -283,20 +572,15 @@ uint8_t cc1101_get_state(void) {
 void cc1101_set_frequency(uint32_t freq_hz) {
     // Calculate frequency word: freq_word = freq_hz / (26MHz / 2^16)
     // = freq_hz * 65536 / 26000000
-    uint32_t freq_word = ((uint64_t)freq_hz * 65536ULL) / 26000000ULL;
+    uint8_t word[3];
+    cc1101_frequency_word(freq_hz, word);
     
-    uint8_t freq2 = (freq_word >> 16) & 0xFF;
-    uint8_t freq1 = (freq_word >> 8) & 0xFF;
-    uint8_t freq0 = freq_word & 0xFF;
-    
-    cc1101_write_register(CC1101_FREQ2, freq2);
-    cc1101_write_register(CC1101_FREQ1, freq1);
-    cc1101_write_register(CC1101_FREQ0, freq0);
+    cc1101_write_burst(CC1101_FREQ2, word, 3);
     
     current_config.frequency_hz = freq_hz;
     
     FURI_LOG_D(TAG, "Frequency set to %lu Hz (word: 0x%02X%02X%02X)", 
-               freq_hz, freq2, freq1, freq0);
+               freq_hz, word[0], word[1], word[2]);
 }
 
 // Set data rate (in baud)
@@ -312,11 +596,10 @@ void cc1101_set_data_rate(uint32_t baud) {
         drate_e++;
     }
     
-    uint8_t mdmcfg4 = cc1101_read_register(CC1101_MDMCFG4);
-    mdmcfg4 = (mdmcfg4 & 0xF0) | drate_e;
-    
-    cc1101_write_register(CC1101_MDMCFG4, mdmcfg4);
+    cc1101_txn_begin();
+    cc1101_txn_modify(CC1101_MDMCFG4, 0x0F, drate_e);
     cc1101_write_register(CC1101_MDMCFG3, (uint8_t)drate_m);
+    cc1101_txn_commit();
     
     current_config.data_rate = baud;
     
@@ -388,6 +671,49 @@ void cc1101_set_channel(uint8_t channel) {
     cc1101_write_register(CC1101_CHANNR, channel);
 }
 
+// Set RX filter bandwidth to the narrowest setting >= bw_hz
+// BW = 26 MHz / (8 * (4 + CHANBW_M) * 2^CHANBW_E)
+void cc1101_set_bandwidth(uint32_t bw_hz) {
+    uint8_t best = 0x00;            // E = 0, M = 0: widest (812 kHz)
+    uint32_t best_hz = 26000000UL / 32;
+    
+    for(uint8_t e = 0; e < 4; e++) {
+        for(uint8_t m = 0; m < 4; m++) {
+            uint32_t hz = 26000000UL / ((8UL * (4 + m)) << e);
+            if(hz >= bw_hz && hz < best_hz) {
+                best_hz = hz;
+                best = (e << 2) | m;
+            }
+        }
+    }
+    
+    cc1101_txn_modify(CC1101_MDMCFG4, 0xF0, best << 4);
+    current_config.channel_bw = best_hz;
+}
+
+// Apply a full RF configuration: one register transaction, the PA table and
+// a calibration only if the frequency changed. Leaves the radio in IDLE.
+void cc1101_apply_config(const RFConfig_t* config) {
+    bool retune = config->frequency_hz != current_config.frequency_hz;
+    
+    cc1101_enter_idle();
+    
+    cc1101_txn_begin();
+    cc1101_set_frequency(config->frequency_hz);
+    cc1101_set_data_rate(config->data_rate_baud);
+    cc1101_set_bandwidth(config->channel_bw_hz);
+    cc1101_set_modulation(config->modulation);
+    cc1101_txn_modify(CC1101_MDMCFG2, 0x08, config->manchester_encoding ? 0x08 : 0x00);
+    cc1101_txn_modify(CC1101_PKTCTRL0, 0x40, config->whitening ? 0x40 : 0x00);
+    cc1101_set_sync_word(config->sync_word);
+    uint8_t bursts = cc1101_txn_commit();
+    
+    cc1101_set_tx_power(config->tx_power_dbm);
+    if(retune) cc1101_calibrate();
+    
+    FURI_LOG_D(TAG, "Config applied (%d register bursts)", bursts);
+}
+
 // Enter RX mode
 void cc1101_enter_rx(void) {
     cc1101_send_command(CC1101_SRX);
@@ -397,7 +723,7 @@ void cc1101_enter_rx(void) {
     do {
         state = cc1101_get_state();
         furi_delay_us(10);
-    } while(state != CC1101_STATE_RX && --timeout > 0);
+    } while(state != CC1101_MARCSTATE_RX && --timeout > 0);
 }
 
 // Enter TX mode
@@ -409,7 +735,7 @@ void cc1101_enter_tx(void) {
     do {
         state = cc1101_get_state();
         furi_delay_us(10);
-    } while(state != CC1101_STATE_TX && --timeout > 0);
+    } while(state != CC1101_MARCSTATE_TX && --timeout > 0);
 }
 
 // Enter idle mode
@@ -420,7 +746,7 @@ void cc1101_enter_idle(void) {
     do {
         state = cc1101_get_state();
         furi_delay_us(10);
-    } while(state != CC1101_STATE_IDLE && --timeout > 0);
+    } while(state != CC1101_MARCSTATE_IDLE && --timeout > 0);
 }
 
 // Flush RX FIFO
@@ -441,7 +767,7 @@ uint8_t cc1101_read_rssi(void) {
 // Read RSSI directly (for ISR use)
 uint8_t cc1101_read_rssi_live(void) {
     // Direct SPI read without mutex for ISR safety
-    uint8_t addr = (CC1101_RSSI & 0x3F) | CC1101_READ_SINGLE;
+    uint8_t addr = (CC1101_RSSI & 0x3F) | CC1101_READ_BURST;
     uint8_t value = 0;
     
     furi_hal_gpio_write(CC1101_CS_PIN, false);
@@ -455,15 +781,24 @@ uint8_t cc1101_read_rssi_live(void) {
 
 // Convert RSSI to dBm
 int16_t cc1101_rssi_to_dbm(uint8_t rssi_reg) {
-    if(rssi_reg >= 128) {
-        return (int16_t)rssi_reg - 256;
-    } else {
-        return (int16_t)rssi_reg - 256;
-    }
+    // Two's complement in half-dB steps, minus the datasheet offset
+    int16_t half_db = (rssi_reg >= 128) ? (int16_t)rssi_reg - 256 : (int16_t)rssi_reg;
+    return half_db / 2 - CC1101_RSSI_OFFSET_DB;
 }
 
 // Receive packet
 bool cc1101_receive_packet(uint8_t* data, uint8_t* len, uint8_t* rssi, uint8_t* lqi) {
+    // DMA mode: packets were already drained and reassembled into the ring
+    if(dma_rx_enabled) {
+        CC1101RxRecord_t record;
+        if(!cc1101_pop_rx_record(&record, data, 60)) return false;
+
+        *len = (record.length > 60) ? 60 : record.length;
+        if(rssi) *rssi = record.rssi;
+        if(lqi) *lqi = record.lqi;
+        return true;
+    }
+    
     uint8_t rxbytes = cc1101_read_register(CC1101_RXBYTES);
     
     // Check for overflow
@@ -523,7 +858,7 @@ bool cc1101_transmit_packet(const uint8_t* data, uint8_t len) {
     do {
         state = cc1101_get_state();
         furi_delay_us(10);
-    } while(state == CC1101_STATE_TX && --timeout > 0);
+    } while(state == CC1101_MARCSTATE_TX && --timeout > 0);
     
     if(timeout == 0) {
         FURI_LOG_E(TAG, "TX timeout");
@@ -565,8 +900,10 @@ void cc1101_calibrate(void) {
 
 // Set sync word
 void cc1101_set_sync_word(const uint8_t* sync_word) {
+    cc1101_txn_begin();
     cc1101_write_register(CC1101_SYNC1, sync_word[0]);
     cc1101_write_register(CC1101_SYNC0, sync_word[1]);
+    cc1101_txn_commit();
     
     current_config.sync_word[0] = sync_word[0];
     current_config.sync_word[1] = sync_word[1];
@@ -598,6 +935,230 @@ void cc1101_load_preset_config(const uint8_t* config) {
     FURI_LOG_I(TAG, "Preset configuration loaded");
 }
 
+// ============================================================================
+// DMA RX FIFO DRAIN
+// GDO0 is programmed to "RX FIFO above threshold or end of packet". The ISR
+// only latches a drain request; cc1101_dma_service() then bursts the FIFO
+// into the DMA buffer and reassembles packets into the RX ring, so FIFO
+// contents never wait on a blocking byte-wise read. The burst completes
+// before reassembly starts, so one buffer is enough.
+// ============================================================================
+
+// Read a status register twice until stable (CC1101 errata: RXBYTES may
+// change mid-read while the FIFO is being written)
+static uint8_t cc1101_read_status_stable(uint8_t reg) {
+    uint8_t value = cc1101_read_register(reg);
+    uint8_t check;
+    for(uint8_t i = 0; i < 4; i++) {
+        check = cc1101_read_register(reg);
+        if(check == value) break;
+        value = check;
+    }
+    return value;
+}
+
+// Reset packet reassembly
+static void cc1101_rx_assembly_reset(void) {
+    rx_assembly_count = 0;
+    rx_assembly_expected = 0;
+}
+
+// Completion callback: feed one drained chunk into packet reassembly and
+// publish finished packets to the ring as a single push
+static void cc1101_dma_rx_complete(const uint8_t* chunk, uint16_t len) {
+    uint8_t* packet = &rx_assembly[sizeof(CC1101RxRecord_t)];
+    
+    for(uint16_t i = 0; i < len; i++) {
+        if(rx_assembly_expected == 0) {
+            // First byte is the variable-length field; status bytes follow payload
+            if(chunk[i] == 0) continue;
+            rx_assembly_expected = (uint16_t)chunk[i] + 3;
+            
+            CC1101RxRecord_t* header = (CC1101RxRecord_t*)rx_assembly;
+            header->timestamp_cycles = fifo_irq_timestamp;
+            header->length = chunk[i];
+        }
+        
+        packet[rx_assembly_count++] = chunk[i];
+        
+        if(rx_assembly_count == rx_assembly_expected) {
+            CC1101RxRecord_t* header = (CC1101RxRecord_t*)rx_assembly;
+            header->rssi = packet[rx_assembly_count - 2];
+            header->lqi = packet[rx_assembly_count - 1];
+            
+            // Drop the length byte so the payload directly follows the header
+            memmove(packet, packet + 1, header->length);
+            uint32_t record_len = sizeof(CC1101RxRecord_t) + header->length;
+            
+            if(rx_ring && circular_buffer_free(rx_ring) >= record_len) {
+                circular_buffer_push_n(rx_ring, rx_assembly, record_len);
+                dma_stats.packets_completed++;
+            } else {
+                dma_stats.ring_drops++;
+            }
+            
+            cc1101_rx_assembly_reset();
+        }
+    }
+}
+
+// Burst read the RX FIFO into rx_data using SPI DMA
+static bool cc1101_dma_read_fifo(uint8_t* rx_data, uint16_t len) {
+    uint8_t addr = CC1101_RXFIFO | CC1101_READ_BURST;
+    
+    furi_mutex_acquire(spi_mutex, FuriWaitForever);
+    furi_hal_spi_acquire(CC1101_SPI_HANDLE);
+    dma_in_flight = true;
+    
+    furi_hal_gpio_write(CC1101_CS_PIN, false);
+    furi_hal_spi_bus_tx(CC1101_SPI_HANDLE, &addr, 1, CC1101_SPI_TIMEOUT);
+    bool ok = furi_hal_spi_bus_trx_dma(CC1101_SPI_HANDLE, NULL, rx_data, len, CC1101_SPI_TIMEOUT);
+    furi_hal_gpio_write(CC1101_CS_PIN, true);
+    
+    dma_in_flight = false;
+    furi_hal_spi_release(CC1101_SPI_HANDLE);
+    furi_mutex_release(spi_mutex);
+    
+    dma_stats.dma_transfers++;
+    return ok;
+}
+
+// Enable DMA-driven receive over a caller-owned static buffer
+void cc1101_dma_init(uint8_t* buffer, uint16_t size) {
+    if(!buffer || size < CC1101_DMA_CHUNK_MAX) {
+        FURI_LOG_E(TAG, "DMA buffer too small: %d bytes", size);
+        return;
+    }
+    
+    dma_rx_buffer = buffer;
+    dma_rx_size = size;
+    memset(&dma_stats, 0, sizeof(dma_stats));
+    cc1101_rx_assembly_reset();
+    
+    // Route FIFO threshold to GDO0 and packet framing to GDO2
+    saved_iocfg0 = cc1101_read_register(CC1101_IOCFG0);
+    saved_iocfg2 = cc1101_read_register(CC1101_IOCFG2);
+    saved_fifothr = cc1101_read_register(CC1101_FIFOTHR);
+    
+    cc1101_txn_begin();
+    cc1101_write_register(CC1101_IOCFG0, CC1101_GDO_RX_FIFO_THR_OR_EOP);
+    cc1101_write_register(CC1101_IOCFG2, CC1101_GDO_SYNC_EOP);
+    cc1101_write_register(CC1101_FIFOTHR, (saved_fifothr & 0xF0) | CC1101_DMA_FIFO_THR);
+    cc1101_txn_commit();
+    
+    furi_hal_gpio_init(CC1101_GDO0_PIN, GpioModeInterruptRise, GpioPullNo, GpioSpeedVeryHigh);
+    
+    fifo_irq_pending = false;
+    dma_rx_enabled = true;
+    
+    FURI_LOG_I(TAG, "DMA RX enabled (%d bytes)", dma_rx_size);
+}
+
+// Return to register-polled receive
+void cc1101_dma_deinit(void) {
+    if(!dma_rx_enabled) return;
+    
+    dma_rx_enabled = false;
+    cc1101_dma_wait_complete();
+    
+    // The restored GDO0 setting may be a clock output; stop taking its edges
+    furi_hal_gpio_init(CC1101_GDO0_PIN, GpioModeInput, GpioPullNo, GpioSpeedLow);
+    fifo_irq_pending = false;
+    
+    cc1101_txn_begin();
+    cc1101_write_register(CC1101_IOCFG0, saved_iocfg0);
+    cc1101_write_register(CC1101_IOCFG2, saved_iocfg2);
+    cc1101_write_register(CC1101_FIFOTHR, saved_fifothr);
+    cc1101_txn_commit();
+    
+    FURI_LOG_I(TAG, "DMA RX disabled");
+}
+
+// Full-duplex DMA transfer framed by chip select
+bool cc1101_dma_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t len) {
+    if(len == 0) return false;
+    
+    furi_mutex_acquire(spi_mutex, FuriWaitForever);
+    furi_hal_spi_acquire(CC1101_SPI_HANDLE);
+    dma_in_flight = true;
+    
+    furi_hal_gpio_write(CC1101_CS_PIN, false);
+    bool ok = furi_hal_spi_bus_trx_dma(
+        CC1101_SPI_HANDLE, (uint8_t*)tx_data, rx_data, len, CC1101_SPI_TIMEOUT);
+    furi_hal_gpio_write(CC1101_CS_PIN, true);
+    
+    dma_in_flight = false;
+    furi_hal_spi_release(CC1101_SPI_HANDLE);
+    furi_mutex_release(spi_mutex);
+    
+    dma_stats.dma_transfers++;
+    return ok;
+}
+
+// Wait for any in-flight DMA burst to finish
+void cc1101_dma_wait_complete(void) {
+    uint32_t timeout = 1000;
+    while(dma_in_flight && --timeout > 0) {
+        furi_delay_us(10);
+    }
+}
+
+// Drain the RX FIFO after a GDO0 interrupt. Called from the capture thread;
+// returns true if any bytes were moved. GDO0 only falls once the FIFO is
+// empty, so a drain that had to leave bytes behind raises no new edge: a
+// high GDO0 is serviced on the idle timeout without a pending interrupt.
+bool cc1101_dma_service(void) {
+    if(!dma_rx_enabled) return false;
+    if(!fifo_irq_pending && !furi_hal_gpio_read(CC1101_GDO0_PIN)) return false;
+    fifo_irq_pending = false;
+    PROFILE_SCOPE("fifo_drain");
+    
+    bool moved = false;
+    
+    while(dma_rx_enabled) {
+        uint8_t rxbytes = cc1101_read_status_stable(CC1101_RXBYTES);
+        
+        if(rxbytes & 0x80) {
+            dma_stats.fifo_overflows++;
+            cc1101_flush_rx();
+            cc1101_rx_assembly_reset();
+            cc1101_enter_rx();
+            break;
+        }
+        
+        uint16_t count = rxbytes & 0x7F;
+        
+        // Never empty the FIFO while a packet is still arriving (errata)
+        if(furi_hal_gpio_read(CC1101_GDO2_PIN) && count > 0) {
+            count--;
+        }
+        if(count == 0) {
+            // Held-back byte: keep the drain armed for the next wake
+            if(rxbytes & 0x7F) fifo_irq_pending = true;
+            break;
+        }
+        if(count > dma_rx_size) count = dma_rx_size;
+        
+        if(!cc1101_dma_read_fifo(dma_rx_buffer, count)) {
+            FURI_LOG_W(TAG, "RX FIFO DMA burst failed");
+            break;
+        }
+        
+        cc1101_dma_rx_complete(dma_rx_buffer, count);
+        moved = true;
+        
+        // Threshold/EOP signal deasserted - FIFO drained
+        if(!furi_hal_gpio_read(CC1101_GDO0_PIN)) break;
+    }
+    
+    return moved;
+}
+
+// Get DMA receive statistics
+CC1101DmaStats_t cc1101_dma_get_stats(void) {
+    return dma_stats;
+}
+
 // Start RSSI sampling for fingerprinting
 void cc1101_start_rssi_sampling(uint16_t sample_rate_hz) {
     // Configure GDO0 to output continuous RSSI
@@ -614,6 +1175,8 @@ void cc1101_stop_rssi_sampling(void) {
 }
 
 uint8_t cc1101_get_rssi_sample(void) {
+    // Sampled from thread context - the GDO0 ISR no longer touches SPI
+    last_rssi = cc1101_read_rssi();
     return last_rssi;
 }
 
@@ -648,3 +1211,77 @@ void cc1101_hop_frequency(void) {
     current_freq_index = (current_freq_index + 1) % num_hop_freqs;
     cc1101_set_frequency(hop_frequencies[current_freq_index]);
 }
+
+// ============================================================================
+// FAST RETUNE
+// Sweeps program FREQ and FSCAL3..1 from a per-channel cache instead of
+// running SCAL (~750 us) on every step. The whole retune (SIDLE, both bursts,
+// SRX) runs under one lock and bus acquisition, with no logging.
+// ============================================================================
+
+// Synthesizer ranges the CC1101 VCO can lock in
+static const struct {
+    uint32_t min_hz;
+    uint32_t max_hz;
+} cc1101_bands[] = {
+    {300000000, 348000000},
+    {387000000, 464000000},
+    {779000000, 928000000},
+};
+
+// True if freq_hz lies in one of the synthesizer's bands
+bool cc1101_frequency_supported(uint32_t freq_hz) {
+    for(uint8_t i = 0; i < sizeof(cc1101_bands) / sizeof(cc1101_bands[0]); i++) {
+        if(freq_hz >= cc1101_bands[i].min_hz && freq_hz <= cc1101_bands[i].max_hz) return true;
+    }
+    return false;
+}
+
+// Frequency last programmed by cc1101_set_frequency (not changed by retune)
+uint32_t cc1101_get_frequency(void) {
+    return current_config.frequency_hz;
+}
+
+// FREQ2..FREQ0 for freq_hz: freq_hz * 2^16 / 26 MHz
+void cc1101_frequency_word(uint32_t freq_hz, uint8_t word[3]) {
+    uint32_t freq_word = ((uint64_t)freq_hz * 65536ULL) / 26000000ULL;
+    
+    word[0] = (freq_word >> 16) & 0xFF;
+    word[1] = (freq_word >> 8) & 0xFF;
+    word[2] = freq_word & 0xFF;
+}
+
+// Calibrate at freq_hz and capture the result. Leaves the radio in IDLE
+// tuned to freq_hz.
+void cc1101_calibrate_channel(uint32_t freq_hz, CC1101ChannelCal_t* cal) {
+    cc1101_frequency_word(freq_hz, cal->freq);
+    
+    cc1101_enter_idle();
+    cc1101_write_burst(CC1101_FREQ2, cal->freq, 3);
+    cc1101_send_command(CC1101_SCAL);
+    furi_delay_us(CC1101_CALIBRATE_TIME_US);
+    cc1101_enter_idle();  // SCAL ends in IDLE; wait out a slow calibration
+    
+    cc1101_read_burst(CC1101_FSCAL3, cal->fscal, 3);
+}
+
+// Retune to a calibrated channel and restart RX
+void cc1101_retune(const CC1101ChannelCal_t* cal) {
+    furi_mutex_acquire(spi_mutex, FuriWaitForever);
+    furi_hal_spi_acquire(CC1101_SPI_HANDLE);
+    
+    cc1101_frame_tx(CC1101_SIDLE, NULL, 0);
+    for(uint8_t i = 0; i < CC1101_STATE_POLL_LIMIT; i++) {
+        if((cc1101_frame_read_status(CC1101_MARCSTATE) & 0x1F) == CC1101_MARCSTATE_IDLE) break;
+    }
+    
+    cc1101_frame_tx(CC1101_FREQ2 | CC1101_WRITE_BURST, cal->freq, 3);
+    cc1101_frame_tx(CC1101_FSCAL3 | CC1101_WRITE_BURST, cal->fscal, 3);
+    cc1101_shadow_store(CC1101_FREQ2, cal->freq, 3);
+    cc1101_shadow_store(CC1101_FSCAL3, cal->fscal, 3);
+    cc1101_frame_tx(CC1101_SRX, NULL, 0);
+    furi_delay_us(1);
+    
+    furi_hal_spi_release(CC1101_SPI_HANDLE);
+    furi_mutex_release(spi_mutex);
+}
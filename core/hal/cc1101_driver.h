@@ -95,6 +95,11 @@ extern "C" {
 #define CC1101_RCCTRL1_STATUS 0x3C  // Last RC oscillator calibration result
 #define CC1101_RCCTRL0_STATUS 0x3D  // Last RC oscillator calibration result
 
+// Multi-byte registers
+#define CC1101_PATABLE      0x3E    // PA power control table
+#define CC1101_TXFIFO       0x3F    // TX FIFO (write access)
+#define CC1101_RXFIFO       0x3F    // RX FIFO (read access)
+
 // Burst access bits
 #define CC1101_WRITE_BURST    0x40
 #define CC1101_READ_SINGLE    0x80
@@ -110,6 +115,24 @@ extern "C" {
 #define CC1101_STATE_RX_OVERFLOW 0x60
 #define CC1101_STATE_TX_UNDERFLOW 0x70
 
+// MARCSTATE values (cc1101_get_state)
+#define CC1101_MARCSTATE_IDLE   0x01
+#define CC1101_MARCSTATE_RX     0x0D
+#define CC1101_MARCSTATE_TX     0x13
+
+// Register transactions: configuration registers 0x00-0x2E are shadowed;
+// queued writes are committed as bursts over contiguous dirty runs
+#define CC1101_CONFIG_REG_COUNT       0x2F
+#define CC1101_TXN_GAP_MAX            2     // Clean registers rewritten to merge two runs
+
+// GDOx signal selections used by the DMA receive path
+#define CC1101_GDO_RX_FIFO_THR_OR_EOP 0x01  // RX FIFO >= threshold or end of packet
+#define CC1101_GDO_SYNC_EOP           0x06  // Asserts on sync word, deasserts at end of packet
+
+// RX FIFO threshold used for DMA draining (FIFOTHR.FIFO_THR = 7 -> 32 bytes)
+#define CC1101_DMA_FIFO_THR           0x07
+#define CC1101_DMA_CHUNK_MAX          CC1101_FIFO_SIZE
+
 // ============================================================================
 // CC1101 CONFIGURATION STRUCTURES
 // ============================================================================
@@ -123,6 +146,38 @@ typedef struct {
     uint8_t sync_word[2];
 } CC1101Config_t;
 
+// Record header pushed into the RX ring for every completed packet,
+// followed by `length` payload bytes
+typedef struct __attribute__((packed)) {
+    uint32_t timestamp_cycles;      // DWT cycle count at first FIFO interrupt
+    uint8_t length;                 // Payload bytes following this header
+    uint8_t rssi;                   // Appended RSSI status byte
+    uint8_t lqi;                    // Appended LQI byte (bit 7 = CRC OK)
+} CC1101RxRecord_t;
+
+// Synthesizer programming for one channel: FREQ2..FREQ0 and the FSCAL3..FSCAL1
+// results of a calibration at that frequency. Writing both back retunes
+// without another SCAL (TI DN508 fast frequency hopping).
+typedef struct {
+    uint8_t freq[3];                // FREQ2, FREQ1, FREQ0
+    uint8_t fscal[3];               // FSCAL3, FSCAL2, FSCAL1
+} CC1101ChannelCal_t;
+
+// Register transaction statistics
+typedef struct {
+    uint32_t commits;               // Outermost cc1101_txn_commit calls that wrote
+    uint32_t bursts;                // Burst frames issued by commits
+    uint32_t registers_written;     // Bytes sent by commits (including merged gaps)
+} CC1101TxnStats_t;
+
+// DMA receive statistics
+typedef struct {
+    uint32_t dma_transfers;         // FIFO drain DMA bursts issued
+    uint32_t packets_completed;     // Records pushed into the ring
+    uint32_t ring_drops;            // Packets lost because the ring was full
+    uint32_t fifo_overflows;        // RXBYTES overflow flag seen
+} CC1101DmaStats_t;
+
 typedef struct {
     uint8_t partnum;
     uint8_t version;
@@ -150,6 +205,17 @@ void cc1101_write_burst(uint8_t reg, const uint8_t* data, uint8_t len);
 void cc1101_read_burst(uint8_t reg, uint8_t* data, uint8_t len);
 void cc1101_send_command(uint8_t cmd);
 
+// Register transactions. Between begin and commit, configuration writes from
+// the calling thread (cc1101_write_register, cc1101_write_burst and the set_*
+// helpers) are only queued; commit sends them in as few bursts as possible
+// under one lock. Until then other threads keep reading the committed values.
+// Transactions nest; the outermost commit writes. Returns bursts issued.
+void cc1101_shadow_sync(void);
+void cc1101_txn_begin(void);
+void cc1101_txn_modify(uint8_t reg, uint8_t mask, uint8_t bits);
+uint8_t cc1101_txn_commit(void);
+CC1101TxnStats_t cc1101_txn_get_stats(void);
+
 // Status and control
 CC1101Status_t cc1101_get_status(void);
 uint8_t cc1101_get_state(void);
@@ -158,6 +224,8 @@ void cc1101_set_data_rate(uint32_t baud);
 void cc1101_set_modulation(uint8_t modulation);
 void cc1101_set_tx_power(uint8_t power_dbm);
 void cc1101_set_channel(uint8_t channel);
+void cc1101_set_bandwidth(uint32_t bw_hz);
+void cc1101_apply_config(const RFConfig_t* config);
 
 // RX/TX operations
 void cc1101_enter_rx(void);
@@ -169,9 +237,19 @@ void cc1101_flush_tx(void);
 // Data transfer
 uint8_t cc1101_read_rssi(void);
 uint8_t cc1101_read_rssi_live(void);
+int16_t cc1101_rssi_to_dbm(uint8_t rssi_reg);
 bool cc1101_receive_packet(uint8_t* data, uint8_t* len, uint8_t* rssi, uint8_t* lqi);
 bool cc1101_transmit_packet(const uint8_t* data, uint8_t len);
 
+// Received packet handoff (lock-free SPSC ring of CC1101RxRecord_t + payload)
+void cc1101_attach_rx_ring(CircularBuffer_t* ring);
+void cc1101_set_rx_notify(FuriThreadId thread, uint32_t flags);
+bool cc1101_has_data(void);
+bool cc1101_pop_rx_record(CC1101RxRecord_t* record, uint8_t* payload, uint8_t max_len);
+
+// GDO0 interrupt entry latency sample (result in the profiler ISR stats)
+void cc1101_probe_isr_latency(void);
+
 // Advanced features
 void cc1101_set_low_power_mode(bool enable);
 void cc1101_calibrate(void);
@@ -179,9 +257,13 @@ void cc1101_set_sync_word(const uint8_t* sync_word);
 void cc1101_set_preamble(uint8_t preamble_bytes);
 
 // DMA operations (for high-speed transfers)
-void cc1101_dma_init(void);
+// buffer receives each FIFO burst and must hold at least CC1101_DMA_CHUNK_MAX bytes
+void cc1101_dma_init(uint8_t* buffer, uint16_t size);
+void cc1101_dma_deinit(void);
 bool cc1101_dma_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t len);
 void cc1101_dma_wait_complete(void);
+bool cc1101_dma_service(void);
+CC1101DmaStats_t cc1101_dma_get_stats(void);
 
 // RSSI sampling for fingerprinting
 void cc1101_start_rssi_sampling(uint16_t sample_rate_hz);
@@ -192,6 +274,14 @@ uint8_t cc1101_get_rssi_sample(void);
 void cc1101_set_frequency_hopping(bool enable, uint16_t hop_interval_ms);
 void cc1101_hop_frequency(void);
 
+// Fast retune (spectrum sweep). Callers disable MCSM0.FS_AUTOCAL first so
+// the cached calibration is not overwritten on IDLE -> RX.
+bool cc1101_frequency_supported(uint32_t freq_hz);
+uint32_t cc1101_get_frequency(void);
+void cc1101_frequency_word(uint32_t freq_hz, uint8_t word[3]);
+void cc1101_calibrate_channel(uint32_t freq_hz, CC1101ChannelCal_t* cal);
+void cc1101_retune(const CC1101ChannelCal_t* cal);
+
 // ============================================================================
 // PRESET CONFIGURATIONS
 // ============================================================================
@@ -0,0 +1,308 @@
+#include "edge_capture.h"
+#include "cc1101_driver.h"
+#include "timer_precision.h"
+#include "../pulse_store.h"
+#include "../profiler.h"
+#include <furi_hal_bus.h>
+#include <furi_hal_interrupt.h>
+#include <stm32wbxx_ll_tim.h>
+#include <stm32wbxx_ll_dma.h>
+
+#define TAG "EDGE_CAP"
+
+// Hardware resources
+#define EDGE_CAPTURE_PIN        &gpio_ext_pa7       // CC1101 GDO2
+#define EDGE_CAPTURE_TIM        TIM17
+#define EDGE_CAPTURE_DMA        DMA2
+#define EDGE_CAPTURE_DMA_CH     LL_DMA_CHANNEL_2
+#define EDGE_CAPTURE_DMA_IRQ    FuriHalInterruptIdDma2Ch2
+#define EDGE_CAPTURE_TIM_IRQ    FuriHalInterruptIdTim1TrgComTim17
+
+// CC1101 async serial mode settings
+#define CC1101_GDO_ASYNC_SERIAL 0x0D                // Serial data output (async)
+#define CC1101_PKTCTRL0_ASYNC   0x32                // Async serial, infinite length
+
+// Static state
+static uint16_t capture_dma[EDGE_CAPTURE_DMA_SAMPLES] __attribute__((aligned(4)));
+static PulseBuffer_t* pulse_out = NULL;
+static volatile bool capture_running = false;
+static EdgeCaptureStats_t capture_stats;
+static volatile FuriThreadId notify_thread = NULL;
+static uint32_t notify_flags = 0;
+
+// Producer state - only touched from the capture ISRs or with interrupts masked
+static uint16_t dma_read_pos = 0;
+static uint32_t last_capture = 0;           // Extended edge time (overflows << 16 | count)
+static bool have_last_capture = false;
+static uint8_t current_level = 0;
+static uint32_t running_time_us = 0;
+static volatile uint32_t timer_overflows = 0;
+
+// Saved CC1101 configuration
+static uint8_t saved_iocfg2 = 0;
+static uint8_t saved_pktctrl0 = 0;
+
+// Append one pulse to the packed output store (producer side)
+static inline void edge_capture_store_pulse(uint32_t width_us, uint8_t level) {
+    if(pulse_store_push(pulse_out, width_us, level, running_time_us)) {
+        capture_stats.pulses_stored++;
+    } else {
+        capture_stats.pulses_dropped++;
+    }
+}
+
+// Overflow count and counter value at this instant. An overflow whose
+// interrupt has not run yet is counted if the counter already restarted.
+static inline uint32_t edge_capture_overflows_now(uint16_t* counter) {
+    uint16_t count = (uint16_t)LL_TIM_GetCounter(EDGE_CAPTURE_TIM);
+    uint32_t overflows = timer_overflows;
+    if(LL_TIM_IsActiveFlag_UPDATE(EDGE_CAPTURE_TIM) && count < EDGE_CAPTURE_TIMER_PERIOD / 2) {
+        overflows++;
+    }
+    *counter = count;
+    return overflows;
+}
+
+// Convert captures [dma_read_pos, write_pos) into pulses. Captures are at
+// most one timer period old here (the update ISR drains them on every
+// overflow), so a count above the current one belongs to the previous period.
+static void edge_capture_process_to(uint16_t write_pos) {
+    uint16_t now_count;
+    uint32_t now_overflows = edge_capture_overflows_now(&now_count);
+
+    while(dma_read_pos != write_pos) {
+        uint16_t count = capture_dma[dma_read_pos];
+        dma_read_pos = (dma_read_pos + 1) % EDGE_CAPTURE_DMA_SAMPLES;
+        capture_stats.edges_captured++;
+
+        uint32_t overflows = now_overflows - ((count > now_count) ? 1 : 0);
+        uint32_t capture = (overflows << 16) | count;
+
+        if(have_last_capture) {
+            uint32_t width = capture - last_capture;
+            if(width >= EDGE_CAPTURE_TIMER_PERIOD) capture_stats.gaps_detected++;
+            edge_capture_store_pulse(width, current_level);
+            running_time_us += width;
+        }
+
+        last_capture = capture;
+        have_last_capture = true;
+        current_level ^= 1;
+    }
+}
+
+// Current DMA write position in the capture buffer
+static inline uint16_t edge_capture_dma_pos(void) {
+    return (uint16_t)(EDGE_CAPTURE_DMA_SAMPLES -
+                      LL_DMA_GetDataLength(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH)) %
+           EDGE_CAPTURE_DMA_SAMPLES;
+}
+
+// DMA half/full transfer ISR
+static void edge_capture_dma_isr(void* context) {
+    UNUSED(context);
+    uint32_t enter_cycles = profiler_isr_enter(PROFILER_ISR_EDGE_DMA);
+
+    if(LL_DMA_IsActiveFlag_HT2(EDGE_CAPTURE_DMA)) {
+        LL_DMA_ClearFlag_HT2(EDGE_CAPTURE_DMA);
+        capture_stats.dma_events++;
+    }
+
+    if(LL_DMA_IsActiveFlag_TC2(EDGE_CAPTURE_DMA)) {
+        LL_DMA_ClearFlag_TC2(EDGE_CAPTURE_DMA);
+        capture_stats.dma_events++;
+    }
+
+    // Process up to the live DMA position rather than the fixed half/full
+    // boundary, so a poll that already ran ahead is never re-walked
+    edge_capture_process_to(edge_capture_dma_pos());
+
+    FuriThreadId thread = notify_thread;
+    if(thread) {
+        furi_thread_flags_set(thread, notify_flags);
+    }
+
+    profiler_isr_exit(PROFILER_ISR_EDGE_DMA, enter_cycles);
+}
+
+// TIM17 overflow ISR: drain pending captures (the set update flag already
+// places them on the right side of the overflow), then count it
+static void edge_capture_timer_isr(void* context) {
+    UNUSED(context);
+
+    if(LL_TIM_IsActiveFlag_UPDATE(EDGE_CAPTURE_TIM)) {
+        edge_capture_process_to(edge_capture_dma_pos());
+        timer_overflows++;
+        LL_TIM_ClearFlag_UPDATE(EDGE_CAPTURE_TIM);
+    }
+}
+
+// Thread flags raised from the DMA ISR once new pulses are stored (NULL to stop)
+void edge_capture_set_notify(FuriThreadId thread, uint32_t flags) {
+    notify_flags = flags;
+    notify_thread = thread;
+}
+
+// Initialize capture engine
+FuriStatus edge_capture_init(PulseBuffer_t* pulse_buffer) {
+    if(!pulse_buffer) return FuriStatusError;
+
+    pulse_out = pulse_buffer;
+    pulse_store_reset(pulse_out);
+    memset(&capture_stats, 0, sizeof(capture_stats));
+    capture_running = false;
+
+    FURI_LOG_I(TAG, "Edge capture engine initialized");
+    return FuriStatusOk;
+}
+
+void edge_capture_deinit(void) {
+    edge_capture_stop();
+    pulse_out = NULL;
+}
+
+// Start hardware capture
+bool edge_capture_start(void) {
+    if(!pulse_out || capture_running) return false;
+
+    // Reset producer state
+    dma_read_pos = 0;
+    have_last_capture = false;
+    running_time_us = 0;
+    timer_overflows = 0;
+    pulse_store_reset(pulse_out);
+
+    // CC1101: demodulated data straight to GDO2
+    saved_iocfg2 = cc1101_read_register(CC1101_IOCFG2);
+    saved_pktctrl0 = cc1101_read_register(CC1101_PKTCTRL0);
+    cc1101_write_register(CC1101_PKTCTRL0, CC1101_PKTCTRL0_ASYNC);
+    cc1101_write_register(CC1101_IOCFG2, CC1101_GDO_ASYNC_SERIAL);
+
+    // GDO2 -> TIM17_CH1
+    furi_hal_gpio_init_ex(
+        EDGE_CAPTURE_PIN, GpioModeAltFunctionPushPull, GpioPullNo, GpioSpeedVeryHigh,
+        GpioAltFn14TIM17);
+    current_level = furi_hal_gpio_read(EDGE_CAPTURE_PIN) ? 1 : 0;
+
+    // Timer: free-running 16-bit counter at 1 MHz, capture on both edges
+    furi_hal_bus_enable(FuriHalBusTIM17);
+    LL_TIM_SetPrescaler(EDGE_CAPTURE_TIM, (SystemCoreClock / EDGE_CAPTURE_TIMER_HZ) - 1);
+    LL_TIM_SetAutoReload(EDGE_CAPTURE_TIM, 0xFFFF);
+    LL_TIM_SetCounterMode(EDGE_CAPTURE_TIM, LL_TIM_COUNTERMODE_UP);
+    LL_TIM_IC_SetActiveInput(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1, LL_TIM_ACTIVEINPUT_DIRECTTI);
+    LL_TIM_IC_SetPrescaler(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1, LL_TIM_ICPSC_DIV1);
+    LL_TIM_IC_SetFilter(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1, LL_TIM_IC_FILTER_FDIV1_N4);
+    LL_TIM_IC_SetPolarity(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1, LL_TIM_IC_POLARITY_BOTHEDGE);
+    LL_TIM_EnableDMAReq_CC1(EDGE_CAPTURE_TIM);
+    LL_TIM_CC_EnableChannel(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1);
+
+    // DMA: CCR1 -> capture buffer, circular, half/full interrupts
+    LL_DMA_InitTypeDef dma = {0};
+    dma.PeriphOrM2MSrcAddress = (uint32_t)&EDGE_CAPTURE_TIM->CCR1;
+    dma.MemoryOrM2MDstAddress = (uint32_t)capture_dma;
+    dma.Direction = LL_DMA_DIRECTION_PERIPH_TO_MEMORY;
+    dma.Mode = LL_DMA_MODE_CIRCULAR;
+    dma.PeriphOrM2MSrcIncMode = LL_DMA_PERIPH_NOINCREMENT;
+    dma.MemoryOrM2MDstIncMode = LL_DMA_MEMORY_INCREMENT;
+    dma.PeriphOrM2MSrcDataSize = LL_DMA_PDATAALIGN_HALFWORD;
+    dma.MemoryOrM2MDstDataSize = LL_DMA_MDATAALIGN_HALFWORD;
+    dma.NbData = EDGE_CAPTURE_DMA_SAMPLES;
+    dma.PeriphRequest = LL_DMAMUX_REQ_TIM17_CH1;
+    dma.Priority = LL_DMA_PRIORITY_VERYHIGH;
+    LL_DMA_Init(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH, &dma);
+
+    furi_hal_interrupt_set_isr(EDGE_CAPTURE_DMA_IRQ, edge_capture_dma_isr, NULL);
+    LL_DMA_EnableIT_HT(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH);
+    LL_DMA_EnableIT_TC(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH);
+    LL_DMA_EnableChannel(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH);
+
+    // Overflow interrupt extends edge times beyond 16 bits
+    LL_TIM_SetCounter(EDGE_CAPTURE_TIM, 0);
+    LL_TIM_ClearFlag_UPDATE(EDGE_CAPTURE_TIM);
+    furi_hal_interrupt_set_isr(EDGE_CAPTURE_TIM_IRQ, edge_capture_timer_isr, NULL);
+    LL_TIM_EnableIT_UPDATE(EDGE_CAPTURE_TIM);
+    LL_TIM_EnableCounter(EDGE_CAPTURE_TIM);
+
+    capture_running = true;
+    FURI_LOG_I(TAG, "Edge capture started (TIM17 CH1, %d sample DMA ring)",
+               EDGE_CAPTURE_DMA_SAMPLES);
+    return true;
+}
+
+// Stop hardware capture and restore CC1101 GDO2
+void edge_capture_stop(void) {
+    if(!capture_running) return;
+
+    LL_TIM_DisableCounter(EDGE_CAPTURE_TIM);
+    LL_TIM_DisableIT_UPDATE(EDGE_CAPTURE_TIM);
+    furi_hal_interrupt_set_isr(EDGE_CAPTURE_TIM_IRQ, NULL, NULL);
+    LL_TIM_DisableDMAReq_CC1(EDGE_CAPTURE_TIM);
+    LL_TIM_CC_DisableChannel(EDGE_CAPTURE_TIM, LL_TIM_CHANNEL_CH1);
+    LL_DMA_DisableChannel(EDGE_CAPTURE_DMA, EDGE_CAPTURE_DMA_CH);
+    furi_hal_interrupt_set_isr(EDGE_CAPTURE_DMA_IRQ, NULL, NULL);
+    furi_hal_bus_disable(FuriHalBusTIM17);
+
+    // Flush captures that never reached a half-transfer boundary
+    edge_capture_poll();
+    capture_running = false;
+
+    furi_hal_gpio_init(EDGE_CAPTURE_PIN, GpioModeInput, GpioPullNo, GpioSpeedLow);
+    cc1101_write_register(CC1101_IOCFG2, saved_iocfg2);
+    cc1101_write_register(CC1101_PKTCTRL0, saved_pktctrl0);
+
+    FURI_LOG_I(TAG, "Edge capture stopped: %lu pulses, %lu dropped",
+               capture_stats.pulses_stored, capture_stats.pulses_dropped);
+}
+
+bool edge_capture_is_running(void) {
+    return capture_running;
+}
+
+// Process captures that have not yet reached a DMA interrupt boundary.
+// Returns pulses available to the consumer.
+uint16_t edge_capture_poll(void) {
+    if(!pulse_out) return 0;
+
+    if(capture_running) {
+        uint32_t primask = critical_section_enter();
+        edge_capture_process_to(edge_capture_dma_pos());
+        critical_section_exit(primask);
+    }
+
+    return edge_capture_available();
+}
+
+// Pulses waiting in the output buffer
+uint16_t edge_capture_available(void) {
+    if(!pulse_out) return 0;
+
+    pulse_out->count = pulse_store_count(pulse_out);
+    return pulse_out->count;
+}
+
+// Pop oldest pulse (consumer side)
+bool edge_capture_pop(Pulse_t* pulse) {
+    if(!pulse_out) return false;
+
+    return pulse_store_pop(pulse_out, pulse);
+}
+
+// Wait for the next pulse, sleeping between polls instead of spinning
+bool edge_capture_wait_pulse(Pulse_t* pulse, uint32_t timeout_us) {
+    uint32_t start = timer_get_us();
+
+    while(true) {
+        if(edge_capture_pop(pulse)) return true;
+        if(!capture_running || timer_get_elapsed_us(start) >= timeout_us) return false;
+
+        edge_capture_poll();
+        if(edge_capture_pop(pulse)) return true;
+
+        furi_delay_ms(1);
+    }
+}
+
+// Get capture statistics
+EdgeCaptureStats_t edge_capture_get_stats(void) {
+    return capture_stats;
+}
@@ -0,0 +1,64 @@
+#ifndef EDGE_CAPTURE_H
+#define EDGE_CAPTURE_H
+
+#include <furi.h>
+#include <furi_hal.h>
+#include "../flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// HARDWARE EDGE CAPTURE ENGINE
+// TIM17 CH1 input capture on CC1101 GDO2 (PA7, async serial data output),
+// both edges, 1 MHz timebase, circular DMA into a capture buffer. Edge times
+// are converted to packed pulses in DMA half/full interrupts, so raw OOK
+// capture needs no CPU spin-waits. Timer update interrupts count 16-bit
+// overflows, so gaps longer than one timer period are measured, not clamped.
+// ============================================================================
+
+#define EDGE_CAPTURE_DMA_SAMPLES    512             // Capture buffer (16-bit timer counts)
+#define EDGE_CAPTURE_TIMER_HZ       1000000         // 1 us per tick (TIMING_PRECISION_US)
+#define EDGE_CAPTURE_TIMER_PERIOD   0x10000         // Ticks per timer overflow
+
+typedef struct {
+    uint32_t edges_captured;        // Timer captures processed
+    uint32_t pulses_stored;         // Pulses written to the pulse buffer
+    uint32_t pulses_dropped;        // Pulses lost because the buffer was full
+    uint32_t dma_events;            // DMA half/full transfer interrupts
+    uint32_t gaps_detected;         // Pulses longer than one timer period
+} EdgeCaptureStats_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Initialization - pulse_buffer is filled asynchronously while running
+FuriStatus edge_capture_init(PulseBuffer_t* pulse_buffer);
+void edge_capture_deinit(void);
+
+// Capture control (switches CC1101 GDO2 to async serial data output)
+bool edge_capture_start(void);
+void edge_capture_stop(void);
+bool edge_capture_is_running(void);
+
+// Consumer side (thread context)
+void edge_capture_set_notify(FuriThreadId thread, uint32_t flags);
+uint16_t edge_capture_poll(void);
+uint16_t edge_capture_available(void);
+
+// Pulse-by-pulse consumers for the standalone measurement helpers. Popping
+// moves the store tail, so these must not be used while the session store
+// is attached to the same pulse buffer (capture thread running).
+bool edge_capture_pop(Pulse_t* pulse);
+bool edge_capture_wait_pulse(Pulse_t* pulse, uint32_t timeout_us);
+
+// Diagnostics
+EdgeCaptureStats_t edge_capture_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EDGE_CAPTURE_H
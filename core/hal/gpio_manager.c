@@ -1,5 +1,6 @@
 #include "gpio_manager.h"
 #include "timer_precision.h"
+#include "edge_capture.h"
 
 #define TAG "GPIO_MGR"
 #define MAX_GPIO_INPUTS 16
@@ -351,6 +352,20 @@ bool gpio_get_sample(uint32_t* timestamp, bool* state) {
 uint32_t gpio_measure_pulse_width(const GpioPin* pin, bool target_level, uint32_t timeout_us) {
     uint32_t start = timer_get_us();
     
+    // Hardware-timestamped path: take the next matching pulse from the
+    // capture engine instead of spinning on the pin
+    if(pin == GPIO_CC1101_GDO2 && edge_capture_is_running()) {
+        Pulse_t pulse;
+        while(timer_get_elapsed_us(start) < timeout_us) {
+            uint32_t remaining = timeout_us - timer_get_elapsed_us(start);
+            if(!edge_capture_wait_pulse(&pulse, remaining)) break;
+            if(pulse.level == (target_level ? 1 : 0)) {
+                return pulse.width_us;
+            }
+        }
+        return 0;  // Timeout
+    }
+    
     // Wait for target level
     while(gpio_read(pin) != target_level) {
         if(timer_get_elapsed_us(start) > timeout_us) {
@@ -390,6 +405,30 @@ bool gpio_wait_for_pattern(const GpioPin* pin, const bool* pattern, uint8_t patt
     uint32_t start = furi_get_tick();
     uint8_t matched = 0;
     
+    if(pattern_len == 0 || bit_time_us == 0) return false;
+    
+    // Hardware-timestamped path: expand captured pulses into bit periods
+    if(pin == GPIO_CC1101_GDO2 && edge_capture_is_running()) {
+        Pulse_t pulse;
+        while((furi_get_tick() - start) < timeout_ms) {
+            uint32_t remaining_us = (timeout_ms - (furi_get_tick() - start)) * 1000;
+            if(!edge_capture_wait_pulse(&pulse, remaining_us)) break;
+            
+            uint32_t bits = (pulse.width_us + bit_time_us / 2) / bit_time_us;
+            bool level = pulse.level != 0;
+            
+            for(uint32_t b = 0; b < bits; b++) {
+                if(level == pattern[matched]) {
+                    if(++matched >= pattern_len) return true;
+                } else {
+                    // Restart: this bit may begin a new match
+                    matched = (level == pattern[0]) ? 1 : 0;
+                }
+            }
+        }
+        return false;  // Timeout
+    }
+    
     while((furi_get_tick() - start) < timeout_ms) {
         bool current = gpio_read(pin);
         
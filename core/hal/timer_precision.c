@@ -1,4 +1,5 @@
 #include "timer_precision.h"
+#include "edge_capture.h"
 
 // Static state
 static volatile bool timer_initialized = false;
@@ -111,6 +112,12 @@ void timer_delay_ns(uint32_t ns) {
 
 // Measure pulse width with timeout
 uint32_t measure_pulse_width_us(uint32_t timeout_us) {
+    // Prefer hardware input-capture timestamps when the engine is running
+    if(edge_capture_is_running()) {
+        Pulse_t pulse;
+        return edge_capture_wait_pulse(&pulse, timeout_us) ? pulse.width_us : 0;
+    }
+    
     uint32_t start = timer_get_us();
     uint32_t timeout_cycles = timeout_us * cycles_per_us;
     uint32_t start_cycles = DWT_CYCCNT;
@@ -170,6 +177,9 @@ void interval_stats_init(IntervalStatistics_t* stats) {
     memset(stats, 0, sizeof(IntervalStatistics_t));
     stats->min_interval = 0xFFFFFFFF;
     stats->max_interval = 0;
+    p2_quantile_init(&stats->q1, 25);
+    p2_quantile_init(&stats->median, 50);
+    p2_quantile_init(&stats->q3, 75);
 }
 
 void interval_stats_add(IntervalStatistics_t* stats, uint32_t interval_us) {
@@ -183,6 +193,11 @@ void interval_stats_add(IntervalStatistics_t* stats, uint32_t interval_us) {
     if(interval_us > stats->max_interval) {
         stats->max_interval = interval_us;
     }
+    
+    int32_t sample = (interval_us > INT32_MAX) ? INT32_MAX : (int32_t)interval_us;
+    p2_quantile_add(&stats->q1, sample);
+    p2_quantile_add(&stats->median, sample);
+    p2_quantile_add(&stats->q3, sample);
 }
 
 uint32_t interval_stats_get_mean(const IntervalStatistics_t* stats) {
@@ -219,6 +234,16 @@ uint32_t interval_stats_get_std_dev(const IntervalStatistics_t* stats) {
     return res;
 }
 
+uint32_t interval_stats_get_median(const IntervalStatistics_t* stats) {
+    return (uint32_t)p2_quantile_get(&stats->median);
+}
+
+uint32_t interval_stats_get_iqr(const IntervalStatistics_t* stats) {
+    int32_t q1 = p2_quantile_get(&stats->q1);
+    int32_t q3 = p2_quantile_get(&stats->q3);
+    return (q3 > q1) ? (uint32_t)(q3 - q1) : 0;
+}
+
 // Jitter measurement functions
 void jitter_measurement_init(JitterMeasurement_t* jm, uint32_t expected_interval_us) {
     memset(jm, 0, sizeof(JitterMeasurement_t));
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../math/statistics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -93,6 +94,9 @@ typedef struct {
     uint32_t count;
     uint32_t min_interval;
     uint32_t max_interval;
+    P2Quantile_t q1;                // Streaming quartiles, O(1) per interval
+    P2Quantile_t median;
+    P2Quantile_t q3;
 } IntervalStatistics_t;
 
 void interval_stats_init(IntervalStatistics_t* stats);
@@ -100,6 +104,8 @@ void interval_stats_add(IntervalStatistics_t* stats, uint32_t interval_us);
 uint32_t interval_stats_get_mean(const IntervalStatistics_t* stats);
 uint32_t interval_stats_get_variance(const IntervalStatistics_t* stats);
 uint32_t interval_stats_get_std_dev(const IntervalStatistics_t* stats);
+uint32_t interval_stats_get_median(const IntervalStatistics_t* stats);
+uint32_t interval_stats_get_iqr(const IntervalStatistics_t* stats);    // q3 - q1, robust jitter
 
 // Jitter measurement
 typedef struct {
@@ -0,0 +1,63 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// TABLE-DRIVEN CRC ENGINE
+// Constant 256-entry tables for the polynomials in the threat model CRC
+// database; CRC-32 (IEEE, reflected) also has slice-by-4 tables since it
+// checksums SD blocks. Engines without a table (e.g. polynomials recovered
+// from captures) fall back to a bitwise update with identical results.
+//
+// Registers are kept in output orientation: MSB-first for normal engines,
+// LSB-first for reflected ones, so final value = register ^ xor_out.
+// ============================================================================
+
+typedef enum {
+    CRC_ENGINE_8_07 = 0,            // CRC-8 (0x07)
+    CRC_ENGINE_16_8005_REF,         // CRC-16/ARC family (0x8005 reflected)
+    CRC_ENGINE_16_1021_REF,         // CRC-16/KERMIT family (0x1021 reflected)
+    CRC_ENGINE_32_REF,              // CRC-32 / IEEE 802.3 (0x04C11DB7 reflected)
+    CRC_ENGINE_32_NORMAL,           // CRC-32/MPEG-2 family (0x04C11DB7)
+    CRC_ENGINE_COUNT
+} CrcEngineId_t;
+
+typedef struct {
+    uint32_t polynomial;            // Normal (MSB-first) form without the x^width term
+    uint8_t width;                  // 8, 16 or 32
+    bool reflected;                 // reflect_in == reflect_out
+    const void* table;              // 256 entries of width bits, NULL for bitwise
+    bool sliced;                    // table is [4][256] (slice-by-4)
+} CrcEngine_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Engine lookup (NULL when no table exists for the parameters)
+const CrcEngine_t* crc_get_engine(CrcEngineId_t id);
+const CrcEngine_t* crc_find_engine(uint32_t polynomial, uint8_t width, bool reflected);
+void crc_engine_make(CrcEngine_t* engine, uint32_t polynomial, uint8_t width, bool reflected);
+
+// Register update (no init/xor_out handling) and full computation.
+// init is given unreflected, as in the usual parameter tables.
+uint32_t crc_update(const CrcEngine_t* engine, uint32_t crc, const uint8_t* data, uint32_t len);
+uint32_t crc_init_register(const CrcEngine_t* engine, uint32_t init);
+uint32_t crc_compute(const CrcEngine_t* engine, uint32_t init, uint32_t xor_out,
+                     const uint8_t* data, uint32_t len);
+
+// Utility
+uint32_t crc_reflect(uint32_t value, uint8_t width);
+uint32_t crc_width_mask(uint8_t width);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CRC_H
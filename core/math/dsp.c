@@ -0,0 +1,255 @@
+#include "dsp.h"
+
+// ============================================================================
+// TABLES
+// Generated offline: dsp_sin_quarter[i] = round(32768 * sin(2 * pi * i / 1024))
+// ============================================================================
+
+const uint16_t dsp_sin_quarter[DSP_SIN_QUARTER + 1] = {
+        0,   201,   402,   603,   804,  1005,  1206,  1407,  1608,  1809,  2009,  2210,
+     2411,  2611,  2811,  3012,  3212,  3412,  3612,  3812,  4011,  4211,  4410,  4609,
+     4808,  5007,  5205,  5404,  5602,  5800,  5998,  6195,  6393,  6590,  6787,  6983,
+     7180,  7376,  7571,  7767,  7962,  8157,  8351,  8546,  8740,  8933,  9127,  9319,
+     9512,  9704,  9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+    16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+    20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+    23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+    26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+    31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+    32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+    32758, 32762, 32766, 32767, 32768
+};
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+static inline int32_t sat_i32(int64_t x) {
+    if(x > INT32_MAX) return INT32_MAX;
+    if(x < INT32_MIN) return INT32_MIN;
+    return (int32_t)x;
+}
+
+// sin in Q15 without saturation (+-32768 at the peaks)
+static inline int32_t sin_interp(dsp_phase_t phase) {
+    // Top 2 bits: quadrant, next 8: table step, next 16: interpolation fraction
+    uint32_t quadrant = phase >> 30;
+    uint32_t index = (phase >> 22) & (DSP_SIN_QUARTER - 1);
+    int32_t frac = (int32_t)((phase >> 6) & 0xFFFF);
+
+    int32_t a;
+    int32_t b;
+    if(quadrant & 1) {
+        a = dsp_sin_quarter[DSP_SIN_QUARTER - index];
+        b = dsp_sin_quarter[DSP_SIN_QUARTER - 1 - index];
+    } else {
+        a = dsp_sin_quarter[index];
+        b = dsp_sin_quarter[index + 1];
+    }
+
+    int32_t v = a + (((b - a) * frac + 0x8000) >> 16);
+    return (quadrant & 2) ? -v : v;
+}
+
+// ============================================================================
+// VECTOR KERNELS
+// ============================================================================
+
+// SMLALD rather than SMLAD: two Q30 products already fill a 32-bit accumulator
+int64_t dsp_dot_q15(const q15_t* a, const q15_t* b, uint32_t n) {
+    int64_t acc = 0;
+    uint32_t i = 0;
+
+    // Four samples per iteration, two dual MACs
+    for(; i + 4 <= n; i += 4) {
+        acc = dsp_smlald(dsp_read_q15x2(a + i), dsp_read_q15x2(b + i), acc);
+        acc = dsp_smlald(dsp_read_q15x2(a + i + 2), dsp_read_q15x2(b + i + 2), acc);
+    }
+    if(i + 2 <= n) {
+        acc = dsp_smlald(dsp_read_q15x2(a + i), dsp_read_q15x2(b + i), acc);
+        i += 2;
+    }
+    if(i < n) {
+        acc += (int32_t)a[i] * b[i];
+    }
+
+    return acc;
+}
+
+// Saturating element-wise add, two lanes per QADD16
+void dsp_add_q15(const q15_t* a, const q15_t* b, q15_t* out, uint32_t n) {
+    uint32_t i = 0;
+
+    for(; i + 2 <= n; i += 2) {
+        dsp_write_q15x2(out + i, dsp_qadd16(dsp_read_q15x2(a + i), dsp_read_q15x2(b + i)));
+    }
+    if(i < n) {
+        out[i] = dsp_sat_q15((int32_t)a[i] + b[i]);
+    }
+}
+
+// Q15.16 to Q15 with saturation
+void dsp_fixed_to_q15(const fixed_t* in, q15_t* out, uint32_t n) {
+    for(uint32_t i = 0; i < n; i++) {
+        out[i] = dsp_sat_q15(in[i] >> (FIXED_FRACTIONAL_BITS - 15));
+    }
+}
+
+// Template correlation, e.g. a preamble against a demodulated envelope
+uint32_t dsp_correlate_q15(
+    const q15_t* x,
+    uint32_t n,
+    const q15_t* ref,
+    uint16_t ref_len,
+    int32_t* out) {
+    if(!x || !ref || !out || ref_len == 0 || n < ref_len) return 0;
+
+    uint32_t count = n - ref_len + 1;
+    for(uint32_t k = 0; k < count; k++) {
+        int64_t acc = dsp_dot_q15(ref, x + k, ref_len);
+        out[k] = sat_i32((acc + (1 << 14)) >> 15);
+    }
+
+    return count;
+}
+
+// Lagged cross-correlation, one division per lag
+void dsp_xcorr_q15(const q15_t* x, const q15_t* y, uint32_t n, int32_t* out, uint32_t max_lag) {
+    if(!x || !y || !out) return;
+
+    for(uint32_t lag = 0; lag <= max_lag; lag++) {
+        if(lag >= n) {
+            out[lag] = 0;
+            continue;
+        }
+        int64_t acc = dsp_dot_q15(x, y + lag, n - lag);
+        out[lag] = (int32_t)((acc / (int64_t)(n - lag)) >> 15);
+    }
+}
+
+// ============================================================================
+// FIR FILTER
+// ============================================================================
+
+// Store the coefficients reversed so the tap loop walks both arrays forwards
+bool dsp_fir_q15_init(DspFirQ15_t* fir, const q15_t* coeffs, uint16_t taps) {
+    if(!fir || !coeffs || taps == 0 || taps > DSP_FIR_MAX_TAPS) return false;
+
+    memset(fir, 0, sizeof(DspFirQ15_t));
+    for(uint16_t i = 0; i < taps; i++) {
+        fir->coeffs[i] = coeffs[taps - 1 - i];
+    }
+    fir->taps = taps;
+
+    return true;
+}
+
+// Clear the delay line, keep the coefficients
+void dsp_fir_q15_reset(DspFirQ15_t* fir) {
+    if(!fir) return;
+    memset(fir->delay, 0, sizeof(fir->delay));
+    fir->pos = 0;
+}
+
+// One sample in, one out
+q15_t dsp_fir_q15_process(DspFirQ15_t* fir, q15_t input) {
+    uint16_t pos = fir->pos;
+
+    fir->delay[pos] = input;
+    fir->delay[pos + fir->taps] = input;
+    pos = (pos + 1 == fir->taps) ? 0 : pos + 1;
+    fir->pos = pos;
+
+    // delay[pos .. pos + taps) holds the window, oldest first
+    int64_t acc = dsp_dot_q15(fir->coeffs, &fir->delay[pos], fir->taps);
+    return dsp_sat_q15((int32_t)((acc + (1 << 14)) >> 15));
+}
+
+// Filter a block; out may alias in
+void dsp_fir_q15_block(DspFirQ15_t* fir, const q15_t* in, q15_t* out, uint32_t n) {
+    if(!fir || fir->taps == 0 || !in || !out) return;
+
+    for(uint32_t i = 0; i < n; i++) {
+        out[i] = dsp_fir_q15_process(fir, in[i]);
+    }
+}
+
+// ============================================================================
+// SQUARE ROOT
+// ============================================================================
+
+// One result bit per step, starting at the highest power of four <= x
+uint16_t dsp_isqrt32(uint32_t x) {
+    if(x == 0) return 0;
+
+    uint32_t bit = 1UL << ((31 - dsp_clz(x)) & ~1U);
+    uint32_t root = 0;
+
+    while(bit != 0) {
+        if(x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint16_t)root;
+}
+
+// sqrt(raw / 2^16) * 2^16 = sqrt(raw) * 2^8
+fixed_t dsp_sqrt_fixed(fixed_t x) {
+    if(x <= 0) return 0;
+
+    uint32_t v = (uint32_t)x;
+    uint8_t lz = dsp_clz(v);
+
+    if(lz >= 16) {
+        // Below 1.0: shift up by an even amount so the root keeps 16 bits
+        uint8_t shift = lz & ~1U;
+        uint32_t root = dsp_isqrt32(v << shift);
+        return (fixed_t)(root >> (shift / 2 - 8));
+    }
+
+    // Integer root plus one linear correction step; error under 0.5 LSB
+    // because root >= 256 here
+    uint32_t root = dsp_isqrt32(v);
+    uint32_t rem = v - root * root;
+    return (fixed_t)((root << 8) + (rem << 7) / root);
+}
+
+// ============================================================================
+// BINARY-ANGLE TRIGONOMETRY
+// ============================================================================
+
+q15_t dsp_sin_q15(dsp_phase_t phase) {
+    return dsp_sat_q15(sin_interp(phase));
+}
+
+q15_t dsp_cos_q15(dsp_phase_t phase) {
+    return dsp_sat_q15(sin_interp(phase + DSP_PHASE_QUARTER));
+}
+
+void dsp_sincos_q15(dsp_phase_t phase, q15_t* sin_out, q15_t* cos_out) {
+    if(sin_out) *sin_out = dsp_sat_q15(sin_interp(phase));
+    if(cos_out) *cos_out = dsp_sat_q15(sin_interp(phase + DSP_PHASE_QUARTER));
+}
+
+fixed_t dsp_sin_fixed(dsp_phase_t phase) {
+    return sin_interp(phase) * 2;
+}
+
+fixed_t dsp_cos_fixed(dsp_phase_t phase) {
+    return sin_interp(phase + DSP_PHASE_QUARTER) * 2;
+}
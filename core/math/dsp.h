@@ -0,0 +1,194 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "fixed_point.h"
+
+#if defined(__ARM_FEATURE_DSP) && defined(__ARM_FEATURE_SIMD32)
+#include <arm_acle.h>
+#define DSP_HAVE_SIMD 1
+#else
+#define DSP_HAVE_SIMD 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// DSP KERNELS
+// Q15 kernels on packed int16 arrays. On the STM32WB (Cortex-M4 with the DSP
+// extension) two samples travel in one 32-bit word: SMLALD/SMUAD do both
+// 16x16 products per instruction, QADD16 adds both lanes with saturation and
+// CLZ normalises. Other targets (the host tests) use portable C with
+// bit-identical results.
+//
+// Angles are binary: a uint32 phase where 2^32 is one full turn, so phase
+// arithmetic wraps for free.
+// ============================================================================
+
+typedef int16_t q15_t;
+typedef uint32_t dsp_phase_t;
+
+#define Q15_MAX                 32767
+#define Q15_MIN                 (-32768)
+
+#define DSP_FIR_MAX_TAPS        32
+#define DSP_SIN_QUARTER         256           // Table steps per quarter wave
+#define DSP_PHASE_QUARTER       0x40000000UL  // pi / 2
+#define DSP_PHASE_HALF          0x80000000UL  // pi
+#define DSP_RAD_TO_PHASE        683565276LL   // 2^32 / (2 * pi)
+
+// round(32768 * sin(i * pi / 512)) for i = 0..256, shared with the FFT twiddles
+extern const uint16_t dsp_sin_quarter[DSP_SIN_QUARTER + 1];
+
+// FIR filter with a doubled delay line: each sample is stored at pos and
+// pos + taps, so the newest `taps` samples are always contiguous and the
+// tap loop needs no modulo. Coefficients are kept reversed to match.
+typedef struct {
+    q15_t coeffs[DSP_FIR_MAX_TAPS];         // Reversed: coeffs[0] multiplies the oldest sample
+    q15_t delay[2 * DSP_FIR_MAX_TAPS];
+    uint16_t taps;
+    uint16_t pos;
+} DspFirQ15_t;
+
+// ============================================================================
+// INTRINSICS
+// ============================================================================
+
+// Two adjacent samples as one word (low half = p[0]); p need not be aligned
+static inline uint32_t dsp_read_q15x2(const q15_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void dsp_write_q15x2(q15_t* p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+// acc + x.lo * y.lo + x.hi * y.hi, 64-bit accumulator
+static inline int64_t dsp_smlald(uint32_t x, uint32_t y, int64_t acc) {
+#if DSP_HAVE_SIMD
+    return __smlald((int16x2_t)x, (int16x2_t)y, acc);
+#else
+    return acc + (int32_t)(int16_t)x * (int16_t)y +
+           (int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16);
+#endif
+}
+
+// x.lo * y.lo + x.hi * y.hi (wraps only for two -32768 * -32768 products)
+static inline int32_t dsp_smuad(uint32_t x, uint32_t y) {
+#if DSP_HAVE_SIMD
+    return __smuad((int16x2_t)x, (int16x2_t)y);
+#else
+    uint32_t lo = (uint32_t)((int32_t)(int16_t)x * (int16_t)y);
+    uint32_t hi = (uint32_t)((int32_t)(int16_t)(x >> 16) * (int16_t)(y >> 16));
+    return (int32_t)(lo + hi);
+#endif
+}
+
+// Saturate to the Q15 range
+static inline q15_t dsp_sat_q15(int32_t x) {
+#if DSP_HAVE_SIMD
+    return (q15_t)__ssat(x, 16);
+#else
+    if(x > Q15_MAX) return Q15_MAX;
+    if(x < Q15_MIN) return Q15_MIN;
+    return (q15_t)x;
+#endif
+}
+
+// Lane-wise saturating add of two packed pairs
+static inline uint32_t dsp_qadd16(uint32_t x, uint32_t y) {
+#if DSP_HAVE_SIMD
+    return (uint32_t)__qadd16((int16x2_t)x, (int16x2_t)y);
+#else
+    uint16_t lo = (uint16_t)dsp_sat_q15((int16_t)x + (int16_t)y);
+    uint16_t hi = (uint16_t)dsp_sat_q15((int16_t)(x >> 16) + (int16_t)(y >> 16));
+    return ((uint32_t)hi << 16) | lo;
+#endif
+}
+
+// Leading zeros, 32 for x == 0 like the CLZ instruction
+static inline uint8_t dsp_clz(uint32_t x) {
+    return x ? (uint8_t)__builtin_clz(x) : 32;
+}
+
+// ============================================================================
+// VECTOR KERNELS
+// ============================================================================
+
+// sum(a[i] * b[i]) in Q30; no overflow below 2^33 terms
+int64_t dsp_dot_q15(const q15_t* a, const q15_t* b, uint32_t n);
+
+// out[i] = sat(a[i] + b[i]); out may alias a or b
+void dsp_add_q15(const q15_t* a, const q15_t* b, q15_t* out, uint32_t n);
+
+// Q15.16 to Q15 with saturation (values outside [-1, 1) clip)
+void dsp_fixed_to_q15(const fixed_t* in, q15_t* out, uint32_t n);
+
+// Slide ref over x: out[k] = sum(ref[j] * x[k + j]) in Q15, saturated to
+// int32, for k = 0..n - ref_len. Returns the number of outputs.
+uint32_t dsp_correlate_q15(
+    const q15_t* x,
+    uint32_t n,
+    const q15_t* ref,
+    uint16_t ref_len,
+    int32_t* out);
+
+// Lagged mean product: out[lag] = mean(x[i] * y[i + lag]) in Q15 over the
+// n - lag overlapping samples, for lag = 0..max_lag
+void dsp_xcorr_q15(const q15_t* x, const q15_t* y, uint32_t n, int32_t* out, uint32_t max_lag);
+
+// ============================================================================
+// FIR FILTER
+// ============================================================================
+
+// coeffs[0] multiplies the newest sample (same order as FIRFilter_t)
+bool dsp_fir_q15_init(DspFirQ15_t* fir, const q15_t* coeffs, uint16_t taps);
+void dsp_fir_q15_reset(DspFirQ15_t* fir);
+q15_t dsp_fir_q15_process(DspFirQ15_t* fir, q15_t input);
+void dsp_fir_q15_block(DspFirQ15_t* fir, const q15_t* in, q15_t* out, uint32_t n);
+
+// ============================================================================
+// SQUARE ROOT
+// ============================================================================
+
+// floor(sqrt(x)); digit-by-digit from the top set bit, no division
+uint16_t dsp_isqrt32(uint32_t x);
+
+// Q15.16 square root, within 1 LSB; 0 for x <= 0
+fixed_t dsp_sqrt_fixed(fixed_t x);
+
+// ============================================================================
+// BINARY-ANGLE TRIGONOMETRY
+// ============================================================================
+
+// Quarter-wave table with linear interpolation; max error about 3e-5
+q15_t dsp_sin_q15(dsp_phase_t phase);
+q15_t dsp_cos_q15(dsp_phase_t phase);
+void dsp_sincos_q15(dsp_phase_t phase, q15_t* sin_out, q15_t* cos_out);
+
+// Q15.16 results; exactly +-1.0 at the peaks
+fixed_t dsp_sin_fixed(dsp_phase_t phase);
+fixed_t dsp_cos_fixed(dsp_phase_t phase);
+
+// Q15.16 radians to a phase; any angle, no wrapping loop
+static inline dsp_phase_t dsp_phase_from_radians(fixed_t radians) {
+    return (dsp_phase_t)(((int64_t)radians * DSP_RAD_TO_PHASE + FIXED_HALF) >> FIXED_FRACTIONAL_BITS);
+}
+
+// Per-sample phase increment of a freq_hz tone at sample_rate_hz
+static inline dsp_phase_t dsp_phase_step(uint32_t freq_hz, uint32_t sample_rate_hz) {
+    if(sample_rate_hz == 0) return 0;
+    return (dsp_phase_t)(((uint64_t)freq_hz << 32) / sample_rate_hz);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_H
@@ -0,0 +1,394 @@
+#include "fft.h"
+#include "dsp.h"
+
+_Static_assert(DSP_SIN_QUARTER == FFT_MAX_SIZE / 4, "twiddle table size mismatch");
+
+// Headroom limits: a radix-2 butterfly grows a component by at most 1 + sqrt(2),
+// a radix-4 butterfly (and the real-FFT split) by at most 1 + 3 * sqrt(2)
+#define FFT_LIMIT_RADIX2        (1L << 29)
+#define FFT_LIMIT_RADIX4        (1L << 28)
+
+// ============================================================================
+// TABLES
+// Twiddles come from the quarter-wave dsp_sin_quarter table in dsp.c.
+// Generated offline: fft_bitrev8[i] = i with its 8 bits reversed.
+// ============================================================================
+
+static const uint8_t fft_bitrev8[256] = {
+    0x00, 0x80, 0x40, 0xC0, 0x20, 0xA0, 0x60, 0xE0, 0x10, 0x90, 0x50, 0xD0, 0x30, 0xB0, 0x70, 0xF0,
+    0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0x68, 0xE8, 0x18, 0x98, 0x58, 0xD8, 0x38, 0xB8, 0x78, 0xF8,
+    0x04, 0x84, 0x44, 0xC4, 0x24, 0xA4, 0x64, 0xE4, 0x14, 0x94, 0x54, 0xD4, 0x34, 0xB4, 0x74, 0xF4,
+    0x0C, 0x8C, 0x4C, 0xCC, 0x2C, 0xAC, 0x6C, 0xEC, 0x1C, 0x9C, 0x5C, 0xDC, 0x3C, 0xBC, 0x7C, 0xFC,
+    0x02, 0x82, 0x42, 0xC2, 0x22, 0xA2, 0x62, 0xE2, 0x12, 0x92, 0x52, 0xD2, 0x32, 0xB2, 0x72, 0xF2,
+    0x0A, 0x8A, 0x4A, 0xCA, 0x2A, 0xAA, 0x6A, 0xEA, 0x1A, 0x9A, 0x5A, 0xDA, 0x3A, 0xBA, 0x7A, 0xFA,
+    0x06, 0x86, 0x46, 0xC6, 0x26, 0xA6, 0x66, 0xE6, 0x16, 0x96, 0x56, 0xD6, 0x36, 0xB6, 0x76, 0xF6,
+    0x0E, 0x8E, 0x4E, 0xCE, 0x2E, 0xAE, 0x6E, 0xEE, 0x1E, 0x9E, 0x5E, 0xDE, 0x3E, 0xBE, 0x7E, 0xFE,
+    0x01, 0x81, 0x41, 0xC1, 0x21, 0xA1, 0x61, 0xE1, 0x11, 0x91, 0x51, 0xD1, 0x31, 0xB1, 0x71, 0xF1,
+    0x09, 0x89, 0x49, 0xC9, 0x29, 0xA9, 0x69, 0xE9, 0x19, 0x99, 0x59, 0xD9, 0x39, 0xB9, 0x79, 0xF9,
+    0x05, 0x85, 0x45, 0xC5, 0x25, 0xA5, 0x65, 0xE5, 0x15, 0x95, 0x55, 0xD5, 0x35, 0xB5, 0x75, 0xF5,
+    0x0D, 0x8D, 0x4D, 0xCD, 0x2D, 0xAD, 0x6D, 0xED, 0x1D, 0x9D, 0x5D, 0xDD, 0x3D, 0xBD, 0x7D, 0xFD,
+    0x03, 0x83, 0x43, 0xC3, 0x23, 0xA3, 0x63, 0xE3, 0x13, 0x93, 0x53, 0xD3, 0x33, 0xB3, 0x73, 0xF3,
+    0x0B, 0x8B, 0x4B, 0xCB, 0x2B, 0xAB, 0x6B, 0xEB, 0x1B, 0x9B, 0x5B, 0xDB, 0x3B, 0xBB, 0x7B, 0xFB,
+    0x07, 0x87, 0x47, 0xC7, 0x27, 0xA7, 0x67, 0xE7, 0x17, 0x97, 0x57, 0xD7, 0x37, 0xB7, 0x77, 0xF7,
+    0x0F, 0x8F, 0x4F, 0xCF, 0x2F, 0xAF, 0x6F, 0xEF, 0x1F, 0x9F, 0x5F, 0xDF, 0x3F, 0xBF, 0x7F, 0xFF
+};
+
+// ============================================================================
+// HELPERS
+// ============================================================================
+
+// sin(2 * pi * m / FFT_MAX_SIZE) in Q1.15 from the quarter-wave table
+static inline int32_t twiddle_sin(uint32_t m) {
+    m &= FFT_MAX_SIZE - 1;
+    if(m <= FFT_MAX_SIZE / 4) return dsp_sin_quarter[m];
+    if(m <= FFT_MAX_SIZE / 2) return dsp_sin_quarter[FFT_MAX_SIZE / 2 - m];
+    if(m <= 3 * FFT_MAX_SIZE / 4) return -(int32_t)dsp_sin_quarter[m - FFT_MAX_SIZE / 2];
+    return -(int32_t)dsp_sin_quarter[FFT_MAX_SIZE - m];
+}
+
+static inline int32_t twiddle_cos(uint32_t m) {
+    return twiddle_sin(m + FFT_MAX_SIZE / 4);
+}
+
+static inline uint32_t bit_reverse(uint32_t i, uint8_t bits) {
+    uint32_t r = ((uint32_t)fft_bitrev8[i & 0xFF] << 8) | fft_bitrev8[(i >> 8) & 0xFF];
+    return r >> (16 - bits);
+}
+
+static inline uint8_t log2_u32(uint32_t n) {
+    uint8_t bits = 0;
+    while((1UL << bits) < n) bits++;
+    return bits;
+}
+
+// (re + i*im) * (c - i*s), twiddle in Q1.15 with rounding
+static inline void rotate(int32_t* re, int32_t* im, int32_t c, int32_t s) {
+    int64_t r = (int64_t)*re * c + (int64_t)*im * s;
+    int64_t i = (int64_t)*im * c - (int64_t)*re * s;
+    *re = (int32_t)((r + (1 << 14)) >> 15);
+    *im = (int32_t)((i + (1 << 14)) >> 15);
+}
+
+// Cheap magnitude bound: OR of |x| over the block
+static inline uint32_t mag_bits(int32_t x) {
+    return (uint32_t)(x ^ (x >> 31));
+}
+
+// Shift the block right until its magnitude bound is below limit. Returns
+// the shift applied (added to the block exponent).
+static uint8_t block_normalize(fixed_t* data, uint32_t count, uint32_t* mag, uint32_t limit) {
+    uint8_t shift = 0;
+    while((*mag >> shift) >= limit) shift++;
+    if(shift == 0) return 0;
+
+    for(uint32_t i = 0; i < count; i++) data[i] >>= shift;
+    *mag >>= shift;
+    return shift;
+}
+
+// 64-bit state times a Qq coefficient without overflowing the product
+static inline int64_t mul_s64_q(int64_t s, int32_t c, uint8_t q) {
+    int64_t hi = s >> q;
+    int64_t lo = s & (((int64_t)1 << q) - 1);
+    return hi * c + ((lo * c) >> q);
+}
+
+static uint32_t isqrt64(uint64_t x) {
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+
+    while(bit > x) bit >>= 2;
+    while(bit != 0) {
+        if(x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)result;
+}
+
+static inline fixed_t saturate_fixed(int64_t x) {
+    if(x > INT32_MAX) return INT32_MAX;
+    if(x < INT32_MIN) return INT32_MIN;
+    return (fixed_t)x;
+}
+
+// ============================================================================
+// COMPLEX FFT CORE
+// ============================================================================
+
+// Two fused radix-2 stages (spans s and 2s) on bit-reversed data: for each
+// group of 4s points, t1..t3 are rotated by w^2, w, w^3 with w = W_4s^j
+static uint32_t radix4_stage(fixed_t* x, uint32_t n, uint32_t s) {
+    uint32_t step = FFT_MAX_SIZE / (4 * s);
+    uint32_t mag = 0;
+
+    for(uint32_t j = 0; j < s; j++) {
+        uint32_t m = j * step;
+        int32_t c1 = twiddle_cos(m), s1 = twiddle_sin(m);
+        int32_t c2 = twiddle_cos(2 * m), s2 = twiddle_sin(2 * m);
+        int32_t c3 = twiddle_cos(3 * m), s3 = twiddle_sin(3 * m);
+
+        for(uint32_t g = j; g < n; g += 4 * s) {
+            fixed_t* p0 = &x[2 * g];
+            fixed_t* p1 = p0 + 2 * s;
+            fixed_t* p2 = p1 + 2 * s;
+            fixed_t* p3 = p2 + 2 * s;
+
+            int32_t t1r = p1[0], t1i = p1[1];
+            int32_t t2r = p2[0], t2i = p2[1];
+            int32_t t3r = p3[0], t3i = p3[1];
+            if(j != 0) {
+                rotate(&t1r, &t1i, c2, s2);
+                rotate(&t2r, &t2i, c1, s1);
+                rotate(&t3r, &t3i, c3, s3);
+            }
+
+            int32_t ar = p0[0] + t1r, ai = p0[1] + t1i;     // t0 + t1
+            int32_t br = p0[0] - t1r, bi = p0[1] - t1i;     // t0 - t1
+            int32_t cr = t2r + t3r, ci = t2i + t3i;         // t2 + t3
+            int32_t dr = t2r - t3r, di = t2i - t3i;         // t2 - t3
+
+            p0[0] = ar + cr; p0[1] = ai + ci;
+            p2[0] = ar - cr; p2[1] = ai - ci;
+            p1[0] = br + di; p1[1] = bi - dr;               // b - i*d
+            p3[0] = br - di; p3[1] = bi + dr;               // b + i*d
+
+            mag |= mag_bits(p0[0]) | mag_bits(p0[1]) | mag_bits(p1[0]) | mag_bits(p1[1]) |
+                   mag_bits(p2[0]) | mag_bits(p2[1]) | mag_bits(p3[0]) | mag_bits(p3[1]);
+        }
+    }
+
+    return mag;
+}
+
+// In-place FFT of any power-of-two size up to FFT_MAX_SIZE
+static int8_t fft_core(fixed_t* x, uint32_t n) {
+    uint8_t bits = log2_u32(n);
+    uint32_t mag = 0;
+    int8_t exponent = 0;
+
+    // Bit-reversal permutation
+    for(uint32_t i = 0; i < n; i++) {
+        uint32_t j = bit_reverse(i, bits);
+        if(j > i) {
+            fixed_t re = x[2 * i], im = x[2 * i + 1];
+            x[2 * i] = x[2 * j];
+            x[2 * i + 1] = x[2 * j + 1];
+            x[2 * j] = re;
+            x[2 * j + 1] = im;
+        }
+        mag |= mag_bits(x[2 * i]) | mag_bits(x[2 * i + 1]);
+    }
+
+    // Odd power of two: one radix-2 stage with unit twiddles first
+    uint32_t span = 1;
+    if(bits & 1) {
+        exponent += block_normalize(x, 2 * n, &mag, FFT_LIMIT_RADIX2);
+        mag = 0;
+        for(uint32_t i = 0; i < 2 * n; i += 4) {
+            int32_t ar = x[i], ai = x[i + 1];
+            int32_t br = x[i + 2], bi = x[i + 3];
+            x[i] = ar + br; x[i + 1] = ai + bi;
+            x[i + 2] = ar - br; x[i + 3] = ai - bi;
+            mag |= mag_bits(x[i]) | mag_bits(x[i + 1]) | mag_bits(x[i + 2]) | mag_bits(x[i + 3]);
+        }
+        span = 2;
+    }
+
+    for(; span < n; span *= 4) {
+        exponent += block_normalize(x, 2 * n, &mag, FFT_LIMIT_RADIX4);
+        mag = radix4_stage(x, n, span);
+    }
+
+    return exponent;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool fft_size_supported(uint32_t n) {
+    return n >= FFT_MIN_SIZE && n <= FFT_MAX_SIZE && (n & (n - 1)) == 0;
+}
+
+// Complex in-place FFT, returns block exponent
+int8_t fft_complex(fixed_t* data, uint16_t n) {
+    if(!data || !fft_size_supported(n)) return FFT_ERROR;
+    return fft_core(data, n);
+}
+
+// Real in-place FFT: n/2-point complex FFT of the (even, odd) sample pairs,
+// then the split X[k] = (Z[k] + Z*[m-k] - i W_n^k (Z[k] - Z*[m-k])) / 2
+int8_t fft_real(fixed_t* data, uint16_t n) {
+    if(!data || !fft_size_supported(n)) return FFT_ERROR;
+
+    uint32_t m = n / 2;
+    int8_t exponent = fft_core(data, m);
+
+    uint32_t mag = 0;
+    for(uint32_t i = 0; i < n; i++) mag |= mag_bits(data[i]);
+    exponent += block_normalize(data, n, &mag, FFT_LIMIT_RADIX4);
+
+    // The split is computed without the 1/2, which moves into the exponent
+    int32_t z0r = data[0], z0i = data[1];
+    data[0] = 2 * (z0r + z0i);
+    data[1] = 2 * (z0r - z0i);
+
+    uint32_t step = FFT_MAX_SIZE / n;
+    for(uint32_t k = 1; k <= m / 2; k++) {
+        fixed_t* zk = &data[2 * k];
+        fixed_t* zc = &data[2 * (m - k)];
+
+        int32_t sr = zk[0] + zc[0], si = zk[1] - zc[1];     // Z[k] + conj(Z[m-k])
+        int32_t qr = zk[0] - zc[0], qi = zk[1] + zc[1];     // Z[k] - conj(Z[m-k])
+        rotate(&qr, &qi, twiddle_cos(k * step), twiddle_sin(k * step));
+
+        zk[0] = sr + qi; zk[1] = si - qr;                   // sum - i*q
+        if(zc != zk) {
+            zc[0] = sr - qi; zc[1] = -si - qr;              // conj(sum) - i*conj(q)
+        }
+    }
+
+    return exponent - 1;
+}
+
+// Amplitude spectrum from packed fft_real output, written to data[0 .. n/2 - 1]
+void fft_real_magnitude(fixed_t* data, uint16_t n, int8_t exponent) {
+    if(!data || !fft_size_supported(n) || exponent == FFT_ERROR) return;
+
+    int32_t shift = exponent - log2_u32(n);
+    for(uint32_t k = 0; k < n / 2u; k++) {
+        uint64_t mag;
+        if(k == 0) {
+            mag = (uint64_t)(data[0] < 0 ? -(int64_t)data[0] : data[0]);
+        } else {
+            int64_t re = data[2 * k], im = data[2 * k + 1];
+            mag = isqrt64((uint64_t)(re * re) + (uint64_t)(im * im));
+        }
+
+        // Slot k is rewritten only after bins <= k were read
+        if(shift >= 0) {
+            data[k] = saturate_fixed((int64_t)(mag << shift));
+        } else {
+            data[k] = (fixed_t)((mag + ((uint64_t)1 << (-shift - 1))) >> -shift);
+        }
+    }
+}
+
+// ============================================================================
+// GOERTZEL
+// ============================================================================
+
+// sin and cos of a phase (2^32 = one cycle) in Q30: octant reduction, then
+// Taylor series on [0, pi/4] (error below 2e-9). Used once per Goertzel setup,
+// where Q1.15 twiddles would smear strong tones into neighbouring bins.
+static void sincos_q30(uint32_t phase, int32_t* sin_out, int32_t* cos_out) {
+    uint8_t octant = phase >> 29;
+    uint32_t r = phase & ((1UL << 29) - 1);
+    if(octant & 1) r = (1UL << 29) - r;
+
+    int64_t x = ((uint64_t)r * 3373259426ULL) >> 31;         // r * pi / 2^31, pi in Q30
+    int64_t x2 = (x * x) >> 30;
+    int64_t one = (int64_t)1 << 30;
+
+    int64_t s = one - x2 / 72;
+    s = one - ((x2 * s) >> 30) / 42;
+    s = one - ((x2 * s) >> 30) / 20;
+    s = one - ((x2 * s) >> 30) / 6;
+    s = (x * s) >> 30;
+
+    int64_t c = one - x2 / 90;
+    c = one - ((x2 * c) >> 30) / 56;
+    c = one - ((x2 * c) >> 30) / 30;
+    c = one - ((x2 * c) >> 30) / 12;
+    c = one - ((x2 * c) >> 30) / 2;
+
+    // Odd octants mirror: the reduced angle is measured from the next axis
+    int64_t sv, cv;
+    switch(octant) {
+    case 0: sv = s; cv = c; break;
+    case 1: sv = c; cv = s; break;
+    case 2: sv = c; cv = -s; break;
+    case 3: sv = s; cv = -c; break;
+    case 4: sv = -s; cv = -c; break;
+    case 5: sv = -c; cv = -s; break;
+    case 6: sv = -c; cv = s; break;
+    default: sv = -s; cv = c; break;
+    }
+
+    *sin_out = (int32_t)(sv >= one ? one - 1 : sv);
+    *cos_out = (int32_t)(cv >= one ? one - 1 : cv);
+}
+
+static void goertzel_setup(GoertzelState_t* g, uint32_t phase) {
+    sincos_q30(phase, &g->sin_q30, &g->cos_q30);
+    g->coeff = g->cos_q30;          // 2cos(w) in Q29 has the same bits as cos(w) in Q30
+    goertzel_reset(g);
+}
+
+// Arbitrary frequency; trig is evaluated once here, not per sample
+void goertzel_init(GoertzelState_t* g, uint32_t target_hz, uint32_t sample_rate_hz) {
+    if(!g) return;
+    if(sample_rate_hz == 0) sample_rate_hz = 1;   // Degenerate: DC
+    goertzel_setup(g, (uint32_t)(((uint64_t)(target_hz % sample_rate_hz) << 32) / sample_rate_hz));
+}
+
+// Bin k of an n-point DFT
+void goertzel_init_bin(GoertzelState_t* g, uint32_t k, uint32_t n) {
+    if(!g) return;
+    if(n == 0) n = 1;                               // Degenerate: DC
+    goertzel_setup(g, (uint32_t)(((uint64_t)(k % n) << 32) / n));
+}
+
+void goertzel_reset(GoertzelState_t* g) {
+    g->s1 = 0;
+    g->s2 = 0;
+    g->count = 0;
+}
+
+// s[i] = x[i] + 2cos(w) s[i-1] - s[i-2]
+void goertzel_process(GoertzelState_t* g, const fixed_t* data, uint32_t n) {
+    int64_t s1 = g->s1;
+    int64_t s2 = g->s2;
+
+    for(uint32_t i = 0; i < n; i++) {
+        int64_t s0 = data[i] + mul_s64_q(s1, g->coeff, 29) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    g->s1 = s1;
+    g->s2 = s2;
+    g->count += n;
+}
+
+// One zero-input step, then X = s[N] - e^{-iw} s[N-1]. Matches the DFT sum
+// for integer bins; saturates to the fixed_t range.
+void goertzel_result(const GoertzelState_t* g, fixed_t* real, fixed_t* imag) {
+    int64_t sn = mul_s64_q(g->s1, g->coeff, 29) - g->s2;
+    if(real) *real = saturate_fixed(sn - mul_s64_q(g->s1, g->cos_q30, 30));
+    if(imag) *imag = saturate_fixed(mul_s64_q(g->s1, g->sin_q30, 30));
+}
+
+// Sinusoid amplitude at the target frequency: 2|X| / N in input units
+fixed_t goertzel_amplitude(const GoertzelState_t* g) {
+    if(g->count == 0) return 0;
+
+    int64_t sn = mul_s64_q(g->s1, g->coeff, 29) - g->s2;
+    int64_t re = sn - mul_s64_q(g->s1, g->cos_q30, 30);
+    int64_t im = mul_s64_q(g->s1, g->sin_q30, 30);
+
+    // Keep the squares inside 64 bits
+    uint8_t shift = 0;
+    while((re >> shift) > INT32_MAX || (re >> shift) < INT32_MIN ||
+          (im >> shift) > INT32_MAX || (im >> shift) < INT32_MIN) shift++;
+    re >>= shift;
+    im >>= shift;
+
+    uint64_t mag = (uint64_t)isqrt64((uint64_t)(re * re) + (uint64_t)(im * im)) << shift;
+    return saturate_fixed((int64_t)((2 * mag) / g->count));
+}
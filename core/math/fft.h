@@ -0,0 +1,68 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "fixed_point.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// FIXED-POINT FFT AND GOERTZEL
+// In-place decimation-in-time FFT on interleaved (re, im) fixed_t pairs:
+// bit-reversal by table, radix-4 butterflies (plus one radix-2 stage for odd
+// powers of two) and constant quarter-wave twiddles in Q1.15. Block floating
+// point: before each stage the block is shifted right just enough to leave
+// headroom, and the shifts are returned as an exponent, so Q15.16 inputs of
+// any magnitude never overflow.
+//
+// True transform = output * 2^exponent (no 1/n normalisation).
+// ============================================================================
+
+#define FFT_MIN_SIZE            64
+#define FFT_MAX_SIZE            1024            // Twiddle table resolution
+#define FFT_ERROR               INT8_MIN        // Returned for unsupported sizes
+
+typedef struct {
+    int64_t s1;                     // s[n-1]
+    int64_t s2;                     // s[n-2]
+    int32_t coeff;                  // 2cos(w) in Q29
+    int32_t cos_q30;
+    int32_t sin_q30;
+    uint32_t count;                 // Samples processed
+} GoertzelState_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// n must be a power of two in [FFT_MIN_SIZE, FFT_MAX_SIZE]
+bool fft_size_supported(uint32_t n);
+
+// Complex FFT of n points: data holds 2n values (re0, im0, re1, im1, ...)
+int8_t fft_complex(fixed_t* data, uint16_t n);
+
+// Real FFT of n samples via an n/2-point complex FFT. Output is packed in
+// place: data[0] = X[0], data[1] = X[n/2] (both real), then (re, im) of
+// X[1] .. X[n/2 - 1].
+int8_t fft_real(fixed_t* data, uint16_t n);
+
+// Packed fft_real output -> n/2 amplitudes |X[k]| / n in input units
+void fft_real_magnitude(fixed_t* data, uint16_t n, int8_t exponent);
+
+// Goertzel single-bin DFT (no per-sample trig). init_bin targets bin k of an
+// n-point DFT, init an arbitrary frequency.
+void goertzel_init(GoertzelState_t* g, uint32_t target_hz, uint32_t sample_rate_hz);
+void goertzel_init_bin(GoertzelState_t* g, uint32_t k, uint32_t n);
+void goertzel_reset(GoertzelState_t* g);
+void goertzel_process(GoertzelState_t* g, const fixed_t* data, uint32_t n);
+void goertzel_result(const GoertzelState_t* g, fixed_t* real, fixed_t* imag);
+fixed_t goertzel_amplitude(const GoertzelState_t* g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FFT_H
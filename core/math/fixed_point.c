@@ -1,4 +1,5 @@
 #include "fixed_point.h"
+#include "dsp.h"
 #include <string.h>
 
 // Log2 lookup table for 8-bit values (0-255)
@@ -25,14 +26,6 @@ static const uint16_t log2_lut[256] = {
     // For brevity, showing pattern - full table would have 256 entries
 };
 
-// Sine lookup table for CORDIC or direct lookup
-// 256 entries covering 0 to 2π (0 to 65536 in fixed-point angle)
-static const int16_t sin_lut[256] = {
-    0, 402, 804, 1206, 1608, 2009, 2410, 2811,
-    3212, 3612, 4011, 4410, 4808, 5205, 5602, 5998,
-    // ... (full 256-entry table would continue)
-};
-
 // Initialize fixed-point library
 void fixed_point_init(void) {
     // Verify lookup tables are properly initialized
@@ -68,27 +61,9 @@ fixed_t fixed_div(fixed_t a, fixed_t b) {
     return (fixed_t)(temp / b);
 }
 
-// Square root using Newton-Raphson method
+// Square root: CLZ-normalised integer root (dsp_sqrt_fixed)
 fixed_t fixed_sqrt(fixed_t x) {
-    if(x <= 0) return 0;
-    
-    // Initial guess: x / 2
-    fixed_t guess = x >> 1;
-    if(guess == 0) guess = FIXED_ONE;
-    
-    // Newton-Raphson iteration: guess = (guess + x/guess) / 2
-    for(int i = 0; i < 8; i++) {  // 8 iterations for convergence
-        fixed_t div_result = fixed_div(x, guess);
-        fixed_t new_guess = (guess + div_result) >> 1;
-        
-        // Check for convergence
-        if(fixed_abs(new_guess - guess) < 16) {  // Close enough
-            break;
-        }
-        guess = new_guess;
-    }
-    
-    return guess;
+    return dsp_sqrt_fixed(x);
 }
 
 // Fast inverse square root (Quake III style)
@@ -176,36 +151,13 @@ fixed_t fixed_pow(fixed_t base, fixed_t exp) {
 
 // Sine using lookup table with linear interpolation
 fixed_t fixed_sin(fixed_t x) {
-    // Normalize angle to [0, 2π) in fixed-point
-    // 2π ≈ 411774 in Q15.16 (2π * 65536)
-    const fixed_t two_pi = FLOAT_TO_FIXED(6.283185f);
-    
-    // Wrap to [0, 2π)
-    while(x < 0) x += two_pi;
-    while(x >= two_pi) x -= two_pi;
-    
-    // Scale to table index: x * 256 / (2π) = x * 40.743
-    fixed_t index_fp = fixed_mul(x, FLOAT_TO_FIXED(40.743f));
-    int32_t index = FIXED_TO_INT(index_fp);
-    fixed_t frac = FIXED_FRAC_PART(index_fp);
-    
-    // Clamp index
-    if(index < 0) index = 0;
-    if(index >= 255) index = 255;
-    
-    // Linear interpolation
-    int16_t val1 = sin_lut[index];
-    int16_t val2 = sin_lut[index + 1];
-    int32_t diff = val2 - val1;
-    
-    fixed_t result = INT_TO_FIXED(val1) + fixed_mul(INT_TO_FIXED(diff), frac);
-    return result >> 8;  // Adjust for table scaling
+    // Radians to a binary angle; the uint32 phase wraps by itself
+    return dsp_sin_fixed(dsp_phase_from_radians(x));
 }
 
 // Cosine: cos(x) = sin(x + π/2)
 fixed_t fixed_cos(fixed_t x) {
-    const fixed_t half_pi = FLOAT_TO_FIXED(1.570796f);
-    return fixed_sin(x + half_pi);
+    return dsp_cos_fixed(dsp_phase_from_radians(x));
 }
 
 // Tangent: tan(x) = sin(x) / cos(x)
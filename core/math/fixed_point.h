@@ -96,7 +96,7 @@ static inline fixed_t fixed_clamp(fixed_t x, fixed_t min, fixed_t max) {
 // ADVANCED OPERATIONS
 // ============================================================================
 
-// Square root using integer bit-shift algorithm (Newton-Raphson)
+// Square root, CLZ-normalised integer root (dsp.h)
 fixed_t fixed_sqrt(fixed_t x);
 
 // Fast inverse square root (Quake III style)
@@ -111,7 +111,7 @@ fixed_t fixed_log(fixed_t x);
 // Power function (x^y)
 fixed_t fixed_pow(fixed_t base, fixed_t exp);
 
-// Trigonometric functions (using CORDIC or lookup tables)
+// Trigonometric functions (binary-angle quarter-wave table, dsp.h)
 fixed_t fixed_sin(fixed_t x);   // x in radians
 fixed_t fixed_cos(fixed_t x);   // x in radians
 fixed_t fixed_tan(fixed_t x);   // x in radians
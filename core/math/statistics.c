@@ -1,4 +1,5 @@
 #include "statistics.h"
+#include "fft.h"
 #include <string.h>
 
 // Welford's online algorithm initialization
@@ -209,27 +210,93 @@ fixed_t stats_std_dev(const fixed_t* data, uint32_t n) {
     return fixed_sqrt(stats_variance(data, n));
 }
 
-// Calculate median (modifies data array)
-fixed_t stats_median(fixed_t* data, uint32_t n) {
-    if(n == 0) return 0;
-    if(n == 1) return data[0];
-    
-    // Simple bubble sort for small n
-    for(uint32_t i = 0; i < n - 1; i++) {
-        for(uint32_t j = 0; j < n - i - 1; j++) {
-            if(data[j] > data[j + 1]) {
-                fixed_t temp = data[j];
-                data[j] = data[j + 1];
-                data[j + 1] = temp;
+// k-th smallest by quickselect. Keys are compared as (x ^ bias) so one
+// routine serves unsigned (bias 0) and signed (bias 0x80000000) data.
+static uint32_t select_biased(uint32_t* data, uint32_t n, uint32_t k, uint32_t bias) {
+    int32_t lo = 0;
+    int32_t hi = (int32_t)n - 1;
+
+    while(hi > lo) {
+        // Median-of-three pivot keeps sorted and reversed runs linear
+        int32_t mid = lo + (hi - lo) / 2;
+        uint32_t tmp;
+        if((data[mid] ^ bias) < (data[lo] ^ bias)) {
+            tmp = data[mid]; data[mid] = data[lo]; data[lo] = tmp;
+        }
+        if((data[hi] ^ bias) < (data[lo] ^ bias)) {
+            tmp = data[hi]; data[hi] = data[lo]; data[lo] = tmp;
+        }
+        if((data[hi] ^ bias) < (data[mid] ^ bias)) {
+            tmp = data[hi]; data[hi] = data[mid]; data[mid] = tmp;
+        }
+        uint32_t pivot = data[mid] ^ bias;
+
+        // Hoare partition: [lo, j] <= pivot, [i, hi] >= pivot, between == pivot
+        int32_t i = lo;
+        int32_t j = hi;
+        while(i <= j) {
+            while((data[i] ^ bias) < pivot) i++;
+            while((data[j] ^ bias) > pivot) j--;
+            if(i <= j) {
+                tmp = data[i]; data[i] = data[j]; data[j] = tmp;
+                i++;
+                j--;
             }
         }
+
+        if((int32_t)k <= j) {
+            hi = j;
+        } else if((int32_t)k >= i) {
+            lo = i;
+        } else {
+            break;
+        }
     }
-    
-    if(n % 2 == 0) {
-        return (data[n/2 - 1] + data[n/2]) / 2;
-    } else {
-        return data[n/2];
+
+    return data[k];
+}
+
+// Largest of data[0..n), used for the lower middle after a selection
+static uint32_t max_biased(const uint32_t* data, uint32_t n, uint32_t bias) {
+    uint32_t best = data[0];
+    for(uint32_t i = 1; i < n; i++) {
+        if((data[i] ^ bias) > (best ^ bias)) best = data[i];
     }
+    return best;
+}
+
+// k-th smallest value, expected O(n); reorders data so that data[k] is in
+// its sorted place with smaller values before it
+fixed_t stats_select(fixed_t* data, uint32_t n, uint32_t k) {
+    if(n == 0 || k >= n) return 0;
+    return (fixed_t)select_biased((uint32_t*)data, n, k, 0x80000000UL);
+}
+
+uint32_t stats_select_u32(uint32_t* data, uint32_t n, uint32_t k) {
+    if(n == 0 || k >= n) return 0;
+    return select_biased(data, n, k, 0);
+}
+
+// Calculate median (modifies data array)
+fixed_t stats_median(fixed_t* data, uint32_t n) {
+    if(n == 0) return 0;
+
+    fixed_t upper = stats_select(data, n, n / 2);
+    if(n % 2 != 0) return upper;
+
+    fixed_t lower = (fixed_t)max_biased((const uint32_t*)data, n / 2, 0x80000000UL);
+    return (fixed_t)(((int64_t)lower + upper) / 2);
+}
+
+// Median of unsigned data (modifies data array)
+uint32_t stats_median_u32(uint32_t* data, uint32_t n) {
+    if(n == 0) return 0;
+
+    uint32_t upper = stats_select_u32(data, n, n / 2);
+    if(n % 2 != 0) return upper;
+
+    uint32_t lower = max_biased(data, n / 2, 0);
+    return (uint32_t)(((uint64_t)lower + upper) / 2);
 }
 
 // Calculate mode
@@ -254,6 +321,100 @@ fixed_t stats_mode(const fixed_t* data, uint32_t n) {
     return mode;
 }
 
+// Initialize a P² estimator for the given percentile (0-100)
+void p2_quantile_init(P2Quantile_t* est, uint8_t percentile) {
+    memset(est, 0, sizeof(P2Quantile_t));
+    if(percentile > 100) percentile = 100;
+    est->p = (fixed_t)(((uint32_t)percentile << FIXED_FRACTIONAL_BITS) / 100);
+}
+
+// Desired position of marker i after count samples, Q16
+static int64_t p2_desired(const P2Quantile_t* est, uint8_t i) {
+    // Twice the marker fractions {0, p/2, p, (1+p)/2, 1}, as base + num * p
+    static const uint8_t f_base[5] = {0, 0, 0, 1, 2};
+    static const uint8_t f_num[5] = {0, 1, 2, 1, 0};
+    int64_t f2 = (int64_t)f_base[i] * FIXED_ONE + (int64_t)f_num[i] * est->p;
+    return ((int64_t)(est->count - 1) * f2) >> 1;
+}
+
+// Add one sample: O(1), at most three marker moves
+void p2_quantile_add(P2Quantile_t* est, int32_t sample) {
+    // Heights carry 16 fraction bits so sub-unit marker moves accumulate
+    int64_t x = (int64_t)sample << FIXED_FRACTIONAL_BITS;
+    int64_t* q = est->height;
+    uint32_t* pos = est->pos;
+
+    // First five samples: keep them sorted, they seed the markers
+    if(est->count < 5) {
+        uint32_t i = est->count;
+        while(i > 0 && q[i - 1] > x) {
+            q[i] = q[i - 1];
+            i--;
+        }
+        q[i] = x;
+        est->count++;
+        if(est->count == 5) {
+            for(uint8_t m = 0; m < 5; m++) pos[m] = m;
+        }
+        return;
+    }
+
+    // Cell holding x; the end markers track min and max
+    uint8_t k;
+    if(x < q[0]) {
+        q[0] = x;
+        k = 0;
+    } else if(x >= q[4]) {
+        q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while(k < 3 && x >= q[k + 1]) k++;
+    }
+
+    for(uint8_t m = k + 1; m < 5; m++) pos[m]++;
+    est->count++;
+
+    // Move the inner markers that drifted at least one position off target
+    for(uint8_t i = 1; i < 4; i++) {
+        int64_t diff = p2_desired(est, i) - ((int64_t)pos[i] << FIXED_FRACTIONAL_BITS);
+        int32_t a = (int32_t)(pos[i] - pos[i - 1]);
+        int32_t b = (int32_t)(pos[i + 1] - pos[i]);
+        int32_t d;
+
+        if(diff >= FIXED_ONE && b > 1) {
+            d = 1;
+        } else if(diff <= -FIXED_ONE && a > 1) {
+            d = -1;
+        } else {
+            continue;
+        }
+
+        // Piecewise-parabolic prediction, linear if it leaves the neighbours
+        int64_t rise = q[i + 1] - q[i];
+        int64_t fall = q[i] - q[i - 1];
+        int64_t t = (rise / b) * (a + d) + (fall / a) * (b - d);
+        int64_t h = q[i] + d * t / (a + b);
+
+        if(h <= q[i - 1] || h >= q[i + 1]) {
+            h = (d > 0) ? q[i] + rise / b : q[i] - fall / a;
+        }
+
+        q[i] = h;
+        pos[i] += d;
+    }
+}
+
+// Current estimate; exact nearest-rank value while fewer than five samples
+int32_t p2_quantile_get(const P2Quantile_t* est) {
+    if(est->count == 0) return 0;
+    if(est->count < 5) {
+        uint32_t i = (uint32_t)(((uint64_t)(est->count - 1) * est->p + FIXED_HALF) >> FIXED_FRACTIONAL_BITS);
+        return (int32_t)(est->height[i] >> FIXED_FRACTIONAL_BITS);
+    }
+    return (int32_t)((est->height[2] + FIXED_HALF) >> FIXED_FRACTIONAL_BITS);
+}
+
 // Calculate range
 fixed_t stats_range(const fixed_t* data, uint32_t n) {
     if(n == 0) return 0;
@@ -348,11 +509,12 @@ fixed_t stats_covariance(const fixed_t* x, const fixed_t* y, uint32_t n) {
 void stats_cross_correlation(const fixed_t* x, const fixed_t* y, uint32_t n,
                               fixed_t* result, uint32_t max_lag) {
     for(uint32_t lag = 0; lag < max_lag && lag < n; lag++) {
-        fixed_t sum = 0;
+        // Accumulate the raw Q31.32 products and scale once per lag
+        fixed_dbl_t sum = 0;
         for(uint32_t i = 0; i < n - lag; i++) {
-            sum += fixed_mul(x[i], y[i + lag]);
+            sum += (fixed_dbl_t)x[i] * y[i + lag];
         }
-        result[lag] = sum / (n - lag);
+        result[lag] = (fixed_t)((sum / (fixed_dbl_t)(n - lag)) >> FIXED_FRACTIONAL_BITS);
     }
 }
 
@@ -367,18 +529,22 @@ void fir_filter_init(FIRFilter_t* filter, const fixed_t* coeffs, uint8_t order)
 
 // Process sample through FIR filter
 fixed_t fir_filter_process(FIRFilter_t* filter, fixed_t input) {
-    // Add new sample to history
+    uint8_t order = filter->order;
+    if(order == 0) return 0;
+
+    // Store the sample twice so the window never wraps
     filter->history[filter->index] = input;
-    filter->index = (filter->index + 1) % filter->order;
-    
-    // Calculate output
-    fixed_t output = 0;
-    for(uint8_t i = 0; i < filter->order; i++) {
-        uint8_t idx = (filter->index + filter->order - 1 - i) % filter->order;
-        output += fixed_mul(filter->coeffs[i], filter->history[idx]);
+    filter->history[filter->index + order] = input;
+    filter->index = (filter->index + 1 == order) ? 0 : filter->index + 1;
+
+    // history[index .. index + order) runs oldest to newest; coeffs[0] takes the newest
+    const fixed_t* window = &filter->history[filter->index];
+    fixed_dbl_t acc = 0;
+    for(uint8_t i = 0; i < order; i++) {
+        acc += (fixed_dbl_t)filter->coeffs[i] * window[order - 1 - i];
     }
-    
-    return output;
+
+    return (fixed_t)((acc + FIXED_HALF) >> FIXED_FRACTIONAL_BITS);
 }
 
 // Initialize IIR filter
@@ -554,28 +720,27 @@ void stats_mutual_information(const uint8_t* x, const uint8_t* y, uint32_t len,
     *mi = h_x + h_y - *joint_entropy;
 }
 
-// Simplified FFT magnitude (placeholder)
+// Amplitude spectrum |X[k]| / n of a real signal. freq_magnitude must hold n
+// values (it is the FFT work area); bins 0 .. n/2 - 1 are returned in it.
+// Sizes outside FFT_MIN_SIZE .. FFT_MAX_SIZE (or not a power of two) give zeros.
 void stats_fft_magnitude(const fixed_t* time_data, uint32_t n,
                          fixed_t* freq_magnitude) {
-    // Placeholder - full FFT implementation would go here
-    // For now, just copy data
-    for(uint32_t i = 0; i < n && i < 64; i++) {
-        freq_magnitude[i] = fixed_abs(time_data[i]);
+    if(!fft_size_supported(n)) {
+        memset(freq_magnitude, 0, n * sizeof(fixed_t));
+        return;
     }
+    
+    memcpy(freq_magnitude, time_data, n * sizeof(fixed_t));
+    int8_t exponent = fft_real(freq_magnitude, (uint16_t)n);
+    fft_real_magnitude(freq_magnitude, (uint16_t)n, exponent);
 }
 
-// DFT single bin calculation
+// DFT single bin calculation (Goertzel, O(n) without per-sample trig)
 void stats_dft_bin(const fixed_t* data, uint32_t n, uint32_t k,
                     fixed_t* real, fixed_t* imag) {
-    *real = 0;
-    *imag = 0;
-    
-    fixed_t two_pi = FLOAT_TO_FIXED(6.283185307f);
-    fixed_t angle_step = fixed_div(two_pi * k, INT_TO_FIXED(n));
+    GoertzelState_t goertzel;
     
-    for(uint32_t i = 0; i < n; i++) {
-        fixed_t angle = angle_step * i;
-        *real += fixed_mul(data[i], fixed_cos(angle));
-        *imag -= fixed_mul(data[i], fixed_sin(angle));
-    }
+    goertzel_init_bin(&goertzel, k, n);
+    goertzel_process(&goertzel, data, n);
+    goertzel_result(&goertzel, real, imag);
 }
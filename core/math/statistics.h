@@ -50,6 +50,15 @@ typedef struct {
     fixed_t correlation;
 } LinearRegression_t;
 
+// P² streaming quantile (Jain & Chlamtac): five markers instead of a sample
+// buffer, O(1) per sample
+typedef struct {
+    int64_t height[5];          // Marker heights in Q16 (min, p/2, p, (1+p)/2, max)
+    uint32_t pos[5];            // Marker positions, 0-based
+    fixed_t p;                  // Target quantile, Q16 fraction
+    uint32_t count;             // Samples seen
+} P2Quantile_t;
+
 // ============================================================================
 // WELFORD'S ONLINE ALGORITHM
 // ============================================================================
@@ -90,11 +99,26 @@ fixed_t stats_mean(const fixed_t* data, uint32_t n);
 fixed_t stats_variance(const fixed_t* data, uint32_t n);
 fixed_t stats_std_dev(const fixed_t* data, uint32_t n);
 fixed_t stats_median(fixed_t* data, uint32_t n);  // Modifies data array
+uint32_t stats_median_u32(uint32_t* data, uint32_t n);  // Modifies data array
 fixed_t stats_mode(const fixed_t* data, uint32_t n);
 fixed_t stats_range(const fixed_t* data, uint32_t n);
 fixed_t stats_skewness(const fixed_t* data, uint32_t n);
 fixed_t stats_kurtosis(const fixed_t* data, uint32_t n);
 
+// k-th smallest (0-based) by quickselect, expected O(n). Reorders data:
+// afterwards data[k] is in sorted position, smaller values before it.
+fixed_t stats_select(fixed_t* data, uint32_t n, uint32_t k);
+uint32_t stats_select_u32(uint32_t* data, uint32_t n, uint32_t k);
+
+// ============================================================================
+// STREAMING QUANTILES
+// ============================================================================
+
+// Values are plain int32 (fixed_t or integer units such as microseconds)
+void p2_quantile_init(P2Quantile_t* est, uint8_t percentile);
+void p2_quantile_add(P2Quantile_t* est, int32_t sample);
+int32_t p2_quantile_get(const P2Quantile_t* est);
+
 // ============================================================================
 // CORRELATION AND COVARIANCE
 // ============================================================================
@@ -105,7 +129,7 @@ void stats_cross_correlation(const fixed_t* x, const fixed_t* y, uint32_t n,
                               fixed_t* result, uint32_t max_lag);
 
 // ============================================================================
-// FREQUENCY DOMAIN (Simplified FFT)
+// FREQUENCY DOMAIN (engine in fft.h)
 // ============================================================================
 
 void stats_fft_magnitude(const fixed_t* time_data, uint32_t n, 
@@ -119,7 +143,7 @@ void stats_dft_bin(const fixed_t* data, uint32_t n, uint32_t k,
 
 typedef struct {
     fixed_t coeffs[8];
-    fixed_t history[8];
+    fixed_t history[16];  // Delay line stored twice (see fir_filter_process)
     uint8_t order;
     uint8_t index;
 } FIRFilter_t;
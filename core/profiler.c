@@ -0,0 +1,632 @@
+#include "profiler.h"
+#include "hal/timer_precision.h"
+#include "../storage/sd_manager.h"
+
+#define TAG "PROFILER"
+
+#define PROFILER_CALIBRATION_RUNS   32
+#define PROFILER_HIST_SUB           (1UL << PROFILER_HIST_SUB_BITS)
+
+typedef struct {
+    ProfilerZoneId_t zone;
+    uint32_t start;                 // DWT_CYCCNT at enter
+    uint32_t child_cycles;          // Inclusive time of nested zones
+} ProfilerFrame_t;
+
+typedef struct {
+    FuriThreadId id;
+    const char* name;
+    bool accounted;                 // Brackets its waits (explicitly registered)
+    bool busy;
+    uint32_t busy_start;
+    uint32_t busy_isr_mark;         // isr_cycles_total at busy_start
+    uint32_t window_busy;           // Busy cycles in the open window
+    uint32_t last_busy;             // Busy cycles in the last closed window
+    uint8_t load_percent;
+    uint8_t depth;                  // May exceed PROFILER_MAX_DEPTH (frames dropped)
+    uint8_t max_depth;
+    uint32_t depth_overflows;
+    ProfilerFrame_t frames[PROFILER_MAX_DEPTH];
+} ProfilerThread_t;
+
+// Zone registry persists across profiler_init so call-site ids stay valid
+static char zone_names[PROFILER_MAX_ZONES][PROFILER_NAME_LEN];
+static uint8_t zone_count = 0;
+static ProfilerZoneStats_t zone_stats[PROFILER_MAX_ZONES];
+
+static ProfilerThread_t threads[PROFILER_MAX_THREADS];
+static uint8_t thread_count = 0;
+
+static ProfilerIsrStats_t isr_stats[PROFILER_ISR_COUNT];
+static uint32_t isr_probe_cycles[PROFILER_ISR_COUNT];
+static volatile bool isr_probe_armed[PROFILER_ISR_COUNT];
+static uint32_t isr_cycles_total = 0;   // All hooked ISRs, wraps
+static uint32_t isr_sample_mark = 0;
+static uint8_t isr_load_percent = 0;
+
+static uint32_t sample_start = 0;       // DWT_CYCCNT at the last cpu sample
+static uint32_t overhead_cycles = 0;    // Measured cost of an empty zone
+
+static ProfilerTraceRecord_t trace_records[PROFILER_TRACE_RECORDS];
+static uint32_t trace_head = 0;
+static volatile bool trace_armed = false;
+
+static const char* const isr_names[PROFILER_ISR_COUNT] = {
+    [PROFILER_ISR_GDO0]     = "gdo0",
+    [PROFILER_ISR_EDGE_DMA] = "edge_dma",
+};
+
+// ============================================================================
+// HISTOGRAM
+// ============================================================================
+
+static inline uint8_t hist_bucket(uint32_t cycles) {
+    if(cycles < PROFILER_HIST_SUB) return (uint8_t)cycles;
+
+    uint32_t msb = 31 - __builtin_clz(cycles);
+    uint32_t bucket = ((msb - PROFILER_HIST_SUB_BITS + 1) << PROFILER_HIST_SUB_BITS) |
+                      ((cycles >> (msb - PROFILER_HIST_SUB_BITS)) & (PROFILER_HIST_SUB - 1));
+    return (bucket < PROFILER_HIST_BUCKETS) ? (uint8_t)bucket : PROFILER_HIST_BUCKETS - 1;
+}
+
+// Largest value that maps to bucket
+static uint32_t hist_bucket_upper(uint8_t bucket) {
+    if(bucket < PROFILER_HIST_SUB) return bucket;
+
+    uint32_t msb = (bucket >> PROFILER_HIST_SUB_BITS) + PROFILER_HIST_SUB_BITS - 1;
+    uint32_t width = 1UL << (msb - PROFILER_HIST_SUB_BITS);
+    uint32_t low = (PROFILER_HIST_SUB | (bucket & (PROFILER_HIST_SUB - 1))) * width;
+    return low + width - 1;
+}
+
+// Upper bound of the bucket holding the given percentile (0 if empty)
+uint32_t profiler_hist_percentile(const uint32_t* hist, uint32_t count, uint8_t percentile) {
+    if(!hist || count == 0) return 0;
+
+    uint32_t target = (uint32_t)(((uint64_t)count * percentile + 99) / 100);
+    if(target == 0) target = 1;
+
+    uint32_t seen = 0;
+    for(uint8_t b = 0; b < PROFILER_HIST_BUCKETS; b++) {
+        seen += hist[b];
+        if(seen >= target) return hist_bucket_upper(b);
+    }
+    return hist_bucket_upper(PROFILER_HIST_BUCKETS - 1);
+}
+
+// ============================================================================
+// THREADS AND TRACE
+// ============================================================================
+
+static ProfilerThread_t* thread_add(FuriThreadId id, const char* name) {
+    ProfilerThread_t* thread = NULL;
+
+    uint32_t primask = critical_section_enter();
+    for(uint8_t i = 0; i < thread_count; i++) {
+        if(threads[i].id == id) thread = &threads[i];
+    }
+    if(!thread && thread_count < PROFILER_MAX_THREADS) {
+        thread = &threads[thread_count];
+        memset(thread, 0, sizeof(*thread));
+        thread->name = name;
+        thread->id = id;
+        __atomic_store_n(&thread_count, thread_count + 1, __ATOMIC_RELEASE);
+    }
+    critical_section_exit(primask);
+
+    return thread;
+}
+
+// Slot of the calling thread, added on first use (NULL in ISR context or
+// when the table is full)
+static ProfilerThread_t* current_thread(void) {
+    if(FURI_IS_IRQ_MODE()) return NULL;
+
+    FuriThreadId id = furi_thread_get_current_id();
+    uint8_t count = __atomic_load_n(&thread_count, __ATOMIC_ACQUIRE);
+    for(uint8_t i = 0; i < count; i++) {
+        if(threads[i].id == id) return &threads[i];
+    }
+    return thread_add(id, furi_thread_get_name(id));
+}
+
+static inline uint8_t thread_index(const ProfilerThread_t* thread) {
+    return (uint8_t)(thread - threads);
+}
+
+// Fold the running busy span into the window, minus ISR time within it.
+// The span is wall time between active and idle marks, so time the thread
+// spent preempted by other threads is counted too; there is no scheduler
+// switch hook to split it out. Caller holds a critical section.
+static void thread_close_busy(ProfilerThread_t* thread, uint32_t now) {
+    uint32_t span = now - thread->busy_start;
+    uint32_t isr = isr_cycles_total - thread->busy_isr_mark;
+    thread->window_busy += (span > isr) ? span - isr : 0;
+    thread->busy_start = now;
+    thread->busy_isr_mark = isr_cycles_total;
+}
+
+static void trace_push(ProfilerTraceKind_t kind, ProfilerZoneId_t zone,
+                       const ProfilerThread_t* thread, uint8_t depth, uint32_t cycles) {
+    if(!trace_armed) return;
+
+    uint32_t slot = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    if(slot >= PROFILER_TRACE_RECORDS) {
+        trace_armed = false;
+        return;
+    }
+
+    ProfilerTraceRecord_t* rec = &trace_records[slot];
+    rec->cycles = cycles;
+    rec->zone = zone;
+    rec->thread = thread_index(thread);
+    rec->kind = kind;
+    rec->depth = depth;
+}
+
+// ============================================================================
+// ZONES
+// ============================================================================
+
+static void zone_stats_add(ProfilerZoneId_t zone, uint32_t cycles, uint32_t self_cycles) {
+    ProfilerZoneStats_t* stats = &zone_stats[zone];
+    uint8_t bucket = hist_bucket(cycles);
+
+    uint32_t primask = critical_section_enter();
+    stats->count++;
+    stats->total_cycles += cycles;
+    stats->self_cycles += self_cycles;
+    if(cycles < stats->min_cycles) stats->min_cycles = cycles;
+    if(cycles > stats->max_cycles) stats->max_cycles = cycles;
+    stats->hist[bucket]++;
+    critical_section_exit(primask);
+}
+
+static void zone_stats_clear(void) {
+    memset(zone_stats, 0, sizeof(zone_stats));
+    for(uint8_t i = 0; i < PROFILER_MAX_ZONES; i++) {
+        zone_stats[i].min_cycles = UINT32_MAX;
+    }
+}
+
+// Id for name, registering it on first use (PROFILER_ZONE_NONE when full)
+ProfilerZoneId_t profiler_zone_register(const char* name) {
+    if(!name) return PROFILER_ZONE_NONE;
+
+    // Lookups are lock-free: entries are immutable once published
+    uint8_t count = __atomic_load_n(&zone_count, __ATOMIC_ACQUIRE);
+    for(uint8_t i = 0; i < count; i++) {
+        if(strncmp(zone_names[i], name, PROFILER_NAME_LEN - 1) == 0) return i;
+    }
+
+    ProfilerZoneId_t id = PROFILER_ZONE_NONE;
+    uint32_t primask = critical_section_enter();
+    for(uint8_t i = count; i < zone_count; i++) {
+        if(strncmp(zone_names[i], name, PROFILER_NAME_LEN - 1) == 0) id = i;
+    }
+    if(id == PROFILER_ZONE_NONE && zone_count < PROFILER_MAX_ZONES) {
+        id = zone_count;
+        strncpy(zone_names[id], name, PROFILER_NAME_LEN - 1);
+        zone_names[id][PROFILER_NAME_LEN - 1] = '\0';
+        __atomic_store_n(&zone_count, zone_count + 1, __ATOMIC_RELEASE);
+    }
+    critical_section_exit(primask);
+
+    if(id == PROFILER_ZONE_NONE) FURI_LOG_W(TAG, "Zone table full, %s not profiled", name);
+    return id;
+}
+
+void profiler_zone_enter(ProfilerZoneId_t zone) {
+    if(zone >= zone_count) return;
+    ProfilerThread_t* thread = current_thread();
+    if(!thread) return;
+
+    if(thread->depth >= PROFILER_MAX_DEPTH) {
+        thread->depth++;
+        thread->depth_overflows++;
+        return;
+    }
+
+    ProfilerFrame_t* frame = &thread->frames[thread->depth++];
+    if(thread->depth > thread->max_depth) thread->max_depth = thread->depth;
+    frame->zone = zone;
+    frame->child_cycles = 0;
+    trace_push(PROFILER_TRACE_ENTER, zone, thread, thread->depth - 1, DWT_CYCCNT);
+
+    // Bookkeeping done: start the clock last
+    frame->start = DWT_CYCCNT;
+}
+
+// Close the innermost open zone of the calling thread
+void profiler_zone_exit(ProfilerZoneId_t zone) {
+    uint32_t now = DWT_CYCCNT;
+    UNUSED(zone);
+
+    ProfilerThread_t* thread = current_thread();
+    if(!thread || thread->depth == 0) return;
+    if(--thread->depth >= PROFILER_MAX_DEPTH) return;
+
+    ProfilerFrame_t* frame = &thread->frames[thread->depth];
+    uint32_t raw = now - frame->start;
+    uint32_t cycles = (raw > overhead_cycles) ? raw - overhead_cycles : 0;
+    uint32_t self_cycles = (cycles > frame->child_cycles) ? cycles - frame->child_cycles : 0;
+
+    // The parent is charged everything, profiler overhead included
+    if(thread->depth > 0) {
+        thread->frames[thread->depth - 1].child_cycles += raw;
+    }
+
+    zone_stats_add(frame->zone, cycles, self_cycles);
+    trace_push(PROFILER_TRACE_EXIT, frame->zone, thread, thread->depth, now);
+}
+
+// Add a duration measured by the caller (e.g. interrupt to processing)
+void profiler_zone_record(ProfilerZoneId_t zone, uint32_t cycles) {
+    if(zone >= zone_count) return;
+
+    zone_stats_add(zone, cycles, cycles);
+
+    ProfilerThread_t* thread = current_thread();
+    if(thread) trace_push(PROFILER_TRACE_RECORD, zone, thread, thread->depth, cycles);
+}
+
+// PROFILE_SCOPE entry: register the call site once, then enter
+ProfilerScope_t profiler_scope_begin(ProfilerZoneId_t* site, const char* name) {
+    if(*site == PROFILER_ZONE_UNSET) *site = profiler_zone_register(name);
+
+    ProfilerScope_t scope = {.zone = *site};
+    profiler_zone_enter(scope.zone);
+    return scope;
+}
+
+// PROFILE_SCOPE cleanup handler
+void profiler_scope_end(ProfilerScope_t* scope) {
+    profiler_zone_exit(scope->zone);
+}
+
+// Cost of an empty zone on this thread, subtracted from every measurement
+static void calibrate_overhead(void) {
+    ProfilerZoneId_t zone = profiler_zone_register("profiler");
+    if(zone == PROFILER_ZONE_NONE) return;
+
+    overhead_cycles = 0;
+    for(uint8_t i = 0; i < PROFILER_CALIBRATION_RUNS; i++) {
+        profiler_zone_enter(zone);
+        profiler_zone_exit(zone);
+    }
+    overhead_cycles = zone_stats[zone].min_cycles;
+    memset(&zone_stats[zone], 0, sizeof(zone_stats[zone]));
+    zone_stats[zone].min_cycles = UINT32_MAX;
+}
+
+// ============================================================================
+// ISR HOOKS
+// ============================================================================
+
+// First statement of a hooked ISR; records probe latency if one is armed
+uint32_t profiler_isr_enter(ProfilerIsr_t isr) {
+    uint32_t now = DWT_CYCCNT;
+    if(isr >= PROFILER_ISR_COUNT) return now;
+
+    if(isr_probe_armed[isr]) {
+        isr_probe_armed[isr] = false;
+        uint32_t latency = now - isr_probe_cycles[isr];
+        ProfilerIsrStats_t* stats = &isr_stats[isr];
+        stats->probes++;
+        stats->latency_last_cycles = latency;
+        if(latency > stats->latency_max_cycles) stats->latency_max_cycles = latency;
+        stats->latency_hist[hist_bucket(latency)]++;
+    }
+
+    return now;
+}
+
+// Last statement of a hooked ISR
+void profiler_isr_exit(ProfilerIsr_t isr, uint32_t enter_cycles) {
+    if(isr >= PROFILER_ISR_COUNT) return;
+
+    uint32_t cycles = DWT_CYCCNT - enter_cycles;
+    ProfilerIsrStats_t* stats = &isr_stats[isr];
+    stats->count++;
+    stats->total_cycles += cycles;
+    if(cycles > stats->max_cycles) stats->max_cycles = cycles;
+
+    // ISRs of different priorities may nest
+    __atomic_fetch_add(&isr_cycles_total, cycles, __ATOMIC_RELAXED);
+}
+
+void profiler_isr_arm_probe(ProfilerIsr_t isr) {
+    if(isr >= PROFILER_ISR_COUNT) return;
+
+    isr_probe_cycles[isr] = DWT_CYCCNT;
+    __atomic_store_n(&isr_probe_armed[isr], true, __ATOMIC_RELEASE);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void profiler_init(void) {
+    memset(threads, 0, sizeof(threads));
+    thread_count = 0;
+    profiler_reset();
+    calibrate_overhead();
+
+    FURI_LOG_I(TAG, "Profiler ready, zone overhead %lu cycles", overhead_cycles);
+}
+
+// Clear all statistics (registered zones and threads are kept)
+void profiler_reset(void) {
+    uint32_t primask = critical_section_enter();
+
+    zone_stats_clear();
+    memset(isr_stats, 0, sizeof(isr_stats));
+    memset((void*)isr_probe_armed, 0, sizeof(isr_probe_armed));
+
+    uint32_t now = DWT_CYCCNT;
+    for(uint8_t i = 0; i < thread_count; i++) {
+        ProfilerThread_t* thread = &threads[i];
+        thread->busy_start = now;
+        thread->busy_isr_mark = isr_cycles_total;
+        thread->window_busy = 0;
+        thread->last_busy = 0;
+        thread->load_percent = 0;
+        thread->max_depth = thread->depth;
+        thread->depth_overflows = 0;
+    }
+    isr_sample_mark = isr_cycles_total;
+    isr_load_percent = 0;
+    sample_start = now;
+
+    critical_section_exit(primask);
+}
+
+// Register the calling thread for CPU accounting; it counts as busy until
+// its first profiler_thread_idle()
+uint8_t profiler_thread_register(const char* name) {
+    ProfilerThread_t* thread = current_thread();
+    if(!thread) return PROFILER_THREAD_NONE;
+
+    uint32_t primask = critical_section_enter();
+    if(name) thread->name = name;
+    thread->accounted = true;
+    thread->busy = true;
+    thread->busy_start = DWT_CYCCNT;
+    thread->busy_isr_mark = isr_cycles_total;
+    critical_section_exit(primask);
+
+    return thread_index(thread);
+}
+
+// Call right before the thread blocks
+void profiler_thread_idle(void) {
+    ProfilerThread_t* thread = current_thread();
+    if(!thread || !thread->accounted || !thread->busy) return;
+
+    uint32_t primask = critical_section_enter();
+    thread_close_busy(thread, DWT_CYCCNT);
+    thread->busy = false;
+    critical_section_exit(primask);
+}
+
+// Call right after the thread wakes
+void profiler_thread_active(void) {
+    ProfilerThread_t* thread = current_thread();
+    if(!thread || !thread->accounted || thread->busy) return;
+
+    uint32_t primask = critical_section_enter();
+    thread->busy = true;
+    thread->busy_start = DWT_CYCCNT;
+    thread->busy_isr_mark = isr_cycles_total;
+    critical_section_exit(primask);
+}
+
+// Close the accounting window (call periodically, < 67 s apart). Returns the
+// load of the accounted threads plus hooked ISRs; unhooked ISRs are charged
+// to the thread they interrupt. Per-thread loads include preemption by other
+// threads and are upper bounds: overlapping busy spans are counted once per
+// thread, so the sum is clamped to 100.
+uint8_t profiler_cpu_sample(void) {
+    uint32_t primask = critical_section_enter();
+
+    uint32_t now = DWT_CYCCNT;
+    uint32_t window = now - sample_start;
+    sample_start = now;
+
+    uint32_t total = 0;
+    for(uint8_t i = 0; i < thread_count; i++) {
+        ProfilerThread_t* thread = &threads[i];
+        if(!thread->accounted) continue;
+
+        if(thread->busy) thread_close_busy(thread, now);
+        thread->last_busy = thread->window_busy;
+        thread->window_busy = 0;
+        thread->load_percent = window ? (uint8_t)(((uint64_t)thread->last_busy * 100) / window) : 0;
+        total += thread->load_percent;
+    }
+
+    uint32_t isr = isr_cycles_total - isr_sample_mark;
+    isr_sample_mark = isr_cycles_total;
+    isr_load_percent = window ? (uint8_t)(((uint64_t)isr * 100) / window) : 0;
+    total += isr_load_percent;
+
+    critical_section_exit(primask);
+
+    return (total > 100) ? 100 : (uint8_t)total;
+}
+
+uint8_t profiler_isr_load_percent(void) {
+    return isr_load_percent;
+}
+
+uint8_t profiler_zone_count(void) {
+    return zone_count;
+}
+
+uint8_t profiler_thread_count(void) {
+    return thread_count;
+}
+
+const char* profiler_zone_name(ProfilerZoneId_t zone) {
+    return (zone < zone_count) ? zone_names[zone] : "unknown";
+}
+
+bool profiler_get_zone_stats(ProfilerZoneId_t zone, ProfilerZoneStats_t* stats) {
+    if(zone >= zone_count || !stats) return false;
+
+    uint32_t primask = critical_section_enter();
+    *stats = zone_stats[zone];
+    critical_section_exit(primask);
+    return true;
+}
+
+bool profiler_get_isr_stats(ProfilerIsr_t isr, ProfilerIsrStats_t* stats) {
+    if(isr >= PROFILER_ISR_COUNT || !stats) return false;
+
+    uint32_t primask = critical_section_enter();
+    *stats = isr_stats[isr];
+    critical_section_exit(primask);
+    return true;
+}
+
+bool profiler_get_thread_stats(uint8_t thread, ProfilerThreadStats_t* stats) {
+    if(thread >= thread_count || !stats) return false;
+
+    const ProfilerThread_t* slot = &threads[thread];
+    stats->name = slot->name;
+    stats->load_percent = slot->load_percent;
+    stats->busy_cycles = slot->last_busy;
+    stats->max_depth = slot->max_depth;
+    stats->depth_overflows = slot->depth_overflows;
+    return true;
+}
+
+// Cycles as "us.t" (one decimal)
+static int format_us(char* out, size_t size, uint32_t cycles) {
+    uint32_t tenths = (uint32_t)(((uint64_t)cycles * 10) / DWT_CYCCNT_US);
+    return snprintf(out, size, "%lu.%lu", tenths / 10, tenths % 10);
+}
+
+// Histogram percentile clamped to the exact extremes
+static uint32_t zone_percentile(const ProfilerZoneStats_t* stats, uint8_t percentile) {
+    uint32_t cycles = profiler_hist_percentile(stats->hist, stats->count, percentile);
+    if(cycles > stats->max_cycles) cycles = stats->max_cycles;
+    if(cycles < stats->min_cycles) cycles = stats->min_cycles;
+    return cycles;
+}
+
+// Per-zone percentiles (microseconds), thread loads and ISR figures
+void profiler_generate_report(char* buffer, uint32_t max_len) {
+    if(!buffer || max_len == 0) return;
+
+    int pos = snprintf(buffer, max_len,
+        "PROFILE (us, overhead %lu cycles)\n"
+        "  zone            count    p50    p95    p99    max  self%%\n",
+        overhead_cycles);
+
+    char p50[12], p95[12], p99[12], max[12];
+    ProfilerZoneStats_t stats;
+
+    for(uint8_t z = 0; z < zone_count && pos < (int)max_len - 80; z++) {
+        if(!profiler_get_zone_stats(z, &stats) || stats.count == 0) continue;
+
+        format_us(p50, sizeof(p50), zone_percentile(&stats, 50));
+        format_us(p95, sizeof(p95), zone_percentile(&stats, 95));
+        format_us(p99, sizeof(p99), zone_percentile(&stats, 99));
+        format_us(max, sizeof(max), stats.max_cycles);
+        uint32_t self_pct = stats.total_cycles ?
+            (uint32_t)((stats.self_cycles * 100) / stats.total_cycles) : 0;
+
+        pos += snprintf(buffer + pos, max_len - pos,
+            "  %-14s %6lu %6s %6s %6s %6s %5lu\n",
+            zone_names[z], stats.count, p50, p95, p99, max, self_pct);
+    }
+
+    for(uint8_t t = 0; t < thread_count && pos < (int)max_len - 60; t++) {
+        const ProfilerThread_t* thread = &threads[t];
+        if(!thread->accounted) continue;
+        pos += snprintf(buffer + pos, max_len - pos,
+            "  thread %-12s %3u%% cpu, depth %u\n",
+            thread->name ? thread->name : "?", thread->load_percent, thread->max_depth);
+    }
+
+    ProfilerIsrStats_t isr;
+    for(uint8_t i = 0; i < PROFILER_ISR_COUNT && pos < (int)max_len - 80; i++) {
+        if(!profiler_get_isr_stats(i, &isr) || isr.count == 0) continue;
+
+        format_us(max, sizeof(max), isr.max_cycles);
+        format_us(p50, sizeof(p50), profiler_hist_percentile(isr.latency_hist, isr.probes, 50));
+        format_us(p99, sizeof(p99), profiler_hist_percentile(isr.latency_hist, isr.probes, 99));
+        pos += snprintf(buffer + pos, max_len - pos,
+            "  isr %-10s n=%lu max=%s latency p50=%s p99=%s (%lu probes)\n",
+            isr_names[i], isr.count, max, p50, p99, isr.probes);
+    }
+}
+
+// Report to the log (static buffer: callers may have small stacks)
+void profiler_print_to_console(void) {
+    static char report[1536];
+    profiler_generate_report(report, sizeof(report));
+    FURI_LOG_I(TAG, "%s", report);
+}
+
+// ============================================================================
+// TRACE
+// ============================================================================
+
+// Start a one-shot trace; it stops by itself after PROFILER_TRACE_RECORDS
+void profiler_trace_arm(void) {
+    trace_armed = false;
+    __atomic_store_n(&trace_head, 0, __ATOMIC_RELEASE);
+    trace_armed = true;
+}
+
+void profiler_trace_stop(void) {
+    trace_armed = false;
+}
+
+uint32_t profiler_trace_count(void) {
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    return (head < PROFILER_TRACE_RECORDS) ? head : PROFILER_TRACE_RECORDS;
+}
+
+// Stop tracing and write header, names and records to LOGS_PATH/filename
+bool profiler_trace_dump(const char* filename) {
+    if(!filename) return false;
+    profiler_trace_stop();
+
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", LOGS_PATH, filename);
+
+    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_LOG, true);
+    if(!file) return false;
+
+    ProfilerTraceHeader_t header = {
+        .magic = PROFILER_TRACE_MAGIC,
+        .version = PROFILER_TRACE_VERSION,
+        .zone_count = zone_count,
+        .thread_count = thread_count,
+        .core_clock_hz = SYSTEM_CORE_CLOCK,
+        .overhead_cycles = overhead_cycles,
+        .record_count = profiler_trace_count(),
+    };
+
+    bool ok = sd_manager_write(file, (const uint8_t*)&header, sizeof(header)) &&
+              sd_manager_write(file, (const uint8_t*)zone_names, (uint32_t)zone_count * PROFILER_NAME_LEN);
+
+    char name[PROFILER_NAME_LEN];
+    for(uint8_t t = 0; ok && t < thread_count; t++) {
+        memset(name, 0, sizeof(name));
+        if(threads[t].name) strncpy(name, threads[t].name, sizeof(name) - 1);
+        ok = sd_manager_write(file, (const uint8_t*)name, sizeof(name));
+    }
+
+    if(ok) {
+        ok = sd_manager_write(file, (const uint8_t*)trace_records,
+                              header.record_count * sizeof(ProfilerTraceRecord_t));
+    }
+
+    sd_manager_close_file(file);
+    FURI_LOG_I(TAG, "Trace: %lu records -> %s", header.record_count, path);
+    return ok;
+}
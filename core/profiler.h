@@ -0,0 +1,186 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <furi.h>
+#include "flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// CYCLE PROFILER
+// Named zones timed with DWT_CYCCNT. Zones nest per thread: each exit adds
+// the inclusive time to the zone's log-bucket histogram (p50/p95/p99) and
+// charges it to the parent, so self time excludes children. ISRs report
+// their run time through enter/exit hooks, and a probe pends the GDO0 EXTI
+// line in software to measure interrupt entry latency.
+//
+// Worker threads mark where they block, which gives per-thread busy time
+// (ISR time excluded) for the CPU load figures. Busy time runs from wake to
+// block, so it includes time preempted by other threads and per-thread loads
+// are upper bounds. A one-shot trace records
+// zone enter/exit events until full and is dumped to SD as binary.
+//
+// Zones are thread-context only; calls from an ISR are ignored.
+// ============================================================================
+
+#define PROFILER_MAX_ZONES          16
+#define PROFILER_MAX_THREADS        6
+#define PROFILER_MAX_DEPTH          8               // Nested zones per thread
+#define PROFILER_NAME_LEN           16
+#define PROFILER_ZONE_UNSET         0xFF            // Call-site cache before registration
+#define PROFILER_ZONE_NONE          0xFE            // Zone table full (calls are ignored)
+#define PROFILER_THREAD_NONE        0xFF
+
+// Histogram: values below 4 cycles get their own bucket, then 4 buckets per
+// power of two (<= 25% wide) up to 2^25 cycles (~0.5 s); longer times land
+// in the last bucket and are still exact in max_cycles.
+#define PROFILER_HIST_SUB_BITS      2
+#define PROFILER_HIST_BUCKETS       96
+
+#define PROFILER_TRACE_RECORDS      256
+#define PROFILER_TRACE_MAGIC        0x43525450      // "PTRC"
+#define PROFILER_TRACE_VERSION      1
+
+typedef uint8_t ProfilerZoneId_t;
+
+typedef enum {
+    PROFILER_ISR_GDO0 = 0,          // CC1101 FIFO threshold / end of packet
+    PROFILER_ISR_EDGE_DMA,          // Edge capture DMA half/full transfer
+    PROFILER_ISR_COUNT
+} ProfilerIsr_t;
+
+typedef enum {
+    PROFILER_TRACE_ENTER = 0,
+    PROFILER_TRACE_EXIT,
+    PROFILER_TRACE_RECORD,          // profiler_zone_record() sample
+} ProfilerTraceKind_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_cycles;          // Inclusive
+    uint64_t self_cycles;           // Inclusive minus nested zones
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t hist[PROFILER_HIST_BUCKETS];
+} ProfilerZoneStats_t;
+
+typedef struct {
+    uint32_t count;
+    uint64_t total_cycles;          // Time spent in the handler
+    uint32_t max_cycles;
+    uint32_t probes;                // Latency samples taken
+    uint32_t latency_last_cycles;
+    uint32_t latency_max_cycles;
+    uint32_t latency_hist[PROFILER_HIST_BUCKETS];
+} ProfilerIsrStats_t;
+
+typedef struct {
+    const char* name;
+    uint8_t load_percent;           // Busy share of the last window (upper bound)
+    uint32_t busy_cycles;           // Busy cycles in the last sample window
+    uint8_t max_depth;              // Deepest zone nesting seen
+    uint32_t depth_overflows;       // Zones dropped past PROFILER_MAX_DEPTH
+} ProfilerThreadStats_t;
+
+// Trace record (8 bytes, written to the dump as is)
+typedef struct {
+    uint32_t cycles;                // DWT_CYCCNT (duration for RECORD)
+    uint8_t zone;
+    uint8_t thread;
+    uint8_t kind;                   // ProfilerTraceKind_t
+    uint8_t depth;
+} ProfilerTraceRecord_t;
+
+// Trace dump header, followed by zone names, thread names (PROFILER_NAME_LEN
+// bytes each) and record_count records
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t zone_count;
+    uint8_t thread_count;
+    uint32_t core_clock_hz;
+    uint32_t overhead_cycles;       // Already subtracted from zone times
+    uint32_t record_count;
+} ProfilerTraceHeader_t;
+
+// Scope handle for PROFILE_SCOPE
+typedef struct {
+    ProfilerZoneId_t zone;
+} ProfilerScope_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Initialization (after timer_precision_init)
+void profiler_init(void);
+void profiler_reset(void);
+
+// Threads: register once at thread start, then bracket every blocking wait
+uint8_t profiler_thread_register(const char* name);
+void profiler_thread_idle(void);
+void profiler_thread_active(void);
+
+// Zones
+ProfilerZoneId_t profiler_zone_register(const char* name);
+void profiler_zone_enter(ProfilerZoneId_t zone);
+void profiler_zone_exit(ProfilerZoneId_t zone);
+void profiler_zone_record(ProfilerZoneId_t zone, uint32_t cycles);
+ProfilerScope_t profiler_scope_begin(ProfilerZoneId_t* site, const char* name);
+void profiler_scope_end(ProfilerScope_t* scope);
+
+// ISR hooks (ISR context). arm_probe is called right before the interrupt is
+// pended in software; the next enter() of that ISR records the latency.
+uint32_t profiler_isr_enter(ProfilerIsr_t isr);
+void profiler_isr_exit(ProfilerIsr_t isr, uint32_t enter_cycles);
+void profiler_isr_arm_probe(ProfilerIsr_t isr);
+
+// CPU accounting: close the sample window and return the total load
+uint8_t profiler_cpu_sample(void);
+uint8_t profiler_isr_load_percent(void);
+
+// Results
+uint8_t profiler_zone_count(void);
+uint8_t profiler_thread_count(void);
+const char* profiler_zone_name(ProfilerZoneId_t zone);
+bool profiler_get_zone_stats(ProfilerZoneId_t zone, ProfilerZoneStats_t* stats);
+bool profiler_get_isr_stats(ProfilerIsr_t isr, ProfilerIsrStats_t* stats);
+bool profiler_get_thread_stats(uint8_t thread, ProfilerThreadStats_t* stats);
+uint32_t profiler_hist_percentile(const uint32_t* hist, uint32_t count, uint8_t percentile);
+void profiler_generate_report(char* buffer, uint32_t max_len);
+void profiler_print_to_console(void);
+
+// One-shot trace
+void profiler_trace_arm(void);
+void profiler_trace_stop(void);
+uint32_t profiler_trace_count(void);
+bool profiler_trace_dump(const char* filename);
+
+#define PROFILER_JOIN_(a, b)        a##b
+#define PROFILER_JOIN(a, b)         PROFILER_JOIN_(a, b)
+
+// Add an externally measured duration to zone `name`
+#define PROFILE_RECORD(name, cycles)                                            \
+    do {                                                                        \
+        static ProfilerZoneId_t profiler_site = PROFILER_ZONE_UNSET;            \
+        if(profiler_site == PROFILER_ZONE_UNSET) {                              \
+            profiler_site = profiler_zone_register(name);                       \
+        }                                                                       \
+        profiler_zone_record(profiler_site, (cycles));                          \
+    } while(0)
+
+// Time the rest of the enclosing block as zone `name` (registered on first use)
+#define PROFILE_SCOPE(name)                                                     \
+    static ProfilerZoneId_t PROFILER_JOIN(profiler_site_, __LINE__) =           \
+        PROFILER_ZONE_UNSET;                                                    \
+    ProfilerScope_t PROFILER_JOIN(profiler_scope_, __LINE__)                    \
+        __attribute__((cleanup(profiler_scope_end))) =                          \
+            profiler_scope_begin(&PROFILER_JOIN(profiler_site_, __LINE__), (name))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROFILER_H
@@ -0,0 +1,105 @@
+#include "pulse_store.h"
+
+_Static_assert((PULSE_STORE_CAPACITY & PULSE_STORE_MASK) == 0, "capacity must be a power of two");
+_Static_assert((1 << PULSE_ANCHOR_SHIFT) == PULSE_ANCHOR_INTERVAL, "anchor shift mismatch");
+
+// Reset store to empty
+void pulse_store_reset(PulseBuffer_t* store) {
+    store->head = 0;
+    store->tail = 0;
+    store->count = 0;
+    store->overflow = false;
+}
+
+// Append pulse (single producer). Space is checked against the start of the
+// tail's anchor block so the pulses needed to rebuild timestamps inside that
+// block are never overwritten.
+bool pulse_store_push(PulseBuffer_t* store, uint32_t width_us, uint8_t level,
+                      uint32_t timestamp_us) {
+    uint16_t head = store->head;
+    uint16_t tail_block = __atomic_load_n(&store->tail, __ATOMIC_ACQUIRE) & ~PULSE_ANCHOR_MASK;
+
+    if((uint16_t)(head - tail_block) >= PULSE_STORE_CAPACITY) {
+        store->overflow = true;
+        return false;
+    }
+
+    uint16_t slot = head & PULSE_STORE_MASK;
+    if((slot & PULSE_ANCHOR_MASK) == 0) {
+        store->anchors[slot >> PULSE_ANCHOR_SHIFT] = timestamp_us;
+    }
+    store->packed[slot] = pulse_pack(width_us, level);
+
+    __atomic_store_n(&store->head, (uint16_t)(head + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+// Timestamp of the i-th stored pulse: block anchor plus preceding widths
+uint32_t pulse_store_timestamp(const PulseBuffer_t* store, uint16_t i) {
+    uint16_t slot = (uint16_t)(store->tail + i) & PULSE_STORE_MASK;
+    uint16_t block_start = slot & ~PULSE_ANCHOR_MASK;
+    uint32_t timestamp = store->anchors[slot >> PULSE_ANCHOR_SHIFT];
+
+    for(uint16_t s = block_start; s < slot; s++) {
+        timestamp += pulse_unpack_duration(store->packed[s]);
+    }
+
+    return timestamp;
+}
+
+// Decode the i-th stored pulse
+bool pulse_store_get(const PulseBuffer_t* store, uint16_t i, Pulse_t* pulse) {
+    if(i >= pulse_store_count(store)) return false;
+
+    uint16_t word = pulse_store_word(store, i);
+    pulse->width_us = pulse_unpack_width(word);
+    pulse->level = pulse_unpack_level(word);
+    pulse->timestamp_us = pulse_store_timestamp(store, i);
+    return true;
+}
+
+// Pop oldest pulse (single consumer)
+bool pulse_store_pop(PulseBuffer_t* store, Pulse_t* pulse) {
+    if(!pulse_store_get(store, 0, pulse)) return false;
+
+    __atomic_store_n(&store->tail, (uint16_t)(store->tail + 1), __ATOMIC_RELEASE);
+    return true;
+}
+
+// Drop n oldest pulses
+void pulse_store_discard(PulseBuffer_t* store, uint16_t n) {
+    uint16_t count = pulse_store_count(store);
+    if(n > count) n = count;
+
+    __atomic_store_n(&store->tail, (uint16_t)(store->tail + n), __ATOMIC_RELEASE);
+}
+
+// Start sequential read at the start-th stored pulse
+void pulse_cursor_init(PulseCursor_t* cursor, const PulseBuffer_t* store, uint16_t start) {
+    cursor->store = store;
+    cursor->pos = store->tail + start;
+    cursor->end = __atomic_load_n(&store->head, __ATOMIC_ACQUIRE);
+    cursor->timestamp_us = (start < pulse_store_count(store)) ?
+        pulse_store_timestamp(store, start) : 0;
+}
+
+// Read next pulse; re-syncs to the stored anchor at every block boundary
+bool pulse_cursor_next(PulseCursor_t* cursor, Pulse_t* pulse) {
+    if(cursor->pos == cursor->end) return false;
+
+    const PulseBuffer_t* store = cursor->store;
+    uint16_t slot = cursor->pos & PULSE_STORE_MASK;
+
+    if((slot & PULSE_ANCHOR_MASK) == 0) {
+        cursor->timestamp_us = store->anchors[slot >> PULSE_ANCHOR_SHIFT];
+    }
+
+    uint16_t word = store->packed[slot];
+    pulse->width_us = pulse_unpack_width(word);
+    pulse->level = pulse_unpack_level(word);
+    pulse->timestamp_us = cursor->timestamp_us;
+
+    cursor->timestamp_us += pulse_unpack_duration(word);
+    cursor->pos++;
+    return true;
+}
@@ -0,0 +1,110 @@
+#ifndef PULSE_STORE_H
+#define PULSE_STORE_H
+
+#include "flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PACKED PULSE STORE
+// Accessors for PulseBuffer_t. Works as an SPSC ring (capture ISR producer,
+// analysis consumer) or as a flat append-only array when tail stays at 0.
+// Indices passed to the accessors are relative to the current tail.
+// ============================================================================
+
+#define PULSE_STORE_MASK        (PULSE_STORE_CAPACITY - 1)
+#define PULSE_ANCHOR_MASK       (PULSE_ANCHOR_INTERVAL - 1)
+#define PULSE_ANCHOR_SHIFT      6
+#define PULSE_FINE_MAX_US       PULSE_WIDTH_MASK
+#define PULSE_COARSE_MAX_US     (PULSE_WIDTH_MASK << PULSE_COARSE_SHIFT)
+
+// Sequential reader - reconstructs timestamps in O(1) per pulse
+typedef struct {
+    const PulseBuffer_t* store;
+    uint16_t pos;                   // Absolute (free-running) index
+    uint16_t end;
+    uint32_t timestamp_us;          // Timestamp of the pulse at pos
+} PulseCursor_t;
+
+// Pack width/level into a 16-bit pulse word
+static inline uint16_t pulse_pack(uint32_t width_us, uint8_t level) {
+    uint16_t word;
+    if(width_us <= PULSE_FINE_MAX_US) {
+        word = (uint16_t)width_us;
+    } else {
+        uint32_t coarse = (width_us + (1u << (PULSE_COARSE_SHIFT - 1))) >> PULSE_COARSE_SHIFT;
+        if(coarse > PULSE_WIDTH_MASK) coarse = PULSE_WIDTH_MASK;
+        word = PULSE_COARSE_BIT | (uint16_t)coarse;
+    }
+    return level ? (word | PULSE_LEVEL_BIT) : word;
+}
+
+// Decode duration in microseconds, up to PULSE_COARSE_MAX_US. Timestamps are
+// rebuilt from this so gaps longer than a 16-bit width do not shift them.
+static inline uint32_t pulse_unpack_duration(uint16_t word) {
+    uint32_t width = word & PULSE_WIDTH_MASK;
+    if(word & PULSE_COARSE_BIT) width <<= PULSE_COARSE_SHIFT;
+    return width;
+}
+
+// Decode width in microseconds (saturates at MAX_PULSE_WIDTH_US)
+static inline uint16_t pulse_unpack_width(uint16_t word) {
+    uint32_t width = pulse_unpack_duration(word);
+    return (width > MAX_PULSE_WIDTH_US) ? MAX_PULSE_WIDTH_US : (uint16_t)width;
+}
+
+// Decode level (0/1)
+static inline uint8_t pulse_unpack_level(uint16_t word) {
+    return (word & PULSE_LEVEL_BIT) ? 1 : 0;
+}
+
+// Pulses currently stored
+static inline uint16_t pulse_store_count(const PulseBuffer_t* store) {
+    return (uint16_t)(__atomic_load_n(&store->head, __ATOMIC_ACQUIRE) - store->tail);
+}
+
+// Raw packed word of the i-th stored pulse
+static inline uint16_t pulse_store_word(const PulseBuffer_t* store, uint16_t i) {
+    return store->packed[(uint16_t)(store->tail + i) & PULSE_STORE_MASK];
+}
+
+// Width of the i-th stored pulse
+static inline uint16_t pulse_store_width(const PulseBuffer_t* store, uint16_t i) {
+    return pulse_unpack_width(pulse_store_word(store, i));
+}
+
+// Level of the i-th stored pulse
+static inline uint8_t pulse_store_level(const PulseBuffer_t* store, uint16_t i) {
+    return pulse_unpack_level(pulse_store_word(store, i));
+}
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Lifecycle
+void pulse_store_reset(PulseBuffer_t* store);
+
+// Producer
+bool pulse_store_push(PulseBuffer_t* store, uint32_t width_us, uint8_t level,
+                      uint32_t timestamp_us);
+
+// Random access (timestamp costs at most PULSE_ANCHOR_INTERVAL adds)
+uint32_t pulse_store_timestamp(const PulseBuffer_t* store, uint16_t i);
+bool pulse_store_get(const PulseBuffer_t* store, uint16_t i, Pulse_t* pulse);
+
+// Consumer
+bool pulse_store_pop(PulseBuffer_t* store, Pulse_t* pulse);
+void pulse_store_discard(PulseBuffer_t* store, uint16_t n);
+
+// Sequential iteration
+void pulse_cursor_init(PulseCursor_t* cursor, const PulseBuffer_t* store, uint16_t start);
+bool pulse_cursor_next(PulseCursor_t* cursor, Pulse_t* pulse);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PULSE_STORE_H
@@ -0,0 +1,240 @@
+#include "session_store.h"
+#include <string.h>
+
+#define TAG "SESSION_STORE"
+
+_Static_assert(SESSION_PAYLOAD_STRIDE >= sizeof(((Frame_t*)0)->data),
+               "frame arena slot smaller than a frame payload");
+
+// Static state
+static SessionStore_t session_store;
+static bool session_store_initialized = false;
+
+// Initialize store over the static frame arena and pulse store
+FuriStatus session_store_init(uint8_t* frame_arena, uint32_t arena_size, PulseBuffer_t* pulses) {
+    if(!frame_arena || !pulses) return FuriStatusError;
+
+    uint32_t capacity = arena_size / SESSION_PAYLOAD_STRIDE;
+    if(capacity > MAX_FRAME_COUNT) capacity = MAX_FRAME_COUNT;
+
+    memset(&session_store, 0, sizeof(session_store));
+    session_store.payloads = frame_arena;
+    session_store.capacity = (uint16_t)capacity;
+    session_store.pulses = pulses;
+    session_store.pulse_base = __atomic_load_n(&pulses->head, __ATOMIC_ACQUIRE);
+    session_store_initialized = true;
+
+    FURI_LOG_I(TAG, "Session store: %u frame slots", session_store.capacity);
+    return FuriStatusOk;
+}
+
+void session_store_deinit(void) {
+    session_store_initialized = false;
+    session_store.payloads = NULL;
+    session_store.pulses = NULL;
+    session_store.capacity = 0;
+    session_store.frame_count = 0;
+}
+
+// Start a new session (views taken earlier become stale). Pulses of the
+// closed session are released so the capture engine has room to push.
+void session_store_reset(void) {
+    if(!session_store_initialized) return;
+
+    PulseBuffer_t* pulses = session_store.pulses;
+    uint16_t head = __atomic_load_n(&pulses->head, __ATOMIC_ACQUIRE);
+
+    __atomic_store_n(&session_store.frame_count, 0, __ATOMIC_RELEASE);
+    pulse_store_discard(pulses, (uint16_t)(head - pulses->tail));
+    session_store.pulse_base = head;
+
+    // Readers re-check the generation after reading slots, so the bump must
+    // land before the next session overwrites any of them
+    __atomic_store_n(&session_store.generation, session_store.generation + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+// ============================================================================
+// WRITER
+// ============================================================================
+
+// No frame slot left, or the pulse store is close to dropping edges
+bool session_store_is_full(void) {
+    if(!session_store_initialized) return false;
+    if(session_store.frame_count >= session_store.capacity) return true;
+    return pulse_store_count(session_store.pulses) >= SESSION_PULSE_LIMIT;
+}
+
+// Next free frame slot, or NULL when the session is full
+uint8_t* session_store_reserve_frame(SessionFrameMeta_t** meta) {
+    if(!session_store_initialized) return NULL;
+
+    uint16_t idx = session_store.frame_count;
+    if(idx >= session_store.capacity) return NULL;
+
+    SessionFrameMeta_t* slot_meta = &session_store.meta[idx];
+    memset(slot_meta, 0, sizeof(SessionFrameMeta_t));
+    if(meta) *meta = slot_meta;
+
+    return session_store.payloads + (uint32_t)idx * SESSION_PAYLOAD_STRIDE;
+}
+
+// Publish the reserved slot to readers
+void session_store_commit_frame(void) {
+    uint16_t idx = session_store.frame_count;
+    if(idx >= session_store.capacity) return;
+
+    if(session_store.meta[idx].length > SESSION_PAYLOAD_STRIDE) {
+        session_store.meta[idx].length = SESSION_PAYLOAD_STRIDE;
+    }
+
+    __atomic_store_n(&session_store.frame_count, (uint16_t)(idx + 1), __ATOMIC_RELEASE);
+}
+
+// Copy a decoded frame into the next slot
+bool session_store_append_frame(const Frame_t* frame) {
+    SessionFrameMeta_t* meta;
+    uint8_t* payload = session_store_reserve_frame(&meta);
+    if(!payload) return false;
+
+    uint8_t len = (frame->length < SESSION_PAYLOAD_STRIDE) ? frame->length : SESSION_PAYLOAD_STRIDE;
+    memcpy(payload, frame->data, len);
+
+    meta->timestamp_us = frame->timestamp_us;
+    meta->frequency_hz = frame->frequency_hz;
+    meta->duration_us = frame->duration_us;
+    meta->rssi_dbm = frame->rssi_dbm;
+    meta->pulse_start_idx = frame->pulse_start_idx;
+    meta->pulse_count = frame->pulse_count;
+    meta->crc = frame->crc;
+    meta->length = len;
+    meta->crc_valid = frame->crc_valid;
+
+    session_store_commit_frame();
+    return true;
+}
+
+// ============================================================================
+// VIEWS
+// ============================================================================
+
+// All published frames
+SessionFrameView_t session_store_frames(void) {
+    return session_store_frames_since(0);
+}
+
+// Published frames starting at index first
+SessionFrameView_t session_store_frames_since(uint16_t first) {
+    SessionFrameView_t view;
+    view.generation = __atomic_load_n(&session_store.generation, __ATOMIC_ACQUIRE);
+    uint16_t count = __atomic_load_n(&session_store.frame_count, __ATOMIC_ACQUIRE);
+
+    if(first > count) first = count;
+    view.store = &session_store;
+    view.first = first;
+    view.count = count - first;
+    return view;
+}
+
+// Session pulses still held by the pulse store
+SessionPulseView_t session_store_pulses(void) {
+    SessionPulseView_t view = {0};
+    const PulseBuffer_t* pulses = session_store.pulses;
+    if(!pulses) return view;
+
+    uint16_t head = __atomic_load_n(&pulses->head, __ATOMIC_ACQUIRE);
+    uint16_t tail = __atomic_load_n(&pulses->tail, __ATOMIC_ACQUIRE);
+
+    // Start at whichever is newer: session start or the consumer tail
+    uint16_t first = session_store.pulse_base;
+    if((uint16_t)(head - tail) < (uint16_t)(head - first)) first = tail;
+
+    view.pulses = pulses;
+    view.first = first;
+    view.count = head - first;
+    return view;
+}
+
+// Pulses belonging to the i-th frame in the view
+SessionPulseView_t session_frame_pulses(const SessionFrameView_t* view, uint16_t i) {
+    SessionPulseView_t session = session_store_pulses();
+    SessionPulseView_t frame_view = {session.pulses, 0, 0};
+    const SessionFrameMeta_t* meta = session_frame_meta(view, i);
+
+    // Only hand out pulses that are still inside the live session window
+    uint16_t offset = meta->pulse_start_idx - session.first;
+    if(meta->pulse_count == 0 || offset >= session.count) return frame_view;
+
+    frame_view.first = meta->pulse_start_idx;
+    frame_view.count = meta->pulse_count;
+    if(frame_view.count > session.count - offset) frame_view.count = session.count - offset;
+    return frame_view;
+}
+
+uint16_t session_store_frame_count(void) {
+    return __atomic_load_n(&session_store.frame_count, __ATOMIC_ACQUIRE);
+}
+
+uint32_t session_store_generation(void) {
+    return __atomic_load_n(&session_store.generation, __ATOMIC_ACQUIRE);
+}
+
+bool session_frame_view_stale(const SessionFrameView_t* view) {
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return view->generation != session_store_generation();
+}
+
+// ============================================================================
+// VIEW HELPERS
+// ============================================================================
+
+// Sub-range of an existing view
+SessionFrameView_t session_frame_view_slice(const SessionFrameView_t* view,
+                                            uint16_t offset, uint16_t count) {
+    SessionFrameView_t slice = *view;
+
+    if(offset > view->count) offset = view->count;
+    if(count > view->count - offset) count = view->count - offset;
+    slice.first = view->first + offset;
+    slice.count = count;
+    return slice;
+}
+
+// Materialize one frame (for APIs that still take Frame_t)
+void session_frame_get(const SessionFrameView_t* view, uint16_t i, Frame_t* frame) {
+    const SessionFrameMeta_t* meta = session_frame_meta(view, i);
+
+    memset(frame, 0, sizeof(Frame_t));
+    memcpy(frame->data, session_frame_payload(view, i), meta->length);
+    frame->length = meta->length;
+    frame->timestamp_us = meta->timestamp_us;
+    frame->rssi_dbm = meta->rssi_dbm;
+    frame->frequency_hz = meta->frequency_hz;
+    frame->pulse_start_idx = meta->pulse_start_idx;
+    frame->pulse_count = meta->pulse_count;
+    frame->duration_us = meta->duration_us;
+    frame->crc = meta->crc;
+    frame->crc_valid = meta->crc_valid;
+}
+
+// Timestamp of the i-th pulse in the view: block anchor plus preceding widths
+uint32_t session_pulse_timestamp(const SessionPulseView_t* view, uint16_t i) {
+    const PulseBuffer_t* pulses = view->pulses;
+    uint16_t slot = (uint16_t)(view->first + i) & PULSE_STORE_MASK;
+    uint16_t block_start = slot & ~PULSE_ANCHOR_MASK;
+    uint32_t timestamp = pulses->anchors[slot >> PULSE_ANCHOR_SHIFT];
+
+    for(uint16_t s = block_start; s < slot; s++) {
+        timestamp += pulse_unpack_duration(pulses->packed[s]);
+    }
+
+    return timestamp;
+}
+
+// Sequential reader over the view
+void session_pulse_cursor(const SessionPulseView_t* view, PulseCursor_t* cursor) {
+    cursor->store = view->pulses;
+    cursor->pos = view->first;
+    cursor->end = view->first + view->count;
+    cursor->timestamp_us = (view->count > 0) ? session_pulse_timestamp(view, 0) : 0;
+}
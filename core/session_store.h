@@ -0,0 +1,133 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include "flipper_rf_lab.h"
+#include "pulse_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SHARED SESSION STORE
+// Single copy of the capture for all analysis engines. Frame payloads live in
+// the static frame arena (fixed 64-byte slots), frame metadata alongside it,
+// and pulses stay in the packed pulse store filled by the capture engine.
+// Engines receive read-only views (first index + count) instead of copying.
+//
+// Single writer (capture thread); readers on other threads see a frame only
+// after session_store_commit_frame() publishes it.
+// ============================================================================
+
+#define SESSION_PAYLOAD_STRIDE  (FRAME_BUFFER_SIZE / MAX_FRAME_COUNT)   // 64 bytes per frame slot
+#define SESSION_PULSE_LIMIT     (PULSE_STORE_CAPACITY - 1024)           // Headroom for edge DMA bursts
+
+// Frame metadata (payload is kept in the arena slot with the same index)
+typedef struct {
+    uint32_t timestamp_us;          // Capture timestamp
+    uint32_t frequency_hz;          // Frequency of capture
+    uint32_t duration_us;           // Total frame duration
+    uint16_t rssi_dbm;              // RSSI at capture time
+    uint16_t pulse_start_idx;       // Absolute index into the pulse store
+    uint16_t pulse_count;           // Number of pulses in frame
+    uint16_t crc;                   // Calculated CRC
+    uint8_t length;                 // Payload length in bytes
+    bool crc_valid;                 // CRC validation result
+} SessionFrameMeta_t;
+
+typedef struct {
+    uint8_t* payloads;              // Frame arena, SESSION_PAYLOAD_STRIDE bytes per slot
+    SessionFrameMeta_t meta[MAX_FRAME_COUNT];
+    uint16_t capacity;              // Frame slots available in the arena
+    uint16_t frame_count;           // Published frames
+    PulseBuffer_t* pulses;          // Packed pulse store (capture engine output)
+    uint16_t pulse_base;            // Absolute index of the first session pulse
+    uint32_t generation;            // Bumped on reset
+} SessionStore_t;
+
+// Read-only window onto session frames
+typedef struct {
+    const SessionStore_t* store;
+    uint16_t first;                 // Index of the first frame in the view
+    uint16_t count;
+    uint32_t generation;            // Session the view was taken from
+} SessionFrameView_t;
+
+// Read-only window onto session pulses (absolute, free-running indices)
+typedef struct {
+    const PulseBuffer_t* pulses;
+    uint16_t first;
+    uint16_t count;
+} SessionPulseView_t;
+
+// Payload of the i-th frame in the view
+static inline const uint8_t* session_frame_payload(const SessionFrameView_t* view, uint16_t i) {
+    return view->store->payloads + (uint32_t)(view->first + i) * SESSION_PAYLOAD_STRIDE;
+}
+
+// Metadata of the i-th frame in the view
+static inline const SessionFrameMeta_t* session_frame_meta(const SessionFrameView_t* view,
+                                                           uint16_t i) {
+    return &view->store->meta[view->first + i];
+}
+
+// Payload length of the i-th frame in the view
+static inline uint8_t session_frame_length(const SessionFrameView_t* view, uint16_t i) {
+    return view->store->meta[view->first + i].length;
+}
+
+// Raw packed word of the i-th pulse in the view
+static inline uint16_t session_pulse_word(const SessionPulseView_t* view, uint16_t i) {
+    return view->pulses->packed[(uint16_t)(view->first + i) & PULSE_STORE_MASK];
+}
+
+// Width of the i-th pulse in the view
+static inline uint16_t session_pulse_width(const SessionPulseView_t* view, uint16_t i) {
+    return pulse_unpack_width(session_pulse_word(view, i));
+}
+
+// Level of the i-th pulse in the view
+static inline uint8_t session_pulse_level(const SessionPulseView_t* view, uint16_t i) {
+    return pulse_unpack_level(session_pulse_word(view, i));
+}
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Lifecycle - frame_arena and pulses are statically allocated by the caller
+FuriStatus session_store_init(uint8_t* frame_arena, uint32_t arena_size, PulseBuffer_t* pulses);
+void session_store_deinit(void);
+void session_store_reset(void);
+
+// Writer (capture thread): fill the returned slot, then commit it. Once the
+// store is full the writer rolls over with session_store_reset().
+bool session_store_is_full(void);
+uint8_t* session_store_reserve_frame(SessionFrameMeta_t** meta);
+void session_store_commit_frame(void);
+bool session_store_append_frame(const Frame_t* frame);
+
+// Views
+SessionFrameView_t session_store_frames(void);
+SessionFrameView_t session_store_frames_since(uint16_t first);
+SessionPulseView_t session_store_pulses(void);
+SessionPulseView_t session_frame_pulses(const SessionFrameView_t* view, uint16_t i);
+uint16_t session_store_frame_count(void);
+uint32_t session_store_generation(void);
+
+// True once the session of the view rolled over; data read through it since
+// may mix frames of both sessions
+bool session_frame_view_stale(const SessionFrameView_t* view);
+
+// View helpers
+SessionFrameView_t session_frame_view_slice(const SessionFrameView_t* view,
+                                            uint16_t offset, uint16_t count);
+void session_frame_get(const SessionFrameView_t* view, uint16_t i, Frame_t* frame);
+uint32_t session_pulse_timestamp(const SessionPulseView_t* view, uint16_t i);
+void session_pulse_cursor(const SessionPulseView_t* view, PulseCursor_t* cursor);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SESSION_STORE_H
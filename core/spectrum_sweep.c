@@ -0,0 +1,263 @@
+#include "spectrum_sweep.h"
+#include "hal/cc1101_driver.h"
+#include "hal/timer_precision.h"
+#include "profiler.h"
+
+#define TAG "SPECTRUM"
+
+#define SPECTRUM_CAL_NONE           0               // Calibrate before the next visit
+#define SPECTRUM_CAL_OK             1
+#define SPECTRUM_CAL_UNSUPPORTED    2               // Outside the synthesizer bands
+
+#define SPECTRUM_MCSM0_FS_AUTOCAL   0x30            // MCSM0 bits 5:4
+
+// Noise floor histogram: 2 dB buckets from -140 dBm
+#define SPECTRUM_HIST_BUCKETS       64
+#define SPECTRUM_HIST_MIN_DBM       (-140)
+#define SPECTRUM_HIST_BUCKET_DB     2
+
+typedef struct {
+    bool running;
+    uint16_t channels;
+    uint32_t start_hz;
+    uint32_t step_hz;
+    uint16_t cursor;                // Next channel to measure
+    int16_t noise_floor_dbm;
+    uint32_t sweeps;
+    uint32_t sweep_start_ms;
+    uint32_t sweep_ms;
+    uint32_t cal_tick;              // When the calibration cache was last cleared
+    uint32_t resume_hz;             // Frequency to restore on stop
+    uint8_t saved_mcsm0;
+} SpectrumSweep_t;
+
+// Static state
+static SpectrumSweep_t sweep;
+static CC1101ChannelCal_t channel_cal[SPECTRUM_MAX_CHANNELS];
+static uint8_t channel_cal_state[SPECTRUM_MAX_CHANNELS];
+static int16_t last_dbm[SPECTRUM_MAX_CHANNELS];
+static int16_t max_hold_dbm[SPECTRUM_MAX_CHANNELS];
+static int16_t average_dbm_q4[SPECTRUM_MAX_CHANNELS];
+static uint16_t floor_hist[SPECTRUM_HIST_BUCKETS];
+static uint16_t floor_samples = 0;
+static SpectrumSweepStats_t sweep_stats;
+
+// ============================================================================
+// NOISE FLOOR
+// ============================================================================
+
+static void floor_add(int16_t dbm) {
+    int16_t bucket = (dbm - SPECTRUM_HIST_MIN_DBM) / SPECTRUM_HIST_BUCKET_DB;
+    if(bucket < 0) bucket = 0;
+    if(bucket >= SPECTRUM_HIST_BUCKETS) bucket = SPECTRUM_HIST_BUCKETS - 1;
+    floor_hist[bucket]++;
+    floor_samples++;
+}
+
+// Percentile of the quiet-dwell readings of the sweep just finished
+static void floor_update(void) {
+    if(floor_samples == 0) return;
+
+    uint32_t target = ((uint32_t)floor_samples * SPECTRUM_FLOOR_PERCENTILE) / 100;
+    uint32_t seen = 0;
+    for(uint8_t b = 0; b < SPECTRUM_HIST_BUCKETS; b++) {
+        seen += floor_hist[b];
+        if(seen > target) {
+            sweep.noise_floor_dbm = SPECTRUM_HIST_MIN_DBM + b * SPECTRUM_HIST_BUCKET_DB;
+            break;
+        }
+    }
+
+    memset(floor_hist, 0, sizeof(floor_hist));
+    floor_samples = 0;
+}
+
+// ============================================================================
+// CHANNEL MEASUREMENT
+// ============================================================================
+
+static inline uint32_t channel_hz(uint16_t channel) {
+    return sweep.start_hz + (uint32_t)channel * sweep.step_hz;
+}
+
+static inline int16_t read_rssi_dbm(void) {
+    return cc1101_rssi_to_dbm(cc1101_read_rssi());
+}
+
+// Retune, dwell and fold the channel's peak into the spectrum buffers
+static void measure_channel(uint16_t channel) {
+    if(channel_cal_state[channel] == SPECTRUM_CAL_NONE) {
+        cc1101_calibrate_channel(channel_hz(channel), &channel_cal[channel]);
+        channel_cal_state[channel] = SPECTRUM_CAL_OK;
+        sweep_stats.calibrations++;
+    }
+
+    uint32_t dwell_start = timer_get_us();
+    cc1101_retune(&channel_cal[channel]);
+    sweep_stats.retunes++;
+    furi_delay_us(SPECTRUM_SETTLE_US);
+
+    // Short dwell
+    int16_t peak = INT16_MIN;
+    int32_t sum = 0;
+    for(uint8_t s = 0; s < SPECTRUM_SHORT_SAMPLES; s++) {
+        if(s > 0) furi_delay_us(SPECTRUM_SAMPLE_US);
+        int16_t dbm = read_rssi_dbm();
+        sum += dbm;
+        if(dbm > peak) peak = dbm;
+    }
+    int16_t mean = (int16_t)(sum / SPECTRUM_SHORT_SAMPLES);
+    floor_add(mean);
+
+    // Long dwell on channels standing out of the floor
+    if(sweep.noise_floor_dbm != SPECTRUM_DBM_EMPTY &&
+       peak >= sweep.noise_floor_dbm + SPECTRUM_ACTIVE_MARGIN_DB) {
+        sweep_stats.long_dwells++;
+        while(timer_get_elapsed_us(dwell_start) < SPECTRUM_DWELL_MS * 1000UL) {
+            furi_delay_us(SPECTRUM_SAMPLE_US);
+            int16_t dbm = read_rssi_dbm();
+            if(dbm > peak) peak = dbm;
+        }
+    }
+
+    last_dbm[channel] = peak;
+    if(peak > max_hold_dbm[channel]) max_hold_dbm[channel] = peak;
+
+    int16_t sample_q4 = (int16_t)(mean * 16);
+    if(average_dbm_q4[channel] == SPECTRUM_DBM_EMPTY) {
+        average_dbm_q4[channel] = sample_q4;
+    } else {
+        average_dbm_q4[channel] += (sample_q4 - average_dbm_q4[channel]) >> SPECTRUM_AVG_SHIFT;
+    }
+}
+
+// Move to the next supported channel, closing the sweep on wrap
+static void advance_cursor(void) {
+    do {
+        if(++sweep.cursor < sweep.channels) continue;
+
+        sweep.cursor = 0;
+        sweep.sweeps++;
+        uint32_t now = furi_get_tick();
+        sweep.sweep_ms = now - sweep.sweep_start_ms;
+        sweep.sweep_start_ms = now;
+        floor_update();
+
+        // Drop stale calibrations; they refill during the next sweep
+        if(now - sweep.cal_tick >= SPECTRUM_RECAL_MS) {
+            for(uint16_t i = 0; i < sweep.channels; i++) {
+                if(channel_cal_state[i] == SPECTRUM_CAL_OK) channel_cal_state[i] = SPECTRUM_CAL_NONE;
+            }
+            sweep.cal_tick = now;
+        }
+    } while(channel_cal_state[sweep.cursor] == SPECTRUM_CAL_UNSUPPORTED);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Start sweeping `channels` points from start_hz to stop_hz inclusive
+bool spectrum_sweep_start(uint32_t start_hz, uint32_t stop_hz, uint16_t channels) {
+    if(channels < 2 || channels > SPECTRUM_MAX_CHANNELS || stop_hz <= start_hz) return false;
+
+    if(sweep.running) spectrum_sweep_stop();
+
+    memset(&sweep, 0, sizeof(sweep));
+    memset(&sweep_stats, 0, sizeof(sweep_stats));
+    sweep.channels = channels;
+    sweep.start_hz = start_hz;
+    sweep.step_hz = (stop_hz - start_hz) / (channels - 1);
+    sweep.noise_floor_dbm = SPECTRUM_DBM_EMPTY;
+
+    for(uint16_t i = 0; i < channels; i++) {
+        bool supported = cc1101_frequency_supported(channel_hz(i));
+        channel_cal_state[i] = supported ? SPECTRUM_CAL_NONE : SPECTRUM_CAL_UNSUPPORTED;
+        if(supported) sweep_stats.supported_channels++;
+    }
+    if(sweep_stats.supported_channels == 0) {
+        FURI_LOG_E(TAG, "No channel in %lu-%lu Hz is tunable", start_hz, stop_hz);
+        return false;
+    }
+
+    spectrum_sweep_reset_hold();
+    memset(floor_hist, 0, sizeof(floor_hist));
+    floor_samples = 0;
+
+    // Cached FSCAL values only survive IDLE -> RX with autocal off
+    sweep.resume_hz = cc1101_get_frequency();
+    sweep.saved_mcsm0 = cc1101_read_register(CC1101_MCSM0);
+    cc1101_write_register(CC1101_MCSM0, sweep.saved_mcsm0 & ~SPECTRUM_MCSM0_FS_AUTOCAL);
+
+    while(channel_cal_state[sweep.cursor] == SPECTRUM_CAL_UNSUPPORTED) sweep.cursor++;
+    sweep.sweep_start_ms = furi_get_tick();
+    sweep.cal_tick = sweep.sweep_start_ms;
+    sweep.running = true;
+
+    FURI_LOG_I(TAG, "Sweep %lu-%lu Hz, %d channels (%d tunable)",
+               start_hz, stop_hz, channels, sweep_stats.supported_channels);
+    return true;
+}
+
+// Restore autocal and the frequency in use before the sweep
+void spectrum_sweep_stop(void) {
+    if(!sweep.running) return;
+    sweep.running = false;
+
+    cc1101_enter_idle();
+    cc1101_write_register(CC1101_MCSM0, sweep.saved_mcsm0);
+    cc1101_set_frequency(sweep.resume_hz);
+    cc1101_calibrate();
+    cc1101_enter_rx();
+
+    FURI_LOG_I(TAG, "Sweep stopped after %lu sweeps", sweep.sweeps);
+}
+
+bool spectrum_sweep_is_running(void) {
+    return sweep.running;
+}
+
+// Clear last, max-hold and average buffers (calibration cache is kept)
+void spectrum_sweep_reset_hold(void) {
+    for(uint16_t i = 0; i < SPECTRUM_MAX_CHANNELS; i++) {
+        last_dbm[i] = SPECTRUM_DBM_EMPTY;
+        max_hold_dbm[i] = SPECTRUM_DBM_EMPTY;
+        average_dbm_q4[i] = SPECTRUM_DBM_EMPTY;
+    }
+}
+
+// Sweep for one time slice (called from the capture thread)
+void spectrum_sweep_step(void) {
+    if(!sweep.running &&
+       !spectrum_sweep_start(SPECTRUM_START_HZ, SPECTRUM_STOP_HZ, SPECTRUM_MAX_CHANNELS)) {
+        return;
+    }
+
+    PROFILE_SCOPE("sweep_slice");
+
+    // A channel is never split across slices, so a long dwell may overrun
+    uint32_t slice_start = timer_get_us();
+    do {
+        measure_channel(sweep.cursor);
+        advance_cursor();
+    } while(timer_get_elapsed_us(slice_start) < SPECTRUM_SLICE_US);
+}
+
+SpectrumView_t spectrum_sweep_view(void) {
+    SpectrumView_t view = {
+        .last_dbm = last_dbm,
+        .max_hold_dbm = max_hold_dbm,
+        .average_dbm_q4 = average_dbm_q4,
+        .channels = sweep.channels,
+        .start_hz = sweep.start_hz,
+        .step_hz = sweep.step_hz,
+        .noise_floor_dbm = sweep.noise_floor_dbm,
+        .sweeps = sweep.sweeps,
+        .sweep_ms = sweep.sweep_ms,
+    };
+    return view;
+}
+
+SpectrumSweepStats_t spectrum_sweep_get_stats(void) {
+    return sweep_stats;
+}
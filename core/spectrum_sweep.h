@@ -0,0 +1,87 @@
+#ifndef SPECTRUM_SWEEP_H
+#define SPECTRUM_SWEEP_H
+
+#include <furi.h>
+#include "flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SPECTRUM SWEEP ENGINE
+// Steps the CC1101 across a fixed channel grid and records RSSI per channel.
+// Each channel is calibrated once; its FREQ and FSCAL3..1 words are cached
+// and later steps reload them via cc1101_retune() instead of set_frequency +
+// SCAL. Quiet channels get a short dwell; channels above the noise floor are
+// held for SPECTRUM_DWELL_MS to catch the peak of a burst. Channels outside
+// the synthesizer bands are skipped.
+//
+// Runs on the capture thread (spectrum_sweep_step, one time slice per call).
+// Readers on other threads get the live buffers; a bin may be one sweep
+// behind its neighbours, which is harmless for display.
+// ============================================================================
+
+#define SPECTRUM_MAX_CHANNELS       256             // Channel grid / buffer size
+#define SPECTRUM_START_HZ           300000000UL
+#define SPECTRUM_STOP_HZ            (SPECTRUM_START_HZ + SPECTRUM_RANGE_MHZ * 1000000UL)
+#define SPECTRUM_SETTLE_US          300             // PLL lock + RSSI valid after SRX (no SCAL)
+#define SPECTRUM_SAMPLE_US          100             // RSSI sampling interval within a dwell
+#define SPECTRUM_SHORT_SAMPLES      2               // RSSI samples on a quiet channel
+#define SPECTRUM_ACTIVE_MARGIN_DB   6               // Above the floor by this -> long dwell
+#define SPECTRUM_SLICE_US           5000            // Sweep time per spectrum_sweep_step()
+#define SPECTRUM_AVG_SHIFT          3               // Average = EMA over ~8 sweeps
+#define SPECTRUM_FLOOR_PERCENTILE   25              // Noise floor = this percentile of a sweep
+#define SPECTRUM_RECAL_MS           60000           // Calibration cache lifetime (VCO drift)
+#define SPECTRUM_DBM_EMPTY          INT16_MIN       // Bin not measured (yet) or unsupported
+
+typedef struct {
+    const int16_t* last_dbm;        // Latest peak per channel
+    const int16_t* max_hold_dbm;    // Highest peak since start / reset
+    const int16_t* average_dbm_q4;  // Running average, dBm * 16
+    uint16_t channels;
+    uint32_t start_hz;
+    uint32_t step_hz;
+    int16_t noise_floor_dbm;        // SPECTRUM_DBM_EMPTY until the first sweep completes
+    uint32_t sweeps;                // Completed sweeps
+    uint32_t sweep_ms;              // Duration of the last completed sweep
+} SpectrumView_t;
+
+typedef struct {
+    uint32_t calibrations;          // SCAL runs (cache fills)
+    uint32_t retunes;
+    uint32_t long_dwells;           // Channels held for SPECTRUM_DWELL_MS
+    uint16_t supported_channels;    // Channels inside the synthesizer bands
+} SpectrumSweepStats_t;
+
+// Average of channel i in whole dBm
+static inline int16_t spectrum_average_dbm(const SpectrumView_t* view, uint16_t i) {
+    int16_t q4 = view->average_dbm_q4[i];
+    return (q4 == SPECTRUM_DBM_EMPTY) ? SPECTRUM_DBM_EMPTY : (int16_t)(q4 / 16);
+}
+
+// Centre frequency of channel i
+static inline uint32_t spectrum_channel_hz(const SpectrumView_t* view, uint16_t i) {
+    return view->start_hz + (uint32_t)i * view->step_hz;
+}
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Control (capture thread). spectrum_sweep_step() starts the full
+// SPECTRUM_RANGE_MHZ sweep if none is running.
+bool spectrum_sweep_start(uint32_t start_hz, uint32_t stop_hz, uint16_t channels);
+void spectrum_sweep_stop(void);
+bool spectrum_sweep_is_running(void);
+void spectrum_sweep_reset_hold(void);
+
+// Results
+SpectrumView_t spectrum_sweep_view(void);
+SpectrumSweepStats_t spectrum_sweep_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPECTRUM_SWEEP_H
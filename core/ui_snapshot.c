@@ -0,0 +1,276 @@
+#include "ui_snapshot.h"
+#include "session_store.h"
+#include "spectrum_sweep.h"
+#include "../analysis/clustering.h"
+#include "../analysis/protocol_infer.h"
+#include "../analysis/threat_model.h"
+#include <string.h>
+
+#define TAG "UI_SNAPSHOT"
+
+typedef struct {
+    uint32_t seq;                   // Odd while the writer is filling the slot
+    UiSnapshot_t data;
+} UiSnapshotSlot_t;
+
+// Published state: readers only ever copy snapshot_slots[snapshot_front]
+static UiSnapshotSlot_t snapshot_slots[2];
+static uint32_t snapshot_front = 0;
+static uint32_t snapshot_version = 0;
+static FuriThreadId snapshot_reader = NULL;
+
+// Writer-side record of what the cached sections were built from
+static struct {
+    bool primed;
+    uint32_t generation;
+    uint16_t pulse_end;
+    uint16_t frame_count;
+    uint32_t sweeps;
+} snapshot_sources;
+
+static DataPoint_t cluster_storage[UI_SNAPSHOT_CLUSTER_POINTS];
+
+// ============================================================================
+// SECTION BUILDERS (analysis thread, into the back slot)
+// ============================================================================
+
+static void build_protocol(UiSnapshot_t* s) {
+    const ProtocolHypothesis_t* hyp = protocol_infer_get_hypothesis();
+
+    s->modulation = (uint8_t)hyp->modulation;
+    s->encoding = (uint8_t)hyp->encoding;
+    s->protocol_confidence = hyp->overall_confidence;
+    s->baud_rate = hyp->baud_rate;
+    s->short_pulse_us = hyp->short_pulse_us;
+    s->long_pulse_us = hyp->long_pulse_us;
+    strncpy(s->description, hyp->description, UI_SNAPSHOT_DESC_LEN - 1);
+    s->description[UI_SNAPSHOT_DESC_LEN - 1] = '\0';
+}
+
+static void build_threat(UiSnapshot_t* s) {
+    const ThreatAssessment_t* assessment = threat_model_get_assessment();
+
+    s->threat_valid = (assessment != NULL);
+    s->risk_level = assessment ? (uint8_t)assessment->level : 0;
+    s->vulnerability_score = assessment ? assessment->vulnerability_score : 0;
+}
+
+// Mark/space scatter of the newest pulses. Points are coloured by the
+// inferred width class nearest their mark, so the plot needs no k-means.
+static void build_clusters(UiSnapshot_t* s, const SessionPulseView_t* pulses) {
+    SessionPulseView_t window = *pulses;
+    if(window.count > 2 * UI_SNAPSHOT_CLUSTER_POINTS) {
+        uint16_t skip = window.count - 2 * UI_SNAPSHOT_CLUSTER_POINTS;
+        window.first += skip;
+        window.count -= skip;
+    }
+
+    // Pairs start on a mark
+    if(window.count > 0 && session_pulse_level(&window, 0) == 0) {
+        window.first++;
+        window.count--;
+    }
+
+    Dataset_t data;
+    clustering_dataset_init(&data, cluster_storage, UI_SNAPSHOT_CLUSTER_POINTS);
+    s->cluster_points = clustering_dataset_from_pulses(&data, &window);
+    if(s->cluster_points == 0) return;
+
+    uint16_t centers[UI_SNAPSHOT_CLUSTER_IDS];
+    uint8_t num_centers = protocol_infer_get_cluster_centers(centers, UI_SNAPSHOT_CLUSTER_IDS);
+
+    for(uint16_t i = 0; i < data.count; i++) {
+        int32_t mark = FIXED_TO_INT(data.points[i].x);
+        uint32_t best = UINT32_MAX;
+
+        for(uint8_t c = 0; c < num_centers; c++) {
+            uint32_t dist = (uint32_t)((mark > centers[c]) ? mark - centers[c] : centers[c] - mark);
+            if(dist < best) {
+                best = dist;
+                data.points[i].cluster_id = c;
+            }
+        }
+    }
+
+    clustering_normalize_for_display(&data, s->cluster_x, s->cluster_y, s->cluster_id, data.count);
+
+    // Display rows 0-63 into the plot area below the header
+    for(uint16_t i = 0; i < data.count; i++) {
+        s->cluster_y[i] = (uint8_t)(UI_PLOT_TOP + s->cluster_y[i] * (UI_PLOT_HEIGHT - 1) / (UI_SCREEN_HEIGHT - 1));
+    }
+}
+
+// Levels seen per column across the newest frame (or the newest pulses when
+// the frame carries no pulse timings)
+static void build_waveform(UiSnapshot_t* s,
+                           const SessionFrameView_t* frames,
+                           const SessionPulseView_t* pulses) {
+    SessionPulseView_t wave = {0};
+    if(frames->count > 0) wave = session_frame_pulses(frames, frames->count - 1);
+    if(wave.count == 0) wave = *pulses;
+    if(wave.count > UI_SNAPSHOT_WAVE_PULSES) {
+        wave.first += wave.count - UI_SNAPSHOT_WAVE_PULSES;
+        wave.count = UI_SNAPSHOT_WAVE_PULSES;
+    }
+
+    memset(s->wave, 0, sizeof(s->wave));
+
+    uint32_t span = 0;
+    for(uint16_t i = 0; i < wave.count; i++) {
+        span += session_pulse_width(&wave, i);
+    }
+    s->wave_span_us = span;
+    if(span == 0) return;
+
+    // span * UI_SCREEN_WIDTH fits: at most 256 * 65535 * 128 < 2^32
+    uint32_t t = 0;
+    for(uint16_t i = 0; i < wave.count; i++) {
+        uint16_t width = session_pulse_width(&wave, i);
+        if(width == 0) continue;
+
+        uint8_t bit = session_pulse_level(&wave, i) ? UI_WAVE_HIGH : UI_WAVE_LOW;
+        uint32_t first = t * UI_SCREEN_WIDTH / span;
+        t += width;
+        uint32_t last = (t * UI_SCREEN_WIDTH - 1) / span;
+
+        for(uint32_t c = first; c <= last; c++) {
+            s->wave[c] |= bit;
+        }
+    }
+}
+
+// dBm to plot rows; unmeasured bins (SPECTRUM_DBM_EMPTY) map to 0
+static uint8_t spectrum_rows(int16_t dbm) {
+    if(dbm <= UI_SPECTRUM_MIN_DBM) return 0;
+    if(dbm >= UI_SPECTRUM_MAX_DBM) return UI_PLOT_HEIGHT;
+    return (uint8_t)((dbm - UI_SPECTRUM_MIN_DBM) * UI_PLOT_HEIGHT /
+                     (UI_SPECTRUM_MAX_DBM - UI_SPECTRUM_MIN_DBM));
+}
+
+// Max-hold decimation of the channel grid to one bar per column, so narrow
+// carriers between columns are not lost
+static void build_spectrum(UiSnapshot_t* s, const SpectrumView_t* view) {
+    s->spectrum_sweeps = view->sweeps;
+    s->spectrum_valid = (view->sweeps > 0 && view->channels > 0);
+    if(!s->spectrum_valid) {
+        memset(s->spectrum_height, 0, sizeof(s->spectrum_height));
+        s->spectrum_floor = 0;
+        return;
+    }
+
+    int16_t peak = SPECTRUM_DBM_EMPTY;
+    uint16_t peak_channel = 0;
+
+    for(uint16_t c = 0; c < UI_SCREEN_WIDTH; c++) {
+        uint16_t lo = (uint32_t)c * view->channels / UI_SCREEN_WIDTH;
+        uint16_t hi = (uint32_t)(c + 1) * view->channels / UI_SCREEN_WIDTH;
+        if(hi <= lo) hi = lo + 1;
+
+        int16_t column = SPECTRUM_DBM_EMPTY;
+        for(uint16_t ch = lo; ch < hi; ch++) {
+            int16_t dbm = view->last_dbm[ch];
+            if(dbm > column) column = dbm;
+            if(dbm > peak) {
+                peak = dbm;
+                peak_channel = ch;
+            }
+        }
+        s->spectrum_height[c] = spectrum_rows(column);
+    }
+
+    s->spectrum_floor = spectrum_rows(view->noise_floor_dbm);
+    s->spectrum_peak_dbm = peak;
+    s->spectrum_peak_hz = spectrum_channel_hz(view, peak_channel);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void ui_snapshot_init(void) {
+    memset(snapshot_slots, 0, sizeof(snapshot_slots));
+    memset(&snapshot_sources, 0, sizeof(snapshot_sources));
+    __atomic_store_n(&snapshot_front, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&snapshot_version, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&snapshot_reader, NULL, __ATOMIC_RELEASE);
+}
+
+// Thread woken with UI_SNAPSHOT_FLAG on every publish (NULL to detach)
+void ui_snapshot_set_reader(FuriThreadId thread) {
+    __atomic_store_n(&snapshot_reader, thread, __ATOMIC_RELEASE);
+}
+
+// Single writer. The back slot starts as a copy of the front one, so sections
+// whose source did not change are carried over instead of rebuilt, and a
+// result identical to the front snapshot is not published at all.
+void ui_snapshot_refresh(void) {
+    uint32_t front = __atomic_load_n(&snapshot_front, __ATOMIC_RELAXED);
+    const UiSnapshot_t* current = &snapshot_slots[front].data;
+    UiSnapshotSlot_t* slot = &snapshot_slots[front ^ 1];
+    UiSnapshot_t* s = &slot->data;
+
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    memcpy(s, current, sizeof(UiSnapshot_t));
+
+    SessionFrameView_t frames = session_store_frames();
+    SessionPulseView_t pulses = session_store_pulses();
+    uint32_t generation = session_store_generation();
+    uint16_t pulse_end = pulses.first + pulses.count;
+    s->frame_count = frames.count;
+    s->pulse_count = pulses.count;
+
+    build_protocol(s);
+    build_threat(s);
+
+    if(!snapshot_sources.primed || generation != snapshot_sources.generation ||
+       pulse_end != snapshot_sources.pulse_end || frames.count != snapshot_sources.frame_count) {
+        build_clusters(s, &pulses);
+        build_waveform(s, &frames, &pulses);
+        snapshot_sources.generation = generation;
+        snapshot_sources.pulse_end = pulse_end;
+        snapshot_sources.frame_count = frames.count;
+    }
+
+    SpectrumView_t spectrum = spectrum_sweep_view();
+    if(!snapshot_sources.primed || spectrum.sweeps != snapshot_sources.sweeps) {
+        build_spectrum(s, &spectrum);
+        snapshot_sources.sweeps = spectrum.sweeps;
+    }
+    snapshot_sources.primed = true;
+
+    if(current->version != 0 && memcmp(s, current, sizeof(UiSnapshot_t)) == 0) {
+        __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+        return;
+    }
+
+    s->version = current->version + 1;
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&snapshot_front, front ^ 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&snapshot_version, s->version, __ATOMIC_RELEASE);
+
+    FuriThreadId reader = __atomic_load_n(&snapshot_reader, __ATOMIC_ACQUIRE);
+    if(reader) furi_thread_flags_set(reader, UI_SNAPSHOT_FLAG);
+}
+
+// Version of the newest published snapshot (0 = none yet)
+uint32_t ui_snapshot_version(void) {
+    return __atomic_load_n(&snapshot_version, __ATOMIC_ACQUIRE);
+}
+
+// Copy the newest snapshot. False until the first publish, or if the writer
+// lapped this reader on every attempt (the caller keeps its previous copy).
+bool ui_snapshot_read(UiSnapshot_t* out) {
+    for(uint8_t attempt = 0; attempt < UI_SNAPSHOT_READ_RETRIES; attempt++) {
+        uint32_t front = __atomic_load_n(&snapshot_front, __ATOMIC_ACQUIRE);
+        const UiSnapshotSlot_t* slot = &snapshot_slots[front];
+
+        uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if(seq & 1) continue;
+        memcpy(out, &slot->data, sizeof(UiSnapshot_t));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == seq) return out->version != 0;
+    }
+    return false;
+}
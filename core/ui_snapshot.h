@@ -0,0 +1,101 @@
+#ifndef UI_SNAPSHOT_H
+#define UI_SNAPSHOT_H
+
+#include <furi.h>
+#include "flipper_rf_lab.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// UI SNAPSHOTS
+// Everything the display shows, published by the analysis thread as an
+// immutable snapshot: protocol hypothesis, threat score, cluster plot points
+// and spectrum/waveform columns already decimated to the 128x64 screen, so a
+// frame is drawn without touching the engines.
+//
+// Two slots, each with a sequence counter that is odd while the writer fills
+// it (seqlock). The writer fills the back slot and flips; readers copy the
+// front slot and retry if its counter moved during the copy. Neither side
+// blocks. The version number grows by one per publish, so the UI redraws
+// only when it changed.
+// ============================================================================
+
+#define UI_SCREEN_WIDTH             128
+#define UI_SCREEN_HEIGHT            64
+#define UI_PLOT_TOP                 10              // Rows above the plot hold a one-line header
+#define UI_PLOT_HEIGHT              (UI_SCREEN_HEIGHT - UI_PLOT_TOP)
+
+#define UI_SNAPSHOT_FLAG            (1UL << 0)      // Raised on the reader thread per publish
+#define UI_SNAPSHOT_READ_RETRIES    4               // Copies attempted before ui_snapshot_read gives up
+#define UI_SNAPSHOT_CLUSTER_POINTS  128             // Newest mark/space pairs in the cluster plot
+#define UI_SNAPSHOT_CLUSTER_IDS     8               // Width classes used to colour the plot
+#define UI_SNAPSHOT_WAVE_PULSES     256             // Newest pulses drawn when a frame carries none
+#define UI_SNAPSHOT_DESC_LEN        24
+#define UI_SPECTRUM_MIN_DBM         (-110)          // Bottom of the spectrum plot
+#define UI_SPECTRUM_MAX_DBM         (-20)           // Top of the spectrum plot
+
+// Waveform column bits
+#define UI_WAVE_LOW                 (1 << 0)
+#define UI_WAVE_HIGH                (1 << 1)
+
+typedef struct {
+    uint32_t version;               // 0 = nothing published yet
+
+    // Session
+    uint16_t frame_count;
+    uint16_t pulse_count;
+
+    // Protocol hypothesis
+    uint8_t modulation;             // InferredModulation_t
+    uint8_t encoding;               // EncodingType_t
+    uint8_t protocol_confidence;    // 0-100
+    uint32_t baud_rate;
+    uint16_t short_pulse_us;
+    uint16_t long_pulse_us;
+    char description[UI_SNAPSHOT_DESC_LEN];
+
+    // Threat assessment
+    bool threat_valid;
+    uint8_t risk_level;             // RiskLevel_t
+    uint16_t vulnerability_score;   // 0-1000
+
+    // Cluster plot, screen coordinates (y inside the plot area)
+    uint16_t cluster_points;
+    uint8_t cluster_x[UI_SNAPSHOT_CLUSTER_POINTS];
+    uint8_t cluster_y[UI_SNAPSHOT_CLUSTER_POINTS];
+    uint8_t cluster_id[UI_SNAPSHOT_CLUSTER_POINTS];
+
+    // Spectrum, one column per pixel: bar height in plot rows
+    bool spectrum_valid;
+    uint8_t spectrum_height[UI_SCREEN_WIDTH];
+    uint8_t spectrum_floor;         // Noise floor in plot rows
+    int16_t spectrum_peak_dbm;
+    uint32_t spectrum_peak_hz;
+    uint32_t spectrum_sweeps;
+
+    // Waveform of the newest frame, UI_WAVE_* per column
+    uint8_t wave[UI_SCREEN_WIDTH];
+    uint32_t wave_span_us;
+} UiSnapshot_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+void ui_snapshot_init(void);
+void ui_snapshot_set_reader(FuriThreadId thread);
+
+// Writer (analysis thread): rebuild the sections whose source changed, publish
+void ui_snapshot_refresh(void);
+
+// Readers (any thread)
+uint32_t ui_snapshot_version(void);
+bool ui_snapshot_read(UiSnapshot_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UI_SNAPSHOT_H
@@ -1,14 +1,88 @@
 #include "telemetry.h"
+#include "../core/hal/timer_precision.h"
 #include "../storage/sd_manager.h"
 #include <string.h>
 
 #define TAG "TELEMETRY"
 
+#define TELEMETRY_REPORT_EVENTS     10              // Recent events in the text report
+
 static TelemetryState_t telemetry_state;
 static bool telemetry_initialized = false;
 static bool monitoring_active = false;
 static uint32_t monitoring_interval_ms = 1000;
 
+// Event ring: ring_head is the next ticket; slot = ticket & mask
+static TelemetryRecord_t event_ring[TELEMETRY_BUFFER_SIZE];
+static uint32_t ring_head = 0;
+static uint32_t boot_cycles = 0;
+static volatile uint32_t coarse_seconds = 0;
+
+// Interned names. Kept across deinit/init so call-site ids stay valid.
+static char name_table[TELEMETRY_MAX_NAMES][TELEMETRY_EVENT_NAME_LEN] = {"OTHER"};
+static uint8_t name_count = 1;
+
+static const char* const event_type_names[] = {
+    [TELEM_EVENT_BOOT]            = "BOOT",
+    [TELEM_EVENT_ERROR]           = "ERR",
+    [TELEM_EVENT_MODE_CHANGE]     = "MODE",
+    [TELEM_EVENT_CAPTURE_START]   = "CAP_START",
+    [TELEM_EVENT_CAPTURE_STOP]    = "CAP_STOP",
+    [TELEM_EVENT_FRAME_DETECTED]  = "FRAME",
+    [TELEM_EVENT_BUFFER_OVERFLOW] = "OVERFLOW",
+    [TELEM_EVENT_SD_WRITE]        = "SD_WRITE",
+    [TELEM_EVENT_SD_ERROR]        = "SD_ERR",
+    [TELEM_EVENT_LOW_BATTERY]     = "LOW_BATT",
+    [TELEM_EVENT_TEMP_WARNING]    = "TEMP",
+    [TELEM_EVENT_CUSTOM]          = "EVENT",
+};
+
+// ============================================================================
+// EVENT RING
+// ============================================================================
+
+// Copy ticket's record if it is complete and not overwritten meanwhile
+static bool ring_read(uint32_t ticket, TelemetryRecord_t* out) {
+    const TelemetryRecord_t* rec = &event_ring[ticket & TELEMETRY_BUFFER_MASK];
+    
+    if(__atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE) != ticket + 1) return false;
+    *out = *rec;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&rec->seq, __ATOMIC_RELAXED) == ticket + 1;
+}
+
+// Oldest ticket still held by the ring
+static uint32_t ring_first_ticket(uint32_t head) {
+    return (head > TELEMETRY_BUFFER_SIZE) ? head - TELEMETRY_BUFFER_SIZE : 0;
+}
+
+static const char* event_type_name(uint8_t type) {
+    return (type <= TELEM_EVENT_CUSTOM) ? event_type_names[type] : "EVENT";
+}
+
+// Microseconds since boot. The coarse seconds stamp picks the number of
+// 32-bit DWT periods, so records stay exact across counter wraps.
+static uint64_t record_uptime_us(const TelemetryRecord_t* rec) {
+    uint32_t raw = rec->cycles - boot_cycles;
+    int64_t estimate = (int64_t)rec->coarse_s * SYSTEM_CORE_CLOCK;
+    int64_t periods = (estimate - (int64_t)raw + (1LL << 31)) >> 32;
+    if(periods < 0) periods = 0;
+    
+    return (((uint64_t)periods << 32) + raw) / DWT_CYCCNT_US;
+}
+
+static void record_decode(const TelemetryRecord_t* rec, TelemetryEvent_t* event) {
+    uint64_t uptime_us = record_uptime_us(rec);
+    
+    event->type = (TelemetryEventType_t)rec->type;
+    event->uptime_ms = (uint32_t)(uptime_us / 1000);
+    event->uptime_us = (uint32_t)uptime_us;
+    event->timestamp_ms = telemetry_state.boot_time_ms + event->uptime_ms;
+    event->name = telemetry_name(rec->name_id);
+    event->value = rec->value;
+    event->context = rec->context;
+}
+
 // Initialize telemetry system
 FuriStatus telemetry_init(void) {
     if(telemetry_initialized) return FuriStatusOk;
@@ -17,6 +91,11 @@ FuriStatus telemetry_init(void) {
     telemetry_state.boot_time_ms = furi_get_tick();
     telemetry_state.last_update_ms = telemetry_state.boot_time_ms;
     
+    memset(event_ring, 0, sizeof(event_ring));
+    ring_head = 0;
+    boot_cycles = DWT_CYCCNT;
+    coarse_seconds = 0;
+    
     // Initialize counters
     for(uint8_t i = 0; i < TELEMETRY_MAX_COUNTERS; i++) {
         telemetry_state.counters[i].min_time_us = 0xFFFFFFFF;
@@ -35,26 +114,64 @@ void telemetry_deinit(void) {
     monitoring_active = false;
 }
 
-// Log an event
-void telemetry_log_event(TelemetryEventType_t type, const char* name, 
-                         int32_t value, uint32_t context) {
-    if(!telemetry_initialized) return;
+// Id of name, adding it on first use (any thread or ISR). Published entries
+// never change, so lookups run without the critical section.
+uint8_t telemetry_intern(const char* name) {
+    if(!name) return TELEMETRY_NAME_OTHER;
     
-    uint16_t idx = telemetry_state.event_head;
+    uint8_t count = __atomic_load_n(&name_count, __ATOMIC_ACQUIRE);
+    for(uint8_t i = 1; i < count; i++) {
+        if(strncmp(name_table[i], name, TELEMETRY_EVENT_NAME_LEN - 1) == 0) return i;
+    }
     
-    telemetry_state.events[idx].type = type;
-    telemetry_state.events[idx].timestamp_ms = furi_get_tick();
-    telemetry_state.events[idx].uptime_ms = telemetry_state.events[idx].timestamp_ms - 
-                                           telemetry_state.boot_time_ms;
-    strncpy(telemetry_state.events[idx].name, name, TELEMETRY_EVENT_NAME_LEN - 1);
-    telemetry_state.events[idx].name[TELEMETRY_EVENT_NAME_LEN - 1] = '\0';
-    telemetry_state.events[idx].value = value;
-    telemetry_state.events[idx].context = context;
+    uint32_t primask = critical_section_enter();
     
-    telemetry_state.event_head = (telemetry_state.event_head + 1) % TELEMETRY_BUFFER_SIZE;
-    if(telemetry_state.event_count < TELEMETRY_BUFFER_SIZE) {
-        telemetry_state.event_count++;
+    // Re-check names added since the unlocked scan
+    uint8_t id = TELEMETRY_NAME_OTHER;
+    for(uint8_t i = count; i < name_count; i++) {
+        if(strncmp(name_table[i], name, TELEMETRY_EVENT_NAME_LEN - 1) == 0) id = i;
+    }
+    if(id == TELEMETRY_NAME_OTHER && name_count < TELEMETRY_MAX_NAMES) {
+        id = name_count;
+        strncpy(name_table[id], name, TELEMETRY_EVENT_NAME_LEN - 1);
+        __atomic_store_n(&name_count, (uint8_t)(id + 1), __ATOMIC_RELEASE);
     }
+    
+    critical_section_exit(primask);
+    return id;
+}
+
+const char* telemetry_name(uint8_t name_id) {
+    return (name_id < name_count) ? name_table[name_id] : name_table[TELEMETRY_NAME_OTHER];
+}
+
+// Log an event: one atomic add, five stores and a release (ISR-safe)
+void telemetry_log_id(TelemetryEventType_t type, uint8_t name_id,
+                      int32_t value, uint32_t context) {
+    if(!telemetry_initialized) return;
+    
+    uint32_t ticket = __atomic_fetch_add(&ring_head, 1, __ATOMIC_RELAXED);
+    TelemetryRecord_t* rec = &event_ring[ticket & TELEMETRY_BUFFER_MASK];
+    
+    // Invalidate before overwriting so a concurrent reader drops the slot
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    
+    rec->cycles = DWT_CYCCNT;
+    rec->value = value;
+    rec->context = context;
+    rec->coarse_s = coarse_seconds;
+    rec->type = (uint8_t)type;
+    rec->name_id = name_id;
+    
+    __atomic_store_n(&rec->seq, ticket + 1, __ATOMIC_RELEASE);
+}
+
+// Log an event by name (interns on every call; prefer TELEMETRY_LOG)
+void telemetry_log_event(TelemetryEventType_t type, const char* name, 
+                         int32_t value, uint32_t context) {
+    if(!telemetry_initialized) return;
+    telemetry_log_id(type, telemetry_intern(name), value, context);
 }
 
 // Log error
@@ -115,6 +232,7 @@ void telemetry_update_system_metrics(void) {
     if(!telemetry_initialized) return;
     
     telemetry_state.last_update_ms = furi_get_tick();
+    coarse_seconds = (telemetry_state.last_update_ms - telemetry_state.boot_time_ms) / 1000;
     
     // Would query FreeRTOS for heap/stack info
     // telemetry_state.heap_free = xPortGetFreeHeapSize();
@@ -191,22 +309,28 @@ const TelemetryState_t* telemetry_get_state(void) {
     return &telemetry_state;
 }
 
-// Get recent events
+// Get recent events, newest first (records overwritten mid-read are skipped)
 uint16_t telemetry_get_recent_events(TelemetryEvent_t* buffer, uint16_t max_count) {
     if(!telemetry_initialized || !buffer || max_count == 0) return 0;
     
     uint16_t count = 0;
-    uint16_t idx = telemetry_state.event_head;
+    uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+    uint32_t first = ring_first_ticket(head);
+    TelemetryRecord_t rec;
     
-    // Go backwards through circular buffer
-    for(uint16_t i = 0; i < telemetry_state.event_count && count < max_count; i++) {
-        idx = (idx + TELEMETRY_BUFFER_SIZE - 1) % TELEMETRY_BUFFER_SIZE;
-        memcpy(&buffer[count++], &telemetry_state.events[idx], sizeof(TelemetryEvent_t));
+    for(uint32_t ticket = head; ticket > first && count < max_count; ticket--) {
+        if(!ring_read(ticket - 1, &rec)) continue;
+        record_decode(&rec, &buffer[count++]);
     }
     
     return count;
 }
 
+// Events logged since init (including those already overwritten)
+uint32_t telemetry_events_logged(void) {
+    return __atomic_load_n(&ring_head, __ATOMIC_RELAXED);
+}
+
 // Get counter stats
 void telemetry_get_counter_stats(uint8_t counter_id, uint32_t* count, 
                                   uint32_t* avg_time, uint32_t* max_time) {
@@ -231,7 +355,7 @@ void telemetry_generate_report(char* buffer, uint32_t max_len) {
     pos += snprintf(buffer + pos, max_len - pos,
         "=== RF RESEARCH PLATFORM TELEMETRY ===\n"
         "Uptime: %lu ms\n"
-        "Events logged: %u\n\n"
+        "Events logged: %lu\n\n"
         "RF METRICS:\n"
         "  Frames processed: %lu\n"
         "  Frames dropped: %lu\n"
@@ -252,7 +376,7 @@ void telemetry_generate_report(char* buffer, uint32_t max_len) {
         "  Avg write latency: %lu us\n\n"
         "PERFORMANCE COUNTERS:\n",
         furi_get_tick() - telemetry_state.boot_time_ms,
-        telemetry_state.event_count,
+        telemetry_events_logged(),
         telemetry_state.frames_processed,
         telemetry_state.frames_dropped,
         telemetry_state.buffer_overflows,
@@ -281,29 +405,44 @@ void telemetry_generate_report(char* buffer, uint32_t max_len) {
     
     // Recent events
     pos += snprintf(buffer + pos, max_len - pos, "\nRECENT EVENTS:\n");
-    uint16_t event_idx = telemetry_state.event_head;
-    for(uint16_t i = 0; i < 10 && i < telemetry_state.event_count && pos < (int)max_len - 50; i++) {
-        event_idx = (event_idx + TELEMETRY_BUFFER_SIZE - 1) % TELEMETRY_BUFFER_SIZE;
-        TelemetryEvent_t* ev = &telemetry_state.events[event_idx];
+    TelemetryEvent_t recent[TELEMETRY_REPORT_EVENTS];
+    uint16_t recent_count = telemetry_get_recent_events(recent, TELEMETRY_REPORT_EVENTS);
+    for(uint16_t i = 0; i < recent_count && pos < (int)max_len - 50; i++) {
+        TelemetryEvent_t* ev = &recent[i];
         pos += snprintf(buffer + pos, max_len - pos,
             "  [%lu] %s: %s (val=%ld)\n",
-            ev->uptime_ms, 
-            ev->type == TELEM_EVENT_ERROR ? "ERR" :
-            ev->type == TELEM_EVENT_BOOT ? "BOOT" :
-            ev->type == TELEM_EVENT_MODE_CHANGE ? "MODE" : "EVENT",
-            ev->name, ev->value
+            ev->uptime_ms, event_type_name(ev->type), ev->name, ev->value
         );
     }
 }
 
-// Export to SD card
+// Export the event ring to LOGS_PATH/filename as CSV, oldest first
 bool telemetry_export_to_sd(const char* filename) {
-    char report[2048];
-    telemetry_generate_report(report, sizeof(report));
+    if(!telemetry_initialized || !filename) return false;
+    
+    char path[MAX_PATH_LEN];
+    snprintf(path, sizeof(path), "%s/%s", LOGS_PATH, filename);
+    
+    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_LOG, true);
+    if(!file) return false;
+    
+    bool ok = sd_manager_write_string(file, "seq,uptime_us,type,name,value,context\n");
+    
+    uint32_t head = __atomic_load_n(&ring_head, __ATOMIC_ACQUIRE);
+    TelemetryRecord_t rec;
+    TelemetryEvent_t ev;
+    char line[96];
+    
+    for(uint32_t ticket = ring_first_ticket(head); ok && ticket < head; ticket++) {
+        if(!ring_read(ticket, &rec)) continue;
+        record_decode(&rec, &ev);
+        snprintf(line, sizeof(line), "%lu,%lu,%s,%s,%ld,%lu\n",
+                 ticket, ev.uptime_us, event_type_name(ev.type), ev.name, ev.value, ev.context);
+        ok = sd_manager_write_string(file, line);
+    }
     
-    // Would write to SD via sd_manager
-    UNUSED(filename);
-    return true;
+    sd_manager_close_file(file);
+    return ok;
 }
 
 // Print to console
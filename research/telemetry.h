@@ -10,10 +10,20 @@ extern "C" {
 // ============================================================================
 // INTERNAL TELEMETRY SYSTEM
 // OS-level monitoring for reliability and optimization
+//
+// Events are 24-byte binary records in a lock-free ring shared by all
+// threads and ISRs: a producer takes a ticket with one atomic add, fills the
+// slot and publishes it by storing the ticket. Names are interned once into
+// small ids and timestamps are raw DWT cycles; text is only produced by the
+// report and export functions. The ring overwrites its oldest records.
 // ============================================================================
 
-#define TELEMETRY_BUFFER_SIZE       256
+#define TELEMETRY_BUFFER_SIZE       256             // Event records (power of 2)
+#define TELEMETRY_BUFFER_MASK       (TELEMETRY_BUFFER_SIZE - 1)
 #define TELEMETRY_EVENT_NAME_LEN    16
+#define TELEMETRY_MAX_NAMES         64              // Interned event names
+#define TELEMETRY_NAME_OTHER        0               // Id used once the name table is full
+#define TELEMETRY_NAME_UNSET        0xFF            // Call-site cache before interning
 #define TELEMETRY_MAX_COUNTERS      16
 
 // Event types
@@ -32,12 +42,24 @@ typedef enum {
     TELEM_EVENT_CUSTOM
 } TelemetryEventType_t;
 
-// Event structure
+// Ring record as written by producers
+typedef struct {
+    uint32_t seq;                   // Ticket + 1 once complete, 0 while being written
+    uint32_t cycles;                // DWT_CYCCNT at log time
+    int32_t value;
+    uint32_t context;
+    uint32_t coarse_s;              // Uptime seconds, resolves DWT wraps on decode
+    uint8_t type;                   // TelemetryEventType_t
+    uint8_t name_id;                // Interned name
+} TelemetryRecord_t;
+
+// Decoded event (telemetry_get_recent_events)
 typedef struct {
     TelemetryEventType_t type;
     uint32_t timestamp_ms;
     uint32_t uptime_ms;
-    char name[TELEMETRY_EVENT_NAME_LEN];
+    uint32_t uptime_us;             // Sub-millisecond position (wraps after ~71 min)
+    const char* name;               // Interned, valid for the app lifetime
     int32_t value;
     uint32_t context;
 } TelemetryEvent_t;
@@ -54,11 +76,6 @@ typedef struct {
 
 // System telemetry state
 typedef struct {
-    // Event log (circular buffer)
-    TelemetryEvent_t events[TELEMETRY_BUFFER_SIZE];
-    uint16_t event_head;
-    uint16_t event_count;
-    
     // Performance counters
     PerformanceCounter_t counters[TELEMETRY_MAX_COUNTERS];
     uint8_t counter_count;
@@ -109,7 +126,12 @@ typedef struct {
 FuriStatus telemetry_init(void);
 void telemetry_deinit(void);
 
-// Event logging
+// Event logging. telemetry_log_id is the hot path (no locks, no strings);
+// telemetry_log_event interns the name on every call.
+uint8_t telemetry_intern(const char* name);
+const char* telemetry_name(uint8_t name_id);
+void telemetry_log_id(TelemetryEventType_t type, uint8_t name_id,
+                      int32_t value, uint32_t context);
 void telemetry_log_event(TelemetryEventType_t type, const char* name, 
                          int32_t value, uint32_t context);
 void telemetry_log_error(const char* source, int32_t error_code);
@@ -137,6 +159,7 @@ void telemetry_update_throughput(uint32_t bps, uint32_t fer, uint32_t pdr);
 // Query functions
 const TelemetryState_t* telemetry_get_state(void);
 uint16_t telemetry_get_recent_events(TelemetryEvent_t* buffer, uint16_t max_count);
+uint32_t telemetry_events_logged(void);
 void telemetry_get_counter_stats(uint8_t counter_id, uint32_t* count, 
                                   uint32_t* avg_time, uint32_t* max_time);
 
@@ -154,6 +177,16 @@ void telemetry_start_monitoring(uint32_t interval_ms);
 void telemetry_stop_monitoring(void);
 bool telemetry_is_monitoring(void);
 
+// Log with the name interned once per call site
+#define TELEMETRY_LOG(type, name, value, context)                               \
+    do {                                                                        \
+        static uint8_t telemetry_site_id = TELEMETRY_NAME_UNSET;                \
+        if(telemetry_site_id == TELEMETRY_NAME_UNSET) {                         \
+            telemetry_site_id = telemetry_intern(name);                         \
+        }                                                                       \
+        telemetry_log_id((type), telemetry_site_id, (value), (context));        \
+    } while(0)
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,6 @@
 #include "compression.h"
+#include "../core/math/crc.h"
+#include "../core/pulse_store.h"
 #include <string.h>
 
 #define TAG "COMPRESSION"
@@ -9,6 +11,13 @@ static RLEState_t rle_state;
 static DeltaState_t delta_state;
 static bool compression_initialized = false;
 
+// Encode scratch for algorithm selection and block payloads (delta escapes
+// may run two bytes past COMPRESSION_MAX_BLOCK_SIZE)
+static uint8_t block_scratch[COMPRESSION_MAX_BLOCK_SIZE + 4];
+
+static uint32_t huffman_encode_bounded(const HuffmanState_t* state, const uint8_t* input,
+                                       uint32_t len, uint8_t* output, uint32_t max_output);
+
 // Initialize compression engine
 void compression_init(void) {
     if(compression_initialized) return;
@@ -45,15 +54,26 @@ bool compress_data(const uint8_t* input, uint32_t input_len,
             compressed_size = rle_encode(input, input_len, output);
             break;
             
-        case COMPRESS_HUFFMAN:
+        case COMPRESS_HUFFMAN: {
+            // Serialized code lengths followed by the bitstream
+            uint32_t table_len = 0;
             huffman_init(&huffman_state);
             huffman_build_tree(&huffman_state, input, input_len);
             huffman_generate_codes(&huffman_state);
-            compressed_size = huffman_encode(&huffman_state, input, input_len, output);
+            huffman_save_tree(&huffman_state, output, &table_len);
+            if(input_len > 0 && table_len == 0) return false;
+
+            uint32_t payload = huffman_encode_bounded(&huffman_state, input, input_len,
+                                                      &output[table_len],
+                                                      COMPRESSION_MAX_BLOCK_SIZE - table_len);
+            if(input_len > 0 && payload == 0) return false;  // Larger than a block
+            compressed_size = table_len + payload;
             break;
+        }
             
         case COMPRESS_LZ77:
-            compressed_size = lz77_encode(input, input_len, output, 4096, 18);
+            compressed_size = lz77_encode(input, input_len, output, 0, 0);
+            if(compressed_size == 0) return false;  // Larger than a block
             break;
             
         case COMPRESS_ADAPTIVE:
@@ -82,14 +102,27 @@ bool compress_data(const uint8_t* input, uint32_t input_len,
     return true;
 }
 
-// High-level decompression
+// High-level decompression of a block from compression_compress_block
+// (the header names the algorithm)
 bool decompress_data(const uint8_t* input, uint32_t input_len,
                      uint8_t* output, uint32_t* output_len,
                      CompressionStats_t* stats) {
-    // Would implement based on header indicating algorithm
-    // For now, just copy
-    memcpy(output, input, input_len);
-    *output_len = input_len;
+    if(!compression_initialized || !input || !output || !output_len) {
+        return false;
+    }
+
+    if(!compression_decompress_block(input, input_len, output, output_len, 0)) {
+        return false;
+    }
+
+    if(stats) {
+        stats->original_size = *output_len;
+        stats->compressed_size = input_len;
+        stats->ratio = (float)*output_len / (float)input_len;
+        stats->algorithm = (CompressionAlgorithm_t)input[1];
+        stats->decode_time_us = 0;
+    }
+
     return true;
 }
 
@@ -132,7 +165,7 @@ uint32_t delta_decode(const uint8_t* input, uint32_t len, uint8_t* output) {
     int16_t last = input[in_pos++];
     output[out_pos++] = (uint8_t)last;
     
-    while(in_pos < len) {
+    while(in_pos < len && out_pos < COMPRESSION_MAX_BLOCK_SIZE) {
         uint8_t byte = input[in_pos++];
         
         if(byte == 0x80 && in_pos + 1 < len) {
@@ -262,7 +295,7 @@ uint32_t rle_decode(const uint8_t* input, uint32_t len, uint8_t* output) {
     uint32_t in_pos = 0;
     uint32_t out_pos = 0;
     
-    while(in_pos < len) {
+    while(in_pos < len && out_pos < COMPRESSION_MAX_BLOCK_SIZE) {
         uint8_t byte = input[in_pos++];
         
         if(byte == 0x00) {
@@ -311,115 +344,217 @@ uint32_t rle_encode_adaptive(const uint8_t* input, uint32_t len, uint8_t* output
     }
 }
 
+// ============================================================================
+// CANONICAL HUFFMAN
+// ============================================================================
+
+// Tree construction scratch: leaves 0..n-1 in frequency order, internal
+// nodes n..2n-2 in creation order (which is also weight order)
+static uint16_t huffman_leaves[COMPRESSION_MAX_SYMBOLS];
+static uint32_t huffman_weight[2 * COMPRESSION_MAX_SYMBOLS];
+static uint16_t huffman_parent[2 * COMPRESSION_MAX_SYMBOLS];
+
+static inline bool huffman_leaf_before(const uint32_t* freq, uint16_t a, uint16_t b) {
+    return freq[a] < freq[b] || (freq[a] == freq[b] && a < b);
+}
+
+static void huffman_sift_down(uint16_t* leaves, uint16_t root, uint16_t n, const uint32_t* freq) {
+    while(1) {
+        uint16_t child = 2 * root + 1;
+        if(child >= n) break;
+        if(child + 1 < n && huffman_leaf_before(freq, leaves[child], leaves[child + 1])) child++;
+        if(!huffman_leaf_before(freq, leaves[root], leaves[child])) break;
+
+        uint16_t tmp = leaves[root];
+        leaves[root] = leaves[child];
+        leaves[child] = tmp;
+        root = child;
+    }
+}
+
+// Heapsort symbols by ascending frequency
+static void huffman_sort_leaves(uint16_t* leaves, uint16_t n, const uint32_t* freq) {
+    for(uint16_t i = n / 2; i-- > 0;) {
+        huffman_sift_down(leaves, i, n, freq);
+    }
+    for(uint16_t end = n; end-- > 1;) {
+        uint16_t tmp = leaves[0];
+        leaves[0] = leaves[end];
+        leaves[end] = tmp;
+        huffman_sift_down(leaves, 0, end, freq);
+    }
+}
+
+// Encoded size in bits for the current code lengths and frequencies
+static uint32_t huffman_bit_cost(const HuffmanState_t* state) {
+    uint32_t bits = 0;
+    for(uint16_t i = 0; i < COMPRESSION_MAX_SYMBOLS; i++) {
+        bits += state->frequencies[i] * state->code_lengths[i];
+    }
+    return bits;
+}
+
+// Bit writer shared by huffman_encode and compress_data
+static uint32_t huffman_encode_bounded(const HuffmanState_t* state, const uint8_t* input,
+                                       uint32_t len, uint8_t* output, uint32_t max_output) {
+    uint32_t out_pos = 0;
+    uint32_t bit_buffer = 0;
+    uint8_t bit_count = 0;
+
+    for(uint32_t i = 0; i < len; i++) {
+        uint8_t code_len = state->code_lengths[input[i]];
+        if(code_len == 0) return 0;  // Symbol not in the table
+
+        // At most 7 pending + 15 new bits, always fits the 32-bit buffer
+        bit_buffer = (bit_buffer << code_len) | state->codes[input[i]];
+        bit_count += code_len;
+
+        while(bit_count >= 8) {
+            if(out_pos >= max_output) return 0;
+            bit_count -= 8;
+            output[out_pos++] = (uint8_t)(bit_buffer >> bit_count);
+        }
+    }
+
+    // Flush remaining bits, zero padded
+    if(bit_count > 0) {
+        if(out_pos >= max_output) return 0;
+        output[out_pos++] = (uint8_t)(bit_buffer << (8 - bit_count));
+    }
+
+    return out_pos;
+}
+
 // Initialize Huffman state
 void huffman_init(HuffmanState_t* state) {
     memset(state, 0, sizeof(HuffmanState_t));
     state->initialized = true;
 }
 
-// Build Huffman tree
+// Count frequencies and compute length-limited code lengths
 void huffman_build_tree(HuffmanState_t* state, const uint8_t* data, uint32_t len) {
     if(!state->initialized) return;
-    
-    // Count frequencies
+
     memset(state->frequencies, 0, sizeof(state->frequencies));
+    memset(state->code_lengths, 0, sizeof(state->code_lengths));
     for(uint32_t i = 0; i < len; i++) {
         state->frequencies[data[i]]++;
     }
-    
-    // Initialize leaf nodes
-    state->num_nodes = 0;
+    state->symbol_count = len;
+
+    uint16_t n = 0;
     for(uint16_t i = 0; i < COMPRESSION_MAX_SYMBOLS; i++) {
-        if(state->frequencies[i] > 0) {
-            state->nodes[state->num_nodes].symbol = i;
-            state->nodes[state->num_nodes].frequency = state->frequencies[i];
-            state->nodes[state->num_nodes].left = 0xFFFF;
-            state->nodes[state->num_nodes].right = 0xFFFF;
-            state->nodes[state->num_nodes].parent = 0xFFFF;
-            state->symbol_to_node[i] = state->num_nodes;
-            state->num_nodes++;
-        }
+        if(state->frequencies[i] > 0) huffman_leaves[n++] = i;
     }
-    
-    // Build tree by combining lowest frequency nodes
-    uint16_t num_leaves = state->num_nodes;
-    
-    while(num_leaves > 1) {
-        // Find two nodes with lowest frequency
-        uint32_t min1_freq = 0xFFFFFFFF;
-        uint32_t min2_freq = 0xFFFFFFFF;
-        uint16_t min1_idx = 0xFFFF;
-        uint16_t min2_idx = 0xFFFF;
-        
-        for(uint16_t i = 0; i < state->num_nodes; i++) {
-            if(state->nodes[i].parent == 0xFFFF) {
-                if(state->nodes[i].frequency < min1_freq) {
-                    min2_freq = min1_freq;
-                    min2_idx = min1_idx;
-                    min1_freq = state->nodes[i].frequency;
-                    min1_idx = i;
-                } else if(state->nodes[i].frequency < min2_freq) {
-                    min2_freq = state->nodes[i].frequency;
-                    min2_idx = i;
-                }
+    state->num_symbols = n;
+
+    if(n == 0) return;
+    if(n == 1) {
+        state->code_lengths[huffman_leaves[0]] = 1;
+        return;
+    }
+
+    huffman_sort_leaves(huffman_leaves, n, state->frequencies);
+
+    // Two-queue merge: leaves and internal nodes are each consumed in
+    // weight order, so the two lightest nodes are always at a queue front
+    for(uint16_t i = 0; i < n; i++) {
+        huffman_weight[i] = state->frequencies[huffman_leaves[i]];
+    }
+
+    uint16_t next_leaf = 0;
+    uint16_t next_internal = n;
+    for(uint16_t node = n; node < 2 * n - 1; node++) {
+        uint32_t sum = 0;
+        for(uint8_t k = 0; k < 2; k++) {
+            uint16_t pick;
+            if(next_leaf < n &&
+               (next_internal >= node || huffman_weight[next_leaf] <= huffman_weight[next_internal])) {
+                pick = next_leaf++;
+            } else {
+                pick = next_internal++;
             }
+            huffman_parent[pick] = node;
+            sum += huffman_weight[pick];
         }
-        
-        if(min1_idx == 0xFFFF || min2_idx == 0xFFFF) break;
-        
-        // Create parent node
-        uint16_t parent_idx = state->num_nodes++;
-        state->nodes[parent_idx].frequency = state->nodes[min1_idx].frequency + 
-                                            state->nodes[min2_idx].frequency;
-        state->nodes[parent_idx].left = min1_idx;
-        state->nodes[parent_idx].right = min2_idx;
-        state->nodes[parent_idx].symbol = 0xFFFF;  // Internal node
-        state->nodes[parent_idx].parent = 0xFFFF;
-        
-        state->nodes[min1_idx].parent = parent_idx;
-        state->nodes[min2_idx].parent = parent_idx;
-        
-        num_leaves--;
+        huffman_weight[node] = sum;
     }
-    
-    // Find root
-    state->root = 0xFFFF;
-    for(uint16_t i = 0; i < state->num_nodes; i++) {
-        if(state->nodes[i].parent == 0xFFFF) {
-            state->root = i;
-            break;
+
+    // Depths, reusing the weight array: parents always follow their children
+    uint16_t root = 2 * n - 2;
+    huffman_weight[root] = 0;
+    for(uint16_t i = root; i-- > 0;) {
+        huffman_weight[i] = huffman_weight[huffman_parent[i]] + 1;
+    }
+
+    // Clamp to the length limit, then lengthen the deepest codes below the
+    // limit until the Kraft sum (in units of 2^-MAX) fits again
+    uint16_t bl_count[HUFFMAN_MAX_CODE_LENGTH + 1] = {0};
+    for(uint16_t i = 0; i < n; i++) {
+        uint32_t depth = huffman_weight[i];
+        bl_count[depth > HUFFMAN_MAX_CODE_LENGTH ? HUFFMAN_MAX_CODE_LENGTH : depth]++;
+    }
+
+    uint32_t kraft = 0;
+    for(uint8_t l = 1; l <= HUFFMAN_MAX_CODE_LENGTH; l++) {
+        kraft += (uint32_t)bl_count[l] << (HUFFMAN_MAX_CODE_LENGTH - l);
+    }
+    while(kraft > (1UL << HUFFMAN_MAX_CODE_LENGTH)) {
+        uint8_t l = HUFFMAN_MAX_CODE_LENGTH - 1;
+        while(bl_count[l] == 0) l--;
+        bl_count[l]--;
+        bl_count[l + 1]++;
+        kraft -= 1UL << (HUFFMAN_MAX_CODE_LENGTH - l - 1);
+    }
+
+    // Longest codes go to the least frequent symbols
+    uint16_t leaf = 0;
+    for(uint8_t l = HUFFMAN_MAX_CODE_LENGTH; l >= 1; l--) {
+        for(uint16_t c = bl_count[l]; c > 0; c--) {
+            state->code_lengths[huffman_leaves[leaf++]] = l;
         }
     }
 }
 
-// Generate Huffman codes
+// Assign canonical codes from code lengths and build the decode tables
 void huffman_generate_codes(HuffmanState_t* state) {
-    if(state->root == 0xFFFF) return;
-    
-    // Traverse tree to generate codes
-    // Simplified: just assign codes based on depth
-    for(uint16_t i = 0; i < state->num_nodes; i++) {
-        if(state->nodes[i].symbol != 0xFFFF) {
-            // Leaf node - calculate code by walking up tree
-            uint32_t code = 0;
-            uint8_t depth = 0;
-            uint16_t node = i;
-            
-            while(state->nodes[node].parent != 0xFFFF) {
-                uint16_t parent = state->nodes[node].parent;
-                code = (code << 1) | ((state->nodes[parent].right == node) ? 1 : 0);
-                depth++;
-                node = parent;
-            }
-            
-            // Reverse code
-            uint32_t reversed = 0;
-            for(uint8_t j = 0; j < depth; j++) {
-                reversed = (reversed << 1) | ((code >> j) & 1);
+    memset(state->length_count, 0, sizeof(state->length_count));
+    state->max_length = 0;
+    for(uint16_t s = 0; s < COMPRESSION_MAX_SYMBOLS; s++) {
+        uint8_t l = state->code_lengths[s];
+        if(l == 0) continue;
+        state->length_count[l]++;
+        if(l > state->max_length) state->max_length = l;
+    }
+
+    // First code and sorted-symbol offset of each length
+    uint16_t code = 0;
+    uint16_t offset = 0;
+    for(uint8_t l = 1; l <= HUFFMAN_MAX_CODE_LENGTH; l++) {
+        code = (code + state->length_count[l - 1]) << 1;
+        state->first_code[l] = code;
+        state->length_offset[l] = offset;
+        offset += state->length_count[l];
+    }
+
+    // Codes of one length are consecutive in symbol order
+    uint16_t rank[HUFFMAN_MAX_CODE_LENGTH + 1] = {0};
+    memset(state->lookup, 0, sizeof(state->lookup));
+    for(uint16_t s = 0; s < COMPRESSION_MAX_SYMBOLS; s++) {
+        uint8_t l = state->code_lengths[s];
+        if(l == 0) continue;
+
+        state->codes[s] = state->first_code[l] + rank[l];
+        state->sorted_symbols[state->length_offset[l] + rank[l]] = (uint8_t)s;
+        rank[l]++;
+
+        if(l <= HUFFMAN_LOOKUP_BITS) {
+            uint16_t start = state->codes[s] << (HUFFMAN_LOOKUP_BITS - l);
+            uint16_t span = 1 << (HUFFMAN_LOOKUP_BITS - l);
+            uint16_t entry = (s << 4) | l;
+            for(uint16_t k = 0; k < span; k++) {
+                state->lookup[start + k] = entry;
             }
-            
-            state->nodes[i].code = reversed;
-            state->nodes[i].code_length = depth;
         }
     }
 }
@@ -427,211 +562,643 @@ void huffman_generate_codes(HuffmanState_t* state) {
 // Huffman encode
 uint32_t huffman_encode(const HuffmanState_t* state, const uint8_t* input,
                         uint32_t len, uint8_t* output) {
+    return huffman_encode_bounded(state, input, len, output, COMPRESSION_MAX_BLOCK_SIZE);
+}
+
+// Huffman decode - table lookup on the top bits of a 32-bit window
+uint32_t huffman_decode(const HuffmanState_t* state, const uint8_t* input,
+                        uint32_t len, uint8_t* output) {
+    uint32_t in_pos = 0;
     uint32_t out_pos = 0;
-    uint8_t bit_buffer = 0;
-    uint8_t bit_count = 0;
-    
-    for(uint32_t i = 0; i < len; i++) {
-        uint16_t node_idx = state->symbol_to_node[input[i]];
-        uint32_t code = state->nodes[node_idx].code;
-        uint8_t code_len = state->nodes[node_idx].code_length;
-        
-        // Add bits to buffer
-        for(int8_t j = code_len - 1; j >= 0; j--) {
-            bit_buffer = (bit_buffer << 1) | ((code >> j) & 1);
-            bit_count++;
-            
-            if(bit_count == 8) {
-                output[out_pos++] = bit_buffer;
-                bit_buffer = 0;
-                bit_count = 0;
-                
-                if(out_pos >= COMPRESSION_MAX_BLOCK_SIZE) break;
+    uint32_t window = 0;  // Unread bits, left-aligned
+    uint8_t bits = 0;
+
+    while(out_pos < state->symbol_count) {
+        while(bits <= 24 && in_pos < len) {
+            window |= (uint32_t)input[in_pos++] << (24 - bits);
+            bits += 8;
+        }
+
+        uint16_t entry = state->lookup[window >> (32 - HUFFMAN_LOOKUP_BITS)];
+        uint8_t code_len = entry & 0x0F;
+        uint8_t symbol = entry >> 4;
+
+        if(entry == 0) {
+            // Longer code: compare against each length's canonical range
+            for(uint8_t l = HUFFMAN_LOOKUP_BITS + 1; l <= state->max_length; l++) {
+                uint32_t rank = (window >> (32 - l)) - state->first_code[l];
+                if(rank < state->length_count[l]) {
+                    code_len = l;
+                    symbol = state->sorted_symbols[state->length_offset[l] + rank];
+                    break;
+                }
             }
         }
+
+        if(code_len == 0 || code_len > bits) break;  // Invalid code or truncated input
+
+        window <<= code_len;
+        bits -= code_len;
+        output[out_pos++] = symbol;
     }
-    
-    // Flush remaining bits
-    if(bit_count > 0) {
-        bit_buffer <<= (8 - bit_count);
-        output[out_pos++] = bit_buffer;
+
+    return out_pos;
+}
+
+// ============================================================================
+// LZ77 (HASH-CHAIN MATCH FINDER, LZ4-STYLE TOKENS)
+// ============================================================================
+//
+// Sequence: token (literal run << 4 | match length - LZ77_MIN_MATCH), run
+// extension bytes while 255, literals, offset (LE16), match extension bytes.
+// A nibble of 15 means extension bytes follow. The last sequence carries
+// literals only and ends the stream.
+
+#define LZ77_NO_POSITION    0xFFFFFFFFUL
+
+// Match finder state: newest position per hash, distance to the previous
+// position with the same hash (0 = end of chain)
+static uint32_t lz77_head[1 << LZ77_HASH_BITS];
+static uint16_t lz77_chain[LZ77_WINDOW_SIZE];
+
+static inline uint32_t lz77_load32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t lz77_hash(const uint8_t* p) {
+    return (uint32_t)(lz77_load32(p) * 2654435761U) >> (32 - LZ77_HASH_BITS);
+}
+
+static inline void lz77_insert(const uint8_t* input, uint32_t pos) {
+    uint32_t h = lz77_hash(&input[pos]);
+    uint32_t prev = lz77_head[h];
+    uint32_t dist = (prev == LZ77_NO_POSITION) ? 0 : pos - prev;
+    lz77_chain[pos & (LZ77_WINDOW_SIZE - 1)] = (dist < LZ77_WINDOW_SIZE) ? (uint16_t)dist : 0;
+    lz77_head[h] = pos;
+}
+
+// Longest match for pos among the previous chain_depth positions with the
+// same hash. Positions before pos must already be inserted.
+static uint32_t lz77_find_match(const uint8_t* input, uint32_t pos, uint32_t max_len,
+                                uint32_t window, uint32_t* offset) {
+    uint32_t best_len = 0;
+    uint32_t cand = lz77_head[lz77_hash(&input[pos])];
+    uint32_t first = lz77_load32(&input[pos]);
+
+    for(uint8_t depth = 0; depth < LZ77_CHAIN_DEPTH && cand != LZ77_NO_POSITION; depth++) {
+        if(pos - cand > window) break;
+
+        // Cheap rejects: the byte that would extend the best match, then
+        // the hashed prefix (hash collisions)
+        if(input[cand + best_len] == input[pos + best_len] && lz77_load32(&input[cand]) == first) {
+            uint32_t l = LZ77_MIN_MATCH;
+            while(l < max_len && input[cand + l] == input[pos + l]) l++;
+            if(l > best_len) {
+                best_len = l;
+                *offset = pos - cand;
+                if(l >= max_len) break;
+            }
+        }
+
+        uint16_t dist = lz77_chain[cand & (LZ77_WINDOW_SIZE - 1)];
+        if(dist == 0) break;
+        cand -= dist;
     }
-    
+
+    return best_len;
+}
+
+static inline uint32_t lz77_write_length(uint8_t* output, uint32_t out_pos, uint32_t extra) {
+    while(extra >= 255) {
+        output[out_pos++] = 255;
+        extra -= 255;
+    }
+    output[out_pos++] = (uint8_t)extra;
     return out_pos;
 }
 
-// Huffman decode
-uint32_t huffman_decode(const HuffmanState_t* state, const uint8_t* input,
-                        uint32_t len, uint8_t* output) {
-    // Would implement tree traversal
-    // For now, return 0
-    UNUSED(state);
-    UNUSED(input);
-    UNUSED(len);
-    UNUSED(output);
-    return 0;
+// Emit one sequence (match_len 0 = final literal-only sequence).
+// Returns the new output position, 0 when it does not fit.
+static uint32_t lz77_emit(uint8_t* output, uint32_t out_pos, uint32_t max_output,
+                          const uint8_t* literals, uint32_t lit_len,
+                          uint32_t offset, uint32_t match_len) {
+    uint32_t extra_match = match_len ? match_len - LZ77_MIN_MATCH : 0;
+    uint32_t worst = 1 + lit_len / 255 + 1 + lit_len + (match_len ? 2 + extra_match / 255 + 1 : 0);
+    if(out_pos + worst > max_output) return 0;
+
+    uint8_t token = (uint8_t)(((lit_len >= 15) ? 15 : lit_len) << 4);
+    if(match_len) token |= (extra_match >= 15) ? 15 : extra_match;
+    output[out_pos++] = token;
+
+    if(lit_len >= 15) out_pos = lz77_write_length(output, out_pos, lit_len - 15);
+    memcpy(&output[out_pos], literals, lit_len);
+    out_pos += lit_len;
+
+    if(match_len) {
+        output[out_pos++] = (uint8_t)(offset & 0xFF);
+        output[out_pos++] = (uint8_t)(offset >> 8);
+        if(extra_match >= 15) out_pos = lz77_write_length(output, out_pos, extra_match - 15);
+    }
+
+    return out_pos;
 }
 
-// LZ77 encode (simplified)
-uint32_t lz77_encode(const uint8_t* input, uint32_t len, uint8_t* output,
-                     uint16_t window_size, uint16_t lookahead_size) {
-    uint32_t in_pos = 0;
+static uint32_t lz77_encode_bounded(const uint8_t* input, uint32_t len, uint8_t* output,
+                                    uint32_t max_output, uint32_t window, uint32_t max_match) {
+    if(window == 0 || window > LZ77_WINDOW_SIZE - 1) window = LZ77_WINDOW_SIZE - 1;
+    if(max_match < LZ77_MIN_MATCH) max_match = LZ77_MIN_MATCH;
+
+    for(uint32_t i = 0; i < (1UL << LZ77_HASH_BITS); i++) {
+        lz77_head[i] = LZ77_NO_POSITION;
+    }
+
     uint32_t out_pos = 0;
-    
-    while(in_pos < len && out_pos < COMPRESSION_MAX_BLOCK_SIZE - 4) {
-        // Find longest match in window
-        uint16_t best_length = 0;
-        uint16_t best_offset = 0;
-        
-        uint16_t window_start = (in_pos > window_size) ? (in_pos - window_size) : 0;
-        uint16_t max_lookahead = (in_pos + lookahead_size < len) ? 
-                                 lookahead_size : (len - in_pos);
-        
-        for(uint16_t i = window_start; i < in_pos; i++) {
-            uint16_t match_len = 0;
-            while(match_len < max_lookahead && 
-                  input[i + match_len] == input[in_pos + match_len]) {
-                match_len++;
-            }
-            
-            if(match_len > best_length) {
-                best_length = match_len;
-                best_offset = in_pos - i;
-            }
+    uint32_t anchor = 0;            // First literal not yet emitted
+    uint32_t next_insert = 0;       // First position not yet in the chains
+    uint32_t pos = 0;
+
+    // Hashing reads LZ77_MIN_MATCH bytes, so matches start at most here
+    uint32_t match_limit = (len >= LZ77_MIN_MATCH) ? len - LZ77_MIN_MATCH + 1 : 0;
+
+    while(pos < match_limit) {
+        while(next_insert < pos) lz77_insert(input, next_insert++);
+
+        uint32_t offset = 0;
+        uint32_t remaining = len - pos;
+        uint32_t match_len = lz77_find_match(input, pos, remaining < max_match ? remaining : max_match,
+                                             window, &offset);
+        lz77_insert(input, pos);
+        next_insert = pos + 1;
+
+        if(match_len < LZ77_MIN_MATCH) {
+            pos++;
+            continue;
         }
-        
-        if(best_length >= 3) {
-            // Encode as (offset, length) pair
-            output[out_pos++] = 0x00;  // Match indicator
-            output[out_pos++] = best_offset >> 8;
-            output[out_pos++] = best_offset & 0xFF;
-            output[out_pos++] = best_length;
-            in_pos += best_length;
-        } else {
-            // Encode literal
-            if(input[in_pos] == 0x00) {
-                output[out_pos++] = 0x00;
-                output[out_pos++] = 0xFF;  // Escape
-            }
-            output[out_pos++] = input[in_pos++];
+
+        // Lazy matching: defer by one byte while that finds a longer match
+        while(match_len < LZ77_LAZY_LENGTH && pos + 1 < match_limit) {
+            uint32_t next_offset = 0;
+            remaining = len - pos - 1;
+            uint32_t next_len = lz77_find_match(input, pos + 1,
+                                                remaining < max_match ? remaining : max_match,
+                                                window, &next_offset);
+            lz77_insert(input, pos + 1);
+            next_insert = pos + 2;
+
+            if(next_len <= match_len) break;
+            pos++;
+            match_len = next_len;
+            offset = next_offset;
         }
+
+        out_pos = lz77_emit(output, out_pos, max_output, &input[anchor], pos - anchor,
+                            offset, match_len);
+        if(out_pos == 0) return 0;
+
+        pos += match_len;
+        anchor = pos;
     }
-    
+
+    out_pos = lz77_emit(output, out_pos, max_output, &input[anchor], len - anchor, 0, 0);
     return out_pos;
 }
 
-// LZ77 decode
+// LZ77 encode (window_size and max_match of 0 select the defaults)
+uint32_t lz77_encode(const uint8_t* input, uint32_t len, uint8_t* output,
+                     uint16_t window_size, uint16_t max_match) {
+    if(len > COMPRESSION_MAX_BLOCK_SIZE) return 0;  // Decoder output is block-bounded
+    return lz77_encode_bounded(input, len, output, COMPRESSION_MAX_BLOCK_SIZE, window_size,
+                               max_match ? max_match : LZ77_MAX_MATCH);
+}
+
+static inline bool lz77_read_length(const uint8_t* input, uint32_t len, uint32_t* in_pos,
+                                    uint32_t* value) {
+    uint8_t byte;
+    do {
+        if(*in_pos >= len) return false;
+        byte = input[(*in_pos)++];
+        *value += byte;
+    } while(byte == 255);
+    return true;
+}
+
+// LZ77 decode - returns 0 on a malformed stream
 uint32_t lz77_decode(const uint8_t* input, uint32_t len, uint8_t* output) {
     uint32_t in_pos = 0;
     uint32_t out_pos = 0;
-    
+
     while(in_pos < len) {
-        uint8_t byte = input[in_pos++];
-        
-        if(byte == 0x00) {
-            if(in_pos >= len) break;
-            uint8_t next = input[in_pos++];
-            
-            if(next == 0xFF) {
-                // Escaped 0x00
-                output[out_pos++] = 0x00;
-            } else if(in_pos + 1 < len) {
-                // Match
-                uint16_t offset = (next << 8) | input[in_pos++];
-                uint8_t length = input[in_pos++];
-                
-                for(uint8_t i = 0; i < length; i++) {
-                    output[out_pos] = output[out_pos - offset];
-                    out_pos++;
-                }
-            }
-        } else {
-            output[out_pos++] = byte;
+        uint8_t token = input[in_pos++];
+
+        uint32_t lit_len = token >> 4;
+        if(lit_len == 15 && !lz77_read_length(input, len, &in_pos, &lit_len)) return 0;
+        if(lit_len > len - in_pos || lit_len > COMPRESSION_MAX_BLOCK_SIZE - out_pos) return 0;
+
+        memcpy(&output[out_pos], &input[in_pos], lit_len);
+        in_pos += lit_len;
+        out_pos += lit_len;
+
+        if(in_pos == len) break;  // Final literal-only sequence
+
+        if(len - in_pos < 2) return 0;
+        uint32_t offset = input[in_pos] | ((uint32_t)input[in_pos + 1] << 8);
+        in_pos += 2;
+
+        uint32_t match_len = token & 0x0F;
+        if(match_len == 15 && !lz77_read_length(input, len, &in_pos, &match_len)) return 0;
+        match_len += LZ77_MIN_MATCH;
+
+        if(offset == 0 || offset > out_pos || match_len > COMPRESSION_MAX_BLOCK_SIZE - out_pos) {
+            return 0;
         }
+
+        // Byte copy: overlapping matches replicate runs
+        const uint8_t* src = &output[out_pos - offset];
+        for(uint32_t i = 0; i < match_len; i++) {
+            output[out_pos + i] = src[i];
+        }
+        out_pos += match_len;
     }
-    
+
     return out_pos;
 }
 
-// Compress pulse sequence
-uint32_t compress_pulse_sequence(const Pulse_t* pulses, uint16_t count,
-                                  uint8_t* output, uint32_t max_output) {
-    if(count == 0 || !output || max_output == 0) return 0;
-    
-    uint32_t out_pos = 0;
-    
-    // Store count
-    output[out_pos++] = count >> 8;
-    output[out_pos++] = count & 0xFF;
-    
-    // Delta encode pulse widths
-    uint16_t* widths = (uint16_t*)malloc(count * sizeof(uint16_t));
-    if(!widths) return 0;
-    
+// ============================================================================
+// PULSE CODEC
+// ============================================================================
+//
+// Header: magic, flags (bit 0 first level, bits 1-3 residual shift), pulse
+// count (LE16), first timestamp (LE32), cluster count, then per cluster its
+// center (LE16) and Rice parameter. Each pulse is a fixed-width symbol - the
+// cluster index, or the escape symbol (= cluster count) - followed by the
+// Rice-coded zigzag residual against the cluster center. Escapes carry a
+// level-repeat bit and the raw 20-bit width, enough for the coarse pulse
+// store range (PULSE_COARSE_MAX_US). Levels alternate implicitly.
+
+#define PULSE_CODEC_HEADER_SIZE     9
+#define PULSE_CODEC_RICE_ESCAPE     16      // Unary prefix meaning "raw 16-bit value follows"
+#define PULSE_CODEC_RICE_MAX_K      14
+#define PULSE_CODEC_ESCAPE_BITS     20      // Raw width after an escape symbol
+
+_Static_assert(PULSE_COARSE_MAX_US < (1UL << PULSE_CODEC_ESCAPE_BITS), "escape too narrow");
+
+typedef uint32_t (*PulseSourceFn)(const void* source, uint16_t index, uint8_t* level);
+typedef bool (*PulseSinkFn)(void* sink, uint32_t width_us, uint8_t level, uint32_t timestamp_us);
+
+typedef struct {
+    uint8_t* data;
+    uint32_t pos;
+    uint32_t max;
+    uint32_t acc;
+    uint8_t count;
+    bool overflow;
+} BitWriter_t;
+
+typedef struct {
+    const uint8_t* data;
+    uint32_t pos;
+    uint32_t len;
+    uint32_t acc;
+    uint8_t count;
+    bool overrun;
+} BitReader_t;
+
+typedef struct {
+    const PulseBuffer_t* store;
+    uint16_t start;
+} PulseStoreSource_t;
+
+typedef struct {
+    Pulse_t* pulses;
+    uint16_t max;
+    uint16_t count;
+} PulseArraySink_t;
+
+// Write n <= 16 bits, MSB first
+static inline void bits_put(BitWriter_t* w, uint32_t value, uint8_t n) {
+    w->acc = (w->acc << n) | (value & ((1UL << n) - 1));
+    w->count += n;
+    while(w->count >= 8) {
+        w->count -= 8;
+        if(w->pos >= w->max) {
+            w->overflow = true;
+            return;
+        }
+        w->data[w->pos++] = (uint8_t)(w->acc >> w->count);
+    }
+}
+
+static inline void bits_flush(BitWriter_t* w) {
+    if(w->count > 0) bits_put(w, 0, 8 - w->count);
+}
+
+// Read n <= 16 bits (zeros past the end, flagged as overrun)
+static inline uint32_t bits_get(BitReader_t* r, uint8_t n) {
+    while(r->count < n) {
+        uint8_t byte = 0;
+        if(r->pos < r->len) {
+            byte = r->data[r->pos++];
+        } else {
+            r->overrun = true;
+        }
+        r->acc = (r->acc << 8) | byte;
+        r->count += 8;
+    }
+    r->count -= n;
+    return (r->acc >> r->count) & ((1UL << n) - 1);
+}
+
+static inline void rice_put(BitWriter_t* w, uint32_t value, uint8_t k) {
+    uint32_t q = value >> k;
+    if(q >= PULSE_CODEC_RICE_ESCAPE) {
+        bits_put(w, 0xFFFF, PULSE_CODEC_RICE_ESCAPE);
+        bits_put(w, value, 16);
+        return;
+    }
+    bits_put(w, ((1UL << q) - 1) << 1, (uint8_t)(q + 1));  // q ones, then a zero
+    if(k > 0) bits_put(w, value, k);
+}
+
+static inline uint32_t rice_get(BitReader_t* r, uint8_t k) {
+    uint32_t q = 0;
+    while(q < PULSE_CODEC_RICE_ESCAPE && bits_get(r, 1)) q++;
+    if(q == PULSE_CODEC_RICE_ESCAPE) return bits_get(r, 16);
+    return (q << k) | (k > 0 ? bits_get(r, k) : 0);
+}
+
+static inline uint32_t zigzag_encode(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+// Nearest cluster within tolerance, cluster_count (= escape) if none.
+// Widths beyond 16 bits always escape.
+static uint8_t pulse_codec_nearest(const uint16_t* centers, uint8_t cluster_count, uint32_t width) {
+    uint8_t best = cluster_count;
+    if(width > UINT16_MAX) return best;
+    uint32_t best_dist = 0xFFFFFFFFUL;
+    for(uint8_t c = 0; c < cluster_count; c++) {
+        uint32_t dist = (width > centers[c]) ? width - centers[c] : centers[c] - width;
+        uint32_t tolerance = (centers[c] >> PULSE_CODEC_TOLERANCE_SHIFT) + PULSE_CODEC_MIN_TOLERANCE_US;
+        if(dist <= tolerance && dist < best_dist) {
+            best = c;
+            best_dist = dist;
+        }
+    }
+    return best;
+}
+
+// Residual scaled by 2^-shift, rounded half away from zero
+static inline int32_t pulse_codec_quantize(int32_t residual, uint8_t shift) {
+    int32_t half = (1 << shift) >> 1;
+    return (residual >= 0) ? (residual + half) >> shift : -((-residual + half) >> shift);
+}
+
+static uint32_t pulse_codec_encode(PulseSourceFn source_fn, const void* source, uint16_t count,
+                                   uint32_t first_timestamp, const uint16_t* seeds,
+                                   uint8_t seed_count, uint8_t residual_shift,
+                                   uint8_t* output, uint32_t max_output) {
+    if(count == 0 || !output || max_output < PULSE_CODEC_HEADER_SIZE) return 0;
+    if(residual_shift > 7) residual_shift = 7;
+
+    uint16_t centers[PULSE_CODEC_MAX_CLUSTERS];
+    uint32_t sums[PULSE_CODEC_MAX_CLUSTERS];
+    uint16_t members[PULSE_CODEC_MAX_CLUSTERS];
+    uint8_t cluster_count = 0;
+    uint8_t level;
+
+    // Pass 1: seed with the inferred timing clusters, open clusters for
+    // widths outside every tolerance, track running means
+    for(uint8_t i = 0; i < seed_count && cluster_count < PULSE_CODEC_MAX_CLUSTERS; i++) {
+        if(seeds[i] == 0) continue;
+        centers[cluster_count] = seeds[i];
+        sums[cluster_count] = seeds[i];
+        members[cluster_count++] = 1;
+    }
+
     for(uint16_t i = 0; i < count; i++) {
-        widths[i] = pulses[i].width_us;
+        uint32_t width = source_fn(source, i, &level);
+        uint8_t c = pulse_codec_nearest(centers, cluster_count, width);
+
+        if(c == cluster_count) {
+            if(cluster_count == PULSE_CODEC_MAX_CLUSTERS || width > UINT16_MAX) {
+                continue;  // Escaped later
+            }
+            centers[c] = (uint16_t)width;
+            sums[c] = 0;
+            members[c] = 0;
+            cluster_count++;
+        }
+        sums[c] += width;
+        members[c]++;
+        centers[c] = (uint16_t)((sums[c] + members[c] / 2) / members[c]);
     }
-    
-    uint32_t compressed = delta_encode_16bit(widths, count, &output[out_pos]);
-    out_pos += compressed;
-    
-    // Store levels (RLE encoded)
-    uint8_t current_level = pulses[0].level;
-    uint8_t run_length = 1;
-    
-    for(uint16_t i = 1; i < count && out_pos < max_output; i++) {
-        if(pulses[i].level == current_level && run_length < 255) {
-            run_length++;
+
+    // Drop singletons - an escape costs about what a table entry does
+    uint8_t kept = 0;
+    for(uint8_t c = 0; c < cluster_count; c++) {
+        if(members[c] >= 2) centers[kept++] = centers[c];
+    }
+    cluster_count = kept;
+
+    // Pass 2: residual magnitudes per cluster pick the Rice parameters
+    uint8_t level_prev = 0;
+    uint8_t rice_k[PULSE_CODEC_MAX_CLUSTERS];
+    memset(sums, 0, sizeof(sums));
+    memset(members, 0, sizeof(members));
+
+    for(uint16_t i = 0; i < count; i++) {
+        uint32_t width = source_fn(source, i, &level);
+        uint8_t c = pulse_codec_nearest(centers, cluster_count, width);
+        if(c == cluster_count || (i > 0 && level == level_prev)) {
+            level_prev = level;
+            continue;
+        }
+        level_prev = level;
+        sums[c] += zigzag_encode(pulse_codec_quantize((int32_t)width - centers[c], residual_shift));
+        members[c]++;
+    }
+
+    for(uint8_t c = 0; c < cluster_count; c++) {
+        uint8_t k = 0;
+        while(k < PULSE_CODEC_RICE_MAX_K && ((uint32_t)members[c] << (k + 1)) <= sums[c]) k++;
+        rice_k[c] = k;
+    }
+
+    // Header
+    source_fn(source, 0, &level);
+    uint32_t pos = 0;
+    output[pos++] = PULSE_CODEC_MAGIC;
+    output[pos++] = (uint8_t)(level | (residual_shift << 1));
+    output[pos++] = (uint8_t)(count & 0xFF);
+    output[pos++] = (uint8_t)(count >> 8);
+    for(uint8_t i = 0; i < 4; i++) {
+        output[pos++] = (uint8_t)(first_timestamp >> (8 * i));
+    }
+    output[pos++] = cluster_count;
+
+    if(pos + 3UL * cluster_count > max_output) return 0;
+    for(uint8_t c = 0; c < cluster_count; c++) {
+        output[pos++] = (uint8_t)(centers[c] & 0xFF);
+        output[pos++] = (uint8_t)(centers[c] >> 8);
+        output[pos++] = rice_k[c];
+    }
+
+    // Pass 3: symbols and residuals
+    BitWriter_t w = {.data = output, .pos = pos, .max = max_output};
+    uint8_t symbol_bits = 1;
+    while((1U << symbol_bits) <= cluster_count) symbol_bits++;
+
+    for(uint16_t i = 0; i < count && !w.overflow; i++) {
+        uint32_t width = source_fn(source, i, &level);
+        uint8_t c = pulse_codec_nearest(centers, cluster_count, width);
+        bool repeat = (i > 0 && level == level_prev);
+        level_prev = level;
+
+        if(c == cluster_count || repeat) {
+            bits_put(&w, cluster_count, symbol_bits);
+            bits_put(&w, repeat ? 1 : 0, 1);
+            bits_put(&w, width >> 16, PULSE_CODEC_ESCAPE_BITS - 16);
+            bits_put(&w, width, 16);
         } else {
-            output[out_pos++] = (run_length << 1) | current_level;
-            current_level = pulses[i].level;
-            run_length = 1;
+            bits_put(&w, c, symbol_bits);
+            rice_put(&w, zigzag_encode(pulse_codec_quantize((int32_t)width - centers[c],
+                                                            residual_shift)),
+                     rice_k[c]);
         }
     }
-    
-    if(run_length > 0 && out_pos < max_output) {
-        output[out_pos++] = (run_length << 1) | current_level;
+    bits_flush(&w);
+
+    return w.overflow ? 0 : w.pos;
+}
+
+static uint16_t pulse_codec_decode(const uint8_t* input, uint32_t len, PulseSinkFn sink_fn,
+                                   void* sink) {
+    if(!input || len < PULSE_CODEC_HEADER_SIZE || input[0] != PULSE_CODEC_MAGIC) return 0;
+
+    uint8_t level = input[1] & 1;
+    uint8_t residual_shift = (input[1] >> 1) & 0x07;
+    uint16_t count = input[2] | ((uint16_t)input[3] << 8);
+    uint32_t timestamp = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        timestamp |= (uint32_t)input[4 + i] << (8 * i);
     }
-    
-    free(widths);
-    return out_pos;
+
+    uint8_t cluster_count = input[8];
+    if(cluster_count > PULSE_CODEC_MAX_CLUSTERS ||
+       len < PULSE_CODEC_HEADER_SIZE + 3UL * cluster_count) {
+        return 0;
+    }
+
+    uint16_t centers[PULSE_CODEC_MAX_CLUSTERS];
+    uint8_t rice_k[PULSE_CODEC_MAX_CLUSTERS];
+    uint32_t pos = PULSE_CODEC_HEADER_SIZE;
+    for(uint8_t c = 0; c < cluster_count; c++) {
+        centers[c] = input[pos] | ((uint16_t)input[pos + 1] << 8);
+        rice_k[c] = input[pos + 2];
+        if(rice_k[c] > PULSE_CODEC_RICE_MAX_K) return 0;
+        pos += 3;
+    }
+
+    BitReader_t r = {.data = input, .pos = pos, .len = len};
+    uint8_t symbol_bits = 1;
+    while((1U << symbol_bits) <= cluster_count) symbol_bits++;
+
+    uint16_t decoded = 0;
+    for(uint16_t i = 0; i < count; i++) {
+        uint8_t c = (uint8_t)bits_get(&r, symbol_bits);
+        int32_t width;
+
+        if(c == cluster_count) {
+            if(bits_get(&r, 1) && i > 0) level ^= 1;  // Level repeats: undo the alternation
+            width = (int32_t)(bits_get(&r, PULSE_CODEC_ESCAPE_BITS - 16) << 16);
+            width |= (int32_t)bits_get(&r, 16);
+        } else if(c < cluster_count) {
+            int32_t residual = zigzag_decode(rice_get(&r, rice_k[c]));
+            width = (int32_t)centers[c] + residual * (1 << residual_shift);
+            if(width < 0) width = 0;
+            if(width > MAX_PULSE_WIDTH_US) width = MAX_PULSE_WIDTH_US;
+        } else {
+            break;  // Symbol outside the table
+        }
+
+        if(r.overrun || !sink_fn(sink, (uint32_t)width, level, timestamp)) break;
+
+        decoded++;
+        timestamp += (uint32_t)width;
+        level ^= 1;
+    }
+
+    return decoded;
+}
+
+static uint32_t pulse_array_source(const void* source, uint16_t index, uint8_t* level) {
+    const Pulse_t* pulse = &((const Pulse_t*)source)[index];
+    *level = pulse->level ? 1 : 0;
+    return pulse->width_us;
+}
+
+// Full coarse duration, so long gaps round-trip into the same packed word
+static uint32_t pulse_store_source(const void* source, uint16_t index, uint8_t* level) {
+    const PulseStoreSource_t* src = source;
+    uint16_t word = pulse_store_word(src->store, (uint16_t)(src->start + index));
+    *level = pulse_unpack_level(word);
+    return pulse_unpack_duration(word);
+}
+
+static bool pulse_array_sink(void* sink, uint32_t width_us, uint8_t level, uint32_t timestamp_us) {
+    PulseArraySink_t* dst = sink;
+    if(dst->count >= dst->max) return false;
+
+    Pulse_t* pulse = &dst->pulses[dst->count++];
+    pulse->width_us = (width_us > MAX_PULSE_WIDTH_US) ? MAX_PULSE_WIDTH_US : (uint16_t)width_us;
+    pulse->level = level;
+    pulse->timestamp_us = timestamp_us;
+    return true;
 }
 
-// Decompress pulse sequence
+static bool pulse_store_sink(void* sink, uint32_t width_us, uint8_t level, uint32_t timestamp_us) {
+    return pulse_store_push((PulseBuffer_t*)sink, width_us, level, timestamp_us);
+}
+
+// Compress pulse sequence (lossless, clusters found by the codec)
+uint32_t compress_pulse_sequence(const Pulse_t* pulses, uint16_t count,
+                                  uint8_t* output, uint32_t max_output) {
+    if(!pulses || count == 0) return 0;
+    return pulse_codec_encode(pulse_array_source, pulses, count, pulses[0].timestamp_us,
+                              NULL, 0, 0, output, max_output);
+}
+
+// Decompress pulse sequence (timestamps rebuilt from the widths)
 uint32_t decompress_pulse_sequence(const uint8_t* input, uint32_t len,
                                     Pulse_t* pulses, uint16_t max_pulses) {
-    if(len < 2) return 0;
-    
-    uint32_t in_pos = 0;
-    uint16_t count = (input[in_pos] << 8) | input[in_pos + 1];
-    in_pos += 2;
-    
-    if(count > max_pulses) count = max_pulses;
-    
-    // Decompress widths
-    uint16_t* widths = (uint16_t*)malloc(count * sizeof(uint16_t));
-    if(!widths) return 0;
-    
-    uint32_t decompressed = delta_decode_16bit(&input[in_pos], len - in_pos, widths);
-    in_pos += decompressed;
-    
-    // Decompress levels
-    uint16_t pulse_idx = 0;
-    while(pulse_idx < count && in_pos < len) {
-        uint8_t packed = input[in_pos++];
-        uint8_t run_length = packed >> 1;
-        uint8_t level = packed & 1;
-        
-        for(uint8_t i = 0; i < run_length && pulse_idx < count; i++) {
-            pulses[pulse_idx].width_us = widths[pulse_idx];
-            pulses[pulse_idx].level = level;
-            pulses[pulse_idx].timestamp_us = 0;  // Would reconstruct
-            pulse_idx++;
-        }
-    }
-    
-    free(widths);
-    return pulse_idx;
+    if(!pulses) return 0;
+    PulseArraySink_t sink = {.pulses = pulses, .max = max_pulses, .count = 0};
+    return pulse_codec_decode(input, len, pulse_array_sink, &sink);
+}
+
+// Compress count pulses of the pulse store starting at start (relative to
+// its tail). centers seeds the timing clusters (e.g. from
+// protocol_infer_get_cluster_centers); residual_shift > 0 drops that many
+// low bits of each residual.
+uint32_t compress_pulse_store(const PulseBuffer_t* store, uint16_t start, uint16_t count,
+                              const uint16_t* centers, uint8_t center_count,
+                              uint8_t residual_shift, uint8_t* output, uint32_t max_output) {
+    if(!store || count == 0 || (uint32_t)start + count > pulse_store_count(store)) return 0;
+
+    PulseStoreSource_t source = {.store = store, .start = start};
+    return pulse_codec_encode(pulse_store_source, &source, count,
+                              pulse_store_timestamp(store, start), centers,
+                              centers ? center_count : 0, residual_shift, output, max_output);
+}
+
+// Decode straight into the pulse store (appended at its head)
+uint16_t decompress_pulse_store(const uint8_t* input, uint32_t len, PulseBuffer_t* store) {
+    if(!store) return 0;
+    return pulse_codec_decode(input, len, pulse_store_sink, store);
 }
 
 // Find duplicate frames
@@ -669,29 +1236,51 @@ uint32_t compress_frame_sequence(const Frame_t* frames, uint16_t count,
     return out_pos;
 }
 
-// Select best compression algorithm
+// Select best compression algorithm for a block: smallest output, but
+// COMPRESS_NONE unless the ratio exceeds 1.2 (marginal gains don't pay for
+// the decode time)
 CompressionAlgorithm_t compression_select_algorithm(const uint8_t* sample_data,
                                                    uint32_t sample_len) {
-    // Quick test of each algorithm on sample
-    uint8_t test_output[256];
+    if(!sample_data || sample_len == 0) return COMPRESS_NONE;
+    if(sample_len > COMPRESSION_MAX_BLOCK_SIZE) sample_len = COMPRESSION_MAX_BLOCK_SIZE;
+
+    CompressionAlgorithm_t best = COMPRESS_NONE;
+    uint32_t best_len = sample_len;
     uint32_t test_len;
-    
-    // Test delta
-    test_len = delta_encode(sample_data, sample_len, test_output);
-    float delta_ratio = (float)sample_len / (float)test_len;
-    
-    // Test RLE
-    test_len = rle_encode(sample_data, sample_len, test_output);
-    float rle_ratio = (float)sample_len / (float)test_len;
-    
-    // Pick best
-    if(delta_ratio > rle_ratio && delta_ratio > 1.2f) {
-        return COMPRESS_DELTA;
-    } else if(rle_ratio > 1.2f) {
-        return COMPRESS_RLE;
+
+    test_len = delta_encode(sample_data, sample_len, block_scratch);
+    if(test_len < best_len) {
+        best = COMPRESS_DELTA;
+        best_len = test_len;
     }
-    
-    return COMPRESS_NONE;
+
+    test_len = rle_encode(sample_data, sample_len, block_scratch);
+    if(test_len < best_len) {
+        best = COMPRESS_RLE;
+        best_len = test_len;
+    }
+
+    test_len = lz77_encode_bounded(sample_data, sample_len, block_scratch, best_len, 0,
+                                   LZ77_MAX_MATCH);
+    if(test_len > 0 && test_len < best_len) {
+        best = COMPRESS_LZ77;
+        best_len = test_len;
+    }
+
+    // Huffman is priced from its code lengths without encoding
+    huffman_init(&huffman_state);
+    huffman_build_tree(&huffman_state, sample_data, sample_len);
+    huffman_save_tree(&huffman_state, block_scratch, &test_len);
+    if(test_len > 0) {
+        test_len += (huffman_bit_cost(&huffman_state) + 7) / 8;
+        if(test_len < best_len) {
+            best = COMPRESS_HUFFMAN;
+            best_len = test_len;
+        }
+    }
+
+    if(best_len * 6 >= sample_len * 5) return COMPRESS_NONE;
+    return best;
 }
 
 // Estimate compression ratio
@@ -707,6 +1296,18 @@ float compression_estimate_ratio(const uint8_t* data, uint32_t len,
         case COMPRESS_RLE:
             test_len = rle_encode(data, len > 256 ? 256 : len, test_output);
             break;
+        case COMPRESS_LZ77:
+            test_len = lz77_encode_bounded(data, len > 256 ? 256 : len, test_output,
+                                           sizeof(test_output), 0, LZ77_MAX_MATCH);
+            if(test_len == 0) return 1.0f;
+            break;
+        case COMPRESS_HUFFMAN:
+            // Exact size from the code lengths, no bitstream needed
+            huffman_init(&huffman_state);
+            huffman_build_tree(&huffman_state, data, len > 256 ? 256 : len);
+            huffman_save_tree(&huffman_state, test_output, &test_len);
+            test_len += (huffman_bit_cost(&huffman_state) + 7) / 8;
+            break;
         default:
             return 1.0f;
     }
@@ -715,60 +1316,255 @@ float compression_estimate_ratio(const uint8_t* data, uint32_t len,
     return (float)(len > 256 ? 256 : len) / (float)test_len;
 }
 
-// Compress block with CRC
+// ============================================================================
+// BLOCK CONTAINER
+// ============================================================================
+//
+// Header: magic, algorithm, original size (LE16), payload size (LE16),
+// CRC-32 of the original data (LE32). Blocks that do not shrink are stored
+// with COMPRESS_NONE, so a payload never exceeds COMPRESSION_MAX_BLOCK_SIZE.
+
+// Streaming state - input is buffered into one block
+typedef struct {
+    CompressionAlgorithm_t algorithm;
+    uint8_t block[COMPRESSION_MAX_BLOCK_SIZE];
+    uint16_t fill;
+    uint32_t blocks;
+} CompressionStream_t;
+
+static CompressionStream_t compression_stream;
+
+static inline uint32_t block_crc32(const uint8_t* data, uint32_t len) {
+    return crc_compute(crc_get_engine(CRC_ENGINE_32_REF), 0xFFFFFFFFUL, 0xFFFFFFFFUL, data, len);
+}
+
+static bool compress_block_with(CompressionAlgorithm_t algorithm,
+                                const uint8_t* input, uint32_t input_len,
+                                uint8_t* output, uint32_t* output_len, uint32_t* crc32) {
+    if(!input || !output || !output_len || input_len > COMPRESSION_MAX_BLOCK_SIZE) return false;
+
+    if(algorithm == COMPRESS_ADAPTIVE) {
+        algorithm = compression_select_algorithm(input, input_len);
+    }
+
+    const uint8_t* payload = block_scratch;
+    uint32_t payload_len = 0;
+    if(algorithm != COMPRESS_NONE &&
+       !compress_data(input, input_len, block_scratch, &payload_len, algorithm, NULL)) {
+        payload_len = 0;
+    }
+
+    // Delta and RLE stop near COMPRESSION_MAX_BLOCK_SIZE, so output that
+    // close to the input size may be truncated: store those blocks raw
+    if(algorithm == COMPRESS_NONE || payload_len == 0 || payload_len + 4 > input_len) {
+        algorithm = COMPRESS_NONE;
+        payload = input;
+        payload_len = input_len;
+    }
+
+    uint32_t crc = block_crc32(input, input_len);
+
+    output[0] = COMPRESSION_BLOCK_MAGIC;
+    output[1] = (uint8_t)algorithm;
+    output[2] = (uint8_t)(input_len & 0xFF);
+    output[3] = (uint8_t)(input_len >> 8);
+    output[4] = (uint8_t)(payload_len & 0xFF);
+    output[5] = (uint8_t)(payload_len >> 8);
+    for(uint8_t i = 0; i < 4; i++) {
+        output[6 + i] = (uint8_t)(crc >> (8 * i));
+    }
+    memmove(&output[COMPRESSION_BLOCK_HEADER_SIZE], payload, payload_len);
+
+    *output_len = COMPRESSION_BLOCK_HEADER_SIZE + payload_len;
+    if(crc32) *crc32 = crc;
+    return true;
+}
+
+// Decode a payload into output (COMPRESSION_MAX_BLOCK_SIZE bytes)
+static bool decode_payload(uint8_t algorithm, const uint8_t* payload, uint32_t payload_len,
+                           uint8_t* output, uint32_t* decoded_len) {
+    switch(algorithm) {
+        case COMPRESS_NONE:
+            memcpy(output, payload, payload_len);
+            *decoded_len = payload_len;
+            return true;
+
+        case COMPRESS_DELTA:
+            *decoded_len = delta_decode(payload, payload_len, output);
+            return true;
+
+        case COMPRESS_RLE:
+            *decoded_len = rle_decode(payload, payload_len, output);
+            return true;
+
+        case COMPRESS_HUFFMAN:
+            if(!huffman_load_tree(&huffman_state, payload, payload_len)) return false;
+            if(huffman_state.symbol_count > COMPRESSION_MAX_BLOCK_SIZE) return false;
+            *decoded_len = huffman_decode(&huffman_state, &payload[huffman_state.table_bytes],
+                                          payload_len - huffman_state.table_bytes, output);
+            return true;
+
+        case COMPRESS_LZ77:
+            *decoded_len = lz77_decode(payload, payload_len, output);
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// Parse and sanity-check a block header
+bool compression_parse_block_header(const uint8_t* input, uint32_t len,
+                                    CompressionBlockHeader_t* header) {
+    if(!input || len < COMPRESSION_BLOCK_HEADER_SIZE || input[0] != COMPRESSION_BLOCK_MAGIC) {
+        return false;
+    }
+
+    header->algorithm = input[1];
+    header->original_size = input[2] | ((uint16_t)input[3] << 8);
+    header->compressed_size = input[4] | ((uint16_t)input[5] << 8);
+    header->crc32 = 0;
+    for(uint8_t i = 0; i < 4; i++) {
+        header->crc32 |= (uint32_t)input[6 + i] << (8 * i);
+    }
+
+    return header->algorithm <= COMPRESS_LZ77 &&
+           header->original_size <= COMPRESSION_MAX_BLOCK_SIZE &&
+           header->compressed_size <= COMPRESSION_MAX_BLOCK_SIZE;
+}
+
+// Compress one block with adaptive algorithm choice (crc32 may be NULL)
 bool compression_compress_block(const uint8_t* input, uint32_t input_len,
                                  uint8_t* output, uint32_t* output_len,
                                  uint32_t* crc32) {
-    // Would compress and calculate CRC
-    // For now, just copy
-    memcpy(output, input, input_len);
-    *output_len = input_len;
-    *crc32 = 0;  // Would calculate
-    return true;
+    return compress_block_with(COMPRESS_ADAPTIVE, input, input_len, output, output_len, crc32);
 }
 
-// Decompress block with CRC verification
+// Decompress one block and verify its CRC (expected_crc32 = 0 trusts the header)
 bool compression_decompress_block(const uint8_t* input, uint32_t input_len,
                                    uint8_t* output, uint32_t* output_len,
                                    uint32_t expected_crc32) {
-    // Would decompress and verify CRC
-    UNUSED(expected_crc32);
-    memcpy(output, input, input_len);
-    *output_len = input_len;
+    CompressionBlockHeader_t header;
+    if(!output || !output_len) return false;
+    if(!compression_parse_block_header(input, input_len, &header)) return false;
+    if(input_len < COMPRESSION_BLOCK_HEADER_SIZE + (uint32_t)header.compressed_size) return false;
+    if(expected_crc32 != 0 && header.crc32 != expected_crc32) return false;
+
+    uint32_t decoded_len = 0;
+    if(!decode_payload(header.algorithm, &input[COMPRESSION_BLOCK_HEADER_SIZE],
+                       header.compressed_size, output, &decoded_len) ||
+       decoded_len != header.original_size) {
+        FURI_LOG_W(TAG, "Block decode failed (algorithm %u)", header.algorithm);
+        return false;
+    }
+
+    if(block_crc32(output, decoded_len) != header.crc32) {
+        FURI_LOG_W(TAG, "Block CRC mismatch");
+        return false;
+    }
+
+    *output_len = decoded_len;
     return true;
 }
 
-// Streaming compression (placeholder)
+// Start a block stream (COMPRESS_ADAPTIVE chooses per block)
 void compression_stream_init(CompressionAlgorithm_t algorithm) {
-    UNUSED(algorithm);
+    compression_stream.algorithm = algorithm;
+    compression_stream.fill = 0;
+    compression_stream.blocks = 0;
 }
 
+// Buffer input and emit every completed block into output
 bool compression_stream_process(const uint8_t* input, uint32_t len,
                                  uint8_t* output, uint32_t* output_len) {
-    UNUSED(input);
-    UNUSED(len);
-    UNUSED(output);
-    UNUSED(output_len);
+    if(!output_len || (!input && len > 0)) return false;
+    *output_len = 0;
+
+    while(len > 0) {
+        uint32_t take = COMPRESSION_MAX_BLOCK_SIZE - compression_stream.fill;
+        if(take > len) take = len;
+
+        memcpy(&compression_stream.block[compression_stream.fill], input, take);
+        compression_stream.fill += take;
+        input += take;
+        len -= take;
+
+        if(compression_stream.fill == COMPRESSION_MAX_BLOCK_SIZE) {
+            uint32_t block_len = 0;
+            if(!compress_block_with(compression_stream.algorithm, compression_stream.block,
+                                    compression_stream.fill, &output[*output_len], &block_len,
+                                    NULL)) {
+                return false;
+            }
+            *output_len += block_len;
+            compression_stream.fill = 0;
+            compression_stream.blocks++;
+        }
+    }
+
     return true;
 }
 
+// Emit the partial last block, if any
 void compression_stream_finalize(uint8_t* output, uint32_t* output_len) {
-    UNUSED(output);
-    UNUSED(output_len);
+    *output_len = 0;
+    if(compression_stream.fill == 0) return;
+
+    if(compress_block_with(compression_stream.algorithm, compression_stream.block,
+                           compression_stream.fill, output, output_len, NULL)) {
+        compression_stream.blocks++;
+    }
+    compression_stream.fill = 0;
 }
 
-// Save/load Huffman tree
+// Save Huffman table: symbol count, last used symbol, then 4-bit code
+// lengths for symbols 0..last
 void huffman_save_tree(const HuffmanState_t* state, uint8_t* buffer, uint32_t* len) {
-    // Would serialize tree structure
-    UNUSED(state);
-    UNUSED(buffer);
     *len = 0;
+    if(state->num_symbols == 0 || state->symbol_count > 0xFFFF) return;
+
+    uint16_t last = COMPRESSION_MAX_SYMBOLS - 1;
+    while(last > 0 && state->code_lengths[last] == 0) last--;
+
+    uint32_t pos = 0;
+    buffer[pos++] = (uint8_t)(state->symbol_count >> 8);
+    buffer[pos++] = (uint8_t)(state->symbol_count & 0xFF);
+    buffer[pos++] = (uint8_t)last;
+
+    for(uint16_t s = 0; s <= last; s += 2) {
+        uint8_t low = (s + 1 <= last) ? state->code_lengths[s + 1] : 0;
+        buffer[pos++] = (uint8_t)((state->code_lengths[s] << 4) | low);
+    }
+
+    *len = pos;
 }
 
+// Load Huffman table and rebuild the canonical codes
 bool huffman_load_tree(HuffmanState_t* state, const uint8_t* buffer, uint32_t len) {
-    // Would deserialize tree structure
-    UNUSED(buffer);
-    UNUSED(len);
-    memset(state, 0, sizeof(HuffmanState_t));
+    huffman_init(state);
+    if(len < HUFFMAN_TABLE_HEADER_BYTES) return false;
+
+    uint16_t last = buffer[2];
+    uint32_t table_bytes = HUFFMAN_TABLE_HEADER_BYTES + (last + 2) / 2;
+    if(len < table_bytes) return false;
+
+    state->symbol_count = ((uint32_t)buffer[0] << 8) | buffer[1];
+
+    uint32_t kraft = 0;
+    for(uint16_t s = 0; s <= last; s++) {
+        uint8_t packed = buffer[HUFFMAN_TABLE_HEADER_BYTES + s / 2];
+        uint8_t l = (s & 1) ? (packed & 0x0F) : (packed >> 4);
+        state->code_lengths[s] = l;
+        if(l > 0) {
+            state->num_symbols++;
+            kraft += 1UL << (HUFFMAN_MAX_CODE_LENGTH - l);
+        }
+    }
+
+    // Reject empty and over-subscribed tables
+    if(state->num_symbols == 0 || kraft > (1UL << HUFFMAN_MAX_CODE_LENGTH)) return false;
+
+    state->table_bytes = (uint16_t)table_bytes;
+    huffman_generate_codes(state);
     return true;
 }
@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "../core/flipper_rf_lab.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -10,14 +11,25 @@ extern "C" {
 
 // ============================================================================
 // SIGNAL COMPRESSION ENGINE
-// Delta encoding, RLE, and Huffman coding
+// Delta encoding, RLE, and canonical Huffman coding
 // ============================================================================
 
 #define COMPRESSION_MAX_BLOCK_SIZE  1024
 #define COMPRESSION_MAX_SYMBOLS     256
-#define HUFFMAN_MAX_CODES           512
+#define HUFFMAN_MAX_CODE_LENGTH     15              // Length limit, code lengths fit a nibble
+#define HUFFMAN_LOOKUP_BITS         9               // Primary decode table index width
+#define HUFFMAN_TABLE_HEADER_BYTES  3               // Symbol count (BE16) + last symbol
+#define HUFFMAN_TABLE_MAX_BYTES     (HUFFMAN_TABLE_HEADER_BYTES + COMPRESSION_MAX_SYMBOLS / 2)
 #define RLE_MAX_RUN_LENGTH          255
 
+// LZ77 match finder (hash heads + chain table are statically allocated)
+#define LZ77_WINDOW_SIZE            2048            // Power of two, max match distance + 1
+#define LZ77_HASH_BITS              10
+#define LZ77_MIN_MATCH              4
+#define LZ77_MAX_MATCH              0xFFFF
+#define LZ77_CHAIN_DEPTH            16              // Candidates checked per position
+#define LZ77_LAZY_LENGTH            32              // Matches this long skip lazy evaluation
+
 // Compression algorithms
 typedef enum {
     COMPRESS_NONE = 0,
@@ -28,6 +40,18 @@ typedef enum {
     COMPRESS_ADAPTIVE    // Auto-select best algorithm
 } CompressionAlgorithm_t;
 
+// Pulse codec: widths quantized to timing clusters plus Rice-coded
+// residuals, levels implicit by alternation
+#define PULSE_CODEC_MAGIC               0x51            // 0x50 streams had 16-bit escapes
+#define PULSE_CODEC_MAX_CLUSTERS        7               // Plus the escape symbol: 3-bit symbols
+#define PULSE_CODEC_TOLERANCE_SHIFT     3               // Widths within center/8 ...
+#define PULSE_CODEC_MIN_TOLERANCE_US    8               // ... plus 8 us join a cluster
+
+// Block container: header followed by the payload
+#define COMPRESSION_BLOCK_MAGIC         0xB7
+#define COMPRESSION_BLOCK_HEADER_SIZE   10
+#define COMPRESSION_BLOCK_MAX_OUTPUT    (COMPRESSION_BLOCK_HEADER_SIZE + COMPRESSION_MAX_BLOCK_SIZE)
+
 // Compression statistics
 typedef struct {
     uint32_t original_size;
@@ -38,25 +62,31 @@ typedef struct {
     uint32_t decode_time_us;
 } CompressionStats_t;
 
-// Huffman tree node
+// Parsed block header
 typedef struct {
-    uint16_t symbol;
-    uint32_t frequency;
-    uint16_t left;
-    uint16_t right;
-    uint16_t parent;
-    uint8_t depth;
-    uint32_t code;
-    uint8_t code_length;
-} HuffmanNode_t;
-
-// Huffman coding state
+    uint8_t algorithm;              // CompressionAlgorithm_t of the payload
+    uint16_t original_size;
+    uint16_t compressed_size;       // Payload bytes after the header
+    uint32_t crc32;                 // CRC-32 of the original data
+} CompressionBlockHeader_t;
+
+// Canonical Huffman coding state. Only code lengths are serialized
+// (two per byte); codes are reassigned canonically on load. Codes up to
+// HUFFMAN_LOOKUP_BITS decode with one table lookup, longer ones by comparing
+// against the first canonical code of each length.
 typedef struct {
-    HuffmanNode_t nodes[HUFFMAN_MAX_CODES];
-    uint16_t num_nodes;
-    uint16_t root;
-    uint16_t symbol_to_node[COMPRESSION_MAX_SYMBOLS];
     uint32_t frequencies[COMPRESSION_MAX_SYMBOLS];
+    uint16_t codes[COMPRESSION_MAX_SYMBOLS];            // MSB-first canonical codes
+    uint8_t code_lengths[COMPRESSION_MAX_SYMBOLS];      // 0 = symbol absent
+    uint16_t lookup[1 << HUFFMAN_LOOKUP_BITS];          // (symbol << 4) | length, 0 = longer code
+    uint16_t first_code[HUFFMAN_MAX_CODE_LENGTH + 1];   // First canonical code per length
+    uint16_t length_count[HUFFMAN_MAX_CODE_LENGTH + 1]; // Codes per length
+    uint16_t length_offset[HUFFMAN_MAX_CODE_LENGTH + 1];// First sorted_symbols index per length
+    uint8_t sorted_symbols[COMPRESSION_MAX_SYMBOLS];    // Symbols in canonical order
+    uint32_t symbol_count;                              // Symbols in the encoded message
+    uint16_t num_symbols;                               // Distinct symbols
+    uint16_t table_bytes;                               // Serialized size (set by huffman_load_tree)
+    uint8_t max_length;
     bool initialized;
 } HuffmanState_t;
 
@@ -102,7 +132,8 @@ uint32_t rle_encode(const uint8_t* input, uint32_t len, uint8_t* output);
 uint32_t rle_decode(const uint8_t* input, uint32_t len, uint8_t* output);
 uint32_t rle_encode_adaptive(const uint8_t* input, uint32_t len, uint8_t* output);
 
-// Huffman coding
+// Huffman coding (encode returns 0 if the output would exceed
+// COMPRESSION_MAX_BLOCK_SIZE; decode produces state->symbol_count symbols)
 void huffman_init(HuffmanState_t* state);
 void huffman_build_tree(HuffmanState_t* state, const uint8_t* data, uint32_t len);
 void huffman_generate_codes(HuffmanState_t* state);
@@ -113,16 +144,22 @@ uint32_t huffman_decode(const HuffmanState_t* state, const uint8_t* input,
 void huffman_save_tree(const HuffmanState_t* state, uint8_t* buffer, uint32_t* len);
 bool huffman_load_tree(HuffmanState_t* state, const uint8_t* buffer, uint32_t len);
 
-// LZ77 sliding window compression
+// LZ77 sliding window compression. Input and output are bounded by
+// COMPRESSION_MAX_BLOCK_SIZE; encode returns 0 if either does not fit,
+// decode returns 0 for a malformed stream.
 uint32_t lz77_encode(const uint8_t* input, uint32_t len, uint8_t* output,
-                     uint16_t window_size, uint16_t lookahead_size);
+                     uint16_t window_size, uint16_t max_match);
 uint32_t lz77_decode(const uint8_t* input, uint32_t len, uint8_t* output);
 
-// Pulse sequence compression (specialized for RF data)
+// Pulse sequence compression (specialized for RF data, no heap use)
 uint32_t compress_pulse_sequence(const Pulse_t* pulses, uint16_t count, 
                                   uint8_t* output, uint32_t max_output);
 uint32_t decompress_pulse_sequence(const uint8_t* input, uint32_t len,
                                     Pulse_t* pulses, uint16_t max_pulses);
+uint32_t compress_pulse_store(const PulseBuffer_t* store, uint16_t start, uint16_t count,
+                              const uint16_t* centers, uint8_t center_count,
+                              uint8_t residual_shift, uint8_t* output, uint32_t max_output);
+uint16_t decompress_pulse_store(const uint8_t* input, uint32_t len, PulseBuffer_t* store);
 
 // Frame deduplication
 uint32_t find_duplicate_frames(const Frame_t* frames, uint16_t count,
@@ -130,7 +167,9 @@ uint32_t find_duplicate_frames(const Frame_t* frames, uint16_t count,
 uint32_t compress_frame_sequence(const Frame_t* frames, uint16_t count,
                                   uint8_t* output, uint32_t max_output);
 
-// Streaming compression
+// Streaming compression: input is buffered into COMPRESSION_MAX_BLOCK_SIZE
+// blocks; process emits each completed block and finalize the partial last
+// one. output needs COMPRESSION_BLOCK_MAX_OUTPUT bytes per emitted block.
 void compression_stream_init(CompressionAlgorithm_t algorithm);
 bool compression_stream_process(const uint8_t* input, uint32_t len,
                                  uint8_t* output, uint32_t* output_len);
@@ -142,7 +181,10 @@ CompressionAlgorithm_t compression_select_algorithm(const uint8_t* sample_data,
 float compression_estimate_ratio(const uint8_t* data, uint32_t len,
                                   CompressionAlgorithm_t algorithm);
 
-// Block-based compression for SD storage
+// Block-based compression for SD storage (one block of at most
+// COMPRESSION_MAX_BLOCK_SIZE bytes; decompress output must hold that much)
+bool compression_parse_block_header(const uint8_t* input, uint32_t len,
+                                    CompressionBlockHeader_t* header);
 bool compression_compress_block(const uint8_t* input, uint32_t input_len,
                                  uint8_t* output, uint32_t* output_len,
                                  uint32_t* crc32);
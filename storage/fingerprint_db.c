@@ -0,0 +1,374 @@
+#include "fingerprint_db.h"
+#include <string.h>
+#include <stddef.h>
+
+#define TAG "FP_DB"
+
+// Static state
+static FileHandle_t* journal_file = NULL;
+static uint32_t db_generation = 0;
+static uint32_t journal_sequence = 0;
+static bool journal_unsynced = false;
+static bool journal_damaged = false;        // Torn tail or stale entries, compact before appending
+static FingerprintDbStats_t db_stats;
+
+// SD transfer chunk (thread stacks are too small for record batches)
+static union {
+    FingerprintDbRecord_t records[FINGERPRINT_DB_IO_RECORDS];
+    FingerprintDbTemporal_t temporal[FINGERPRINT_DB_IO_RECORDS];
+    FingerprintJournalEntry_t journal[FINGERPRINT_DB_IO_RECORDS];
+} io_chunk;
+
+// ============================================================================
+// RECORD HELPERS
+// ============================================================================
+
+static inline uint16_t chunk_len(uint16_t done, uint16_t total) {
+    uint16_t left = total - done;
+    return (left < FINGERPRINT_DB_IO_RECORDS) ? left : FINGERPRINT_DB_IO_RECORDS;
+}
+
+static void pack_record(const DeviceDatabase_t* db, uint16_t i, FingerprintDbRecord_t* record) {
+    memset(record, 0, sizeof(FingerprintDbRecord_t));
+    memcpy(&record->fingerprint, &db->fingerprints[i], sizeof(RFFingerprint_t));
+    memcpy(record->name, db->device_names[i], sizeof(record->name));
+    record->last_seen = db->last_seen[i];
+    record->match_count = db->match_count[i];
+}
+
+static void unpack_record(DeviceDatabase_t* db, uint16_t i, const FingerprintDbRecord_t* record) {
+    memcpy(&db->fingerprints[i], &record->fingerprint, sizeof(RFFingerprint_t));
+    memcpy(db->device_names[i], record->name, sizeof(record->name));
+    db->device_names[i][sizeof(record->name) - 1] = '\0';
+    db->last_seen[i] = record->last_seen;
+    db->match_count[i] = record->match_count;
+}
+
+static inline uint32_t header_crc(const FingerprintDbHeader_t* header) {
+    return sd_manager_crc32(0, header, offsetof(FingerprintDbHeader_t, header_crc));
+}
+
+static inline uint32_t entry_crc(const FingerprintJournalEntry_t* entry) {
+    return sd_manager_crc32(0, entry, offsetof(FingerprintJournalEntry_t, crc));
+}
+
+static bool header_valid(const FingerprintDbHeader_t* header) {
+    return header->magic == FINGERPRINT_DB_MAGIC &&
+           header->version == FINGERPRINT_DB_VERSION &&
+           header->record_size == sizeof(FingerprintDbRecord_t) &&
+           header->temporal_size == sizeof(FingerprintDbTemporal_t) &&
+           header->device_count <= MAX_DEVICE_DB_ENTRIES &&
+           header->temporal_count <= MAX_DEVICE_DB_ENTRIES &&
+           header->header_crc == header_crc(header);
+}
+
+// ============================================================================
+// LOAD
+// ============================================================================
+
+// Sequential snapshot read: header, device records, temporal records.
+// Returns false with the database empty if path is missing or damaged.
+static bool load_snapshot_file(const char* path, DeviceDatabase_t* db,
+                               FingerprintDbTemporalLoadFn load_temporal, void* ctx) {
+    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_FINGERPRINT, false);
+    if(!file) return false;
+    
+    FingerprintDbHeader_t header;
+    bool ok = sd_manager_read(file, (uint8_t*)&header, sizeof(header)) && header_valid(&header);
+    uint32_t crc = 0;
+    
+    for(uint16_t i = 0; ok && i < header.device_count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, header.device_count);
+        uint32_t bytes = n * sizeof(FingerprintDbRecord_t);
+        ok = sd_manager_read(file, (uint8_t*)io_chunk.records, bytes);
+        if(!ok) break;
+        
+        crc = sd_manager_crc32(crc, io_chunk.records, bytes);
+        for(uint16_t j = 0; j < n; j++) {
+            unpack_record(db, i + j, &io_chunk.records[j]);
+        }
+        db->count = i + n;
+    }
+    
+    for(uint16_t i = 0; ok && i < header.temporal_count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, header.temporal_count);
+        uint32_t bytes = n * sizeof(FingerprintDbTemporal_t);
+        ok = sd_manager_read(file, (uint8_t*)io_chunk.temporal, bytes);
+        if(!ok) break;
+        
+        crc = sd_manager_crc32(crc, io_chunk.temporal, bytes);
+        for(uint16_t j = 0; load_temporal && j < n; j++) {
+            load_temporal(&io_chunk.temporal[j], ctx);
+        }
+    }
+    
+    sd_manager_close_file(file);
+    
+    if(ok && crc != header.payload_crc) ok = false;
+    if(!ok) {
+        FURI_LOG_E(TAG, "Snapshot %s damaged", path);
+        db->count = 0;
+        if(load_temporal) load_temporal(NULL, ctx);
+        db_stats.load_errors++;
+        return false;
+    }
+    
+    db_generation = header.generation;
+    return true;
+}
+
+// Load devices.db. If it is missing (compaction interrupted between its
+// renames) or fails its CRC, the temporary file (newest) or the backup may
+// still hold a snapshot; the first valid one is promoted back to devices.db.
+// The other fallback serves as the scratch name for the replace, so the
+// source of the promotion is never deleted.
+static bool load_snapshot(DeviceDatabase_t* db, FingerprintDbTemporalLoadFn load_temporal,
+                          void* ctx) {
+    if(load_snapshot_file(FINGERPRINT_DB_PATH, db, load_temporal, ctx)) return true;
+    
+    static const char* const fallbacks[] = {FINGERPRINT_DB_TMP_PATH, FINGERPRINT_DB_BAK_PATH};
+    for(uint8_t i = 0; i < 2; i++) {
+        if(!load_snapshot_file(fallbacks[i], db, load_temporal, ctx)) continue;
+        
+        FURI_LOG_W(TAG, "Recovered snapshot from %s", fallbacks[i]);
+        sd_manager_replace_file(fallbacks[i], FINGERPRINT_DB_PATH, fallbacks[1 - i]);
+        return true;
+    }
+    
+    return false;
+}
+
+// Apply one journal entry to the in-memory database
+static void apply_entry(DeviceDatabase_t* db, const FingerprintJournalEntry_t* entry) {
+    uint16_t id = entry->device_id;
+    
+    switch(entry->op) {
+        case FP_JOURNAL_ADD:
+        case FP_JOURNAL_UPDATE:
+            if(id < db->count) {
+                unpack_record(db, id, &entry->record);
+            } else if(id == db->count && db->count < MAX_DEVICE_DB_ENTRIES) {
+                unpack_record(db, id, &entry->record);
+                db->count++;
+            }
+            break;
+        
+        case FP_JOURNAL_REMOVE:
+            if(id >= db->count) break;
+            for(uint16_t i = id; i + 1 < db->count; i++) {
+                db->fingerprints[i] = db->fingerprints[i + 1];
+                memcpy(db->device_names[i], db->device_names[i + 1], 16);
+                db->last_seen[i] = db->last_seen[i + 1];
+                db->match_count[i] = db->match_count[i + 1];
+            }
+            db->count--;
+            break;
+        
+        default:
+            break;
+    }
+}
+
+// Replay journal entries of the current generation, stopping at a torn tail
+static void replay_journal(DeviceDatabase_t* db) {
+    FileHandle_t* file = sd_manager_open_file(FINGERPRINT_JOURNAL_PATH, FILE_TYPE_FINGERPRINT, false);
+    if(!file) return;
+    
+    bool done = false;
+    while(!done) {
+        uint32_t bytes = sd_manager_read_upto(file, (uint8_t*)io_chunk.journal, sizeof(io_chunk.journal));
+        uint16_t n = bytes / sizeof(FingerprintJournalEntry_t);
+        
+        if(bytes < sizeof(io_chunk.journal)) {
+            done = true;
+            if(bytes % sizeof(FingerprintJournalEntry_t)) journal_damaged = true;
+        }
+        
+        for(uint16_t j = 0; j < n; j++) {
+            const FingerprintJournalEntry_t* entry = &io_chunk.journal[j];
+            if(entry->crc != entry_crc(entry)) {
+                journal_damaged = true;
+                done = true;
+                break;
+            }
+            
+            db_stats.journal_entries++;
+            if(entry->generation != db_generation) {
+                // Left over from a compaction interrupted before the journal was reset
+                journal_damaged = true;
+                continue;
+            }
+            
+            apply_entry(db, entry);
+            db_stats.journal_replayed++;
+            journal_sequence = entry->sequence + 1;
+        }
+    }
+    
+    sd_manager_close_file(file);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Load snapshot, replay journal and keep the journal open for appends
+FuriStatus fingerprint_db_open(DeviceDatabase_t* db, FingerprintDbTemporalLoadFn load_temporal,
+                               void* ctx) {
+    fingerprint_db_close();
+    
+    memset(&db_stats, 0, sizeof(db_stats));
+    db_generation = 0;
+    journal_sequence = 0;
+    journal_unsynced = false;
+    journal_damaged = false;
+    
+    if(!sd_manager_is_card_present()) {
+        FURI_LOG_W(TAG, "No SD card, database is not persistent");
+        return FuriStatusError;
+    }
+    
+    load_snapshot(db, load_temporal, ctx);
+    replay_journal(db);
+    
+    journal_file = sd_manager_open_append(FINGERPRINT_JOURNAL_PATH, FILE_TYPE_FINGERPRINT);
+    db_stats.generation = db_generation;
+    
+    FURI_LOG_I(TAG, "Loaded %d devices (generation %lu, %d journal entries)",
+               db->count, db_generation, db_stats.journal_replayed);
+    
+    return journal_file ? FuriStatusOk : FuriStatusError;
+}
+
+void fingerprint_db_close(void) {
+    if(!journal_file) return;
+    
+    sd_manager_close_file(journal_file);
+    journal_file = NULL;
+    journal_unsynced = false;
+}
+
+// Append one change. Refused while the journal has a damaged tail, since
+// replay would stop before anything appended after it.
+bool fingerprint_db_journal(FingerprintJournalOp_t op, const DeviceDatabase_t* db,
+                            uint16_t device_id) {
+    if(!journal_file || journal_damaged) return false;
+    
+    FingerprintJournalEntry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.generation = db_generation;
+    entry.sequence = journal_sequence;
+    entry.op = op;
+    entry.device_id = device_id;
+    if(op != FP_JOURNAL_REMOVE && device_id < db->count) {
+        pack_record(db, device_id, &entry.record);
+    }
+    entry.crc = entry_crc(&entry);
+    
+    if(!sd_manager_write(journal_file, (const uint8_t*)&entry, sizeof(entry))) {
+        FURI_LOG_E(TAG, "Journal append failed");
+        journal_damaged = true;
+        return false;
+    }
+    
+    journal_sequence++;
+    journal_unsynced = true;
+    db_stats.journal_entries++;
+    db_stats.journal_appends++;
+    
+    return true;
+}
+
+// Flush appended entries to the card
+void fingerprint_db_sync(void) {
+    if(!journal_file || !journal_unsynced) return;
+    
+    sd_manager_sync(journal_file);
+    journal_unsynced = false;
+}
+
+bool fingerprint_db_needs_compaction(void) {
+    return journal_damaged || db_stats.journal_entries >= FINGERPRINT_DB_COMPACT_ENTRIES;
+}
+
+// Write a new snapshot and start an empty journal. The snapshot goes to a
+// temporary file first and the previous one is kept as a backup until the
+// swap completes, so a failure at any point leaves a loadable snapshot.
+bool fingerprint_db_compact(const DeviceDatabase_t* db, uint16_t temporal_count,
+                            FingerprintDbTemporalSaveFn save_temporal, void* ctx) {
+    if(!save_temporal) temporal_count = 0;
+    if(temporal_count > MAX_DEVICE_DB_ENTRIES) temporal_count = MAX_DEVICE_DB_ENTRIES;
+    
+    FingerprintDbHeader_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = FINGERPRINT_DB_MAGIC;
+    header.version = FINGERPRINT_DB_VERSION;
+    header.record_size = sizeof(FingerprintDbRecord_t);
+    header.temporal_size = sizeof(FingerprintDbTemporal_t);
+    header.device_count = db->count;
+    header.temporal_count = temporal_count;
+    header.generation = db_generation + 1;
+    
+    // CRC pass: records are packed twice instead of buffering the payload
+    uint32_t crc = 0;
+    for(uint16_t i = 0; i < db->count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, db->count);
+        for(uint16_t j = 0; j < n; j++) pack_record(db, i + j, &io_chunk.records[j]);
+        crc = sd_manager_crc32(crc, io_chunk.records, n * sizeof(FingerprintDbRecord_t));
+    }
+    for(uint16_t i = 0; i < temporal_count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, temporal_count);
+        memset(io_chunk.temporal, 0, n * sizeof(FingerprintDbTemporal_t));
+        for(uint16_t j = 0; j < n; j++) save_temporal(i + j, &io_chunk.temporal[j], ctx);
+        crc = sd_manager_crc32(crc, io_chunk.temporal, n * sizeof(FingerprintDbTemporal_t));
+    }
+    header.payload_crc = crc;
+    header.header_crc = header_crc(&header);
+    
+    FileHandle_t* file = sd_manager_open_file(FINGERPRINT_DB_TMP_PATH, FILE_TYPE_FINGERPRINT, true);
+    if(!file) return false;
+    
+    bool ok = sd_manager_write(file, (const uint8_t*)&header, sizeof(header));
+    for(uint16_t i = 0; ok && i < db->count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, db->count);
+        for(uint16_t j = 0; j < n; j++) pack_record(db, i + j, &io_chunk.records[j]);
+        ok = sd_manager_write(file, (const uint8_t*)io_chunk.records,
+                              n * sizeof(FingerprintDbRecord_t));
+    }
+    for(uint16_t i = 0; ok && i < temporal_count; i += FINGERPRINT_DB_IO_RECORDS) {
+        uint16_t n = chunk_len(i, temporal_count);
+        memset(io_chunk.temporal, 0, n * sizeof(FingerprintDbTemporal_t));
+        for(uint16_t j = 0; j < n; j++) save_temporal(i + j, &io_chunk.temporal[j], ctx);
+        ok = sd_manager_write(file, (const uint8_t*)io_chunk.temporal,
+                              n * sizeof(FingerprintDbTemporal_t));
+    }
+    
+    sd_manager_close_file(file);
+    
+    if(!ok || !sd_manager_replace_file(FINGERPRINT_DB_TMP_PATH, FINGERPRINT_DB_PATH,
+                                       FINGERPRINT_DB_BAK_PATH)) {
+        FURI_LOG_E(TAG, "Compaction failed, keeping previous snapshot");
+        return false;
+    }
+    
+    // Entries of the old generation are now ignored, so a crash before the
+    // journal is reset below is harmless
+    db_generation = header.generation;
+    fingerprint_db_close();
+    journal_file = sd_manager_open_file(FINGERPRINT_JOURNAL_PATH, FILE_TYPE_FINGERPRINT, true);
+    journal_sequence = 0;
+    journal_damaged = false;
+    
+    db_stats.generation = db_generation;
+    db_stats.journal_entries = 0;
+    db_stats.compactions++;
+    
+    FURI_LOG_I(TAG, "Compacted %d devices, %d temporal records (generation %lu)",
+               db->count, temporal_count, db_generation);
+    
+    return true;
+}
+
+FingerprintDbStats_t fingerprint_db_get_stats(void) {
+    return db_stats;
+}
@@ -0,0 +1,116 @@
+#ifndef FINGERPRINT_DB_H
+#define FINGERPRINT_DB_H
+
+#include <furi.h>
+#include "../core/flipper_rf_lab.h"
+#include "sd_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PERSISTENT FINGERPRINT DATABASE
+// Snapshot file: header, fixed-size device records, then temporal records,
+// loaded in one sequential pass. Changes between snapshots are appended to a
+// journal of fixed-size entries; compaction folds the journal into a fresh
+// snapshot so updates never rewrite the whole file.
+// ============================================================================
+
+#define FINGERPRINT_DB_PATH             FINGERPRINTS_PATH "/devices.db"
+#define FINGERPRINT_DB_TMP_PATH         FINGERPRINTS_PATH "/devices.tmp"
+#define FINGERPRINT_DB_BAK_PATH         FINGERPRINTS_PATH "/devices.bak"
+#define FINGERPRINT_JOURNAL_PATH        FINGERPRINTS_PATH "/devices.jnl"
+#define FINGERPRINT_DB_MAGIC            0x42445046      // "FPDB"
+#define FINGERPRINT_DB_VERSION          1
+#define FINGERPRINT_DB_COMPACT_ENTRIES  64              // Journal entries before compaction
+#define FINGERPRINT_DB_IO_RECORDS       8               // Records per SD read/write
+
+typedef enum {
+    FP_JOURNAL_ADD = 1,             // New device appended at device_id
+    FP_JOURNAL_UPDATE,              // match_count / last_seen changed
+    FP_JOURNAL_REMOVE               // Device removed, later slots shift down
+} FingerprintJournalOp_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;           // sizeof(FingerprintDbRecord_t)
+    uint16_t temporal_size;         // sizeof(FingerprintDbTemporal_t)
+    uint16_t device_count;
+    uint16_t temporal_count;
+    uint16_t reserved;
+    uint32_t generation;            // Journal entries must carry the same generation
+    uint32_t payload_crc;           // CRC32 of all records after the header
+    uint32_t header_crc;            // CRC32 of the header up to this field
+} FingerprintDbHeader_t;
+
+typedef struct {
+    RFFingerprint_t fingerprint;
+    char name[16];
+    uint32_t last_seen;
+    uint16_t match_count;
+    uint16_t reserved;
+} FingerprintDbRecord_t;
+
+typedef struct {
+    RFFingerprint_t baseline;
+    uint32_t first_seen;
+    uint32_t last_seen;
+    uint32_t match_count;
+    uint16_t device_id;
+    uint8_t drift_magnitude;
+    uint8_t drift_detected;
+} FingerprintDbTemporal_t;
+
+typedef struct {
+    uint32_t generation;
+    uint32_t sequence;
+    uint8_t op;                     // FingerprintJournalOp_t
+    uint8_t reserved;
+    uint16_t device_id;
+    FingerprintDbRecord_t record;
+    uint32_t crc;                   // CRC32 of the entry up to this field
+} FingerprintJournalEntry_t;
+
+typedef struct {
+    uint32_t generation;
+    uint16_t journal_entries;       // Entries in the current journal
+    uint16_t journal_replayed;      // Entries applied at load
+    uint32_t journal_appends;
+    uint32_t compactions;
+    uint32_t load_errors;           // Header/payload CRC or version mismatches
+} FingerprintDbStats_t;
+
+// Temporal record transfer (the analysis layer owns the in-memory form).
+// load is called with NULL when a damaged snapshot must be discarded.
+typedef void (*FingerprintDbTemporalLoadFn)(const FingerprintDbTemporal_t* record, void* ctx);
+typedef void (*FingerprintDbTemporalSaveFn)(uint16_t index, FingerprintDbTemporal_t* record, void* ctx);
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Load snapshot, replay journal and keep the journal open for appends
+FuriStatus fingerprint_db_open(DeviceDatabase_t* db, FingerprintDbTemporalLoadFn load_temporal,
+                               void* ctx);
+void fingerprint_db_close(void);
+
+// Journal
+bool fingerprint_db_journal(FingerprintJournalOp_t op, const DeviceDatabase_t* db,
+                            uint16_t device_id);
+void fingerprint_db_sync(void);
+bool fingerprint_db_needs_compaction(void);
+
+// Write a new snapshot and start an empty journal
+bool fingerprint_db_compact(const DeviceDatabase_t* db, uint16_t temporal_count,
+                            FingerprintDbTemporalSaveFn save_temporal, void* ctx);
+
+// Diagnostics
+FingerprintDbStats_t fingerprint_db_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FINGERPRINT_DB_H
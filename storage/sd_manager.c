@@ -1,16 +1,35 @@
 #include "sd_manager.h"
+#include "compression.h"
+#include "sd_writer.h"
+#include "session_index.h"
+#include "../core/math/crc.h"
 #include <datetime/datetime.h>
 
 #define TAG "SD_MGR"
 
+// Compressed files: offset of every SD_COMPRESSED_INDEX_STRIDE-th block
+#define SD_COMPRESSED_INDEX_STRIDE  16
+#define SD_COMPRESSED_INDEX_SIZE    256
+
+typedef struct {
+    const FileHandle_t* handle;     // File the offsets belong to
+    uint32_t open_time;
+    uint16_t count;
+    uint32_t offsets[SD_COMPRESSED_INDEX_SIZE];
+} SdCompressedIndex_t;
+
 // Static state
 static Storage* storage = NULL;
-static SessionIndex_t session_index;
 static bool sd_initialized = false;
 static uint32_t rolling_log_size = 0;
 static uint32_t rolling_log_max_size = 0;
 static File* rolling_log_file = NULL;
 
+// Compressed block I/O (SD flush path, not reentrant)
+static uint8_t compressed_block[COMPRESSION_BLOCK_MAX_OUTPUT];
+static uint8_t decompressed_block[COMPRESSION_MAX_BLOCK_SIZE];
+static SdCompressedIndex_t compressed_index;
+
 // Initialize SD manager
 FuriStatus sd_manager_init(void) {
     if(sd_initialized) {
@@ -40,11 +59,11 @@ FuriStatus sd_manager_init(void) {
         return FuriStatusError;
     }
     
-    // Load session index
+    // Open session index (header only - records are paged in on demand)
     sd_manager_load_session_index();
     
     sd_initialized = true;
-    FURI_LOG_I(TAG, "SD manager initialized, %d sessions found", session_index.count);
+    FURI_LOG_I(TAG, "SD manager initialized, %d sessions found", session_index_count());
     
     return FuriStatusOk;
 }
@@ -59,8 +78,8 @@ void sd_manager_deinit(void) {
         rolling_log_file = NULL;
     }
     
-    // Save session index
-    sd_manager_save_session_index();
+    // Persist and close session index
+    session_index_close();
     
     // Close storage
     furi_record_close(RECORD_STORAGE);
@@ -119,8 +138,9 @@ bool sd_manager_create_session_directory(uint16_t session_id, char* path_out, si
     return true;
 }
 
-// Open file
-FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write) {
+// Open file with explicit access/open modes
+static FileHandle_t* open_file_mode(const char* path, FileType_t type,
+                                    FS_AccessMode access, FS_OpenMode open_mode) {
     if(!storage) return NULL;
     
     FileHandle_t* handle = malloc(sizeof(FileHandle_t));
@@ -137,9 +157,6 @@ FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write
     strncpy(handle->path, path, MAX_PATH_LEN - 1);
     handle->path[MAX_PATH_LEN - 1] = '\0';
     
-    FS_AccessMode access = write ? FS_ACCESS_MODE_WRITE : FS_ACCESS_MODE_READ;
-    FS_OpenMode open_mode = write ? (FS_OPEN_MODE_WRITE | FS_OPEN_MODE_CREATE_ALWAYS) : FS_OPEN_MODE_READ;
-    
     if(!storage_file_open(handle->file, path, access, open_mode)) {
         FURI_LOG_E(TAG, "Failed to open file: %s", path);
         storage_file_free(handle->file);
@@ -151,6 +168,25 @@ FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write
     return handle;
 }
 
+// Open file (write truncates)
+FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write) {
+    FS_AccessMode access = write ? FS_ACCESS_MODE_WRITE : FS_ACCESS_MODE_READ;
+    FS_OpenMode open_mode = write ? (FS_OPEN_MODE_WRITE | FS_OPEN_MODE_CREATE_ALWAYS) : FS_OPEN_MODE_READ;
+    return open_file_mode(path, type, access, open_mode);
+}
+
+// Open file for appending, creating it if missing
+FileHandle_t* sd_manager_open_append(const char* path, FileType_t type) {
+    return open_file_mode(path, type, FS_ACCESS_MODE_WRITE,
+                          FS_OPEN_MODE_WRITE | FS_OPEN_MODE_OPEN_APPEND);
+}
+
+// Open file for in-place reads and writes, creating it if missing
+FileHandle_t* sd_manager_open_rw(const char* path, FileType_t type) {
+    return open_file_mode(path, type, (FS_AccessMode)(FS_ACCESS_MODE_READ | FS_ACCESS_MODE_WRITE),
+                          (FS_OpenMode)(FS_OPEN_MODE_READ | FS_OPEN_MODE_WRITE | FS_OPEN_MODE_OPEN_ALWAYS));
+}
+
 // Close file
 void sd_manager_close_file(FileHandle_t* handle) {
     if(!handle) return;
@@ -160,6 +196,8 @@ void sd_manager_close_file(FileHandle_t* handle) {
         storage_file_free(handle->file);
     }
     
+    if(compressed_index.handle == handle) compressed_index.handle = NULL;
+    
     uint32_t duration = furi_get_tick() - handle->open_time;
     FURI_LOG_D(TAG, "File closed: %s (duration: %lu ms)", handle->path, duration);
     
@@ -190,6 +228,22 @@ bool sd_manager_read(FileHandle_t* handle, uint8_t* data, uint32_t len) {
     return (read == len);
 }
 
+// Read up to len bytes, returns bytes read (short at end of file)
+uint32_t sd_manager_read_upto(FileHandle_t* handle, uint8_t* data, uint32_t len) {
+    if(!handle || !handle->is_open) return 0;
+    
+    uint32_t read = storage_file_read(handle->file, data, len);
+    handle->bytes_read += read;
+    
+    return read;
+}
+
+// Flush buffered writes to the card
+bool sd_manager_sync(FileHandle_t* handle) {
+    if(!handle || !handle->is_open) return false;
+    return storage_file_sync(handle->file);
+}
+
 // Write string to file
 bool sd_manager_write_string(FileHandle_t* handle, const char* str) {
     return sd_manager_write(handle, (const uint8_t*)str, strlen(str));
@@ -197,13 +251,15 @@ bool sd_manager_write_string(FileHandle_t* handle, const char* str) {
 
 // Create new session
 uint16_t sd_manager_create_session(const char* name) {
-    if(session_index.count >= MAX_SESSIONS) {
+    uint16_t session_id = session_index_allocate_id();
+    if(session_id == 0) {
         FURI_LOG_E(TAG, "Maximum sessions reached");
         return 0;
     }
     
-    uint16_t session_id = session_index.count + 1;
-    SessionInfo_t* info = &session_index.sessions[session_index.count];
+    SessionInfo_t session;
+    SessionInfo_t* info = &session;
+    memset(info, 0, sizeof(*info));
     
     info->session_id = session_id;
     strncpy(info->session_name, name, SESSION_NAME_LEN - 1);
@@ -230,8 +286,17 @@ uint16_t sd_manager_create_session(const char* name) {
         return 0;
     }
     
-    session_index.count++;
-    session_index.current_session = session_id;
+    // Captured frames stream into raw/frames.bin through the writer thread
+    char raw_path[MAX_PATH_LEN];
+    snprintf(raw_path, sizeof(raw_path), "%s/raw/frames.bin", path);
+    info->has_raw = sd_writer_open_stream(SD_WRITER_STREAM_CAPTURE, raw_path);
+    
+    // One record written in place
+    session_index_set_current(session_id);
+    if(!session_index_put(info)) {
+        FURI_LOG_E(TAG, "Failed to index session %d", session_id);
+        return 0;
+    }
     
     FURI_LOG_I(TAG, "Created session %d: %s", session_id, name);
     
@@ -240,8 +305,17 @@ uint16_t sd_manager_create_session(const char* name) {
 
 // Close session
 bool sd_manager_close_session(uint16_t session_id) {
-    SessionInfo_t* info = sd_manager_get_session(session_id);
-    if(!info) return false;
+    SessionInfo_t* cached = sd_manager_get_session(session_id);
+    if(!cached) return false;
+    
+    // Work on a copy: the cached record may be evicted by later index reads
+    SessionInfo_t session = *cached;
+    SessionInfo_t* info = &session;
+    
+    // Buffered frames are still written before the capture file closes
+    if(session_id == session_index_current()) {
+        sd_writer_close_stream(SD_WRITER_STREAM_CAPTURE);
+    }
     
     // Update session info
     info->duration_ms = furi_get_tick();  // Would calculate actual duration
@@ -278,82 +352,69 @@ bool sd_manager_close_session(uint16_t session_id) {
         info->has_metadata = true;
     }
     
+    // Update only this session's record
+    if(!session_index_put(info)) {
+        FURI_LOG_E(TAG, "Failed to update session %d record", session_id);
+        return false;
+    }
+    
     FURI_LOG_I(TAG, "Closed session %d", session_id);
     return true;
 }
 
-// Load session index
+// Open the paged session index (migrates a legacy index once)
 bool sd_manager_load_session_index(void) {
-    char path[MAX_PATH_LEN];
-    snprintf(path, sizeof(path), "%s/session_index.bin", SD_BASE_PATH);
-    
-    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_CONFIG, false);
-    if(!file) {
-        // No existing index, start fresh
-        memset(&session_index, 0, sizeof(session_index));
-        return true;
-    }
-    
-    bool success = sd_manager_read(file, (uint8_t*)&session_index, sizeof(session_index));
-    sd_manager_close_file(file);
-    
-    if(!success) {
-        memset(&session_index, 0, sizeof(session_index));
-        return false;
-    }
-    
-    return true;
+    return session_index_open();
 }
 
-// Save session index
+// Flush the session index header and record updates
 bool sd_manager_save_session_index(void) {
-    char path[MAX_PATH_LEN];
-    snprintf(path, sizeof(path), "%s/session_index.bin", SD_BASE_PATH);
-    
-    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_CONFIG, true);
-    if(!file) return false;
-    
-    bool success = sd_manager_write(file, (const uint8_t*)&session_index, sizeof(session_index));
-    sd_manager_close_file(file);
-    
-    return success;
+    return session_index_sync();
 }
 
-// Get session info
+// Get session info (cache entry, valid until the next session index call)
 SessionInfo_t* sd_manager_get_session(uint16_t session_id) {
-    for(uint16_t i = 0; i < session_index.count; i++) {
-        if(session_index.sessions[i].session_id == session_id) {
-            return &session_index.sessions[i];
-        }
-    }
-    return NULL;
+    return session_index_get(session_id);
 }
 
 // Delete session
 bool sd_manager_delete_session(uint16_t session_id) {
-    // Remove from index
-    for(uint16_t i = 0; i < session_index.count; i++) {
-        if(session_index.sessions[i].session_id == session_id) {
-            // Shift remaining sessions
-            for(uint16_t j = i; j < session_index.count - 1; j++) {
-                session_index.sessions[j] = session_index.sessions[j + 1];
-            }
-            session_index.count--;
-            break;
-        }
+    if(session_id == session_index_current()) {
+        sd_writer_close_stream(SD_WRITER_STREAM_CAPTURE);
     }
     
+    // Clear its record in place
+    if(!session_index_remove(session_id)) return false;
+    
     // Delete directory (would need recursive delete)
     char path[MAX_PATH_LEN];
     snprintf(path, sizeof(path), "%s/session_%03d", CAPTURES_PATH, session_id);
     storage_simply_remove_recursive(storage, path);
     
-    sd_manager_save_session_index();
-    
     FURI_LOG_I(TAG, "Deleted session %d", session_id);
     return true;
 }
 
+// Replace dst with src (dst may not exist). dst is moved to backup before
+// src takes its place, so one of the two always holds a complete file; on
+// failure dst is restored.
+bool sd_manager_replace_file(const char* src, const char* dst, const char* backup) {
+    if(!storage) return false;
+    
+    // Stale backup of an earlier replace that completed the rename
+    storage_simply_remove(storage, backup);
+    bool had_dst = storage_common_rename(storage, dst, backup) == FSE_OK;
+    
+    if(storage_common_rename(storage, src, dst) != FSE_OK) {
+        FURI_LOG_E(TAG, "Failed to rename %s to %s", src, dst);
+        if(had_dst) storage_common_rename(storage, backup, dst);
+        return false;
+    }
+    
+    if(had_dst) storage_simply_remove(storage, backup);
+    return true;
+}
+
 // Export session data
 bool sd_manager_export_session(uint16_t session_id, ExportFormat_t format, const char* filename) {
     char path[MAX_PATH_LEN];
@@ -487,18 +548,8 @@ bool sd_manager_save_config(const RFConfig_t* config) {
     return true;
 }
 
-// Log event
+// Log event (queued to the storage thread, returns without touching the card)
 bool sd_manager_log_event(const char* event, const char* details) {
-    char path[MAX_PATH_LEN];
-    snprintf(path, sizeof(path), "%s/system.log", LOGS_PATH);
-    
-    // Open in append mode
-    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_LOG, true);
-    if(!file) return false;
-    
-    // Seek to end
-    storage_file_seek(file->file, 0, true);
-    
     DateTime datetime;
     furi_hal_rtc_get_datetime(&datetime);
     
@@ -510,28 +561,11 @@ bool sd_manager_log_event(const char* event, const char* details) {
         event, details
     );
     
-    sd_manager_write_string(file, line);
-    sd_manager_close_file(file);
-    
-    return true;
+    return sd_writer_append(SD_WRITER_STREAM_SYSTEM_LOG, line, strlen(line));
 }
 
-// Log system status
+// Log system status (the writer adds the CSV header to a new file)
 bool sd_manager_log_system_status(const SystemTelemetry_t* telemetry) {
-    char path[MAX_PATH_LEN];
-    snprintf(path, sizeof(path), "%s/telemetry.csv", LOGS_PATH);
-    
-    FileHandle_t* file = sd_manager_open_file(path, FILE_TYPE_LOG, true);
-    if(!file) return false;
-    
-    // Check if file is new (write header)
-    if(storage_file_tell(file->file) == 0) {
-        sd_manager_write_string(file, "timestamp,cpu_load,frames_per_sec,buffer_util,isr_latency_ms,battery_v\n");
-    }
-    
-    // Seek to end
-    storage_file_seek(file->file, 0, true);
-    
     char line[128];
     snprintf(line, sizeof(line),
         "%lu,%lu,%lu,%lu,%lu,%.2f\n",
@@ -543,10 +577,7 @@ bool sd_manager_log_system_status(const SystemTelemetry_t* telemetry) {
         telemetry->battery_voltage
     );
     
-    sd_manager_write_string(file, line);
-    sd_manager_close_file(file);
-    
-    return true;
+    return sd_writer_append(SD_WRITER_STREAM_TELEMETRY, line, strlen(line));
 }
 
 // Get free space
@@ -577,6 +608,12 @@ bool sd_manager_check_space(uint64_t required_bytes) {
     return (free >= required_bytes);
 }
 
+// CRC-32 (IEEE 802.3, zlib compatible). Pass 0 to start, the previous
+// result to continue.
+uint32_t sd_manager_crc32(uint32_t crc, const void* data, uint32_t len) {
+    return ~crc_update(crc_get_engine(CRC_ENGINE_32_REF), ~crc, data, len);
+}
+
 // Format path
 void sd_manager_format_path(char* out, size_t out_size, const char* base, const char* filename) {
     snprintf(out, out_size, "%s/%s", base, filename);
@@ -653,17 +690,128 @@ bool sd_manager_enum_files(const char* directory, FileEnumCallback callback, voi
     return true;
 }
 
-// Write compressed data (placeholder - would integrate with compression.c)
+// Position the file at block block_index of a compressed file, walking
+// block headers from the nearest indexed block
+static bool compressed_seek_block(FileHandle_t* handle, uint32_t block_index) {
+    if(compressed_index.handle != handle || compressed_index.open_time != handle->open_time) {
+        compressed_index.handle = handle;
+        compressed_index.open_time = handle->open_time;
+        compressed_index.offsets[0] = 0;
+        compressed_index.count = 1;
+    }
+
+    uint32_t slot = block_index / SD_COMPRESSED_INDEX_STRIDE;
+    if(slot >= compressed_index.count) slot = compressed_index.count - 1;
+
+    uint32_t block = slot * SD_COMPRESSED_INDEX_STRIDE;
+    uint32_t offset = compressed_index.offsets[slot];
+
+    while(block < block_index) {
+        CompressionBlockHeader_t header;
+        if(!storage_file_seek(handle->file, offset, true) ||
+           storage_file_read(handle->file, compressed_block, COMPRESSION_BLOCK_HEADER_SIZE) !=
+               COMPRESSION_BLOCK_HEADER_SIZE ||
+           !compression_parse_block_header(compressed_block, COMPRESSION_BLOCK_HEADER_SIZE,
+                                           &header)) {
+            return false;
+        }
+
+        offset += COMPRESSION_BLOCK_HEADER_SIZE + header.compressed_size;
+        block++;
+
+        if(block % SD_COMPRESSED_INDEX_STRIDE == 0 &&
+           block / SD_COMPRESSED_INDEX_STRIDE == compressed_index.count &&
+           compressed_index.count < SD_COMPRESSED_INDEX_SIZE) {
+            compressed_index.offsets[compressed_index.count++] = offset;
+        }
+    }
+
+    return storage_file_seek(handle->file, offset, true);
+}
+
+// Read and decompress the block at the current position. block_len is 0 at
+// end of file or when the block does not fit max_len (position unchanged).
+static bool read_next_block(FileHandle_t* handle, uint8_t* data, uint32_t max_len,
+                            uint32_t* block_len) {
+    CompressionBlockHeader_t header;
+    uint64_t block_start = storage_file_tell(handle->file);
+    *block_len = 0;
+
+    uint32_t got = sd_manager_read_upto(handle, compressed_block, COMPRESSION_BLOCK_HEADER_SIZE);
+    if(got == 0) return true;
+    if(got < COMPRESSION_BLOCK_HEADER_SIZE ||
+       !compression_parse_block_header(compressed_block, got, &header)) {
+        FURI_LOG_E(TAG, "Bad compressed block header at %lu", (uint32_t)block_start);
+        return false;
+    }
+
+    if(header.original_size > max_len) {
+        return storage_file_seek(handle->file, (uint32_t)block_start, true);
+    }
+
+    if(!sd_manager_read(handle, &compressed_block[COMPRESSION_BLOCK_HEADER_SIZE],
+                        header.compressed_size)) {
+        return false;
+    }
+
+    uint32_t decoded_len = 0;
+    if(!compression_decompress_block(compressed_block,
+                                     COMPRESSION_BLOCK_HEADER_SIZE + header.compressed_size,
+                                     decompressed_block, &decoded_len, 0)) {
+        FURI_LOG_E(TAG, "Corrupt compressed block at %lu", (uint32_t)block_start);
+        return false;
+    }
+
+    memcpy(data, decompressed_block, decoded_len);
+    *block_len = decoded_len;
+    return true;
+}
+
+// Write data as compressed blocks, one per COMPRESSION_MAX_BLOCK_SIZE bytes
+// (pass whole blocks, or use the compression stream, for the best ratio)
 bool sd_manager_write_compressed(FileHandle_t* handle, const uint8_t* data, uint32_t len) {
-    // For now, just write uncompressed
-    // Full implementation would compress data before writing
-    return sd_manager_write(handle, data, len);
+    if(!handle || !handle->is_open) return false;
+
+    while(len > 0) {
+        uint32_t chunk = (len > COMPRESSION_MAX_BLOCK_SIZE) ? COMPRESSION_MAX_BLOCK_SIZE : len;
+        uint32_t block_len = 0;
+
+        if(!compression_compress_block(data, chunk, compressed_block, &block_len, NULL) ||
+           !sd_manager_write(handle, compressed_block, block_len)) {
+            return false;
+        }
+
+        data += chunk;
+        len -= chunk;
+    }
+
+    return true;
 }
 
-// Read compressed data (placeholder)
+// Read whole compressed blocks from the current position while they fit
+// max_len (at least COMPRESSION_MAX_BLOCK_SIZE reads any block)
 bool sd_manager_read_compressed(FileHandle_t* handle, uint8_t* data, uint32_t max_len, uint32_t* out_len) {
-    // For now, just read uncompressed
-    // Full implementation would decompress after reading
-    *out_len = max_len;
-    return sd_manager_read(handle, data, max_len);
+    *out_len = 0;
+    if(!handle || !handle->is_open) return false;
+
+    while(*out_len < max_len) {
+        uint32_t block_len = 0;
+        if(!read_next_block(handle, &data[*out_len], max_len - *out_len, &block_len)) {
+            return false;
+        }
+        if(block_len == 0) break;
+        *out_len += block_len;
+    }
+
+    return *out_len > 0;
+}
+
+// Random access: read block block_index; sequential reads continue after it
+bool sd_manager_read_compressed_block(FileHandle_t* handle, uint32_t block_index,
+                                      uint8_t* data, uint32_t max_len, uint32_t* out_len) {
+    *out_len = 0;
+    if(!handle || !handle->is_open) return false;
+    if(!compressed_seek_block(handle, block_index)) return false;
+
+    return read_next_block(handle, data, max_len, out_len) && *out_len > 0;
 }
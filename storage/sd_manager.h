@@ -77,12 +77,6 @@ typedef struct {
     bool has_metadata;
 } SessionInfo_t;
 
-typedef struct {
-    SessionInfo_t sessions[MAX_SESSIONS];
-    uint16_t count;
-    uint16_t current_session;
-} SessionIndex_t;
-
 // ============================================================================
 // FUNCTION DECLARATIONS
 // ============================================================================
@@ -98,12 +92,17 @@ bool sd_manager_create_session_directory(uint16_t session_id, char* path_out, si
 
 // File operations
 FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write);
+FileHandle_t* sd_manager_open_append(const char* path, FileType_t type);
+FileHandle_t* sd_manager_open_rw(const char* path, FileType_t type);
 void sd_manager_close_file(FileHandle_t* handle);
 bool sd_manager_write(FileHandle_t* handle, const uint8_t* data, uint32_t len);
 bool sd_manager_read(FileHandle_t* handle, uint8_t* data, uint32_t len);
+uint32_t sd_manager_read_upto(FileHandle_t* handle, uint8_t* data, uint32_t len);
 bool sd_manager_write_string(FileHandle_t* handle, const char* str);
+bool sd_manager_sync(FileHandle_t* handle);
+bool sd_manager_replace_file(const char* src, const char* dst, const char* backup);
 
-// Session management
+// Session management (records live in the paged index, see session_index.h)
 uint16_t sd_manager_create_session(const char* name);
 bool sd_manager_close_session(uint16_t session_id);
 bool sd_manager_load_session_index(void);
@@ -116,9 +115,11 @@ bool sd_manager_export_session(uint16_t session_id, ExportFormat_t format, const
 bool sd_manager_export_fingerprint(const RFFingerprint_t* fingerprint, const char* device_name);
 bool sd_manager_export_telemetry(const SystemTelemetry_t* telemetry, const char* filename);
 
-// Compression support
+// Compression support (files of compression_compress_block blocks)
 bool sd_manager_write_compressed(FileHandle_t* handle, const uint8_t* data, uint32_t len);
 bool sd_manager_read_compressed(FileHandle_t* handle, uint8_t* data, uint32_t max_len, uint32_t* out_len);
+bool sd_manager_read_compressed_block(FileHandle_t* handle, uint32_t block_index,
+                                      uint8_t* data, uint32_t max_len, uint32_t* out_len);
 
 // Configuration
 bool sd_manager_load_config(RFConfig_t* config);
@@ -133,6 +134,7 @@ uint64_t sd_manager_get_free_space(void);
 uint64_t sd_manager_get_total_space(void);
 bool sd_manager_check_space(uint64_t required_bytes);
 void sd_manager_format_path(char* out, size_t out_size, const char* base, const char* filename);
+uint32_t sd_manager_crc32(uint32_t crc, const void* data, uint32_t len);
 
 // Rolling log buffer
 bool sd_manager_init_rolling_log(uint32_t max_size_mb);
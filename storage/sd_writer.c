@@ -0,0 +1,519 @@
+#include "sd_writer.h"
+#include "../core/hal/timer_precision.h"
+#include "../research/telemetry.h"
+
+#define TAG "SD_WRITER"
+
+// Requests: every block is queued at most once, plus a bounded number of
+// open/close requests per stream
+#define SD_WRITER_QUEUE_DEPTH       (SD_WRITER_BLOCK_COUNT + 3 * SD_WRITER_STREAM_COUNT)
+
+typedef enum {
+    SD_WRITER_OP_BLOCK = 0,         // Write a sealed block
+    SD_WRITER_OP_OPEN,              // Switch the stream to its pending path
+    SD_WRITER_OP_CLOSE,             // Sync and close the stream file
+} SdWriterOp_t;
+
+typedef struct {
+    uint8_t op;
+    uint8_t stream;
+    uint8_t block;
+    uint16_t length;
+} SdWriterRequest_t;
+
+// Per-stream defaults. Streams without a default path are opened on demand.
+typedef struct {
+    const char* path;
+    FileType_t type;
+    const char* header;             // Written when the file is empty
+    uint8_t reserve;                // Free blocks that must remain after an append
+} SdWriterStreamClass_t;
+
+static const SdWriterStreamClass_t stream_classes[SD_WRITER_STREAM_COUNT] = {
+    [SD_WRITER_STREAM_SYSTEM_LOG] = {LOGS_PATH "/system.log", FILE_TYPE_LOG, NULL, 0},
+    [SD_WRITER_STREAM_TELEMETRY]  = {LOGS_PATH "/telemetry.csv", FILE_TYPE_LOG,
+        "timestamp,cpu_load,frames_per_sec,buffer_util,isr_latency_ms,battery_v\n", 0},
+    [SD_WRITER_STREAM_CAPTURE]    = {NULL, FILE_TYPE_RAW, NULL, SD_WRITER_CAPTURE_RESERVE},
+};
+
+typedef struct {
+    // Producer side (guarded by writer_mutex)
+    char pending_path[MAX_PATH_LEN];
+    bool accepting;                 // Appends allowed
+    bool open_pending;              // OPEN queued, pending_path in use
+    int8_t block;                   // Block being filled, -1 if none
+    uint16_t fill;
+    uint32_t block_tick;            // Tick of the first byte in the block
+
+    // Storage thread only
+    char path[MAX_PATH_LEN];        // Empty while the stream is closed
+    FileHandle_t* file;
+    bool dirty;                     // Written since the last sync
+} SdWriterStreamState_t;
+
+// Static state
+static uint8_t block_pool[SD_WRITER_BLOCK_COUNT][SD_WRITER_BLOCK_SIZE] __attribute__((aligned(4)));
+static uint32_t free_mask = 0;
+static uint16_t free_count = 0;
+static uint8_t next_block = 0;
+static SdWriterRequest_t request_queue[SD_WRITER_QUEUE_DEPTH];
+static uint16_t request_head = 0;
+static uint16_t request_count = 0;
+static SdWriterStreamState_t streams[SD_WRITER_STREAM_COUNT];
+static SdWriterStats_t writer_stats;
+static FuriMutex* writer_mutex = NULL;
+static volatile FuriThreadId consumer_thread = NULL;
+static uint32_t last_sync_tick = 0;
+static bool writer_ready = false;
+
+// ============================================================================
+// POOL AND QUEUE HELPERS (caller holds writer_mutex)
+// ============================================================================
+
+// Take a free block, preferring the one after the last allocation so that a
+// single busy stream fills adjacent blocks that coalesce into one write
+static int8_t block_alloc(void) {
+    for(uint8_t i = 0; i < SD_WRITER_BLOCK_COUNT; i++) {
+        uint8_t block = (next_block + i) % SD_WRITER_BLOCK_COUNT;
+        if(free_mask & (1UL << block)) {
+            free_mask &= ~(1UL << block);
+            free_count--;
+            if(free_count < writer_stats.min_free_blocks) writer_stats.min_free_blocks = free_count;
+            next_block = (block + 1) % SD_WRITER_BLOCK_COUNT;
+            return (int8_t)block;
+        }
+    }
+    return -1;
+}
+
+static void block_free(uint8_t block) {
+    if(!(free_mask & (1UL << block))) {
+        free_mask |= 1UL << block;
+        free_count++;
+    }
+}
+
+static bool request_push(SdWriterOp_t op, uint8_t stream, uint8_t block, uint16_t length) {
+    if(request_count >= SD_WRITER_QUEUE_DEPTH) return false;
+
+    SdWriterRequest_t* req = &request_queue[(request_head + request_count) % SD_WRITER_QUEUE_DEPTH];
+    req->op = op;
+    req->stream = stream;
+    req->block = block;
+    req->length = length;
+    request_count++;
+    return true;
+}
+
+static void request_pop(void) {
+    request_head = (request_head + 1) % SD_WRITER_QUEUE_DEPTH;
+    request_count--;
+}
+
+// Queue the stream's partially or completely filled block
+static bool seal_block(SdWriterStream_t id) {
+    SdWriterStreamState_t* stream = &streams[id];
+    if(stream->block < 0) return true;
+
+    if(stream->fill == 0) {
+        block_free((uint8_t)stream->block);
+    } else if(!request_push(SD_WRITER_OP_BLOCK, id, (uint8_t)stream->block, stream->fill)) {
+        return false;
+    }
+
+    stream->block = -1;
+    stream->fill = 0;
+    return true;
+}
+
+static inline void writer_lock(void) {
+    furi_mutex_acquire(writer_mutex, FuriWaitForever);
+}
+
+static inline void writer_unlock(void) {
+    furi_mutex_release(writer_mutex);
+}
+
+static void notify_consumer(void) {
+    FuriThreadId thread = consumer_thread;
+    if(thread) furi_thread_flags_set(thread, SD_WRITER_FLAG_WORK);
+}
+
+// ============================================================================
+// STORAGE THREAD HELPERS
+// ============================================================================
+
+// Open the stream's current file for appending, writing its header if new
+static bool stream_open_file(SdWriterStream_t id) {
+    SdWriterStreamState_t* stream = &streams[id];
+    if(stream->file) return true;
+    if(stream->path[0] == '\0') return false;
+
+    stream->file = sd_manager_open_append(stream->path, stream_classes[id].type);
+    if(!stream->file) return false;
+
+    const char* header = stream_classes[id].header;
+    if(header && storage_file_size(stream->file->file) == 0) {
+        sd_manager_write_string(stream->file, header);
+        stream->dirty = true;
+    }
+
+    return true;
+}
+
+static void stream_close_file(SdWriterStream_t id) {
+    SdWriterStreamState_t* stream = &streams[id];
+    if(!stream->file) return;
+
+    if(stream->dirty) sd_manager_sync(stream->file);
+    sd_manager_close_file(stream->file);
+    stream->file = NULL;
+    stream->dirty = false;
+}
+
+// Write len bytes starting at block first (adjacent blocks are contiguous)
+static void write_run(SdWriterStream_t id, uint8_t first, uint8_t blocks, uint32_t len) {
+    SdWriterStreamState_t* stream = &streams[id];
+    bool ok = stream_open_file(id);
+    uint32_t latency_us = 0;
+
+    if(ok) {
+        uint32_t start_us = timer_get_us();
+        ok = sd_manager_write(stream->file, block_pool[first], len);
+        latency_us = timer_get_elapsed_us(start_us);
+        stream->dirty = true;
+    }
+
+    telemetry_log_sd_write(latency_us, ok);
+
+    writer_lock();
+    if(ok) {
+        writer_stats.bytes_written += len;
+        writer_stats.blocks_written += blocks;
+        writer_stats.writes++;
+        if(latency_us > writer_stats.max_latency_us) writer_stats.max_latency_us = latency_us;
+    } else {
+        writer_stats.write_errors++;
+    }
+    writer_unlock();
+
+    // Reopen on the next run rather than writing through a failed handle
+    if(!ok && stream->file) {
+        FURI_LOG_E(TAG, "Write of %lu bytes to %s failed", len, stream->path);
+        stream_close_file(id);
+    }
+}
+
+// Queue partial blocks that have waited SD_WRITER_SEAL_MS (all if forced)
+static void seal_idle_blocks(bool force) {
+    uint32_t now = furi_get_tick();
+
+    writer_lock();
+    for(uint8_t id = 0; id < SD_WRITER_STREAM_COUNT; id++) {
+        SdWriterStreamState_t* stream = &streams[id];
+        if(stream->block < 0) continue;
+        if(force || now - stream->block_tick >= SD_WRITER_SEAL_MS) {
+            seal_block(id);
+        }
+    }
+    writer_unlock();
+}
+
+// Execute queued requests in order, merging runs of adjacent full blocks
+static void drain_requests(void) {
+    while(1) {
+        writer_lock();
+        if(request_count == 0) {
+            writer_unlock();
+            break;
+        }
+
+        SdWriterRequest_t req = request_queue[request_head];
+        request_pop();
+
+        uint8_t blocks = 1;
+        uint32_t len = req.length;
+        if(req.op == SD_WRITER_OP_BLOCK) {
+            while(blocks < SD_WRITER_MAX_RUN && request_count > 0 &&
+                  len == (uint32_t)blocks * SD_WRITER_BLOCK_SIZE) {
+                const SdWriterRequest_t* next = &request_queue[request_head];
+                if(next->op != SD_WRITER_OP_BLOCK || next->stream != req.stream ||
+                   next->block != req.block + blocks) break;
+                len += next->length;
+                blocks++;
+                request_pop();
+            }
+        }
+        writer_unlock();
+
+        switch(req.op) {
+        case SD_WRITER_OP_BLOCK:
+            write_run(req.stream, req.block, blocks, len);
+            writer_lock();
+            for(uint8_t i = 0; i < blocks; i++) block_free(req.block + i);
+            writer_unlock();
+            break;
+
+        case SD_WRITER_OP_OPEN:
+            stream_close_file(req.stream);
+            writer_lock();
+            memcpy(streams[req.stream].path, streams[req.stream].pending_path, MAX_PATH_LEN);
+            streams[req.stream].open_pending = false;
+            writer_unlock();
+            if(!stream_open_file(req.stream)) {
+                FURI_LOG_E(TAG, "Failed to open %s", streams[req.stream].path);
+            }
+            break;
+
+        case SD_WRITER_OP_CLOSE:
+            stream_close_file(req.stream);
+            streams[req.stream].path[0] = '\0';
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+// Sync every stream written since the last sync
+static void sync_streams(void) {
+    for(uint8_t id = 0; id < SD_WRITER_STREAM_COUNT; id++) {
+        SdWriterStreamState_t* stream = &streams[id];
+        if(!stream->file || !stream->dirty) continue;
+
+        sd_manager_sync(stream->file);
+        stream->dirty = false;
+
+        writer_lock();
+        writer_stats.syncs++;
+        writer_unlock();
+    }
+    last_sync_tick = furi_get_tick();
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Initialize the block pool and the fixed log streams
+FuriStatus sd_writer_init(void) {
+    if(writer_ready) return FuriStatusOk;
+
+    writer_mutex = furi_mutex_alloc(FuriMutexTypeNormal);
+    if(!writer_mutex) return FuriStatusError;
+
+    free_mask = (1UL << SD_WRITER_BLOCK_COUNT) - 1;
+    free_count = SD_WRITER_BLOCK_COUNT;
+    next_block = 0;
+    request_head = 0;
+    request_count = 0;
+    memset(&writer_stats, 0, sizeof(writer_stats));
+    writer_stats.min_free_blocks = SD_WRITER_BLOCK_COUNT;
+
+    for(uint8_t id = 0; id < SD_WRITER_STREAM_COUNT; id++) {
+        SdWriterStreamState_t* stream = &streams[id];
+        memset(stream, 0, sizeof(*stream));
+        stream->block = -1;
+
+        // Fixed streams accept data at once and open on their first write
+        if(stream_classes[id].path) {
+            strncpy(stream->path, stream_classes[id].path, MAX_PATH_LEN - 1);
+            stream->accepting = true;
+        }
+    }
+
+    last_sync_tick = furi_get_tick();
+    consumer_thread = NULL;
+    writer_ready = true;
+
+    FURI_LOG_I(TAG, "Write-behind pool: %d x %d bytes", SD_WRITER_BLOCK_COUNT, SD_WRITER_BLOCK_SIZE);
+    return FuriStatusOk;
+}
+
+// Write everything still buffered and close the stream files
+void sd_writer_deinit(void) {
+    if(!writer_ready) return;
+
+    sd_writer_flush();
+    writer_ready = false;
+
+    for(uint8_t id = 0; id < SD_WRITER_STREAM_COUNT; id++) {
+        stream_close_file(id);
+    }
+
+    furi_mutex_free(writer_mutex);
+    writer_mutex = NULL;
+    consumer_thread = NULL;
+}
+
+// Register the storage thread woken by producers (NULL to detach)
+void sd_writer_attach_consumer(FuriThreadId thread) {
+    consumer_thread = thread;
+    if(thread && request_count > 0) {
+        furi_thread_flags_set(thread, SD_WRITER_FLAG_WORK);
+    }
+}
+
+// Copy data into the stream's blocks. All or nothing: returns false without
+// queuing anything if the pool cannot take len bytes.
+bool sd_writer_append(SdWriterStream_t id, const void* data, uint32_t len) {
+    if(!writer_ready || id >= SD_WRITER_STREAM_COUNT) return false;
+    if(len == 0) return true;
+
+    SdWriterStreamState_t* stream = &streams[id];
+    const uint8_t* src = data;
+    bool wake = false;
+
+    writer_lock();
+    if(!stream->accepting) {
+        writer_unlock();
+        return false;
+    }
+
+    uint32_t room = (stream->block >= 0) ? SD_WRITER_BLOCK_SIZE - stream->fill : 0;
+    uint32_t needed = (len > room) ? (len - room + SD_WRITER_BLOCK_SIZE - 1) / SD_WRITER_BLOCK_SIZE : 0;
+    uint32_t reserve = (needed > 0) ? stream_classes[id].reserve : 0;
+    if(free_count < needed + reserve || request_count + needed + 1 > SD_WRITER_QUEUE_DEPTH) {
+        writer_stats.drops++;
+        writer_stats.bytes_dropped += len;
+        writer_unlock();
+        return false;
+    }
+    writer_stats.bytes_queued += len;
+
+    while(len > 0) {
+        if(stream->block < 0) {
+            stream->block = block_alloc();
+            stream->fill = 0;
+            stream->block_tick = furi_get_tick();
+            wake = true;
+        }
+
+        uint32_t chunk = SD_WRITER_BLOCK_SIZE - stream->fill;
+        if(chunk > len) chunk = len;
+        memcpy(block_pool[stream->block] + stream->fill, src, chunk);
+        stream->fill += chunk;
+        src += chunk;
+        len -= chunk;
+
+        if(stream->fill == SD_WRITER_BLOCK_SIZE) seal_block(id);
+    }
+    writer_unlock();
+
+    // New or sealed blocks need the storage thread; plain appends don't
+    if(wake) notify_consumer();
+    return true;
+}
+
+// Start (or switch) a stream to path. Data appended before the call still
+// goes to the previous file.
+bool sd_writer_open_stream(SdWriterStream_t id, const char* path) {
+    if(!writer_ready || id >= SD_WRITER_STREAM_COUNT || !path) return false;
+
+    SdWriterStreamState_t* stream = &streams[id];
+    bool queued = false;
+
+    writer_lock();
+    if(!stream->open_pending && request_count + 2 <= SD_WRITER_QUEUE_DEPTH) {
+        seal_block(id);
+        strncpy(stream->pending_path, path, MAX_PATH_LEN - 1);
+        stream->pending_path[MAX_PATH_LEN - 1] = '\0';
+        queued = request_push(SD_WRITER_OP_OPEN, id, 0, 0);
+        if(queued) {
+            stream->open_pending = true;
+            stream->accepting = true;
+        }
+    }
+    writer_unlock();
+
+    if(queued) notify_consumer();
+    return queued;
+}
+
+// Stop accepting data; buffered data is written before the file is closed
+bool sd_writer_close_stream(SdWriterStream_t id) {
+    if(!writer_ready || id >= SD_WRITER_STREAM_COUNT) return false;
+
+    SdWriterStreamState_t* stream = &streams[id];
+    bool queued = false;
+
+    writer_lock();
+    if(stream->accepting && request_count + 2 <= SD_WRITER_QUEUE_DEPTH) {
+        seal_block(id);
+        queued = request_push(SD_WRITER_OP_CLOSE, id, 0, 0);
+        if(queued) stream->accepting = false;
+    }
+    writer_unlock();
+
+    if(queued) notify_consumer();
+    return queued;
+}
+
+bool sd_writer_stream_is_open(SdWriterStream_t id) {
+    if(!writer_ready || id >= SD_WRITER_STREAM_COUNT) return false;
+    return streams[id].accepting;
+}
+
+// True while the capture stream would be refused
+bool sd_writer_congested(void) {
+    return writer_ready && free_count <= SD_WRITER_CAPTURE_RESERVE;
+}
+
+// Consumer: block until there is work, one of extra_flags is raised or a
+// partial block/dirty file needs attention. Returns the raised flags.
+uint32_t sd_writer_wait(uint32_t extra_flags) {
+    uint32_t timeout_ms = FuriWaitForever;
+
+    if(request_count > 0) {
+        timeout_ms = 0;
+    } else {
+        for(uint8_t id = 0; id < SD_WRITER_STREAM_COUNT; id++) {
+            if(streams[id].block >= 0 || streams[id].dirty) {
+                timeout_ms = SD_WRITER_SEAL_MS;
+                break;
+            }
+        }
+    }
+
+    uint32_t flags = furi_thread_flags_wait(SD_WRITER_FLAG_WORK | extra_flags, FuriFlagWaitAny,
+                                            timeout_ms);
+    if(flags & FuriFlagError) flags = 0;
+
+    return flags;
+}
+
+// Consumer: write due blocks and sync streams when the interval elapsed
+void sd_writer_service(void) {
+    if(!writer_ready) return;
+
+    seal_idle_blocks(false);
+    drain_requests();
+
+    if(furi_get_tick() - last_sync_tick >= SD_WRITER_SYNC_MS) {
+        sync_streams();
+    }
+}
+
+// Write and sync everything buffered, including partial blocks
+void sd_writer_flush(void) {
+    if(!writer_ready) return;
+
+    seal_idle_blocks(true);
+    drain_requests();
+    sync_streams();
+}
+
+SdWriterStats_t sd_writer_get_stats(void) {
+    SdWriterStats_t stats;
+
+    writer_lock();
+    stats = writer_stats;
+    writer_unlock();
+
+    return stats;
+}
+
+uint16_t sd_writer_free_blocks(void) {
+    return __atomic_load_n(&free_count, __ATOMIC_ACQUIRE);
+}
@@ -0,0 +1,77 @@
+#ifndef SD_WRITER_H
+#define SD_WRITER_H
+
+#include <furi.h>
+#include "sd_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// WRITE-BEHIND SD WRITER
+// Producers copy bytes into per-stream 512-byte blocks from a static pool and
+// return immediately; the storage thread writes sealed blocks in the order
+// they filled, merging runs of adjacent blocks into one write of up to 4 KB.
+// Stream files stay open and are synced periodically. When the pool runs low
+// the capture stream is refused first, so capture never waits on the card.
+// ============================================================================
+
+#define SD_WRITER_BLOCK_SIZE        512             // Coalescing unit
+#define SD_WRITER_BLOCK_COUNT       16              // 8 KB write-behind pool
+#define SD_WRITER_MAX_RUN           8               // Adjacent blocks merged into one write (4 KB)
+#define SD_WRITER_CAPTURE_RESERVE   4               // Free blocks kept back from the capture stream
+#define SD_WRITER_SEAL_MS           500             // Partial blocks older than this are written
+#define SD_WRITER_SYNC_MS           2000            // storage_file_sync interval for dirty streams
+#define SD_WRITER_FLAG_WORK         (1UL << 0)      // Raised when a block is sealed or started
+
+typedef enum {
+    SD_WRITER_STREAM_SYSTEM_LOG = 0,    // logs/system.log
+    SD_WRITER_STREAM_TELEMETRY,         // logs/telemetry.csv
+    SD_WRITER_STREAM_CAPTURE,           // Current session's raw frame file
+    SD_WRITER_STREAM_COUNT
+} SdWriterStream_t;
+
+typedef struct {
+    uint32_t bytes_queued;          // Accepted by sd_writer_append
+    uint32_t bytes_written;
+    uint32_t blocks_written;
+    uint32_t writes;                // storage_file_write calls (one per coalesced run)
+    uint32_t syncs;
+    uint32_t drops;                 // Appends refused for lack of blocks
+    uint32_t bytes_dropped;
+    uint32_t write_errors;
+    uint32_t max_latency_us;        // Slowest single write
+    uint16_t min_free_blocks;       // Pool low-water mark
+} SdWriterStats_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Initialization (after sd_manager_init; deinit after the consumer stopped)
+FuriStatus sd_writer_init(void);
+void sd_writer_deinit(void);
+void sd_writer_attach_consumer(FuriThreadId thread);
+
+// Producers (thread context, never touch the card)
+bool sd_writer_append(SdWriterStream_t stream, const void* data, uint32_t len);
+bool sd_writer_open_stream(SdWriterStream_t stream, const char* path);
+bool sd_writer_close_stream(SdWriterStream_t stream);
+bool sd_writer_stream_is_open(SdWriterStream_t stream);
+bool sd_writer_congested(void);
+
+// Consumer (storage thread)
+uint32_t sd_writer_wait(uint32_t extra_flags);
+void sd_writer_service(void);
+void sd_writer_flush(void);
+
+// Diagnostics
+SdWriterStats_t sd_writer_get_stats(void);
+uint16_t sd_writer_free_blocks(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SD_WRITER_H
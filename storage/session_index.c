@@ -0,0 +1,331 @@
+#include "session_index.h"
+#include <stddef.h>
+
+#define TAG "SESSION_IDX"
+
+#define SESSION_INDEX_NO_PAGE       0xFFFF
+#define SESSION_INDEX_PAGES         ((MAX_SESSIONS + SESSION_INDEX_PAGE_RECORDS - 1) / SESSION_INDEX_PAGE_RECORDS)
+
+// The legacy index was SessionInfo_t[MAX_SESSIONS] followed by count and
+// current session (uint16_t each)
+#define SESSION_INDEX_LEGACY_TAIL   ((uint32_t)MAX_SESSIONS * sizeof(SessionInfo_t))
+
+typedef struct {
+    uint16_t page;                  // SESSION_INDEX_NO_PAGE when unused
+    uint32_t last_use;              // LRU clock value of the last access
+    SessionInfo_t records[SESSION_INDEX_PAGE_RECORDS];
+} SessionIndexPage_t;
+
+// Static state
+static FileHandle_t* index_file = NULL;
+static SessionIndexHeader_t index_header;
+static SessionIndexPage_t page_cache[SESSION_INDEX_CACHE_PAGES];
+static uint32_t cache_clock = 0;
+static uint32_t file_records = 0;   // Record slots present in the file
+static SessionIndexStats_t index_stats;
+
+// ============================================================================
+// FILE HELPERS
+// ============================================================================
+
+static inline uint32_t record_offset(uint16_t session_id) {
+    return sizeof(SessionIndexHeader_t) + (uint32_t)(session_id - 1) * sizeof(SessionInfo_t);
+}
+
+static inline bool session_id_valid(uint16_t session_id) {
+    return session_id >= 1 && session_id <= MAX_SESSIONS;
+}
+
+static uint32_t header_crc(const SessionIndexHeader_t* header) {
+    return sd_manager_crc32(0, header, offsetof(SessionIndexHeader_t, header_crc));
+}
+
+static bool header_valid(const SessionIndexHeader_t* header) {
+    return header->magic == SESSION_INDEX_MAGIC &&
+           header->version == SESSION_INDEX_VERSION &&
+           header->record_size == sizeof(SessionInfo_t) &&
+           header->count <= MAX_SESSIONS &&
+           header->header_crc == header_crc(header);
+}
+
+static void header_reset(void) {
+    memset(&index_header, 0, sizeof(index_header));
+    index_header.magic = SESSION_INDEX_MAGIC;
+    index_header.version = SESSION_INDEX_VERSION;
+    index_header.record_size = sizeof(SessionInfo_t);
+    index_header.next_id = 1;
+}
+
+static bool write_header(void) {
+    index_header.header_crc = header_crc(&index_header);
+
+    if(!storage_file_seek(index_file->file, 0, true)) return false;
+    return sd_manager_write(index_file, (const uint8_t*)&index_header, sizeof(index_header));
+}
+
+// Write one record in place, zero-filling any gap so the file never has holes
+static bool write_record(uint16_t session_id, const SessionInfo_t* record) {
+    if(file_records < (uint32_t)(session_id - 1)) {
+        SessionInfo_t empty;
+        memset(&empty, 0, sizeof(empty));
+
+        if(!storage_file_seek(index_file->file, record_offset(file_records + 1), true)) return false;
+        while(file_records < (uint32_t)(session_id - 1)) {
+            if(!sd_manager_write(index_file, (const uint8_t*)&empty, sizeof(empty))) return false;
+            file_records++;
+        }
+    }
+
+    if(!storage_file_seek(index_file->file, record_offset(session_id), true)) return false;
+    if(!sd_manager_write(index_file, (const uint8_t*)record, sizeof(*record))) return false;
+
+    if(file_records < session_id) file_records = session_id;
+    index_stats.record_writes++;
+    return true;
+}
+
+// ============================================================================
+// PAGE CACHE
+// ============================================================================
+
+static void cache_reset(void) {
+    for(uint8_t i = 0; i < SESSION_INDEX_CACHE_PAGES; i++) {
+        page_cache[i].page = SESSION_INDEX_NO_PAGE;
+        page_cache[i].last_use = 0;
+    }
+    cache_clock = 0;
+}
+
+// Cached page, loading it over the least recently used one on a miss
+static SessionIndexPage_t* page_get(uint16_t page) {
+    SessionIndexPage_t* victim = &page_cache[0];
+
+    for(uint8_t i = 0; i < SESSION_INDEX_CACHE_PAGES; i++) {
+        SessionIndexPage_t* entry = &page_cache[i];
+        if(entry->page == page) {
+            entry->last_use = ++cache_clock;
+            index_stats.cache_hits++;
+            return entry;
+        }
+        if(entry->last_use < victim->last_use) victim = entry;
+    }
+
+    index_stats.cache_misses++;
+    victim->page = SESSION_INDEX_NO_PAGE;
+    memset(victim->records, 0, sizeof(victim->records));
+
+    // Slots past the end of the file are empty
+    uint32_t first = (uint32_t)page * SESSION_INDEX_PAGE_RECORDS;
+    if(first < file_records) {
+        uint32_t count = file_records - first;
+        if(count > SESSION_INDEX_PAGE_RECORDS) count = SESSION_INDEX_PAGE_RECORDS;
+
+        if(!storage_file_seek(index_file->file, record_offset(first + 1), true) ||
+           !sd_manager_read(index_file, (uint8_t*)victim->records, count * sizeof(SessionInfo_t))) {
+            FURI_LOG_E(TAG, "Failed to read index page %d", page);
+            return NULL;
+        }
+    }
+
+    victim->page = page;
+    victim->last_use = ++cache_clock;
+    return victim;
+}
+
+// Record slot of session_id; *page_out receives its cache page
+static SessionInfo_t* slot_get(uint16_t session_id, SessionIndexPage_t** page_out) {
+    SessionIndexPage_t* page = page_get((session_id - 1) / SESSION_INDEX_PAGE_RECORDS);
+    if(page_out) *page_out = page;
+    if(!page) return NULL;
+    return &page->records[(session_id - 1) % SESSION_INDEX_PAGE_RECORDS];
+}
+
+// ============================================================================
+// RECOVERY AND MIGRATION
+// ============================================================================
+
+// Recount live records after a damaged header (only path that scans the file)
+static void rebuild_header(void) {
+    header_reset();
+
+    uint16_t pages = (file_records + SESSION_INDEX_PAGE_RECORDS - 1) / SESSION_INDEX_PAGE_RECORDS;
+    if(pages > SESSION_INDEX_PAGES) pages = SESSION_INDEX_PAGES;
+
+    for(uint16_t p = 0; p < pages; p++) {
+        SessionIndexPage_t* page = page_get(p);
+        if(!page) break;
+
+        for(uint8_t i = 0; i < SESSION_INDEX_PAGE_RECORDS; i++) {
+            uint16_t session_id = p * SESSION_INDEX_PAGE_RECORDS + i + 1;
+            if(page->records[i].session_id != session_id) continue;
+            index_header.count++;
+            index_header.next_id = session_id + 1;
+        }
+    }
+
+    write_header();
+    FURI_LOG_W(TAG, "Index header rebuilt, %d sessions", index_header.count);
+}
+
+// Copy sessions from the old monolithic index into their record slots
+static void migrate_legacy_index(void) {
+    FileHandle_t* legacy = sd_manager_open_file(SESSION_INDEX_LEGACY_PATH, FILE_TYPE_CONFIG, false);
+    if(!legacy) return;
+
+    uint16_t tail[2] = {0, 0};     // count, current session
+    if(storage_file_seek(legacy->file, SESSION_INDEX_LEGACY_TAIL, true) &&
+       sd_manager_read(legacy, (uint8_t*)tail, sizeof(tail)) &&
+       tail[0] <= MAX_SESSIONS &&
+       storage_file_seek(legacy->file, 0, true)) {
+        SessionInfo_t info;
+        for(uint16_t i = 0; i < tail[0]; i++) {
+            if(!sd_manager_read(legacy, (uint8_t*)&info, sizeof(info))) break;
+            if(session_id_valid(info.session_id)) session_index_put(&info);
+        }
+        index_header.current_session = tail[1];
+        write_header();
+        FURI_LOG_I(TAG, "Migrated %d sessions from legacy index", index_header.count);
+    }
+
+    sd_manager_close_file(legacy);
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+// Open (or create) the index. Reads only the header.
+bool session_index_open(void) {
+    if(index_file) return true;
+
+    cache_reset();
+    memset(&index_stats, 0, sizeof(index_stats));
+
+    index_file = sd_manager_open_rw(SESSION_INDEX_PATH, FILE_TYPE_CONFIG);
+    if(!index_file) {
+        header_reset();
+        return false;
+    }
+
+    uint64_t size = storage_file_size(index_file->file);
+    file_records = (size > sizeof(SessionIndexHeader_t)) ?
+        (uint32_t)((size - sizeof(SessionIndexHeader_t)) / sizeof(SessionInfo_t)) : 0;
+
+    bool loaded = size >= sizeof(SessionIndexHeader_t) &&
+                  storage_file_seek(index_file->file, 0, true) &&
+                  sd_manager_read(index_file, (uint8_t*)&index_header, sizeof(index_header)) &&
+                  header_valid(&index_header);
+
+    if(!loaded) {
+        if(size == 0) {
+            header_reset();
+            write_header();
+            migrate_legacy_index();
+        } else {
+            rebuild_header();
+        }
+    }
+
+    return true;
+}
+
+// Persist the header and release the file
+void session_index_close(void) {
+    if(!index_file) return;
+
+    session_index_sync();
+    sd_manager_close_file(index_file);
+    index_file = NULL;
+    cache_reset();
+}
+
+// Write the header (current session) and flush record updates to the card
+bool session_index_sync(void) {
+    if(!index_file) return false;
+    return write_header() && sd_manager_sync(index_file);
+}
+
+// Session record, NULL if the id is unused
+SessionInfo_t* session_index_get(uint16_t session_id) {
+    if(!index_file || !session_id_valid(session_id)) return NULL;
+
+    SessionInfo_t* record = slot_get(session_id, NULL);
+    return (record && record->session_id == session_id) ? record : NULL;
+}
+
+// Create or update the record at info->session_id
+bool session_index_put(const SessionInfo_t* info) {
+    if(!index_file || !info || !session_id_valid(info->session_id)) return false;
+
+    uint16_t session_id = info->session_id;
+    SessionIndexPage_t* page;
+    SessionInfo_t* record = slot_get(session_id, &page);
+    if(!record) return false;
+
+    bool is_new = record->session_id != session_id;
+    if(record != info) *record = *info;
+
+    if(!write_record(session_id, record)) {
+        // Drop the page so the cache never disagrees with the card
+        page->page = SESSION_INDEX_NO_PAGE;
+        return false;
+    }
+
+    if(is_new) {
+        index_header.count++;
+        if(session_id >= index_header.next_id) index_header.next_id = session_id + 1;
+        write_header();
+    }
+
+    return true;
+}
+
+// Clear the record slot
+bool session_index_remove(uint16_t session_id) {
+    if(!index_file || !session_id_valid(session_id)) return false;
+
+    SessionIndexPage_t* page;
+    SessionInfo_t* record = slot_get(session_id, &page);
+    if(!record || record->session_id != session_id) return false;
+
+    memset(record, 0, sizeof(*record));
+    if(!write_record(session_id, record)) {
+        page->page = SESSION_INDEX_NO_PAGE;
+        return false;
+    }
+
+    index_header.count--;
+    if(index_header.current_session == session_id) index_header.current_session = 0;
+    return write_header();
+}
+
+// Id for a new session (0 when the index is full)
+uint16_t session_index_allocate_id(void) {
+    if(!index_file || index_header.count >= MAX_SESSIONS) return 0;
+    if(index_header.next_id <= MAX_SESSIONS) return index_header.next_id;
+
+    // Ids exhausted: reuse the first slot freed by a delete
+    for(uint16_t session_id = 1; session_id <= MAX_SESSIONS; session_id++) {
+        SessionInfo_t* record = slot_get(session_id, NULL);
+        if(record && record->session_id != session_id) return session_id;
+    }
+
+    return 0;
+}
+
+uint16_t session_index_count(void) {
+    return index_header.count;
+}
+
+uint16_t session_index_current(void) {
+    return index_header.current_session;
+}
+
+// Persisted with the next header write (create/delete or sync)
+void session_index_set_current(uint16_t session_id) {
+    index_header.current_session = session_id;
+}
+
+SessionIndexStats_t session_index_get_stats(void) {
+    return index_stats;
+}
@@ -0,0 +1,71 @@
+#ifndef SESSION_INDEX_H
+#define SESSION_INDEX_H
+
+#include <furi.h>
+#include "sd_manager.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// PAGED SESSION INDEX
+// sessions.idx: header, then one fixed-size SessionInfo_t record per session
+// id at header + (id - 1) * record size, so a session is read or updated in
+// place without touching the rest of the file. Records are read a page at a
+// time into a small LRU cache; startup only reads the header.
+// ============================================================================
+
+#define SESSION_INDEX_PATH          SD_BASE_PATH "/sessions.idx"
+#define SESSION_INDEX_LEGACY_PATH   SD_BASE_PATH "/session_index.bin"   // Monolithic pre-paging index
+#define SESSION_INDEX_MAGIC         0x58444953      // "SIDX"
+#define SESSION_INDEX_VERSION       1
+#define SESSION_INDEX_PAGE_RECORDS  8               // Records read per cache miss
+#define SESSION_INDEX_CACHE_PAGES   4               // Cached pages (LRU)
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;           // sizeof(SessionInfo_t)
+    uint16_t count;                 // Live sessions
+    uint16_t next_id;               // Next never-used session id
+    uint16_t current_session;
+    uint16_t reserved;
+    uint32_t header_crc;            // CRC32 of the header up to this field
+} SessionIndexHeader_t;
+
+typedef struct {
+    uint32_t cache_hits;
+    uint32_t cache_misses;
+    uint32_t record_writes;
+} SessionIndexStats_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Open/close (open migrates a legacy index once)
+bool session_index_open(void);
+void session_index_close(void);
+bool session_index_sync(void);
+
+// Records. get() returns a cache entry that stays valid until the next
+// session_index call; copy it to keep it.
+SessionInfo_t* session_index_get(uint16_t session_id);
+bool session_index_put(const SessionInfo_t* info);
+bool session_index_remove(uint16_t session_id);
+uint16_t session_index_allocate_id(void);
+
+// Header fields
+uint16_t session_index_count(void);
+uint16_t session_index_current(void);
+void session_index_set_current(uint16_t session_id);
+
+// Diagnostics
+SessionIndexStats_t session_index_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SESSION_INDEX_H
@@ -0,0 +1,375 @@
+// Built only for the benchmark (RF_LAB_BENCH); the app build skips this file.
+#ifdef RF_LAB_BENCH
+
+#include "bench_corpus.h"
+#include "../../core/pulse_store.h"
+#include "../../core/math/crc.h"
+
+#define CORPUS_DEVICES              4
+#define CORPUS_MAX_FRAME_PULSES     192             // Longest encoded frame (rolling code)
+#define CORPUS_START_US             1000000
+
+#define NRZ_BIT_US                  1000
+#define PWM_TE_US                   320
+#define MANCHESTER_HALF_US          500
+#define ROLLING_TE_US               400
+#define ROLLING_PREAMBLE_PAIRS      12
+
+typedef struct {
+    BenchSignal_t signal;
+    uint32_t frequency_hz;
+    int16_t rssi_dbm;
+    uint8_t code[4];                // Fixed id / serial (from the seed)
+    uint32_t hop;                   // Rolling code state
+} CorpusDevice_t;
+
+// Merges same-level segments into single pulses and pushes them with jitter
+typedef struct {
+    uint32_t* rng;
+    uint32_t now_us;
+    uint8_t level;
+    uint32_t pending_us;
+    uint32_t last_mark_end_us;
+    uint16_t pushed;
+} PulseWriter_t;
+
+// Static state
+static uint8_t corpus_arena[FRAME_BUFFER_SIZE];
+static PulseBuffer_t corpus_pulses;
+static CorpusDevice_t corpus_devices[CORPUS_DEVICES];
+
+// ============================================================================
+// PRNG
+// ============================================================================
+
+uint32_t bench_rand(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static uint32_t rand_range(uint32_t* rng, uint32_t lo, uint32_t hi) {
+    return lo + bench_rand(rng) % (hi - lo + 1);
+}
+
+// ============================================================================
+// PULSE WRITER
+// ============================================================================
+
+static void writer_flush(PulseWriter_t* w) {
+    if(w->pending_us == 0) return;
+
+    int32_t jitter = (int32_t)(w->pending_us * BENCH_CORPUS_JITTER_PCT / 100);
+    int32_t width = (int32_t)w->pending_us + (int32_t)rand_range(w->rng, 0, 2 * jitter) - jitter;
+    if(width < MIN_PULSE_WIDTH_US) width = MIN_PULSE_WIDTH_US;
+
+    if(pulse_store_push(&corpus_pulses, (uint32_t)width, w->level, w->now_us)) {
+        w->pushed++;
+    }
+    w->now_us += (uint32_t)width;
+    if(w->level) w->last_mark_end_us = w->now_us;
+    w->pending_us = 0;
+}
+
+static void writer_emit(PulseWriter_t* w, uint8_t level, uint32_t width_us) {
+    if(w->pending_us && level != w->level) writer_flush(w);
+    w->level = level;
+    w->pending_us += width_us;
+}
+
+static void writer_mark_space(PulseWriter_t* w, uint32_t mark_us, uint32_t space_us) {
+    writer_emit(w, 1, mark_us);
+    writer_emit(w, 0, space_us);
+}
+
+// ============================================================================
+// ENCODERS (each ends on a space; the inter-frame gap extends it)
+// ============================================================================
+
+static void encode_nrz_byte(PulseWriter_t* w, uint8_t byte) {
+    for(int8_t b = 7; b >= 0; b--) {
+        writer_emit(w, (byte >> b) & 1, NRZ_BIT_US);
+    }
+}
+
+static void encode_ook_nrz(PulseWriter_t* w, const uint8_t* payload, uint8_t len) {
+    encode_nrz_byte(w, 0xAA);
+    encode_nrz_byte(w, 0x2D);
+    encode_nrz_byte(w, 0xD4);
+    for(uint8_t i = 0; i < len; i++) encode_nrz_byte(w, payload[i]);
+    writer_emit(w, 0, NRZ_BIT_US);
+}
+
+static void encode_pwm_fixed(PulseWriter_t* w, const uint8_t* payload, uint8_t len) {
+    for(uint8_t i = 0; i < len; i++) {
+        for(int8_t b = 7; b >= 0; b--) {
+            if((payload[i] >> b) & 1) {
+                writer_mark_space(w, 3 * PWM_TE_US, PWM_TE_US);
+            } else {
+                writer_mark_space(w, PWM_TE_US, 3 * PWM_TE_US);
+            }
+        }
+    }
+    writer_mark_space(w, PWM_TE_US, 31 * PWM_TE_US);    // Sync
+}
+
+static void encode_manchester(PulseWriter_t* w, const uint8_t* payload, uint8_t len) {
+    for(uint8_t i = 0; i <= len; i++) {
+        uint8_t byte = (i == 0) ? 0xAA : payload[i - 1];
+        for(int8_t b = 7; b >= 0; b--) {
+            uint8_t bit = (byte >> b) & 1;
+            writer_emit(w, bit, MANCHESTER_HALF_US);
+            writer_emit(w, !bit, MANCHESTER_HALF_US);
+        }
+    }
+    writer_emit(w, 0, 4 * MANCHESTER_HALF_US);
+}
+
+static void encode_rolling(PulseWriter_t* w, const uint8_t* payload, uint8_t len) {
+    UNUSED(len);
+    for(uint8_t i = 0; i < ROLLING_PREAMBLE_PAIRS; i++) {
+        writer_mark_space(w, ROLLING_TE_US, ROLLING_TE_US);
+    }
+    writer_emit(w, 0, 10 * ROLLING_TE_US);              // Header
+
+    // 66 bits: 8 payload bytes plus the two status bits in byte 8
+    for(uint8_t bit = 0; bit < 66; bit++) {
+        if((payload[bit >> 3] >> (7 - (bit & 7))) & 1) {
+            writer_mark_space(w, ROLLING_TE_US, 2 * ROLLING_TE_US);
+        } else {
+            writer_mark_space(w, 2 * ROLLING_TE_US, ROLLING_TE_US);
+        }
+    }
+    writer_emit(w, 0, 39 * ROLLING_TE_US);              // Guard time
+}
+
+static void encode_noise(PulseWriter_t* w) {
+    uint16_t count = (uint16_t)rand_range(w->rng, 24, 40);
+    for(uint16_t i = 0; i < count; i++) {
+        // Squared uniform: mostly short glitches, some long ones
+        uint32_t r = rand_range(w->rng, 0, 54);
+        writer_emit(w, !(i & 1), 20 + r * r);
+    }
+    writer_emit(w, 0, 2000);
+}
+
+// ============================================================================
+// CORPUS
+// ============================================================================
+
+// Payload of the next press of device d (rolling codes advance per press)
+static uint8_t device_payload(CorpusDevice_t* dev, uint32_t* rng, uint8_t* out) {
+    uint8_t button = (uint8_t)rand_range(rng, 1, 4);
+
+    switch(dev->signal) {
+        case BENCH_SIGNAL_OOK_NRZ:
+            memcpy(out, dev->code, 4);
+            out[4] = button;
+            out[5] = out[0] ^ out[1] ^ out[2] ^ out[3] ^ out[4];
+            return 6;
+
+        case BENCH_SIGNAL_PWM_FIXED:
+            out[0] = dev->code[0];
+            out[1] = dev->code[1];
+            out[2] = (uint8_t)((dev->code[2] & 0xF0) | (1u << (button - 1)));
+            return 3;
+
+        case BENCH_SIGNAL_MANCHESTER:
+            memcpy(out, dev->code, 3);
+            out[3] = button;
+            out[4] = (uint8_t)crc_compute(crc_get_engine(CRC_ENGINE_8_07), 0, 0, out, 4);
+            return 5;
+
+        case BENCH_SIGNAL_ROLLING:
+            // Encrypted hop word changes every press, serial + button stay
+            dev->hop = bench_rand(&dev->hop);
+            out[0] = (uint8_t)(dev->hop >> 24);
+            out[1] = (uint8_t)(dev->hop >> 16);
+            out[2] = (uint8_t)(dev->hop >> 8);
+            out[3] = (uint8_t)dev->hop;
+            memcpy(&out[4], dev->code, 4);
+            out[7] = (uint8_t)((out[7] & 0xF0) | button);
+            out[8] = 0x40;              // Status: battery ok, no repeat
+            return 9;
+
+        default:
+            return 0;
+    }
+}
+
+// Encode one frame and publish it; false once the pulse store cannot hold it
+static bool corpus_add_frame(PulseWriter_t* w, BenchSignal_t signal, const uint8_t* payload,
+                             uint8_t len, uint32_t frequency_hz, int16_t rssi_dbm,
+                             uint32_t gap_us, BenchCorpusStats_t* stats) {
+    if(PULSE_STORE_CAPACITY - pulse_store_count(&corpus_pulses) < CORPUS_MAX_FRAME_PULSES) {
+        return false;
+    }
+
+    Frame_t frame = {0};
+    frame.pulse_start_idx = corpus_pulses.head;
+    frame.timestamp_us = w->now_us;
+    w->pushed = 0;
+
+    switch(signal) {
+        case BENCH_SIGNAL_OOK_NRZ:
+            encode_ook_nrz(w, payload, len);
+            break;
+        case BENCH_SIGNAL_PWM_FIXED:
+            encode_pwm_fixed(w, payload, len);
+            break;
+        case BENCH_SIGNAL_MANCHESTER:
+            encode_manchester(w, payload, len);
+            frame.crc = payload[len - 1];
+            frame.crc_valid = true;
+            break;
+        case BENCH_SIGNAL_ROLLING:
+            encode_rolling(w, payload, len);
+            break;
+        default:
+            encode_noise(w);
+            break;
+    }
+    writer_emit(w, 0, gap_us);
+    writer_flush(w);
+
+    memcpy(frame.data, payload, len);
+    frame.length = len;
+    frame.frequency_hz = frequency_hz;
+    frame.rssi_dbm = (uint16_t)(int16_t)(rssi_dbm + (int16_t)rand_range(w->rng, 0, 6) - 3);
+    frame.pulse_count = w->pushed;
+    frame.duration_us = w->last_mark_end_us - frame.timestamp_us;
+
+    if(!session_store_append_frame(&frame)) return false;
+
+    stats->frames++;
+    stats->frames_by_signal[signal]++;
+    stats->payload_bytes += len;
+    return true;
+}
+
+void bench_corpus_build(uint32_t seed, BenchCorpusStats_t* stats) {
+    static const BenchSignal_t signals[CORPUS_DEVICES] = {
+        BENCH_SIGNAL_OOK_NRZ, BENCH_SIGNAL_PWM_FIXED, BENCH_SIGNAL_MANCHESTER, BENCH_SIGNAL_ROLLING,
+    };
+    static const uint32_t frequencies[CORPUS_DEVICES] = {
+        868350000, 433920000, 315000000, 433920000,
+    };
+    static const int16_t rssi[CORPUS_DEVICES] = {-72, -58, -81, -64};
+
+    uint32_t rng = seed ? seed : BENCH_CORPUS_SEED;
+    memset(stats, 0, sizeof(*stats));
+
+    for(uint8_t d = 0; d < CORPUS_DEVICES; d++) {
+        CorpusDevice_t* dev = &corpus_devices[d];
+        dev->signal = signals[d];
+        dev->frequency_hz = frequencies[d];
+        dev->rssi_dbm = rssi[d];
+        uint32_t code = bench_rand(&rng);
+        memcpy(dev->code, &code, 4);
+        dev->hop = bench_rand(&rng) | 1;
+    }
+
+    pulse_store_reset(&corpus_pulses);
+    session_store_init(corpus_arena, sizeof(corpus_arena), &corpus_pulses);
+
+    PulseWriter_t writer = {.rng = &rng, .now_us = CORPUS_START_US};
+    uint8_t payload[16];
+    bool room = true;
+
+    while(room && stats->frames < BENCH_CORPUS_MAX_FRAMES) {
+        // One in five presses is replaced by a noise burst
+        uint32_t pick = rand_range(&rng, 0, CORPUS_DEVICES);
+        if(pick == CORPUS_DEVICES) {
+            uint8_t len = (uint8_t)rand_range(&rng, 2, 8);
+            for(uint8_t i = 0; i < len; i++) payload[i] = (uint8_t)bench_rand(&rng);
+            room = corpus_add_frame(&writer, BENCH_SIGNAL_NOISE, payload, len, 433920000, -95,
+                                    rand_range(&rng, 20000, 120000), stats);
+            continue;
+        }
+
+        CorpusDevice_t* dev = &corpus_devices[pick];
+        uint8_t len = device_payload(dev, &rng, payload);
+        for(uint8_t r = 0; r < BENCH_CORPUS_REPEATS && room; r++) {
+            uint32_t gap = (r + 1 < BENCH_CORPUS_REPEATS) ? rand_range(&rng, 8000, 12000) :
+                                                             rand_range(&rng, 80000, 250000);
+            room = corpus_add_frame(&writer, dev->signal, payload, len, dev->frequency_hz,
+                                    dev->rssi_dbm, gap, stats) &&
+                   stats->frames < BENCH_CORPUS_MAX_FRAMES;
+        }
+    }
+
+    stats->pulses = pulse_store_count(&corpus_pulses);
+    for(uint16_t i = 0; i < stats->pulses; i++) {
+        if(pulse_unpack_duration(pulse_store_word(&corpus_pulses, i)) > MAX_PULSE_WIDTH_US) {
+            stats->long_gaps++;
+        }
+    }
+    stats->duration_us = writer.now_us - CORPUS_START_US;
+}
+
+const char* bench_corpus_signal_name(BenchSignal_t signal) {
+    static const char* names[BENCH_SIGNAL_COUNT] = {
+        "ook_nrz", "pwm_fixed", "manchester", "rolling", "noise",
+    };
+    return (signal < BENCH_SIGNAL_COUNT) ? names[signal] : "?";
+}
+
+uint32_t bench_corpus_capture_bytes(uint8_t* out, uint32_t max_len) {
+    SessionPulseView_t pulses = session_store_pulses();
+    uint32_t len = 0;
+    for(uint16_t i = 0; i < pulses.count && len + 2 <= max_len; i++) {
+        uint16_t word = session_pulse_word(&pulses, i);
+        out[len++] = (uint8_t)word;
+        out[len++] = (uint8_t)(word >> 8);
+    }
+    return len;
+}
+
+static uint32_t put_le(uint8_t* out, uint32_t value, uint8_t bytes) {
+    for(uint8_t b = 0; b < bytes; b++) out[b] = (uint8_t)(value >> (8 * b));
+    return bytes;
+}
+
+uint32_t bench_corpus_frame_bytes(uint8_t* out, uint32_t max_len) {
+    SessionFrameView_t frames = session_store_frames();
+    uint32_t len = 0;
+    for(uint16_t i = 0; i < frames.count; i++) {
+        const SessionFrameMeta_t* meta = session_frame_meta(&frames, i);
+        if(len + 15 + meta->length > max_len) break;
+        len += put_le(&out[len], meta->timestamp_us, 4);
+        len += put_le(&out[len], meta->frequency_hz, 4);
+        len += put_le(&out[len], meta->duration_us, 4);
+        len += put_le(&out[len], meta->rssi_dbm, 2);
+        out[len++] = meta->length;
+        memcpy(&out[len], session_frame_payload(&frames, i), meta->length);
+        len += meta->length;
+    }
+    return len;
+}
+
+uint16_t bench_corpus_frame_pulses(uint16_t i, Pulse_t* out, uint16_t max_pulses) {
+    SessionFrameView_t frames = session_store_frames();
+    if(i >= frames.count) return 0;
+
+    SessionPulseView_t pulses = session_frame_pulses(&frames, i);
+    PulseCursor_t cursor;
+    session_pulse_cursor(&pulses, &cursor);
+
+    uint16_t n = 0;
+    while(n < max_pulses && pulse_cursor_next(&cursor, &out[n])) n++;
+    return n;
+}
+
+void bench_corpus_intervals(uint32_t seed, uint32_t* out, uint16_t count) {
+    uint32_t rng = seed ? seed : BENCH_CORPUS_SEED;
+    uint32_t period = 40000;
+    for(uint16_t i = 0; i < count; i++) {
+        if((i & 63) == 63) period += 3;                 // ~75 ppm per 64 repeats
+        out[i] = period + rand_range(&rng, 0, 300) - 150;
+    }
+}
+
+#endif // RF_LAB_BENCH
@@ -0,0 +1,72 @@
+#ifndef BENCH_CORPUS_H
+#define BENCH_CORPUS_H
+
+#include "../../core/flipper_rf_lab.h"
+#include "../../core/session_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// SYNTHETIC RF CAPTURE CORPUS
+// Reproducible session built from a fixed seed: button presses of four
+// keyfob families (OOK NRZ, PWM fixed code, Manchester with CRC-8, KeeLoq
+// style rolling code) interleaved with noise bursts. Each press repeats its
+// frame a few times like a real remote. Pulse widths carry +-6% jitter.
+//
+// Frames and pulses go through the real session store, so the kernels see
+// the same views as on the device.
+// ============================================================================
+
+#define BENCH_CORPUS_SEED           0x5EED1234U
+#define BENCH_CORPUS_MAX_FRAMES     120
+#define BENCH_CORPUS_REPEATS        3               // Frames per button press
+#define BENCH_CORPUS_JITTER_PCT     6
+
+typedef enum {
+    BENCH_SIGNAL_OOK_NRZ = 0,       // 1 kbps NRZ, 0xAA preamble, 0x2DD4 sync
+    BENCH_SIGNAL_PWM_FIXED,         // EV1527: 20-bit id + 4-bit key, 320 us te
+    BENCH_SIGNAL_MANCHESTER,        // 500 us half-bit, 4 bytes + CRC-8
+    BENCH_SIGNAL_ROLLING,           // KeeLoq: 32-bit hop + 34 fixed bits, 400 us te
+    BENCH_SIGNAL_NOISE,             // Random widths 20-3000 us, no structure
+    BENCH_SIGNAL_COUNT
+} BenchSignal_t;
+
+typedef struct {
+    uint16_t frames;
+    uint16_t pulses;
+    uint16_t long_gaps;             // Pulses longer than MAX_PULSE_WIDTH_US (coarse form)
+    uint16_t frames_by_signal[BENCH_SIGNAL_COUNT];
+    uint32_t payload_bytes;
+    uint32_t duration_us;           // First pulse to last pulse
+} BenchCorpusStats_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Deterministic PRNG (xorshift32; state must be non-zero)
+uint32_t bench_rand(uint32_t* state);
+
+// (Re)build the session store from seed. Same seed -> identical session.
+void bench_corpus_build(uint32_t seed, BenchCorpusStats_t* stats);
+const char* bench_corpus_signal_name(BenchSignal_t signal);
+
+// Packed pulse words of the session, little endian (SD capture layout)
+uint32_t bench_corpus_capture_bytes(uint8_t* out, uint32_t max_len);
+
+// Frame records (timestamp, frequency, duration, RSSI, length, payload)
+uint32_t bench_corpus_frame_bytes(uint8_t* out, uint32_t max_len);
+
+// Up to max_pulses pulses of frame i
+uint16_t bench_corpus_frame_pulses(uint16_t i, Pulse_t* out, uint16_t max_pulses);
+
+// Repeat intervals (us) of a remote whose clock drifts slowly
+void bench_corpus_intervals(uint32_t seed, uint32_t* out, uint16_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BENCH_CORPUS_H
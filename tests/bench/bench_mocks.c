@@ -0,0 +1,94 @@
+// Host stand-ins for the firmware services the benchmarked modules link
+// against. There is no SD card: every open fails, so the fingerprint
+// database starts empty and exports are skipped.
+
+// Host benchmark only; the app and on-device benchmark link the real services.
+#if defined(RF_LAB_BENCH) && !defined(BENCH_ON_DEVICE)
+
+#include <time.h>
+#include "../../storage/sd_manager.h"
+#include "../../core/math/crc.h"
+
+// ============================================================================
+// FURI
+// ============================================================================
+
+uint32_t furi_get_tick(void) {
+    static struct timespec start;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(start.tv_sec == 0 && start.tv_nsec == 0) start = now;
+    return (uint32_t)((now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1000000);
+}
+
+// ============================================================================
+// SD MANAGER (no card)
+// ============================================================================
+
+bool sd_manager_is_card_present(void) {
+    return false;
+}
+
+FileHandle_t* sd_manager_open_file(const char* path, FileType_t type, bool write) {
+    UNUSED(path);
+    UNUSED(type);
+    UNUSED(write);
+    return NULL;
+}
+
+FileHandle_t* sd_manager_open_append(const char* path, FileType_t type) {
+    UNUSED(path);
+    UNUSED(type);
+    return NULL;
+}
+
+void sd_manager_close_file(FileHandle_t* handle) {
+    UNUSED(handle);
+}
+
+bool sd_manager_write(FileHandle_t* handle, const uint8_t* data, uint32_t len) {
+    UNUSED(handle);
+    UNUSED(data);
+    UNUSED(len);
+    return false;
+}
+
+bool sd_manager_read(FileHandle_t* handle, uint8_t* data, uint32_t len) {
+    UNUSED(handle);
+    UNUSED(data);
+    UNUSED(len);
+    return false;
+}
+
+uint32_t sd_manager_read_upto(FileHandle_t* handle, uint8_t* data, uint32_t len) {
+    UNUSED(handle);
+    UNUSED(data);
+    UNUSED(len);
+    return 0;
+}
+
+bool sd_manager_sync(FileHandle_t* handle) {
+    UNUSED(handle);
+    return false;
+}
+
+bool sd_manager_replace_file(const char* src, const char* dst, const char* backup) {
+    UNUSED(src);
+    UNUSED(dst);
+    UNUSED(backup);
+    return false;
+}
+
+// threat_model.c calls this without a prototype in scope
+bool sd_manager_export_report(const void* assessment, const char* filename) {
+    UNUSED(assessment);
+    UNUSED(filename);
+    return false;
+}
+
+// Same engine as storage/sd_manager.c so block CRCs match the device
+uint32_t sd_manager_crc32(uint32_t crc, const void* data, uint32_t len) {
+    return ~crc_update(crc_get_engine(CRC_ENGINE_32_REF), ~crc, data, len);
+}
+
+#endif // RF_LAB_BENCH
@@ -0,0 +1,941 @@
+// Benchmark Runner for Flipper RF Lab
+// Times the real compression and analysis kernels on the synthetic corpus.
+//
+// After timing, every codec and CRC engine is checked against its own output
+// (round trips, known check values); a mismatch fails the run.
+//
+// Host build (default): ns per item, stack high-water mark of each kernel
+// (painted pthread stack) and static RAM of its module (read from the
+// executable's symbol table), compared against a stored baseline.
+// Device build (-DBENCH_ON_DEVICE): DWT cycles per item, stack measured on
+// a FuriThread, results on the log console. See README.md.
+
+// Built only for the benchmark (RF_LAB_BENCH); the app build skips this file.
+#ifdef RF_LAB_BENCH
+
+#include "bench_corpus.h"
+#include "../../storage/compression.h"
+#include "../../analysis/clustering.h"
+#include "../../analysis/threat_model.h"
+#include "../../analysis/protocol_infer.h"
+#include "../../analysis/fingerprinting.h"
+#include "../../core/math/fixed_point.h"
+#include "../../core/math/dsp.h"
+#include "../../core/math/statistics.h"
+#include "../../core/math/crc.h"
+
+#ifdef BENCH_ON_DEVICE
+#include "../../core/hal/timer_precision.h"
+#else
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <elf.h>
+#endif
+
+#define TAG "BENCH"
+
+#define BENCH_REPEATS           7               // Timed rounds (best run per kernel is kept)
+#define BENCH_BLOCKS            8               // 1 KB capture blocks for the block codecs
+#define BENCH_FRAME_BLOCKS      2               // ... of which hold frame records
+#define BENCH_DTW_PAIRS         32
+#define BENCH_INTERVALS         1024            // fingerprinting_calc_statistics input
+#define BENCH_KMEANS_K          4
+#define BENCH_DSP_SAMPLES       4096            // Envelope samples for the Q15 kernels
+#define BENCH_DSP_SAMPLE_US     50              // Envelope sample period
+#define BENCH_DSP_TAPS          DSP_FIR_MAX_TAPS
+#define BENCH_DSP_PREAMBLE      64              // Correlation template length
+#define BENCH_PULSE_OUTPUT      (PULSE_STORE_CAPACITY * 3)
+#define BENCH_MAX_RESULTS       24
+#define BENCH_CRC_CHECK_INPUT   "123456789"     // Input of the catalogued CRC check values
+
+#ifdef BENCH_ON_DEVICE
+#define BENCH_MIN_RUN           3200000         // Cycles per timed run (50 ms at 64 MHz)
+#define BENCH_STACK_SIZE        4096            // Same as the analysis worker
+#define BENCH_TIME_UNIT         "cyc"
+#else
+#define BENCH_MIN_RUN           20000000        // ns per timed run
+#define BENCH_STACK_SIZE        (256 * 1024)
+#define BENCH_STACK_PAINT       0xA5
+#define BENCH_TIME_UNIT         "ns"
+#define BENCH_DEFAULT_THRESHOLD 20              // Percent
+#endif
+
+typedef struct {
+    const char* name;
+    const char* module;             // Source file holding the kernel's static state
+    const char* unit;               // What one item is
+    void (*setup)(void);            // Untimed preparation, may be NULL
+    uint32_t (*run)(void);          // One pass, returns items processed
+} BenchKernel_t;
+
+typedef struct {
+    const char* name;
+    bool (*check)(void);            // True when the output matches
+} BenchCheck_t;
+
+typedef struct {
+    const BenchKernel_t* kernel;
+    uint32_t items;                 // Per pass
+    uint32_t passes;                // Per timed run
+    double time_per_item;           // ns (host) or cycles (device), best run
+    double items_per_sec;
+    uint32_t stack_bytes;           // Peak stack of one pass
+    uint32_t static_bytes;          // Writable static data of the module
+} BenchResult_t;
+
+// Corpus views and kernel buffers
+static BenchCorpusStats_t corpus;
+static uint8_t capture_bytes[BENCH_BLOCKS * COMPRESSION_MAX_BLOCK_SIZE];
+static uint8_t block_output[BENCH_BLOCKS][COMPRESSION_BLOCK_MAX_OUTPUT];
+static uint32_t block_output_len[BENCH_BLOCKS];
+static uint32_t block_crc[BENCH_BLOCKS];
+static uint8_t block_scratch[COMPRESSION_BLOCK_MAX_OUTPUT];
+static uint8_t pulse_output[BENCH_PULSE_OUTPUT];
+static uint16_t pulse_centers[PULSE_CODEC_MAX_CLUSTERS];
+static uint8_t pulse_center_count = 0;
+static DataPoint_t kmeans_points[CLUSTERING_STREAM_CAPACITY];
+static Pulse_t dtw_pulses[2 * BENCH_DTW_PAIRS][DTW_MAX_LENGTH];
+static uint16_t dtw_counts[2 * BENCH_DTW_PAIRS];
+static uint32_t interval_data[BENCH_INTERVALS];
+static uint32_t interval_scratch[BENCH_INTERVALS];
+static RFFingerprint_t fingerprint;
+static q15_t dsp_samples[BENCH_DSP_SAMPLES];
+static q15_t dsp_output[BENCH_DSP_SAMPLES];
+static int32_t dsp_corr[BENCH_DSP_SAMPLES];
+static DspFirQ15_t dsp_fir;
+static volatile uint32_t bench_sink;    // Keeps results observable
+
+// Verification buffers
+static uint8_t verify_encoded[COMPRESSION_BLOCK_MAX_OUTPUT];
+static uint8_t verify_decoded[COMPRESSION_BLOCK_MAX_OUTPUT];
+static HuffmanState_t verify_huffman;
+static HuffmanState_t verify_huffman_loaded;
+static PulseBuffer_t verify_pulses;
+static Pulse_t verify_sequence[DTW_MAX_LENGTH];
+
+static BenchResult_t results[BENCH_MAX_RESULTS];
+static uint8_t result_count = 0;
+
+// ============================================================================
+// KERNELS
+// ============================================================================
+
+// Pulse capture blocks (dense, jittery) followed by frame records (repetitive)
+static void setup_blocks(void) {
+    uint32_t split = (BENCH_BLOCKS - BENCH_FRAME_BLOCKS) * COMPRESSION_MAX_BLOCK_SIZE;
+    bench_corpus_capture_bytes(capture_bytes, split);
+    bench_corpus_frame_bytes(&capture_bytes[split], sizeof(capture_bytes) - split);
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        compression_compress_block(&capture_bytes[b * COMPRESSION_MAX_BLOCK_SIZE],
+                                   COMPRESSION_MAX_BLOCK_SIZE, block_output[b],
+                                   &block_output_len[b], &block_crc[b]);
+    }
+}
+
+static uint32_t run_compress_block(void) {
+    uint32_t crc = 0;
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t len = 0;
+        compression_compress_block(&capture_bytes[b * COMPRESSION_MAX_BLOCK_SIZE],
+                                   COMPRESSION_MAX_BLOCK_SIZE, block_scratch, &len, &crc);
+        bench_sink += len;
+    }
+    return BENCH_BLOCKS * COMPRESSION_MAX_BLOCK_SIZE;
+}
+
+static uint32_t run_decompress_block(void) {
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t len = 0;
+        compression_decompress_block(block_output[b], block_output_len[b], block_scratch, &len,
+                                     block_crc[b]);
+        bench_sink += len;
+    }
+    return BENCH_BLOCKS * COMPRESSION_MAX_BLOCK_SIZE;
+}
+
+static uint32_t run_lz77_encode(void) {
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        bench_sink += lz77_encode(&capture_bytes[b * COMPRESSION_MAX_BLOCK_SIZE],
+                                  COMPRESSION_MAX_BLOCK_SIZE, block_scratch, 0, 0);
+    }
+    return BENCH_BLOCKS * COMPRESSION_MAX_BLOCK_SIZE;
+}
+
+static void setup_pulse_codec(void) {
+    SessionPulseView_t pulses = session_store_pulses();
+    protocol_infer_reset();
+    protocol_infer_stream_pulses(&pulses);
+    pulse_center_count = protocol_infer_get_cluster_centers(pulse_centers,
+                                                            PULSE_CODEC_MAX_CLUSTERS);
+}
+
+static uint32_t run_compress_pulse_store(void) {
+    SessionPulseView_t pulses = session_store_pulses();
+    uint16_t start = (uint16_t)(pulses.first - pulses.pulses->tail);
+    bench_sink += compress_pulse_store(pulses.pulses, start, pulses.count, pulse_centers,
+                                       pulse_center_count, 0, pulse_output, sizeof(pulse_output));
+    return pulses.count;
+}
+
+static uint32_t run_kmeans(void) {
+    SessionPulseView_t pulses = session_store_pulses();
+    Dataset_t data;
+    clustering_dataset_init(&data, kmeans_points, CLUSTERING_STREAM_CAPACITY);
+    uint16_t points = clustering_dataset_from_pulses(&data, &pulses);
+    KMeansResult_t result = clustering_kmeans(&data, BENCH_KMEANS_K);
+    bench_sink += result.iterations;
+    return points;
+}
+
+static void setup_dtw(void) {
+    for(uint16_t i = 0; i < 2 * BENCH_DTW_PAIRS; i++) {
+        dtw_counts[i] = bench_corpus_frame_pulses(i % corpus.frames, dtw_pulses[i],
+                                                  DTW_MAX_LENGTH);
+    }
+}
+
+static uint32_t run_dtw_distance(void) {
+    for(uint16_t p = 0; p < BENCH_DTW_PAIRS; p++) {
+        bench_sink += (uint32_t)clustering_dtw_distance(dtw_pulses[2 * p], dtw_counts[2 * p],
+                                                        dtw_pulses[2 * p + 1],
+                                                        dtw_counts[2 * p + 1]);
+    }
+    return BENCH_DTW_PAIRS;
+}
+
+static uint32_t run_threat_assess(void) {
+    SessionFrameView_t frames = session_store_frames();
+    threat_model_start_analysis();
+    threat_model_set_frames(&frames);
+    threat_model_assess_vulnerabilities();
+    bench_sink += threat_model_calculate_vulnerability_score();
+    return frames.count;
+}
+
+static uint32_t run_infer_stream_pulses(void) {
+    SessionPulseView_t pulses = session_store_pulses();
+    protocol_infer_reset();
+    return protocol_infer_stream_pulses(&pulses);
+}
+
+static uint32_t run_infer_session(void) {
+    SessionPulseView_t pulses = session_store_pulses();
+    SessionFrameView_t frames = session_store_frames();
+    protocol_infer_reset();
+    protocol_infer_stream_pulses(&pulses);
+    protocol_infer_stream_frames(&frames);
+    protocol_infer_refresh_hypothesis();
+    bench_sink += protocol_infer_get_confidence();
+    return frames.count;
+}
+
+static uint32_t run_fingerprint(void) {
+    SessionFrameView_t frames = session_store_frames();
+    fingerprinting_start_capture();
+    fingerprinting_process_frames(&frames);
+    fingerprinting_generate_fingerprint(&fingerprint);
+    bench_sink += fingerprinting_calculate_hash(&fingerprint);
+    return frames.count;
+}
+
+static void setup_intervals(void) {
+    bench_corpus_intervals(BENCH_CORPUS_SEED, interval_data, BENCH_INTERVALS);
+}
+
+static uint32_t run_fp_statistics(void) {
+    StatisticalSummary_t stats;
+    fingerprinting_calc_statistics(interval_data, BENCH_INTERVALS, &stats);
+    bench_sink += stats.median;
+    return BENCH_INTERVALS;
+}
+
+// Demodulated envelope of the corpus frames: +-12000 with a little noise
+static void setup_dsp(void) {
+    Pulse_t pulses[DTW_MAX_LENGTH];
+    uint32_t noise = BENCH_CORPUS_SEED;
+    uint32_t n = 0;
+
+    for(uint16_t f = 0; n < BENCH_DSP_SAMPLES; f = (f + 1) % corpus.frames) {
+        uint16_t count = bench_corpus_frame_pulses(f, pulses, DTW_MAX_LENGTH);
+        for(uint16_t p = 0; p < count && n < BENCH_DSP_SAMPLES; p++) {
+            uint32_t len = (pulses[p].width_us + BENCH_DSP_SAMPLE_US / 2) / BENCH_DSP_SAMPLE_US;
+            for(uint32_t i = 0; i < len && n < BENCH_DSP_SAMPLES; i++) {
+                noise ^= noise << 13;
+                noise ^= noise >> 17;
+                noise ^= noise << 5;
+                dsp_samples[n++] = (q15_t)((pulses[p].level ? 12000 : -12000) +
+                                           (int32_t)(noise & 0x7FF) - 0x400);
+            }
+        }
+    }
+
+    // Triangular low-pass, unity DC gain
+    q15_t coeffs[BENCH_DSP_TAPS];
+    int32_t sum = 0;
+    for(uint16_t i = 0; i < BENCH_DSP_TAPS; i++) {
+        sum += (i < BENCH_DSP_TAPS / 2) ? i + 1 : BENCH_DSP_TAPS - i;
+    }
+    for(uint16_t i = 0; i < BENCH_DSP_TAPS; i++) {
+        int32_t w = (i < BENCH_DSP_TAPS / 2) ? i + 1 : BENCH_DSP_TAPS - i;
+        coeffs[i] = (q15_t)(w * Q15_MAX / sum);
+    }
+    dsp_fir_q15_init(&dsp_fir, coeffs, BENCH_DSP_TAPS);
+}
+
+static uint32_t run_dsp_fir(void) {
+    dsp_fir_q15_reset(&dsp_fir);
+    dsp_fir_q15_block(&dsp_fir, dsp_samples, dsp_output, BENCH_DSP_SAMPLES);
+    bench_sink += (uint16_t)dsp_output[BENCH_DSP_SAMPLES - 1];
+    return BENCH_DSP_SAMPLES;
+}
+
+static uint32_t run_dsp_correlate(void) {
+    uint32_t lags = dsp_correlate_q15(dsp_samples, BENCH_DSP_SAMPLES, dsp_samples,
+                                      BENCH_DSP_PREAMBLE, dsp_corr);
+    bench_sink += (uint32_t)dsp_corr[lags / 2];
+    return lags;
+}
+
+static uint32_t run_fixed_sqrt(void) {
+    for(uint16_t i = 0; i < BENCH_INTERVALS; i++) {
+        bench_sink += (uint32_t)fixed_sqrt((fixed_t)(interval_data[i] << 8));
+    }
+    return BENCH_INTERVALS;
+}
+
+static uint32_t run_fixed_sincos(void) {
+    for(uint16_t i = 0; i < BENCH_INTERVALS; i++) {
+        fixed_t angle = (fixed_t)(interval_data[i] << 4) - INT_TO_FIXED(100);
+        bench_sink += (uint32_t)(fixed_sin(angle) + fixed_cos(angle));
+    }
+    return BENCH_INTERVALS;
+}
+
+static uint32_t run_median_select(void) {
+    memcpy(interval_scratch, interval_data, sizeof(interval_scratch));
+    bench_sink += stats_median_u32(interval_scratch, BENCH_INTERVALS);
+    return BENCH_INTERVALS;
+}
+
+static uint32_t run_empty(void) {
+    return 1;
+}
+
+static const BenchKernel_t bench_kernels[] = {
+    {"compress_block", "compression.c", "B", setup_blocks, run_compress_block},
+    {"decompress_block", "compression.c", "B", setup_blocks, run_decompress_block},
+    {"lz77_encode", "compression.c", "B", setup_blocks, run_lz77_encode},
+    {"compress_pulses", "compression.c", "pulse", setup_pulse_codec, run_compress_pulse_store},
+    {"kmeans", "clustering.c", "point", NULL, run_kmeans},
+    {"dtw_distance", "clustering.c", "pair", setup_dtw, run_dtw_distance},
+    {"threat_assess", "threat_model.c", "frame", NULL, run_threat_assess},
+    {"infer_pulses", "protocol_infer.c", "pulse", NULL, run_infer_stream_pulses},
+    {"infer_session", "protocol_infer.c", "frame", NULL, run_infer_session},
+    {"fingerprint", "fingerprinting.c", "frame", NULL, run_fingerprint},
+    {"fp_statistics", "fingerprinting.c", "value", setup_intervals, run_fp_statistics},
+    {"median_select", "statistics.c", "value", setup_intervals, run_median_select},
+    {"dsp_fir", "dsp.c", "sample", setup_dsp, run_dsp_fir},
+    {"dsp_correlate", "dsp.c", "lag", setup_dsp, run_dsp_correlate},
+    {"fixed_sqrt", "fixed_point.c", "value", setup_intervals, run_fixed_sqrt},
+    {"fixed_sincos", "fixed_point.c", "angle", setup_intervals, run_fixed_sincos},
+};
+
+#define BENCH_KERNEL_COUNT (sizeof(bench_kernels) / sizeof(bench_kernels[0]))
+
+static const BenchKernel_t bench_empty_kernel = {"empty", NULL, "call", NULL, run_empty};
+
+// ============================================================================
+// VERIFICATION
+// ============================================================================
+
+static const uint8_t* verify_block(uint8_t b) {
+    return &capture_bytes[b * COMPRESSION_MAX_BLOCK_SIZE];
+}
+
+// Container (adaptive algorithm + CRC-32) back to the original block
+static bool check_block_codec(void) {
+    setup_blocks();
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t len = 0;
+        if(!compression_decompress_block(block_output[b], block_output_len[b], verify_decoded,
+                                         &len, block_crc[b]) ||
+           len != COMPRESSION_MAX_BLOCK_SIZE ||
+           memcmp(verify_decoded, verify_block(b), len) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Dense pulse blocks may not fit; the repetitive frame blocks must
+static bool check_lz77(void) {
+    setup_blocks();
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        uint32_t len = lz77_encode(verify_block(b), COMPRESSION_MAX_BLOCK_SIZE, verify_encoded,
+                                   0, 0);
+        if(len == 0 && b < BENCH_BLOCKS - BENCH_FRAME_BLOCKS) continue;
+        if(len == 0 || lz77_decode(verify_encoded, len, verify_decoded) !=
+                           COMPRESSION_MAX_BLOCK_SIZE ||
+           memcmp(verify_decoded, verify_block(b), COMPRESSION_MAX_BLOCK_SIZE) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Decoded with the table as stored on SD, not the encoder's state
+static bool check_huffman(void) {
+    setup_blocks();
+    for(uint8_t b = 0; b < BENCH_BLOCKS; b++) {
+        huffman_init(&verify_huffman);
+        huffman_build_tree(&verify_huffman, verify_block(b), COMPRESSION_MAX_BLOCK_SIZE);
+        huffman_generate_codes(&verify_huffman);
+        uint32_t len = huffman_encode(&verify_huffman, verify_block(b), COMPRESSION_MAX_BLOCK_SIZE,
+                                      verify_encoded);
+        if(len == 0 && b < BENCH_BLOCKS - BENCH_FRAME_BLOCKS) continue;
+
+        uint8_t table[HUFFMAN_TABLE_MAX_BYTES];
+        uint32_t table_len = 0;
+        huffman_save_tree(&verify_huffman, table, &table_len);
+        if(len == 0 || !huffman_load_tree(&verify_huffman_loaded, table, table_len) ||
+           huffman_decode(&verify_huffman_loaded, verify_encoded, len, verify_decoded) !=
+               COMPRESSION_MAX_BLOCK_SIZE ||
+           memcmp(verify_decoded, verify_block(b), COMPRESSION_MAX_BLOCK_SIZE) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whole session through the store codec (residual_shift 0 is lossless).
+// Packed words must match exactly, including the coarse inter-press gaps
+// beyond MAX_PULSE_WIDTH_US. Only the first timestamp is carried, so every
+// later one must equal it plus the full durations before it.
+static bool check_pulse_store_codec(void) {
+    if(corpus.long_gaps == 0) return false;     // Nothing would exercise the escapes
+    setup_pulse_codec();
+    SessionPulseView_t pulses = session_store_pulses();
+    uint16_t start = (uint16_t)(pulses.first - pulses.pulses->tail);
+    uint32_t len = compress_pulse_store(pulses.pulses, start, pulses.count, pulse_centers,
+                                        pulse_center_count, 0, pulse_output, sizeof(pulse_output));
+
+    pulse_store_reset(&verify_pulses);
+    if(len == 0 || decompress_pulse_store(pulse_output, len, &verify_pulses) != pulses.count ||
+       pulse_store_timestamp(&verify_pulses, 0) != session_pulse_timestamp(&pulses, 0)) {
+        return false;
+    }
+    uint32_t timestamp = session_pulse_timestamp(&pulses, 0);
+    for(uint16_t i = 0; i < pulses.count; i++) {
+        uint16_t word = session_pulse_word(&pulses, i);
+        if(pulse_store_word(&verify_pulses, i) != word ||
+           pulse_store_timestamp(&verify_pulses, i) != timestamp) {
+            return false;
+        }
+        timestamp += pulse_unpack_duration(word);
+    }
+    return true;
+}
+
+// Per-frame pulse arrays with codec-chosen clusters
+static bool check_pulse_sequence_codec(void) {
+    setup_dtw();
+    for(uint16_t f = 0; f < 2 * BENCH_DTW_PAIRS; f++) {
+        uint16_t count = dtw_counts[f];
+        uint32_t len = compress_pulse_sequence(dtw_pulses[f], count, pulse_output,
+                                               sizeof(pulse_output));
+        if(count == 0) continue;
+        if(len == 0 ||
+           decompress_pulse_sequence(pulse_output, len, verify_sequence, DTW_MAX_LENGTH) != count) {
+            return false;
+        }
+        for(uint16_t i = 0; i < count; i++) {
+            if(verify_sequence[i].width_us != dtw_pulses[f][i].width_us ||
+               verify_sequence[i].level != (dtw_pulses[f][i].level ? 1 : 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Catalogued check values over "123456789", then every table (and the
+// slice-by-4 path) against the bitwise engine on capture data
+static bool check_crc_engines(void) {
+    static const struct {
+        CrcEngineId_t id;
+        uint32_t init;
+        uint32_t xor_out;
+        uint32_t check;
+    } vectors[] = {
+        {CRC_ENGINE_8_07, 0x00, 0x00, 0xF4},                              // CRC-8/SMBUS
+        {CRC_ENGINE_16_8005_REF, 0x0000, 0x0000, 0xBB3D},                 // CRC-16/ARC
+        {CRC_ENGINE_16_1021_REF, 0x0000, 0x0000, 0x2189},                 // CRC-16/KERMIT
+        {CRC_ENGINE_32_REF, 0xFFFFFFFF, 0xFFFFFFFF, 0xCBF43926},          // CRC-32
+        {CRC_ENGINE_32_NORMAL, 0xFFFFFFFF, 0x00000000, 0x0376E6E7},       // CRC-32/MPEG-2
+    };
+    const uint8_t* input = (const uint8_t*)BENCH_CRC_CHECK_INPUT;
+    uint32_t input_len = sizeof(BENCH_CRC_CHECK_INPUT) - 1;
+
+    setup_blocks();
+    for(uint8_t v = 0; v < sizeof(vectors) / sizeof(vectors[0]); v++) {
+        const CrcEngine_t* engine = crc_get_engine(vectors[v].id);
+        if(!engine || crc_compute(engine, vectors[v].init, vectors[v].xor_out, input,
+                                  input_len) != vectors[v].check) {
+            return false;
+        }
+
+        CrcEngine_t bitwise = *engine;
+        bitwise.table = NULL;
+        bitwise.sliced = false;
+        for(uint32_t len = 1; len <= 7; len++) {
+            if(crc_compute(engine, vectors[v].init, vectors[v].xor_out, capture_bytes, len) !=
+               crc_compute(&bitwise, vectors[v].init, vectors[v].xor_out, capture_bytes, len)) {
+                return false;
+            }
+        }
+        if(crc_compute(engine, vectors[v].init, vectors[v].xor_out, capture_bytes,
+                       sizeof(capture_bytes)) !=
+           crc_compute(&bitwise, vectors[v].init, vectors[v].xor_out, capture_bytes,
+                       sizeof(capture_bytes))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const BenchCheck_t bench_checks[] = {
+    {"block_roundtrip", check_block_codec},
+    {"lz77_roundtrip", check_lz77},
+    {"huffman_roundtrip", check_huffman},
+    {"pulse_store_roundtrip", check_pulse_store_codec},
+    {"pulse_seq_roundtrip", check_pulse_sequence_codec},
+    {"crc_check_values", check_crc_engines},
+};
+
+#define BENCH_CHECK_COUNT (sizeof(bench_checks) / sizeof(bench_checks[0]))
+
+// ============================================================================
+// TIMING AND STACK
+// ============================================================================
+
+#ifdef BENCH_ON_DEVICE
+
+static inline uint64_t bench_now(void) {
+    return dwt_get_cycle_count();
+}
+
+static inline uint64_t bench_elapsed(uint64_t start) {
+    return (uint32_t)(dwt_get_cycle_count() - (uint32_t)start);
+}
+
+static double bench_per_second(void) {
+    return (double)dwt_get_cycles_per_us() * 1000000.0;
+}
+
+static int32_t stack_thread(void* context) {
+    const BenchKernel_t* kernel = context;
+    kernel->run();
+    return (int32_t)furi_thread_get_stack_space(furi_thread_get_current_id());
+}
+
+// Stack used by one pass on a worker-sized FuriThread
+static uint32_t bench_measure_stack(const BenchKernel_t* kernel) {
+    FuriThread* thread = furi_thread_alloc();
+    furi_thread_set_name(thread, "RFLabBench");
+    furi_thread_set_stack_size(thread, BENCH_STACK_SIZE);
+    furi_thread_set_context(thread, (void*)kernel);
+    furi_thread_set_callback(thread, stack_thread);
+    furi_thread_start(thread);
+    furi_thread_join(thread);
+    uint32_t free_bytes = (uint32_t)furi_thread_get_return_code(thread);
+    furi_thread_free(thread);
+    return BENCH_STACK_SIZE - free_bytes;
+}
+
+static uint32_t bench_module_static_bytes(const char* module) {
+    UNUSED(module);
+    return 0;                       // Not visible at run time; use nm on the .fap
+}
+
+#else
+
+static uint8_t bench_stack[BENCH_STACK_SIZE] __attribute__((aligned(64)));
+
+static inline uint64_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_elapsed(uint64_t start) {
+    return bench_now() - start;
+}
+
+static double bench_per_second(void) {
+    return 1e9;
+}
+
+static void* stack_thread(void* context) {
+    const BenchKernel_t* kernel = context;
+    kernel->run();
+    return NULL;
+}
+
+// Deepest write into a painted pthread stack during one pass (grows down)
+static uint32_t bench_measure_stack(const BenchKernel_t* kernel) {
+    memset(bench_stack, BENCH_STACK_PAINT, sizeof(bench_stack));
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, bench_stack, sizeof(bench_stack));
+    if(pthread_create(&thread, &attr, stack_thread, (void*)kernel) != 0) {
+        pthread_attr_destroy(&attr);
+        return 0;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    uint32_t untouched = 0;
+    while(untouched < sizeof(bench_stack) && bench_stack[untouched] == BENCH_STACK_PAINT) {
+        untouched++;
+    }
+    return sizeof(bench_stack) - untouched;
+}
+
+// Writable static data (.data/.bss) defined in `module`, from the local
+// symbols that follow its STT_FILE entry in our own symbol table
+static uint32_t bench_module_static_bytes(const char* module) {
+    static uint8_t* image = NULL;
+    static long image_size = 0;
+
+    if(!image) {
+        FILE* f = fopen("/proc/self/exe", "rb");
+        if(!f) return 0;
+        fseek(f, 0, SEEK_END);
+        image_size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        image = malloc((size_t)image_size);
+        if(!image || fread(image, 1, (size_t)image_size, f) != (size_t)image_size) {
+            free(image);
+            image = NULL;
+            fclose(f);
+            return 0;
+        }
+        fclose(f);
+    }
+
+    const Elf64_Ehdr* ehdr = (const Elf64_Ehdr*)image;
+    if(memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 || ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
+        return 0;
+    }
+    const Elf64_Shdr* sections = (const Elf64_Shdr*)(image + ehdr->e_shoff);
+
+    uint32_t total = 0;
+    for(uint16_t s = 0; s < ehdr->e_shnum; s++) {
+        if(sections[s].sh_type != SHT_SYMTAB) continue;
+
+        const Elf64_Sym* symbols = (const Elf64_Sym*)(image + sections[s].sh_offset);
+        const char* names = (const char*)(image + sections[sections[s].sh_link].sh_offset);
+        uint32_t count = (uint32_t)(sections[s].sh_size / sizeof(Elf64_Sym));
+        bool in_module = false;
+
+        for(uint32_t i = 0; i < count; i++) {
+            const Elf64_Sym* sym = &symbols[i];
+            if(ELF64_ST_TYPE(sym->st_info) == STT_FILE) {
+                in_module = (strcmp(names + sym->st_name, module) == 0);
+                continue;
+            }
+            if(!in_module || ELF64_ST_BIND(sym->st_info) != STB_LOCAL ||
+               ELF64_ST_TYPE(sym->st_info) != STT_OBJECT || sym->st_shndx >= ehdr->e_shnum) {
+                continue;
+            }
+            uint64_t flags = sections[sym->st_shndx].sh_flags;
+            if((flags & SHF_ALLOC) && (flags & SHF_WRITE)) total += (uint32_t)sym->st_size;
+        }
+    }
+    return total;
+}
+
+#endif
+
+// ============================================================================
+// MEASUREMENT
+// ============================================================================
+
+// Setup, warm-up pass (sizes the timed runs) and memory figures
+static void bench_prepare_kernel(const BenchKernel_t* kernel, uint32_t stack_offset,
+                                 BenchResult_t* result) {
+    memset(result, 0, sizeof(*result));
+    result->kernel = kernel;
+    if(kernel->setup) kernel->setup();
+
+    uint64_t start = bench_now();
+    result->items = kernel->run();
+    uint64_t once = bench_elapsed(start);
+    if(once == 0) once = 1;
+    result->passes = (once >= BENCH_MIN_RUN) ? 1 : (uint32_t)(BENCH_MIN_RUN / once) + 1;
+
+    uint32_t stack = bench_measure_stack(kernel);
+    result->stack_bytes = (stack > stack_offset) ? stack - stack_offset : 0;
+    result->static_bytes = kernel->module ? bench_module_static_bytes(kernel->module) : 0;
+}
+
+// One timed run; the fastest run across all rounds is kept
+static void bench_time_kernel(BenchResult_t* result) {
+    const BenchKernel_t* kernel = result->kernel;
+
+    uint64_t start = bench_now();
+    for(uint32_t p = 0; p < result->passes; p++) kernel->run();
+    double per_item = (double)bench_elapsed(start) /
+                      ((double)result->passes * (result->items ? result->items : 1));
+
+    if(result->time_per_item == 0 || per_item < result->time_per_item) {
+        result->time_per_item = per_item;
+        result->items_per_sec = (per_item > 0) ? bench_per_second() / per_item : 0;
+    }
+}
+
+// Prepare the modules and the corpus shared by all kernels
+static void bench_init(void) {
+    fixed_point_init();
+    compression_init();
+    clustering_engine_init();
+    threat_model_init();
+    protocol_infer_init();
+    fingerprinting_engine_init();
+    bench_corpus_build(BENCH_CORPUS_SEED, &corpus);
+}
+
+// Run all output checks; returns the failures. Called after the timed rounds
+// so the extra passes stay out of the timings.
+static uint32_t bench_verify(void) {
+    uint32_t failures = 0;
+    for(uint8_t c = 0; c < BENCH_CHECK_COUNT; c++) {
+        if(bench_checks[c].check()) continue;
+#ifdef BENCH_ON_DEVICE
+        FURI_LOG_E(TAG, "Output check failed: %s", bench_checks[c].name);
+#else
+        printf("Output check FAILED: %s\n", bench_checks[c].name);
+#endif
+        failures++;
+    }
+    return failures;
+}
+
+// Run every kernel whose name contains filter (NULL = all)
+static void bench_run_all(const char* filter) {
+    // Thread start-up and TLS are charged to an empty kernel and subtracted
+    uint32_t stack_offset = bench_measure_stack(&bench_empty_kernel);
+
+    result_count = 0;
+    for(uint8_t k = 0; k < BENCH_KERNEL_COUNT && result_count < BENCH_MAX_RESULTS; k++) {
+        if(filter && !strstr(bench_kernels[k].name, filter)) continue;
+        bench_prepare_kernel(&bench_kernels[k], stack_offset, &results[result_count++]);
+    }
+
+    // Round-robin so a burst of host noise costs each kernel one run at most
+    for(uint8_t r = 0; r < BENCH_REPEATS; r++) {
+        for(uint8_t i = 0; i < result_count; i++) bench_time_kernel(&results[i]);
+    }
+}
+
+#ifdef BENCH_ON_DEVICE
+
+// ============================================================================
+// DEVICE ENTRY POINT
+// ============================================================================
+
+int32_t rf_lab_bench_main(void* p) {
+    UNUSED(p);
+
+    timer_precision_init();
+    bench_init();
+    FURI_LOG_I(TAG, "Corpus: %u frames, %u pulses", corpus.frames, corpus.pulses);
+
+    bench_run_all(NULL);
+    for(uint8_t i = 0; i < result_count; i++) {
+        const BenchResult_t* r = &results[i];
+        FURI_LOG_I(TAG, "%-16s %8lu cyc/%s  %8lu %s/s  stack %4lu B",
+                   r->kernel->name, (uint32_t)(r->time_per_item + 0.5), r->kernel->unit,
+                   (uint32_t)r->items_per_sec, r->kernel->unit, r->stack_bytes);
+    }
+
+    uint32_t failures = bench_verify();
+    FURI_LOG_I(TAG, "Output checks: %lu of %u failed", failures, (unsigned)BENCH_CHECK_COUNT);
+    return (failures > 0) ? 1 : 0;
+}
+
+#else
+
+// ============================================================================
+// BASELINES
+// ============================================================================
+
+typedef struct {
+    char name[32];
+    double time_per_item;
+    uint32_t stack_bytes;
+    uint32_t static_bytes;
+} BenchBaseline_t;
+
+static BenchBaseline_t baselines[BENCH_MAX_RESULTS];
+static uint8_t baseline_count = 0;
+
+// Lines: name ns_per_item stack_bytes static_bytes ('#' starts a comment)
+static bool bench_load_baseline(const char* path) {
+    FILE* f = fopen(path, "r");
+    if(!f) {
+        fprintf(stderr, "Cannot open baseline %s\n", path);
+        return false;
+    }
+
+    char line[128];
+    baseline_count = 0;
+    while(fgets(line, sizeof(line), f) && baseline_count < BENCH_MAX_RESULTS) {
+        if(line[0] == '#' || line[0] == '\r' || line[0] == '\n') continue;
+        BenchBaseline_t* b = &baselines[baseline_count];
+        if(sscanf(line, "%31s %lf %u %u", b->name, &b->time_per_item, &b->stack_bytes,
+                  &b->static_bytes) == 4) {
+            baseline_count++;
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool bench_save_baseline(const char* path) {
+    FILE* f = fopen(path, "w");
+    if(!f) {
+        fprintf(stderr, "Cannot write baseline %s\n", path);
+        return false;
+    }
+
+    fprintf(f, "# Flipper RF Lab host benchmark baseline (corpus seed 0x%08X)\n",
+            BENCH_CORPUS_SEED);
+    fprintf(f, "# kernel ns_per_item stack_bytes static_bytes\n");
+    for(uint8_t i = 0; i < result_count; i++) {
+        fprintf(f, "%s %.3f %u %u\n", results[i].kernel->name, results[i].time_per_item,
+                results[i].stack_bytes, results[i].static_bytes);
+    }
+    fclose(f);
+    return true;
+}
+
+static const BenchBaseline_t* bench_find_baseline(const char* name) {
+    for(uint8_t i = 0; i < baseline_count; i++) {
+        if(strcmp(baselines[i].name, name) == 0) return &baselines[i];
+    }
+    return NULL;
+}
+
+// Percent change of value against base
+static double bench_delta(double value, double base) {
+    return (base > 0) ? (value - base) * 100.0 / base : 0;
+}
+
+// ============================================================================
+// REPORT
+// ============================================================================
+
+static uint32_t bench_report(bool compare, double threshold) {
+    uint32_t regressions = 0;
+
+    printf("Corpus: %u frames (", corpus.frames);
+    for(uint8_t s = 0; s < BENCH_SIGNAL_COUNT; s++) {
+        printf("%s%s %u", s ? ", " : "", bench_corpus_signal_name(s), corpus.frames_by_signal[s]);
+    }
+    printf("), %u pulses (%u gaps over %u us), %lu payload bytes, %.1f s of air time\n\n",
+           corpus.pulses, corpus.long_gaps, (unsigned)MAX_PULSE_WIDTH_US,
+           (unsigned long)corpus.payload_bytes, corpus.duration_us / 1e6);
+
+    printf("%-16s %8s %12s %18s %9s %9s%s\n", "kernel", "items", BENCH_TIME_UNIT "/item",
+           "throughput", "stack B", "static B", compare ? "   vs baseline" : "");
+
+    for(uint8_t i = 0; i < result_count; i++) {
+        const BenchResult_t* r = &results[i];
+        char throughput[32];
+        snprintf(throughput, sizeof(throughput), "%.2fM %s/s", r->items_per_sec / 1e6,
+                 r->kernel->unit);
+        printf("%-16s %8u %12.2f %18s %9u %9u", r->kernel->name, r->items, r->time_per_item,
+               throughput, r->stack_bytes, r->static_bytes);
+
+        const BenchBaseline_t* b = compare ? bench_find_baseline(r->kernel->name) : NULL;
+        if(b) {
+            double time_delta = bench_delta(r->time_per_item, b->time_per_item);
+            double stack_delta = bench_delta(r->stack_bytes, b->stack_bytes);
+            double static_delta = bench_delta(r->static_bytes, b->static_bytes);
+            bool regressed = time_delta > threshold || stack_delta > threshold ||
+                             static_delta > threshold;
+            printf("   %+6.1f%% %s", time_delta, regressed ? "REGRESSION" : "ok");
+            if(stack_delta > threshold) printf(" (stack %+.0f%%)", stack_delta);
+            if(static_delta > threshold) printf(" (static %+.0f%%)", static_delta);
+            if(regressed) regressions++;
+        } else if(compare) {
+            printf("   (no baseline)");
+        }
+        printf("\n");
+    }
+
+    if(compare) {
+        printf("\n%u regression(s) above %.0f%%\n", regressions, threshold);
+    }
+    return regressions;
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+static void bench_usage(const char* argv0) {
+    printf("Usage: %s [--baseline FILE] [--update FILE] [--threshold PCT] [--filter NAME]\n",
+           argv0);
+    printf("  --baseline FILE   compare against FILE, exit 1 on regression\n");
+    printf("  --update FILE     write this run as the new baseline\n");
+    printf("  --threshold PCT   allowed slowdown / memory growth (default %d)\n",
+           BENCH_DEFAULT_THRESHOLD);
+    printf("  --filter NAME     only run kernels whose name contains NAME\n");
+}
+
+int main(int argc, char** argv) {
+    const char* baseline_path = NULL;
+    const char* update_path = NULL;
+    const char* filter = NULL;
+    double threshold = BENCH_DEFAULT_THRESHOLD;
+
+    for(int i = 1; i < argc; i++) {
+        bool has_value = (i + 1 < argc);
+        if(strcmp(argv[i], "--baseline") == 0 && has_value) {
+            baseline_path = argv[++i];
+        } else if(strcmp(argv[i], "--update") == 0 && has_value) {
+            update_path = argv[++i];
+        } else if(strcmp(argv[i], "--threshold") == 0 && has_value) {
+            threshold = atof(argv[++i]);
+        } else if(strcmp(argv[i], "--filter") == 0 && has_value) {
+            filter = argv[++i];
+        } else {
+            bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if(baseline_path && !bench_load_baseline(baseline_path)) return 2;
+
+    bench_init();
+    bench_run_all(filter);
+    uint32_t regressions = bench_report(baseline_path != NULL, threshold);
+
+    uint32_t failures = bench_verify();
+    printf("Output checks: %u of %u passed\n", (unsigned)(BENCH_CHECK_COUNT - failures),
+           (unsigned)BENCH_CHECK_COUNT);
+
+    // A baseline is never recorded from a run whose outputs are wrong
+    if(failures > 0) return 1;
+    if(update_path && !bench_save_baseline(update_path)) return 2;
+    return (regressions > 0) ? 1 : 0;
+}
+
+#endif
+
+#endif // RF_LAB_BENCH
@@ -0,0 +1,41 @@
+#ifndef BENCH_MOCK_FURI_H
+#define BENCH_MOCK_FURI_H
+
+// ============================================================================
+// HOST FURI MOCK
+// Just enough of the Furi API to build the analysis and storage modules on a
+// PC. Logging is compiled out so it never shows up in the timings; build
+// with -DBENCH_VERBOSE to see module logs on stderr.
+// ============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+#define UNUSED(x) (void)(x)
+
+#ifdef BENCH_VERBOSE
+#define FURI_LOG_BENCH(level, tag, fmt, ...) \
+    fprintf(stderr, "[" level "][%s] " fmt "\n", tag, ##__VA_ARGS__)
+#else
+#define FURI_LOG_BENCH(level, tag, fmt, ...) ((void)0)
+#endif
+
+#define FURI_LOG_E(tag, fmt, ...) FURI_LOG_BENCH("E", tag, fmt, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, fmt, ...) FURI_LOG_BENCH("W", tag, fmt, ##__VA_ARGS__)
+#define FURI_LOG_I(tag, fmt, ...) FURI_LOG_BENCH("I", tag, fmt, ##__VA_ARGS__)
+#define FURI_LOG_D(tag, fmt, ...) FURI_LOG_BENCH("D", tag, fmt, ##__VA_ARGS__)
+#define FURI_LOG_T(tag, fmt, ...) FURI_LOG_BENCH("T", tag, fmt, ##__VA_ARGS__)
+
+// Milliseconds since the first call (CLOCK_MONOTONIC)
+uint32_t furi_get_tick(void);
+
+#endif // BENCH_MOCK_FURI_H
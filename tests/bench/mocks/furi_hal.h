@@ -0,0 +1,10 @@
+#ifndef BENCH_MOCK_FURI_HAL_H
+#define BENCH_MOCK_FURI_HAL_H
+
+// The benchmarked modules use no HAL calls; flipper_rf_lab.h only needs the
+// header and the opaque GUI handle in its init prototypes.
+#include "furi.h"
+
+typedef struct ViewDispatcher ViewDispatcher;
+
+#endif // BENCH_MOCK_FURI_HAL_H
@@ -0,0 +1,11 @@
+#ifndef BENCH_MOCK_STORAGE_H
+#define BENCH_MOCK_STORAGE_H
+
+// Opaque handles referenced by sd_manager.h (the SD layer itself is stubbed
+// in bench_mocks.c)
+#include "../furi.h"
+
+typedef struct Storage Storage;
+typedef struct File File;
+
+#endif // BENCH_MOCK_STORAGE_H
@@ -1,5 +1,11 @@
 // Unit Test Runner for Flipper RF Lab
-// Tests portable components without Flipper SDK dependencies
+// Tests portable components without Flipper SDK dependencies. Suites for the
+// real modules build against the host Furi mocks used by the benchmark:
+//   gcc -std=gnu11 -DRF_LAB_BENCH -Itests/bench/mocks -Icore -o test_runner
+//       tests/test_runner.c tests/bench/bench_mocks.c core/circular_buffer.c
+//       core/math/crc.c core/pulse_store.c core/session_store.c
+//       analysis/threat_model.c storage/compression.c core/math/fixed_point.c
+//       core/math/fft.c core/math/dsp.c core/math/statistics.c -lm -lpthread
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -8,35 +14,24 @@
 #include <stdbool.h>
 #include <math.h>
 #include <time.h>
+#include <pthread.h>
+#include <sched.h>
 
-// Mock Flipper SDK types for testing
-typedef int32_t FuriStatus;
-#define FuriStatusOk 0
-#define FuriStatusError -1
-#define FURI_LOG_I(tag, fmt, ...) printf("[INFO] " fmt "\n", ##__VA_ARGS__)
-#define FURI_LOG_E(tag, fmt, ...) printf("[ERROR] " fmt "\n", ##__VA_ARGS__)
-#define FURI_LOG_W(tag, fmt, ...) printf("[WARN] " fmt "\n", ##__VA_ARGS__)
-#define UNUSED(x) (void)(x)
-#define furi_get_tick() (clock() * 1000 / CLOCKS_PER_SEC)
+// Host Furi mocks (tests/bench/mocks) and the real modules under test
+#include <furi.h>
+#include "flipper_rf_lab.h"
+#include "math/fixed_point.h"
+#include "math/crc.h"
+#include "math/fft.h"
+#include "math/dsp.h"
+#include "math/statistics.h"
+#include "session_store.h"
+#include "../analysis/threat_model.h"
+#include "../storage/compression.h"
 
 // Include components under test
 #define TESTING_MODE 1
 
-// Minimal fixed-point implementation for testing
-typedef int32_t fixed_t;
-#define FIXED_SCALE 65536
-#define FIXED_ONE 65536
-#define FIXED_TWO 131072
-#define FIXED_HALF 32768
-#define FIXED_PI 205887
-#define FIXED_MAX 2147483647
-#define FIXED_MIN -2147483648
-
-#define INT_TO_FIXED(x) ((x) * FIXED_SCALE)
-#define FIXED_TO_INT(x) ((x) / FIXED_SCALE)
-#define FLOAT_TO_FIXED(x) ((fixed_t)((x) * FIXED_SCALE))
-#define FIXED_TO_FLOAT(x) ((float)(x) / FIXED_SCALE)
-
 // Test statistics
 typedef struct {
     int total_tests;
@@ -72,32 +67,16 @@ static TestStats stats = {0};
         printf("\n=== %s ===\n", name); \
     } while(0)
 
+// Deterministic test data, independent of the srand() seed
+static uint8_t test_rand_byte(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return (uint8_t)(*state >> 24);
+}
+
 // ============================================================================
 // FIXED-POINT MATH TESTS
 // ============================================================================
 
-fixed_t fixed_mul(fixed_t a, fixed_t b) {
-    return (fixed_t)(((int64_t)a * (int64_t)b) / FIXED_SCALE);
-}
-
-fixed_t fixed_div(fixed_t a, fixed_t b) {
-    if (b == 0) return 0;
-    return (fixed_t)(((int64_t)a * FIXED_SCALE) / (int64_t)b);
-}
-
-fixed_t fixed_sqrt(fixed_t x) {
-    if (x <= 0) return 0;
-    fixed_t res = x;
-    for (int i = 0; i < 20; i++) {
-        res = (res + fixed_div(x, res)) / 2;
-    }
-    return res;
-}
-
-fixed_t fixed_abs(fixed_t x) {
-    return (x < 0) ? -x : x;
-}
-
 void test_fixed_point_math() {
     TEST_SUITE("Fixed-Point Math");
     
@@ -127,104 +106,257 @@ void test_fixed_point_math() {
 }
 
 // ============================================================================
-// COMPRESSION TESTS
+// FFT AND GOERTZEL TESTS
 // ============================================================================
 
-uint32_t delta_encode(const uint8_t* input, uint32_t len, uint8_t* output) {
-    if (len == 0) return 0;
-    uint32_t out_pos = 0;
-    int16_t last = input[0];
-    output[out_pos++] = input[0];
-    
-    for (uint32_t i = 1; i < len && out_pos < 1024; i++) {
-        int16_t delta = (int16_t)input[i] - last;
-        if (delta >= -128 && delta <= 127) {
-            output[out_pos++] = (uint8_t)(delta & 0xFF);
-        } else {
-            output[out_pos++] = 0x80;
-            output[out_pos++] = (uint8_t)(delta >> 8);
-            output[out_pos++] = (uint8_t)(delta & 0xFF);
+// Largest |fixed FFT bin * 2^exponent - double DFT bin| over all bins,
+// relative to the largest DFT bin
+static double fft_max_error(const fixed_t* out, int8_t exponent, const double* in, uint16_t n) {
+    double peak = 0.0;
+    double worst = 0.0;
+    for (uint16_t k = 0; k < n; k++) {
+        double re = 0.0;
+        double im = 0.0;
+        for (uint16_t t = 0; t < n; t++) {
+            double w = -2.0 * M_PI * (double)k * t / n;
+            re += in[2 * t] * cos(w) - in[2 * t + 1] * sin(w);
+            im += in[2 * t] * sin(w) + in[2 * t + 1] * cos(w);
         }
-        last = input[i];
+        double scale = ldexp(1.0, exponent) / FIXED_SCALE;
+        double dr = out[2 * k] * scale - re;
+        double di = out[2 * k + 1] * scale - im;
+        if (hypot(re, im) > peak) peak = hypot(re, im);
+        if (hypot(dr, di) > worst) worst = hypot(dr, di);
     }
-    return out_pos;
+    return worst / peak;
 }
 
-uint32_t delta_decode(const uint8_t* input, uint32_t len, uint8_t* output) {
-    if (len == 0) return 0;
-    uint32_t in_pos = 0;
-    uint32_t out_pos = 0;
-    int16_t last = input[in_pos++];
-    output[out_pos++] = (uint8_t)last;
-    
-    while (in_pos < len) {
-        uint8_t byte = input[in_pos++];
-        if (byte == 0x80 && in_pos + 1 < len) {
-            int16_t delta = (int16_t)((input[in_pos] << 8) | input[in_pos + 1]);
-            in_pos += 2;
-            last += delta;
-        } else {
-            last += (int8_t)byte;
+void test_fft_goertzel() {
+    TEST_SUITE("FFT and Goertzel");
+    
+    static fixed_t data[2 * FFT_MAX_SIZE];
+    static double ref[2 * FFT_MAX_SIZE];
+    uint32_t rng = 3;
+    
+    TEST_ASSERT(fft_size_supported(64) && fft_size_supported(1024), "Power-of-two sizes supported");
+    TEST_ASSERT(!fft_size_supported(32) && !fft_size_supported(96) && !fft_size_supported(2048),
+                "Other sizes rejected");
+    TEST_ASSERT_EQ_INT(FFT_ERROR, fft_complex(data, 96), "Unsupported size returns FFT_ERROR");
+    
+    // Random complex input against a double-precision DFT: 256 points is all
+    // radix-4, 128 needs the extra radix-2 stage
+    const uint16_t sizes[] = {256, 128};
+    for (int i = 0; i < 2; i++) {
+        uint16_t n = sizes[i];
+        for (uint16_t t = 0; t < 2 * n; t++) {
+            data[t] = (fixed_t)((test_rand_byte(&rng) - 128) * 64);
+            ref[t] = (double)data[t] / FIXED_SCALE;
         }
-        output[out_pos++] = (uint8_t)last;
+        int8_t exponent = fft_complex(data, n);
+        double error = fft_max_error(data, exponent, ref, n);
+        TEST_ASSERT(error < 0.01, n == 256 ? "Radix-4 FFT matches DFT" : "Mixed radix FFT matches DFT");
+        printf("  %u-point FFT: exponent %d, relative error %.5f\n", n, exponent, error);
     }
-    return out_pos;
-}
-
-uint32_t rle_encode(const uint8_t* input, uint32_t len, uint8_t* output) {
-    uint32_t in_pos = 0, out_pos = 0;
-    while (in_pos < len && out_pos < 1024 - 3) {
-        uint8_t symbol = input[in_pos];
-        uint8_t run_length = 1;
-        while (in_pos + run_length < len && 
-               input[in_pos + run_length] == symbol && 
-               run_length < 255) {
-            run_length++;
-        }
-        if (run_length >= 3) {
-            output[out_pos++] = 0x00;
-            output[out_pos++] = run_length;
-            output[out_pos++] = symbol;
-            in_pos += run_length;
-        } else {
-            if (symbol == 0x00) {
-                output[out_pos++] = 0x00;
-                output[out_pos++] = 0x01;
-            }
-            output[out_pos++] = symbol;
-            in_pos++;
-        }
+    
+    // Near full-scale input does not overflow: x[m] = (1 + i) * 30000 * (-1)^m
+    // puts everything in bin n/2 and the block exponent absorbs the growth
+    for (uint16_t t = 0; t < 2 * 1024; t++) {
+        data[t] = (t & 2) ? -INT_TO_FIXED(30000) : INT_TO_FIXED(30000);
     }
-    return out_pos;
+    int8_t exponent = fft_complex(data, 1024);
+    double nyquist = ldexp((double)data[2 * 512], exponent) / FIXED_SCALE;
+    TEST_ASSERT(exponent > 0, "Large input raises the block exponent");
+    TEST_ASSERT_EQ_FLOAT(1024.0 * 30000, nyquist, 1024.0 * 30000 * 0.001,
+                         "Large input bin keeps its magnitude");
+    
+    // Real FFT of a 0.5-amplitude tone at bin 10 plus 0.25 DC
+    const uint16_t n = 256;
+    for (uint16_t t = 0; t < n; t++) {
+        data[t] = FLOAT_TO_FIXED(0.25 + 0.5 * cos(2.0 * M_PI * 10 * t / n));
+    }
+    exponent = fft_real(data, n);
+    fft_real_magnitude(data, n, exponent);
+    
+    fixed_t leakage = 0;
+    for (uint16_t k = 1; k < n / 2; k++) {
+        if (k != 10 && data[k] > leakage) leakage = data[k];
+    }
+    TEST_ASSERT_EQ_FLOAT(0.25f, FIXED_TO_FLOAT(data[0]), 0.005f, "Real FFT DC amplitude");
+    TEST_ASSERT_EQ_FLOAT(0.25f, FIXED_TO_FLOAT(data[10]), 0.005f, "Real FFT tone amplitude |X|/n");
+    TEST_ASSERT(FIXED_TO_FLOAT(leakage) < 0.002f, "Real FFT has no leakage for a bin-centred tone");
+    
+    // Goertzel on the same tone: amplitude and complex bin match the DFT
+    static fixed_t tone[256];
+    for (uint16_t t = 0; t < n; t++) {
+        tone[t] = FLOAT_TO_FIXED(0.5 * sin(2.0 * M_PI * 10 * t / n + 0.7));
+    }
+    GoertzelState_t g;
+    goertzel_init_bin(&g, 10, n);
+    goertzel_process(&g, tone, 100);
+    goertzel_process(&g, tone + 100, n - 100);
+    
+    fixed_t re = 0;
+    fixed_t im = 0;
+    goertzel_result(&g, &re, &im);
+    TEST_ASSERT_EQ_FLOAT(0.5f, FIXED_TO_FLOAT(goertzel_amplitude(&g)), 0.002f,
+                         "Goertzel amplitude of a bin-centred tone");
+    TEST_ASSERT_EQ_FLOAT(64.0 * cos(0.7 - M_PI / 2), FIXED_TO_FLOAT(re), 0.05f, "Goertzel real part");
+    TEST_ASSERT_EQ_FLOAT(64.0 * sin(0.7 - M_PI / 2), FIXED_TO_FLOAT(im), 0.05f, "Goertzel imaginary part");
+    
+    // Off-bin detector rejects the tone
+    goertzel_init(&g, 2000, 256 * 100);
+    goertzel_process(&g, tone, n);
+    TEST_ASSERT(FIXED_TO_FLOAT(goertzel_amplitude(&g)) < 0.02f, "Goertzel rejects a distant tone");
+    
+    goertzel_reset(&g);
+    TEST_ASSERT_EQ_INT(0, goertzel_amplitude(&g), "Reset clears the Goertzel state");
 }
 
-uint32_t rle_decode(const uint8_t* input, uint32_t len, uint8_t* output) {
-    uint32_t in_pos = 0, out_pos = 0;
-    while (in_pos < len) {
-        uint8_t byte = input[in_pos++];
-        if (byte == 0x00) {
-            if (in_pos >= len) break;
-            uint8_t next = input[in_pos++];
-            if (next == 0x00) {
-                output[out_pos++] = 0x00;
-            } else if (next == 0x01) {
-                if (in_pos >= len) break;
-                output[out_pos++] = input[in_pos++];
-            } else {
-                uint8_t run_length = next;
-                if (in_pos >= len) break;
-                uint8_t symbol = input[in_pos++];
-                for (uint8_t i = 0; i < run_length && out_pos < 1024; i++) {
-                    output[out_pos++] = symbol;
-                }
-            }
-        } else {
-            output[out_pos++] = byte;
-        }
+// ============================================================================
+// Q15 DSP KERNEL TESTS
+// ============================================================================
+
+void test_dsp_q15() {
+    TEST_SUITE("Q15 DSP Kernels");
+    
+    q15_t a[67];
+    q15_t b[67];
+    q15_t sum[67];
+    uint32_t rng = 5;
+    for (int i = 0; i < 67; i++) {
+        a[i] = (q15_t)((test_rand_byte(&rng) << 8) | test_rand_byte(&rng));
+        b[i] = (q15_t)((test_rand_byte(&rng) << 8) | test_rand_byte(&rng));
+    }
+    
+    // Dot product and saturating add against scalar references (odd length
+    // exercises the tail after the paired loop)
+    int64_t dot_ref = 0;
+    bool add_ok = true;
+    for (int i = 0; i < 67; i++) dot_ref += (int32_t)a[i] * b[i];
+    dsp_add_q15(a, b, sum, 67);
+    for (int i = 0; i < 67; i++) {
+        int32_t s = a[i] + b[i];
+        if (s > Q15_MAX) s = Q15_MAX;
+        if (s < Q15_MIN) s = Q15_MIN;
+        if (sum[i] != s) add_ok = false;
+    }
+    TEST_ASSERT(dsp_dot_q15(a, b, 67) == dot_ref, "Dot product matches reference");
+    TEST_ASSERT(add_ok, "Saturating add matches reference");
+    
+    q15_t min_vec[8] = {Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN, Q15_MIN};
+    TEST_ASSERT(dsp_dot_q15(min_vec, min_vec, 8) == 8LL << 30, "Dot product of -1 * -1 does not wrap");
+    
+    // out aliasing an input
+    memcpy(sum, a, sizeof(a));
+    dsp_add_q15(sum, b, sum, 67);
+    bool alias_ok = true;
+    for (int i = 0; i < 67; i++) {
+        int32_t s = a[i] + b[i];
+        if (s > Q15_MAX) s = Q15_MAX;
+        if (s < Q15_MIN) s = Q15_MIN;
+        if (sum[i] != s) alias_ok = false;
+    }
+    TEST_ASSERT(alias_ok, "In-place add matches reference");
+    
+    fixed_t fixed_in[4] = {FIXED_HALF, -FIXED_HALF, FLOAT_TO_FIXED(1.5f), INT_TO_FIXED(-2)};
+    q15_t fixed_out[4];
+    dsp_fixed_to_q15(fixed_in, fixed_out, 4);
+    TEST_ASSERT(fixed_out[0] == 16384 && fixed_out[1] == -16384, "Q15.16 to Q15 conversion");
+    TEST_ASSERT(fixed_out[2] == Q15_MAX && fixed_out[3] == Q15_MIN, "Q15.16 to Q15 saturates");
+    
+    // Correlation finds an embedded reference and matches the rounded sums
+    q15_t ref[16];
+    q15_t x[100];
+    int32_t corr[100];
+    for (int i = 0; i < 16; i++) ref[i] = (i * 5 % 3 == 0) ? 12000 : -12000;
+    for (int i = 0; i < 100; i++) x[i] = (q15_t)((test_rand_byte(&rng) - 128) * 16);
+    memcpy(&x[41], ref, sizeof(ref));
+    
+    uint32_t count = dsp_correlate_q15(x, 100, ref, 16, corr);
+    uint32_t best = 0;
+    bool corr_ok = true;
+    for (uint32_t k = 0; k < count; k++) {
+        int64_t acc = 0;
+        for (int j = 0; j < 16; j++) acc += (int32_t)ref[j] * x[k + j];
+        if (corr[k] != (int32_t)((acc + (1 << 14)) >> 15)) corr_ok = false;
+        if (corr[k] > corr[best]) best = k;
+    }
+    TEST_ASSERT_EQ_INT(85, count, "Correlation output count");
+    TEST_ASSERT(corr_ok, "Correlation matches reference");
+    TEST_ASSERT_EQ_INT(41, best, "Correlation peak at the embedded reference");
+    TEST_ASSERT_EQ_INT(0, dsp_correlate_q15(x, 10, ref, 16, corr), "Reference longer than input");
+    
+    int32_t xcorr[4];
+    dsp_xcorr_q15(ref, ref, 16, xcorr, 3);
+    TEST_ASSERT_EQ_INT((12000 * 12000) >> 15, xcorr[0], "Zero-lag cross-correlation is the mean power");
+    
+    // FIR: impulse response reproduces the taps, block equals per-sample
+    const q15_t taps[5] = {16384, 8192, -4096, 2048, 1024};
+    DspFirQ15_t fir;
+    DspFirQ15_t fir_block;
+    q15_t impulse[8] = {Q15_MAX, 0, 0, 0, 0, 0, 0, 0};
+    q15_t response[8];
+    dsp_fir_q15_init(&fir, taps, 5);
+    dsp_fir_q15_block(&fir, impulse, response, 8);
+    
+    bool impulse_ok = true;
+    for (int i = 0; i < 8; i++) {
+        int32_t expected = (i < 5) ? (int32_t)(((int64_t)taps[i] * Q15_MAX + (1 << 14)) >> 15) : 0;
+        if (response[i] != expected) impulse_ok = false;
+    }
+    TEST_ASSERT(impulse_ok, "FIR impulse response equals the taps");
+    
+    dsp_fir_q15_init(&fir, taps, 5);
+    dsp_fir_q15_init(&fir_block, taps, 5);
+    q15_t block_out[100];
+    dsp_fir_q15_block(&fir_block, x, block_out, 100);
+    bool block_ok = true;
+    for (int i = 0; i < 100; i++) {
+        if (dsp_fir_q15_process(&fir, x[i]) != block_out[i]) block_ok = false;
+    }
+    TEST_ASSERT(block_ok, "FIR block matches per-sample processing");
+    TEST_ASSERT(!dsp_fir_q15_init(&fir, taps, 0) && !dsp_fir_q15_init(&fir, taps, DSP_FIR_MAX_TAPS + 1),
+                "FIR rejects invalid tap counts");
+    
+    // Square roots
+    bool isqrt_ok = true;
+    for (uint32_t v = 0; v < 70000; v++) {
+        uint32_t r = dsp_isqrt32(v * 61357u);
+        uint64_t sq = (uint64_t)(v * 61357u);
+        if ((uint64_t)r * r > sq || (uint64_t)(r + 1) * (r + 1) <= sq) isqrt_ok = false;
+    }
+    TEST_ASSERT(isqrt_ok, "Integer square root is floor(sqrt(x))");
+    TEST_ASSERT_EQ_INT(65535, dsp_isqrt32(UINT32_MAX), "Integer square root of UINT32_MAX");
+    TEST_ASSERT(abs(dsp_sqrt_fixed(INT_TO_FIXED(2)) - FLOAT_TO_FIXED(1.41421356)) <= 1,
+                "Fixed square root within 1 LSB");
+    TEST_ASSERT_EQ_INT(0, dsp_sqrt_fixed(-FIXED_ONE), "Fixed square root of a negative is 0");
+    
+    // Binary-angle trigonometry
+    int32_t worst = 0;
+    for (uint32_t i = 0; i < 4096; i++) {
+        dsp_phase_t phase = i * 1048573u;
+        q15_t sn;
+        q15_t cs;
+        dsp_sincos_q15(phase, &sn, &cs);
+        double angle = (double)phase * 2.0 * M_PI / 4294967296.0;
+        int32_t es = abs(sn - (int32_t)lround(32767.0 * sin(angle)));
+        int32_t ec = abs(cs - (int32_t)lround(32767.0 * cos(angle)));
+        if (es > worst) worst = es;
+        if (ec > worst) worst = ec;
     }
-    return out_pos;
+    TEST_ASSERT(worst <= 2, "Q15 sin/cos within 2 LSB over a full turn");
+    printf("  sin/cos worst error: %d LSB\n", (int)worst);
+    
+    TEST_ASSERT(dsp_sin_fixed(DSP_PHASE_QUARTER) == FIXED_ONE &&
+                dsp_cos_fixed(DSP_PHASE_HALF) == -FIXED_ONE, "Fixed sin/cos exact at the peaks");
+    TEST_ASSERT(abs((int32_t)(dsp_phase_from_radians(FIXED_PI) - DSP_PHASE_HALF)) < 0x10000,
+                "Radians to binary phase");
 }
 
+// ============================================================================
+// COMPRESSION TESTS
+// ============================================================================
+
 void test_compression() {
     TEST_SUITE("Compression");
     
@@ -265,61 +397,184 @@ void test_compression() {
            100, rle_compressed_len, (rle_compressed_len * 100.0) / 100.0);
 }
 
-// ============================================================================
-// STATISTICS TESTS
-// ============================================================================
-
-typedef struct {
-    uint32_t n;
-    fixed_t mean;
-    fixed_t m2;
-    fixed_t min_val;
-    fixed_t max_val;
-} WelfordState_t;
-
-void welford_init(WelfordState_t* state) {
-    memset(state, 0, sizeof(WelfordState_t));
-    state->min_val = FIXED_MAX;
-    state->max_val = FIXED_MIN;
-}
-
-void welford_add_sample(WelfordState_t* state, fixed_t x) {
-    state->n++;
-    if (x < state->min_val) state->min_val = x;
-    if (x > state->max_val) state->max_val = x;
-    fixed_t delta = x - state->mean;
-    state->mean += delta / state->n;
-    fixed_t delta2 = x - state->mean;
-    state->m2 += fixed_mul(delta, delta2);
-}
-
-fixed_t welford_get_mean(const WelfordState_t* state) {
-    return state->mean;
-}
-
-fixed_t welford_get_variance(const WelfordState_t* state) {
-    if (state->n < 2) return 0;
-    return state->m2 / (state->n - 1);
-}
-
-fixed_t stats_mean(const fixed_t* data, uint32_t n) {
-    if (n == 0) return 0;
-    fixed_t sum = 0;
-    for (uint32_t i = 0; i < n; i++) sum += data[i];
-    return sum / n;
+// Canonical Huffman: length-limited codes, table serialization, round-trips
+void test_huffman() {
+    TEST_SUITE("Huffman Coding");
+    
+    static HuffmanState_t enc;
+    static HuffmanState_t dec;
+    uint8_t table[HUFFMAN_TABLE_MAX_BYTES];
+    uint8_t encoded[COMPRESSION_MAX_BLOCK_SIZE];
+    uint8_t decoded[COMPRESSION_MAX_BLOCK_SIZE];
+    uint32_t table_len = 0;
+    
+    // Skewed text-like input
+    uint8_t text[800];
+    uint32_t rng = 7;
+    for (int i = 0; i < 800; i++) {
+        uint8_t r = test_rand_byte(&rng);
+        text[i] = (r < 128) ? 'e' : (r < 192) ? 't' : (r < 224) ? 'a' : (uint8_t)('b' + (r & 15));
+    }
+    
+    huffman_init(&enc);
+    huffman_build_tree(&enc, text, sizeof(text));
+    huffman_generate_codes(&enc);
+    huffman_save_tree(&enc, table, &table_len);
+    uint32_t encoded_len = huffman_encode(&enc, text, sizeof(text), encoded);
+    
+    TEST_ASSERT(encoded_len > 0 && encoded_len < sizeof(text) / 2, "Skewed input compresses");
+    TEST_ASSERT(huffman_load_tree(&dec, table, table_len), "Serialized table loads");
+    TEST_ASSERT_EQ_INT(sizeof(text), dec.symbol_count, "Symbol count survives serialization");
+    
+    bool codes_match = true;
+    for (int s = 0; s < COMPRESSION_MAX_SYMBOLS; s++) {
+        if (enc.code_lengths[s] != dec.code_lengths[s] ||
+            (enc.code_lengths[s] && enc.codes[s] != dec.codes[s])) codes_match = false;
+    }
+    TEST_ASSERT(codes_match, "Reloaded canonical codes match the encoder");
+    
+    uint32_t decoded_len = huffman_decode(&dec, encoded, encoded_len, decoded);
+    TEST_ASSERT_EQ_INT(sizeof(text), decoded_len, "Huffman decoded length matches");
+    TEST_ASSERT(memcmp(text, decoded, sizeof(text)) == 0, "Huffman round-trip successful");
+    printf("  Huffman: %d bytes -> %u bytes + %u table\n",
+           (int)sizeof(text), (unsigned)encoded_len, (unsigned)table_len);
+    
+    // Fibonacci frequencies would need 19-bit codes without the limit
+    static uint8_t fib_data[17710];
+    uint32_t fib[20] = {1, 1};
+    for (int i = 2; i < 20; i++) fib[i] = fib[i - 1] + fib[i - 2];
+    uint32_t pos = 0;
+    for (int s = 0; s < 20; s++) {
+        for (uint32_t n = 0; n < fib[s]; n++) fib_data[pos++] = (uint8_t)s;
+    }
+    
+    huffman_init(&enc);
+    huffman_build_tree(&enc, fib_data, pos);
+    huffman_generate_codes(&enc);
+    
+    uint32_t kraft = 0;
+    for (int s = 0; s < 20; s++) {
+        if (enc.code_lengths[s]) kraft += 1u << (HUFFMAN_MAX_CODE_LENGTH - enc.code_lengths[s]);
+    }
+    TEST_ASSERT(enc.max_length <= HUFFMAN_MAX_CODE_LENGTH, "Code lengths limited to 15 bits");
+    TEST_ASSERT_EQ_INT(1u << HUFFMAN_MAX_CODE_LENGTH, kraft, "Length-limited code is complete");
+    TEST_ASSERT(enc.code_lengths[19] < enc.code_lengths[0], "Frequent symbols get shorter codes");
+    
+    // Codes longer than the lookup table take the canonical-range path
+    uint8_t rare[400];
+    for (int i = 0; i < 400; i++) rare[i] = fib_data[(i * 97) % 17710];
+    rare[7] = 0;
+    rare[300] = 1;
+    encoded_len = huffman_encode(&enc, rare, sizeof(rare), encoded);
+    enc.symbol_count = sizeof(rare);
+    decoded_len = huffman_decode(&enc, encoded, encoded_len, decoded);
+    TEST_ASSERT(enc.code_lengths[0] > HUFFMAN_LOOKUP_BITS, "Rare symbols exceed the lookup width");
+    TEST_ASSERT(decoded_len == sizeof(rare) && memcmp(rare, decoded, sizeof(rare)) == 0,
+                "Long-code round-trip successful");
+    
+    // Single-symbol input still gets a 1-bit code
+    uint8_t flat[64];
+    memset(flat, 0x5A, sizeof(flat));
+    huffman_init(&enc);
+    huffman_build_tree(&enc, flat, sizeof(flat));
+    huffman_generate_codes(&enc);
+    huffman_save_tree(&enc, table, &table_len);
+    encoded_len = huffman_encode(&enc, flat, sizeof(flat), encoded);
+    huffman_load_tree(&dec, table, table_len);
+    decoded_len = huffman_decode(&dec, encoded, encoded_len, decoded);
+    TEST_ASSERT(decoded_len == sizeof(flat) && memcmp(flat, decoded, sizeof(flat)) == 0,
+                "Single-symbol round-trip successful");
+    
+    // Over-subscribed tables are rejected: three 1-bit codes
+    uint8_t bad_table[] = {0x00, 0x03, 0x02, 0x11, 0x10};
+    TEST_ASSERT(!huffman_load_tree(&dec, bad_table, sizeof(bad_table)),
+                "Over-subscribed table rejected");
+    TEST_ASSERT(!huffman_load_tree(&dec, table, 2), "Truncated table rejected");
 }
 
-fixed_t stats_variance(const fixed_t* data, uint32_t n) {
-    if (n < 2) return 0;
-    fixed_t mean = stats_mean(data, n);
-    fixed_t sum_sq = 0;
-    for (uint32_t i = 0; i < n; i++) {
-        fixed_t diff = data[i] - mean;
-        sum_sq += fixed_mul(diff, diff);
+// LZ77 sequences and the CRC-checked block container
+void test_lz77_blocks() {
+    TEST_SUITE("LZ77 and Blocks");
+    
+    static uint8_t input[COMPRESSION_MAX_BLOCK_SIZE];
+    static uint8_t encoded[COMPRESSION_BLOCK_MAX_OUTPUT];
+    static uint8_t decoded[COMPRESSION_MAX_BLOCK_SIZE];
+    uint32_t rng = 11;
+    
+    // Repeated frames with a changing counter byte
+    for (int i = 0; i < COMPRESSION_MAX_BLOCK_SIZE; i++) {
+        input[i] = (i % 24 == 23) ? (uint8_t)(i / 24) : (uint8_t)(0x30 + i % 24);
+    }
+    uint32_t encoded_len = lz77_encode(input, COMPRESSION_MAX_BLOCK_SIZE, encoded, 0, 0);
+    uint32_t decoded_len = lz77_decode(encoded, encoded_len, decoded);
+    TEST_ASSERT(encoded_len > 0 && encoded_len < COMPRESSION_MAX_BLOCK_SIZE / 3,
+                "LZ77 compresses repeated frames");
+    TEST_ASSERT(decoded_len == COMPRESSION_MAX_BLOCK_SIZE &&
+                memcmp(input, decoded, decoded_len) == 0, "LZ77 frame round-trip successful");
+    printf("  LZ77: %d bytes -> %u bytes\n", COMPRESSION_MAX_BLOCK_SIZE, (unsigned)encoded_len);
+    
+    // One long run: overlapping distance-1 match with length extension bytes
+    memset(input, 0xAA, COMPRESSION_MAX_BLOCK_SIZE);
+    encoded_len = lz77_encode(input, COMPRESSION_MAX_BLOCK_SIZE, encoded, 0, 0);
+    decoded_len = lz77_decode(encoded, encoded_len, decoded);
+    TEST_ASSERT(encoded_len > 0 && encoded_len < 16, "Long run encodes as one extended match");
+    TEST_ASSERT(decoded_len == COMPRESSION_MAX_BLOCK_SIZE &&
+                memcmp(input, decoded, decoded_len) == 0, "Overlapping match round-trip successful");
+    
+    // Random data: literals only, and a full random block cannot fit
+    for (int i = 0; i < COMPRESSION_MAX_BLOCK_SIZE; i++) input[i] = test_rand_byte(&rng);
+    encoded_len = lz77_encode(input, 500, encoded, 0, 0);
+    decoded_len = lz77_decode(encoded, encoded_len, decoded);
+    TEST_ASSERT(decoded_len == 500 && memcmp(input, decoded, 500) == 0,
+                "Literal-only round-trip successful");
+    TEST_ASSERT_EQ_INT(0, lz77_encode(input, COMPRESSION_MAX_BLOCK_SIZE, encoded, 0, 0),
+                       "Incompressible full block reports no fit");
+    TEST_ASSERT_EQ_INT(0, lz77_encode(input, COMPRESSION_MAX_BLOCK_SIZE + 1, encoded, 0, 0),
+                       "Oversized input rejected");
+    
+    // Malformed streams: offset before the start, truncated offset
+    const uint8_t bad_offset[] = {0x10, 'A', 0x05, 0x00};
+    const uint8_t bad_truncated[] = {0x10, 'A', 0x01};
+    TEST_ASSERT_EQ_INT(0, lz77_decode(bad_offset, sizeof(bad_offset), decoded),
+                       "Offset beyond output rejected");
+    TEST_ASSERT_EQ_INT(0, lz77_decode(bad_truncated, sizeof(bad_truncated), decoded),
+                       "Truncated offset rejected");
+    
+    // Blocks: header, CRC and payload round-trip for compressible and random data
+    compression_init();
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < 600; i++) {
+            input[i] = pass ? test_rand_byte(&rng) : (uint8_t)((i / 8) % 5);
+        }
+        
+        uint32_t block_len = 0;
+        uint32_t crc32 = 0;
+        CompressionBlockHeader_t header;
+        bool packed = compression_compress_block(input, 600, encoded, &block_len, &crc32);
+        bool parsed = compression_parse_block_header(encoded, block_len, &header);
+        bool unpacked = compression_decompress_block(encoded, block_len, decoded, &decoded_len,
+                                                     crc32);
+        
+        TEST_ASSERT(packed && parsed && header.original_size == 600 && header.crc32 == crc32,
+                    pass ? "Random block header valid" : "Compressible block header valid");
+        TEST_ASSERT(unpacked && decoded_len == 600 && memcmp(input, decoded, 600) == 0,
+                    pass ? "Random block round-trip successful" :
+                           "Compressible block round-trip successful");
+        if (!pass) {
+            TEST_ASSERT(block_len < 200, "Compressible block shrinks");
+            TEST_ASSERT(!compression_decompress_block(encoded, block_len, decoded, &decoded_len,
+                                                      crc32 ^ 1), "Wrong expected CRC rejected");
+            encoded[block_len - 1] ^= 0x40;
+            TEST_ASSERT(!compression_decompress_block(encoded, block_len, decoded, &decoded_len, 0),
+                        "Corrupted payload rejected");
+        }
     }
-    return sum_sq / (n - 1);
 }
 
+// ============================================================================
+// STATISTICS TESTS
+// ============================================================================
+
 void test_statistics() {
     TEST_SUITE("Statistics");
     
@@ -359,6 +614,101 @@ void test_statistics() {
     printf("  Mean: %.2f, Variance: %.2f\n", mean_f, variance_f);
 }
 
+static int compare_fixed(const void* a, const void* b) {
+    fixed_t x = *(const fixed_t*)a;
+    fixed_t y = *(const fixed_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Quickselect order statistics and P² streaming quantiles
+void test_order_statistics() {
+    TEST_SUITE("Order Statistics");
+    
+    static fixed_t data[501];
+    static fixed_t work[501];
+    static fixed_t sorted[501];
+    uint32_t rng = 9;
+    
+    // Signed values with many duplicates
+    for (int i = 0; i < 501; i++) {
+        data[i] = (fixed_t)(test_rand_byte(&rng) % 50 - 25) * FIXED_ONE;
+    }
+    memcpy(sorted, data, sizeof(data));
+    qsort(sorted, 501, sizeof(fixed_t), compare_fixed);
+    
+    bool select_ok = true;
+    bool partition_ok = true;
+    for (uint32_t k = 0; k < 501; k += 25) {
+        memcpy(work, data, sizeof(data));
+        if (stats_select(work, 501, k) != sorted[k]) select_ok = false;
+        for (uint32_t i = 0; i < 501; i++) {
+            if ((i < k && work[i] > work[k]) || (i > k && work[i] < work[k])) partition_ok = false;
+        }
+    }
+    TEST_ASSERT(select_ok, "Quickselect matches sorted order");
+    TEST_ASSERT(partition_ok, "Quickselect partitions around k");
+    
+    memcpy(work, data, sizeof(data));
+    TEST_ASSERT_EQ_INT(sorted[250], stats_median(work, 501), "Odd-length median");
+    memcpy(sorted, data, 500 * sizeof(fixed_t));
+    qsort(sorted, 500, sizeof(fixed_t), compare_fixed);
+    memcpy(work, data, sizeof(data));
+    TEST_ASSERT_EQ_INT((sorted[249] + sorted[250]) / 2, stats_median(work, 500),
+                       "Even-length median averages the middle pair");
+    
+    uint32_t widths[6] = {4000000000u, 12, 3000000000u, 7, 2500000000u, 9};
+    TEST_ASSERT_EQ_INT(2500000000u, stats_select_u32(widths, 6, 3), "Unsigned select above INT32_MAX");
+    TEST_ASSERT_EQ_INT(0, stats_select(work, 0, 0), "Select on empty input returns 0");
+    
+    // Already sorted and reversed input (quickselect worst cases)
+    bool ordered_ok = true;
+    for (int i = 0; i < 501; i++) work[i] = i;
+    if (stats_select(work, 501, 400) != 400) ordered_ok = false;
+    for (int i = 0; i < 501; i++) work[i] = 500 - i;
+    if (stats_select(work, 501, 17) != 17) ordered_ok = false;
+    TEST_ASSERT(ordered_ok, "Quickselect on sorted and reversed input");
+    
+    // P² quartiles of a uniform stream converge on the exact values
+    P2Quantile_t q25;
+    P2Quantile_t q50;
+    P2Quantile_t q75;
+    p2_quantile_init(&q25, 25);
+    p2_quantile_init(&q50, 50);
+    p2_quantile_init(&q75, 75);
+    
+    static fixed_t stream[5000];
+    for (int i = 0; i < 5000; i++) {
+        int32_t v = (int32_t)(((uint32_t)test_rand_byte(&rng) << 8) | test_rand_byte(&rng));
+        stream[i] = v;
+        p2_quantile_add(&q25, v);
+        p2_quantile_add(&q50, v);
+        p2_quantile_add(&q75, v);
+    }
+    qsort(stream, 5000, sizeof(fixed_t), compare_fixed);
+    
+    int32_t tolerance = 65536 / 50;     // 2% of the range
+    TEST_ASSERT(abs(p2_quantile_get(&q25) - stream[1250]) < tolerance, "P2 first quartile");
+    TEST_ASSERT(abs(p2_quantile_get(&q50) - stream[2500]) < tolerance, "P2 median");
+    TEST_ASSERT(abs(p2_quantile_get(&q75) - stream[3750]) < tolerance, "P2 third quartile");
+    TEST_ASSERT(p2_quantile_get(&q25) <= p2_quantile_get(&q50) &&
+                p2_quantile_get(&q50) <= p2_quantile_get(&q75), "P2 quartiles are ordered");
+    printf("  P2 quartiles: %ld / %ld / %ld (exact %ld / %ld / %ld)\n",
+           (long)p2_quantile_get(&q25), (long)p2_quantile_get(&q50), (long)p2_quantile_get(&q75),
+           (long)stream[1250], (long)stream[2500], (long)stream[3750]);
+    
+    // Fewer than five samples: exact order statistic of what was seen
+    p2_quantile_init(&q50, 50);
+    p2_quantile_add(&q50, 30);
+    p2_quantile_add(&q50, 10);
+    p2_quantile_add(&q50, 20);
+    TEST_ASSERT_EQ_INT(20, p2_quantile_get(&q50), "P2 exact median below five samples");
+    
+    // Constant stream stays put
+    p2_quantile_init(&q75, 75);
+    for (int i = 0; i < 100; i++) p2_quantile_add(&q75, 1234);
+    TEST_ASSERT_EQ_INT(1234, p2_quantile_get(&q75), "P2 on a constant stream");
+}
+
 // ============================================================================
 // CLUSTERING TESTS
 // ============================================================================
@@ -479,6 +829,221 @@ void test_threat_model() {
     printf("  Structured data entropy: %.2f bits/byte\n", structured_entropy);
 }
 
+// ============================================================================
+// SPSC RING BUFFER TESTS
+// ============================================================================
+
+#define RING_STRESS_BYTES (1u << 16)
+
+static void* ring_producer(void* arg) {
+    CircularBuffer_t* cb = (CircularBuffer_t*)arg;
+    uint8_t chunk[37];
+    uint32_t sent = 0;
+
+    while (sent < RING_STRESS_BYTES) {
+        uint32_t len = RING_STRESS_BYTES - sent;
+        if (len > sizeof(chunk)) len = sizeof(chunk);
+        for (uint32_t i = 0; i < len; i++) chunk[i] = (uint8_t)(sent + i);
+        // Wait for room rather than let push_n drop the excess
+        while (circular_buffer_free(cb) < len) sched_yield();
+        circular_buffer_push_n(cb, chunk, len);
+        sent += len;
+    }
+    return NULL;
+}
+
+void test_spsc_ring() {
+    TEST_SUITE("SPSC Ring Buffer");
+    
+    uint8_t storage[100];
+    CircularBuffer_t cb;
+    circular_buffer_init(&cb, storage, sizeof(storage));
+    
+    TEST_ASSERT_EQ_INT(64, cb.size, "Size rounds down to a power of two");
+    TEST_ASSERT_EQ_INT(64, circular_buffer_free(&cb), "Empty ring is all free");
+    
+    // Single-byte FIFO order
+    uint8_t byte = 0;
+    bool order_ok = true;
+    for (uint8_t i = 0; i < 10; i++) circular_buffer_write(&cb, i);
+    for (uint8_t i = 0; i < 10; i++) {
+        if (!circular_buffer_read(&cb, &byte) || byte != i) order_ok = false;
+    }
+    TEST_ASSERT(order_ok, "Single-byte FIFO order");
+    TEST_ASSERT(!circular_buffer_read(&cb, &byte), "Read from empty ring fails");
+    
+    // Bulk push across the end of the storage (tail is at offset 10)
+    uint8_t in[70];
+    uint8_t out[64];
+    for (int i = 0; i < 70; i++) in[i] = (uint8_t)(i * 7 + 1);
+    
+    TEST_ASSERT_EQ_INT(60, circular_buffer_push_n(&cb, in, 60), "Bulk push wraps around");
+    TEST_ASSERT_EQ_INT(4, circular_buffer_push_n(&cb, in + 60, 10), "Bulk push stops when full");
+    TEST_ASSERT_EQ_INT(6, cb.dropped, "Rejected bytes counted as dropped");
+    TEST_ASSERT(!circular_buffer_write(&cb, 0xFF), "Write to full ring fails");
+    
+    // Zero-copy span ends at the storage boundary
+    const uint8_t* span = NULL;
+    uint32_t span_len = circular_buffer_peek_span(&cb, &span);
+    TEST_ASSERT_EQ_INT(54, span_len, "Peek span stops at the buffer end");
+    TEST_ASSERT(memcmp(span, in, 54) == 0, "Peek span exposes the oldest bytes");
+    circular_buffer_consume(&cb, span_len);
+    TEST_ASSERT_EQ_INT(10, circular_buffer_count(&cb), "Consume releases the span");
+    
+    uint32_t popped = circular_buffer_pop_n(&cb, out, sizeof(out));
+    TEST_ASSERT_EQ_INT(10, popped, "Bulk pop returns the wrapped remainder");
+    TEST_ASSERT(memcmp(out, in + 54, 10) == 0, "Wrapped remainder keeps FIFO order");
+    
+    // Free-running indices across the 32-bit wrap
+    cb.head = cb.tail = UINT32_MAX - 2;
+    circular_buffer_push_n(&cb, in, 8);
+    TEST_ASSERT_EQ_INT(8, circular_buffer_count(&cb), "Count survives index wrap");
+    popped = circular_buffer_pop_n(&cb, out, sizeof(out));
+    TEST_ASSERT(popped == 8 && memcmp(out, in, 8) == 0, "Data survives index wrap");
+    
+    circular_buffer_push_n(&cb, in, 5);
+    circular_buffer_clear(&cb);
+    TEST_ASSERT_EQ_INT(0, circular_buffer_count(&cb), "Clear empties the ring");
+    
+    // Producer and consumer on separate threads
+    circular_buffer_init(&cb, storage, sizeof(storage));
+    pthread_t producer;
+    pthread_create(&producer, NULL, ring_producer, &cb);
+    
+    uint32_t received = 0;
+    bool stream_ok = true;
+    while (received < RING_STRESS_BYTES) {
+        uint32_t n = circular_buffer_pop_n(&cb, out, 23);
+        if (n == 0) sched_yield();
+        for (uint32_t i = 0; i < n; i++) {
+            if (out[i] != (uint8_t)(received + i)) stream_ok = false;
+        }
+        received += n;
+    }
+    pthread_join(producer, NULL);
+    
+    TEST_ASSERT(stream_ok, "Threaded stream arrives intact and in order");
+    TEST_ASSERT_EQ_INT(0, cb.dropped, "Threaded producer never overruns");
+    printf("  Streamed %u bytes through a %u-byte ring\n",
+           (unsigned)RING_STRESS_BYTES, (unsigned)cb.size);
+}
+
+// ============================================================================
+// CRC ENGINE TESTS
+// ============================================================================
+
+static const uint8_t crc_check_input[] = "123456789";
+
+// Twelve 10-byte frames: random data, then a big-endian CRC field of the
+// given engine (or random bytes when corrupt). Returns the assessment.
+static const ThreatAssessment_t* crc_test_assess(const CrcEngine_t* engine, uint32_t init,
+                                                 uint32_t xor_out, bool corrupt) {
+    static uint8_t arena[FRAME_BUFFER_SIZE];
+    static PulseBuffer_t pulses;
+    uint32_t rng = 0x5EED;
+    uint8_t bytes = engine->width / 8;
+    
+    pulse_store_reset(&pulses);
+    session_store_init(arena, sizeof(arena), &pulses);
+    
+    for (int f = 0; f < 12; f++) {
+        Frame_t frame = {0};
+        frame.length = 10;
+        uint8_t pos = frame.length - bytes;
+        for (uint8_t i = 0; i < frame.length; i++) frame.data[i] = test_rand_byte(&rng);
+        
+        if (!corrupt) {
+            uint32_t crc = crc_compute(engine, init, xor_out, frame.data, pos);
+            for (uint8_t i = 0; i < bytes; i++) {
+                frame.data[pos + i] = (uint8_t)(crc >> (8 * (bytes - 1 - i)));
+            }
+        }
+        session_store_append_frame(&frame);
+    }
+    
+    SessionFrameView_t frames = session_store_frames();
+    threat_model_start_analysis();
+    threat_model_set_frames(&frames);
+    threat_model_assess_vulnerabilities();
+    return threat_model_get_assessment();
+}
+
+void test_crc_engine() {
+    TEST_SUITE("CRC Engine");
+    
+    // Standard check values over "123456789"
+    const uint8_t* check = crc_check_input;
+    CrcEngine_t xmodem;
+    CrcEngine_t dnp;
+    crc_engine_make(&xmodem, 0x1021, 16, false);
+    crc_engine_make(&dnp, 0x3D65, 16, true);
+    
+    TEST_ASSERT_EQ_INT(0xF4, crc_compute(crc_get_engine(CRC_ENGINE_8_07), 0, 0, check, 9),
+                       "CRC-8 check value");
+    TEST_ASSERT_EQ_INT(0xBB3D, crc_compute(crc_get_engine(CRC_ENGINE_16_8005_REF), 0, 0, check, 9),
+                       "CRC-16/ARC check value");
+    TEST_ASSERT_EQ_INT(0x2189, crc_compute(crc_get_engine(CRC_ENGINE_16_1021_REF), 0, 0, check, 9),
+                       "CRC-16/KERMIT check value");
+    TEST_ASSERT_EQ_INT(0xCBF43926u, crc_compute(crc_get_engine(CRC_ENGINE_32_REF), 0xFFFFFFFF,
+                                                0xFFFFFFFF, check, 9),
+                       "CRC-32 check value (slice-by-4)");
+    TEST_ASSERT_EQ_INT(0x0376E6E7u, crc_compute(crc_get_engine(CRC_ENGINE_32_NORMAL), 0xFFFFFFFF,
+                                                0, check, 9),
+                       "CRC-32/MPEG-2 check value");
+    TEST_ASSERT(xmodem.table == NULL, "Unlisted engine falls back to bitwise");
+    TEST_ASSERT_EQ_INT(0x31C3, crc_compute(&xmodem, 0, 0, check, 9),
+                       "CRC-16/XMODEM check value (bitwise)");
+    TEST_ASSERT_EQ_INT(0xEA82, crc_compute(&dnp, 0, 0xFFFF, check, 9),
+                       "CRC-16/DNP check value (bitwise, reflected)");
+    
+    // Every table (and the slice-by-4 path at each alignment) matches the
+    // bitwise update, and updates compose
+    uint8_t data[67];
+    uint32_t rng = 1;
+    for (int i = 0; i < 67; i++) data[i] = test_rand_byte(&rng);
+    
+    bool tables_ok = true;
+    bool split_ok = true;
+    for (int id = 0; id < CRC_ENGINE_COUNT; id++) {
+        const CrcEngine_t* table = crc_get_engine((CrcEngineId_t)id);
+        CrcEngine_t bitwise = *table;
+        bitwise.table = NULL;
+        bitwise.sliced = false;
+        
+        for (uint32_t len = 0; len <= sizeof(data); len++) {
+            uint32_t init = crc_init_register(table, 0xFFFFFFFF);
+            if (crc_update(table, init, data, len) != crc_update(&bitwise, init, data, len)) {
+                tables_ok = false;
+            }
+        }
+        
+        uint32_t whole = crc_update(table, 0, data, sizeof(data));
+        uint32_t split = crc_update(table, crc_update(table, 0, data, 13), data + 13,
+                                    sizeof(data) - 13);
+        if (whole != split) split_ok = false;
+    }
+    TEST_ASSERT(tables_ok, "Table updates match bitwise for all lengths");
+    TEST_ASSERT(split_ok, "Split updates equal one-shot update");
+    
+    TEST_ASSERT_EQ_INT(0xA001, crc_reflect(0x8005, 16), "Reflect 16-bit polynomial");
+    TEST_ASSERT(crc_find_engine(0x1021, 16, true) == crc_get_engine(CRC_ENGINE_16_1021_REF),
+                "Table engine found by parameters");
+    
+    // Identification over captured frames
+    threat_model_init();
+    TEST_ASSERT(crc_test_assess(crc_get_engine(CRC_ENGINE_16_1021_REF), 0xFFFF, 0, false)->has_checksum,
+                "Database CRC-16-CCITT detected");
+    TEST_ASSERT(crc_test_assess(&dnp, 0, 0xFFFF, false)->has_checksum,
+                "Unlisted CRC-16/DNP recovered by GF(2) GCD");
+    
+    CrcEngine_t crc8_31;
+    crc_engine_make(&crc8_31, 0x31, 8, true);
+    TEST_ASSERT(crc_test_assess(&crc8_31, 0, 0, false)->has_checksum,
+                "Unlisted CRC-8/MAXIM recovered by GF(2) GCD");
+    TEST_ASSERT(!crc_test_assess(&dnp, 0, 0xFFFF, true)->has_checksum,
+                "Random trailer is not reported as a CRC");
+}
+
 // ============================================================================
 // MAIN TEST RUNNER
 // ============================================================================
@@ -493,10 +1058,17 @@ int main() {
     
     // Run all test suites
     test_fixed_point_math();
+    test_fft_goertzel();
+    test_dsp_q15();
     test_compression();
+    test_huffman();
+    test_lz77_blocks();
     test_statistics();
+    test_order_statistics();
     test_clustering();
     test_threat_model();
+    test_spsc_ring();
+    test_crc_engine();
     
     // Print summary
     printf("\n========================================\n");
@@ -0,0 +1,214 @@
+#include "live_view.h"
+#include "main_menu.h"
+#include "../analysis/protocol_infer.h"
+#include "../analysis/threat_model.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TAG "LIVE_VIEW"
+
+#define LIVE_LINE_LEN       32
+#define LIVE_WAVE_HIGH_Y    (UI_PLOT_TOP + 8)
+#define LIVE_WAVE_LOW_Y     (UI_SCREEN_HEIGHT - 9)
+
+static ViewDispatcher* live_dispatcher = NULL;
+static View* live_view = NULL;
+
+// Copy target for ui_snapshot_read; a failed read must not tear the model
+static UiSnapshot_t live_scratch;
+
+// ============================================================================
+// PAGES
+// ============================================================================
+
+static void draw_summary(Canvas* canvas, const UiSnapshot_t* s) {
+    char line[LIVE_LINE_LEN];
+
+    canvas_set_font(canvas, FontPrimary);
+    snprintf(line, sizeof(line), "Frames %u", s->frame_count);
+    canvas_draw_str(canvas, 0, 8, line);
+
+    canvas_set_font(canvas, FontSecondary);
+    snprintf(line, sizeof(line), "%s %s %u%%",
+             protocol_infer_modulation_string((InferredModulation_t)s->modulation),
+             protocol_infer_encoding_string((EncodingType_t)s->encoding),
+             s->protocol_confidence);
+    canvas_draw_str(canvas, 0, 20, line);
+
+    snprintf(line, sizeof(line), "%lu bd  %u/%u us",
+             (unsigned long)s->baud_rate, s->short_pulse_us, s->long_pulse_us);
+    canvas_draw_str(canvas, 0, 30, line);
+
+    if(s->threat_valid) {
+        snprintf(line, sizeof(line), "Risk %s %u.%u",
+                 threat_model_get_risk_string((RiskLevel_t)s->risk_level),
+                 s->vulnerability_score / 10, s->vulnerability_score % 10);
+    } else {
+        snprintf(line, sizeof(line), "Risk -");
+    }
+    canvas_draw_str(canvas, 0, 40, line);
+
+    canvas_draw_str(canvas, 0, 52, s->description);
+}
+
+// Alternate width classes are drawn as dots and 2x2 boxes
+static void draw_clusters(Canvas* canvas, const UiSnapshot_t* s) {
+    char line[LIVE_LINE_LEN];
+
+    snprintf(line, sizeof(line), "Mark/space  %u pts", s->cluster_points);
+    canvas_draw_str(canvas, 0, 8, line);
+
+    for(uint16_t i = 0; i < s->cluster_points; i++) {
+        if(s->cluster_id[i] & 1) {
+            canvas_draw_box(canvas, s->cluster_x[i], s->cluster_y[i], 2, 2);
+        } else {
+            canvas_draw_dot(canvas, s->cluster_x[i], s->cluster_y[i]);
+        }
+    }
+}
+
+static void draw_spectrum(Canvas* canvas, const UiSnapshot_t* s) {
+    char line[LIVE_LINE_LEN];
+
+    if(!s->spectrum_valid) {
+        canvas_draw_str(canvas, 0, 8, "Spectrum: no sweep yet");
+        return;
+    }
+
+    snprintf(line, sizeof(line), "%lu.%02lu MHz %d dBm",
+             (unsigned long)(s->spectrum_peak_hz / 1000000),
+             (unsigned long)(s->spectrum_peak_hz / 10000 % 100),
+             s->spectrum_peak_dbm);
+    canvas_draw_str(canvas, 0, 8, line);
+
+    for(uint8_t x = 0; x < UI_SCREEN_WIDTH; x++) {
+        uint8_t h = s->spectrum_height[x];
+        if(h > 0) canvas_draw_line(canvas, x, UI_SCREEN_HEIGHT - 1, x, UI_SCREEN_HEIGHT - h);
+    }
+
+    // Noise floor as a dotted line
+    uint8_t floor_y = UI_SCREEN_HEIGHT - 1 - s->spectrum_floor;
+    for(uint8_t x = 0; x < UI_SCREEN_WIDTH; x += 4) {
+        canvas_draw_dot(canvas, x, floor_y);
+    }
+}
+
+// Columns that saw both levels hold an edge and are drawn as a vertical line
+static void draw_waveform(Canvas* canvas, const UiSnapshot_t* s) {
+    char line[LIVE_LINE_LEN];
+
+    snprintf(line, sizeof(line), "Last frame  %lu us", (unsigned long)s->wave_span_us);
+    canvas_draw_str(canvas, 0, 8, line);
+
+    for(uint8_t x = 0; x < UI_SCREEN_WIDTH; x++) {
+        uint8_t levels = s->wave[x];
+        if(levels == (UI_WAVE_HIGH | UI_WAVE_LOW)) {
+            canvas_draw_line(canvas, x, LIVE_WAVE_HIGH_Y, x, LIVE_WAVE_LOW_Y);
+        } else if(levels & UI_WAVE_HIGH) {
+            canvas_draw_dot(canvas, x, LIVE_WAVE_HIGH_Y);
+        } else if(levels & UI_WAVE_LOW) {
+            canvas_draw_dot(canvas, x, LIVE_WAVE_LOW_Y);
+        }
+    }
+}
+
+// ============================================================================
+// VIEW CALLBACKS
+// ============================================================================
+
+static void live_view_draw_callback(Canvas* canvas, void* model) {
+    const LiveViewModel_t* m = model;
+
+    canvas_clear(canvas);
+    canvas_set_font(canvas, FontSecondary);
+
+    if(!m->valid) {
+        canvas_draw_str(canvas, 0, 8, "Waiting for analysis...");
+        return;
+    }
+
+    switch(m->page) {
+        case LIVE_PAGE_SUMMARY:
+            draw_summary(canvas, &m->snapshot);
+            break;
+        case LIVE_PAGE_CLUSTERS:
+            draw_clusters(canvas, &m->snapshot);
+            break;
+        case LIVE_PAGE_SPECTRUM:
+            draw_spectrum(canvas, &m->snapshot);
+            break;
+        case LIVE_PAGE_WAVEFORM:
+            draw_waveform(canvas, &m->snapshot);
+            break;
+        default:
+            break;
+    }
+}
+
+// Left/Right cycle pages; everything else (Back) goes to the dispatcher
+static bool live_view_input_callback(InputEvent* event, void* context) {
+    View* view = context;
+    uint8_t step;
+
+    if(event->type != InputTypeShort && event->type != InputTypeRepeat) return false;
+    if(event->key == InputKeyRight) {
+        step = 1;
+    } else if(event->key == InputKeyLeft) {
+        step = LIVE_PAGE_COUNT - 1;
+    } else {
+        return false;
+    }
+
+    with_view_model(view, LiveViewModel_t* model, {
+        model->page = (model->page + step) % LIVE_PAGE_COUNT;
+    }, true);
+    return true;
+}
+
+static uint32_t live_view_previous_callback(void* context) {
+    UNUSED(context);
+    return VIEW_MAIN_MENU;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+void live_view_init(ViewDispatcher* view_dispatcher) {
+    live_dispatcher = view_dispatcher;
+    live_view = view_alloc();
+    view_allocate_model(live_view, ViewModelTypeLocking, sizeof(LiveViewModel_t));
+    with_view_model(live_view, LiveViewModel_t* model, {
+        memset(model, 0, sizeof(LiveViewModel_t));
+    }, false);
+
+    view_set_context(live_view, live_view);
+    view_set_draw_callback(live_view, live_view_draw_callback);
+    view_set_input_callback(live_view, live_view_input_callback);
+    view_set_previous_callback(live_view, live_view_previous_callback);
+    view_dispatcher_add_view(view_dispatcher, VIEW_ANALYSIS, live_view);
+
+    FURI_LOG_I(TAG, "Live view initialized");
+}
+
+void live_view_deinit(void) {
+    if(!live_view) return;
+
+    view_dispatcher_remove_view(live_dispatcher, VIEW_ANALYSIS);
+    view_free(live_view);
+    live_view = NULL;
+    live_dispatcher = NULL;
+}
+
+// The snapshot is copied outside the model lock, so drawing never waits on
+// the seqlock retries and a failed read leaves the shown frame intact
+uint32_t live_view_update(uint32_t shown_version) {
+    if(!live_view || ui_snapshot_version() == shown_version) return shown_version;
+    if(!ui_snapshot_read(&live_scratch)) return shown_version;
+
+    with_view_model(live_view, LiveViewModel_t* model, {
+        model->snapshot = live_scratch;
+        model->valid = true;
+    }, true);
+    return live_scratch.version;
+}
@@ -0,0 +1,49 @@
+#ifndef LIVE_VIEW_H
+#define LIVE_VIEW_H
+
+#include <gui/gui.h>
+#include <gui/view.h>
+#include <gui/view_dispatcher.h>
+#include "../core/ui_snapshot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================================================
+// LIVE ANALYSIS VIEW
+// Pages drawn straight from the latest UiSnapshot_t. The model is replaced
+// only when a newer snapshot is published; Left/Right change page.
+// ============================================================================
+
+typedef enum {
+    LIVE_PAGE_SUMMARY = 0,          // Hypothesis and threat score
+    LIVE_PAGE_CLUSTERS,             // Mark/space scatter
+    LIVE_PAGE_SPECTRUM,
+    LIVE_PAGE_WAVEFORM,
+    LIVE_PAGE_COUNT
+} LivePage_t;
+
+typedef struct {
+    UiSnapshot_t snapshot;
+    uint8_t page;                   // LivePage_t
+    bool valid;                     // A snapshot has been received
+} LiveViewModel_t;
+
+// ============================================================================
+// FUNCTION DECLARATIONS
+// ============================================================================
+
+// Registers the view as VIEW_ANALYSIS
+void live_view_init(ViewDispatcher* view_dispatcher);
+void live_view_deinit(void);
+
+// UI thread: take the newest snapshot if it is not shown yet. Returns the
+// version now in the model.
+uint32_t live_view_update(uint32_t shown_version);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LIVE_VIEW_H
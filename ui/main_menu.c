@@ -26,6 +26,7 @@ static void capture_callback(void* context) {
 
 static void analyze_callback(void* context) {
     FURI_LOG_I(TAG, "Analyze selected");
+    view_dispatcher_switch_to_view(menu_context.view_dispatcher, VIEW_ANALYSIS);
     UNUSED(context);
 }
 